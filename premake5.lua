@@ -435,7 +435,11 @@ tool "slang-generate"
 tool "slang-test"
     uuid "0C768A18-1D25-4000-9F37-DA5FE99E3B64"
     includedirs { "." }
-    links { "core" }
+    links { "core", "slang" }
+
+    -- Parts of the compiler that are unit tested directly. They only
+    -- depend on `core`, so we compile them into the test binary.
+    files { "source/slang/name.cpp", "source/slang/serial-source-loc-table.cpp", "source/slang/source-loc.cpp" }
 
 --
 -- The reflection test harness `slang-reflection-test` is pretty
@@ -574,7 +578,9 @@ standardProject "slang"
 
     filter { "system:linux" }
 	-- might be able to do pic(true)
-        buildoptions{"-fPIC"}
+        -- The VM dispatches compute work over a pool of threads.
+        buildoptions{"-fPIC", "-pthread"}
+        links { "pthread" }
        
     -- Next, we want to add a custom build rule for each of the
     -- files that makes up the standard library. Those are
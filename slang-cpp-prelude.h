@@ -0,0 +1,490 @@
+#ifndef SLANG_CPP_PRELUDE_H
+#define SLANG_CPP_PRELUDE_H
+
+/*
+The types and functions needed to compile the C++ source generated by
+Slang for the `cpp` (`SLANG_CPP_SOURCE`) target.
+
+The generated code is HLSL in C++ clothing: it uses `vector<T,N>`,
+`matrix<T,R,C>`, the HLSL intrinsic functions and structured buffers,
+and this header provides just enough of each of them for compute
+kernels to run on the CPU.
+
+A compiled kernel exports the following `extern "C"` functions:
+
+    void* slang_findGlobalParam(char const* name);
+    void slang_getThreadGroupSize(uint32_t* outSize);
+    void slang_dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
+
+Shader parameters are bound by writing to the global returned by
+`slang_findGlobalParam` for the parameter's name. A buffer parameter is
+a `SlangCPP::RWStructuredBuffer<T>` (or `StructuredBuffer<T>`), which is
+just a pointer to the elements and an element count. The fields of a
+`cbuffer` are looked up by their own names.
+
+Limitations: the threads of a group are run one after another, so
+`groupshared` memory and group barriers can't be supported. The compiler
+reports an error for an entry point that uses either of them. Textures
+and samplers are not supported.
+*/
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#   define SLANG_CPP_EXPORT __declspec(dllexport)
+#else
+#   define SLANG_CPP_EXPORT __attribute__((visibility("default")))
+#endif
+
+namespace SlangCPP {
+
+typedef uint32_t uint;
+
+// Used to keep a parameter out of template argument deduction, so that
+// (e.g.) `vector<float,3>` can be multiplied by a `double` literal.
+template<typename T>
+struct Identity { typedef T Type; };
+
+// Vectors
+
+template<typename T, int N>
+struct VectorStorage;
+
+template<typename T>
+struct VectorStorage<T, 1> { T x; };
+
+template<typename T>
+struct VectorStorage<T, 2> { T x, y; };
+
+template<typename T>
+struct VectorStorage<T, 3> { T x, y, z; };
+
+template<typename T>
+struct VectorStorage<T, 4> { T x, y, z, w; };
+
+template<typename T, int N>
+struct vector : VectorStorage<T, N>
+{
+    typedef T Element;
+
+    vector()
+    {
+        for (int i = 0; i < N; ++i)
+            (*this)[i] = T();
+    }
+
+    // Constructs a vector from any mix of scalars and vectors, in the
+    // same way as an HLSL constructor like `float4(v.xy, 0, 1)`. A
+    // single scalar is broadcast to all of the elements.
+    template<typename... Args>
+    vector(Args const&... args)
+    {
+        int count = 0;
+        int dummy[] = { 0, (append(count, args), 0)... };
+        (void) dummy;
+
+        if (count == 1)
+        {
+            for (int i = 1; i < N; ++i)
+                (*this)[i] = (*this)[0];
+        }
+        else
+        {
+            for (int i = count; i < N; ++i)
+                (*this)[i] = T();
+        }
+    }
+
+    T& operator[](int index) { return (&this->x)[index]; }
+    T const& operator[](int index) const { return (&this->x)[index]; }
+
+private:
+    template<typename U>
+    void append(int& count, U const& value)
+    {
+        if (count < N)
+            (*this)[count++] = T(value);
+    }
+
+    template<typename U, int M>
+    void append(int& count, vector<U, M> const& value)
+    {
+        for (int i = 0; i < M && count < N; ++i)
+            (*this)[count++] = T(value[i]);
+    }
+};
+
+typedef vector<float, 2> float2;
+typedef vector<float, 3> float3;
+typedef vector<float, 4> float4;
+typedef vector<int, 2> int2;
+typedef vector<int, 3> int3;
+typedef vector<int, 4> int4;
+typedef vector<uint, 2> uint2;
+typedef vector<uint, 3> uint3;
+typedef vector<uint, 4> uint4;
+
+#define SLANG_CPP_VECTOR_BINARY_OP(OP, RESULT)                                              \
+    template<typename T, int N>                                                             \
+    vector<RESULT, N> operator OP(vector<T, N> const& a, vector<T, N> const& b)             \
+    {                                                                                       \
+        vector<RESULT, N> r;                                                                \
+        for (int i = 0; i < N; ++i) r[i] = a[i] OP b[i];                                    \
+        return r;                                                                           \
+    }                                                                                       \
+    template<typename T, int N>                                                             \
+    vector<RESULT, N> operator OP(vector<T, N> const& a, typename Identity<T>::Type b)      \
+    {                                                                                       \
+        vector<RESULT, N> r;                                                                \
+        for (int i = 0; i < N; ++i) r[i] = a[i] OP b;                                       \
+        return r;                                                                           \
+    }                                                                                       \
+    template<typename T, int N>                                                             \
+    vector<RESULT, N> operator OP(typename Identity<T>::Type a, vector<T, N> const& b)      \
+    {                                                                                       \
+        vector<RESULT, N> r;                                                                \
+        for (int i = 0; i < N; ++i) r[i] = a OP b[i];                                       \
+        return r;                                                                           \
+    }
+
+SLANG_CPP_VECTOR_BINARY_OP(+, T)
+SLANG_CPP_VECTOR_BINARY_OP(-, T)
+SLANG_CPP_VECTOR_BINARY_OP(*, T)
+SLANG_CPP_VECTOR_BINARY_OP(/, T)
+SLANG_CPP_VECTOR_BINARY_OP(%, T)
+SLANG_CPP_VECTOR_BINARY_OP(&, T)
+SLANG_CPP_VECTOR_BINARY_OP(|, T)
+SLANG_CPP_VECTOR_BINARY_OP(^, T)
+SLANG_CPP_VECTOR_BINARY_OP(<<, T)
+SLANG_CPP_VECTOR_BINARY_OP(>>, T)
+SLANG_CPP_VECTOR_BINARY_OP(<, bool)
+SLANG_CPP_VECTOR_BINARY_OP(>, bool)
+SLANG_CPP_VECTOR_BINARY_OP(<=, bool)
+SLANG_CPP_VECTOR_BINARY_OP(>=, bool)
+SLANG_CPP_VECTOR_BINARY_OP(==, bool)
+SLANG_CPP_VECTOR_BINARY_OP(!=, bool)
+SLANG_CPP_VECTOR_BINARY_OP(&&, bool)
+SLANG_CPP_VECTOR_BINARY_OP(||, bool)
+
+#undef SLANG_CPP_VECTOR_BINARY_OP
+
+#define SLANG_CPP_VECTOR_UNARY_OP(OP, RESULT)                                               \
+    template<typename T, int N>                                                             \
+    vector<RESULT, N> operator OP(vector<T, N> const& a)                                    \
+    {                                                                                       \
+        vector<RESULT, N> r;                                                                \
+        for (int i = 0; i < N; ++i) r[i] = OP a[i];                                         \
+        return r;                                                                           \
+    }
+
+SLANG_CPP_VECTOR_UNARY_OP(-, T)
+SLANG_CPP_VECTOR_UNARY_OP(~, T)
+SLANG_CPP_VECTOR_UNARY_OP(!, bool)
+
+#undef SLANG_CPP_VECTOR_UNARY_OP
+
+// Multi-component swizzles (`v.zyx`, and `v.xy = ...` on the left of
+// an assignment) are emitted as calls to these.
+
+template<int... Indices, typename T, int N>
+vector<T, sizeof...(Indices)> slang_swizzle(vector<T, N> const& v)
+{
+    return vector<T, sizeof...(Indices)>(v[Indices]...);
+}
+
+template<int... Indices, typename T, int N, int M>
+void slang_swizzle_store(vector<T, N>& dest, vector<T, M> const& value)
+{
+    int const indices[] = { Indices... };
+    for (int i = 0; i < M; ++i)
+        dest[indices[i]] = value[i];
+}
+
+// Matrices (stored as an array of rows)
+
+template<typename T, int R, int C>
+struct matrix
+{
+    vector<T, C> rows[R];
+
+    matrix() {}
+
+    // Constructs a matrix from its elements in row-major order, or
+    // from its rows, like the HLSL constructors.
+    template<typename... Args>
+    matrix(Args const&... args)
+    {
+        vector<T, R * C> elements(args...);
+        for (int r = 0; r < R; ++r)
+            for (int c = 0; c < C; ++c)
+                rows[r][c] = elements[r * C + c];
+    }
+
+    vector<T, C>& operator[](int index) { return rows[index]; }
+    vector<T, C> const& operator[](int index) const { return rows[index]; }
+};
+
+// Scalar functions
+
+#define SLANG_CPP_FLOAT_FUNC(NAME, FLOAT_IMPL, DOUBLE_IMPL)                                 \
+    inline float NAME(float x) { return FLOAT_IMPL(x); }                                    \
+    inline double NAME(double x) { return DOUBLE_IMPL(x); }
+
+SLANG_CPP_FLOAT_FUNC(sqrt, ::sqrtf, ::sqrt)
+SLANG_CPP_FLOAT_FUNC(floor, ::floorf, ::floor)
+SLANG_CPP_FLOAT_FUNC(ceil, ::ceilf, ::ceil)
+SLANG_CPP_FLOAT_FUNC(round, ::roundf, ::round)
+SLANG_CPP_FLOAT_FUNC(trunc, ::truncf, ::trunc)
+SLANG_CPP_FLOAT_FUNC(exp, ::expf, ::exp)
+SLANG_CPP_FLOAT_FUNC(exp2, ::exp2f, ::exp2)
+SLANG_CPP_FLOAT_FUNC(log, ::logf, ::log)
+SLANG_CPP_FLOAT_FUNC(log2, ::log2f, ::log2)
+SLANG_CPP_FLOAT_FUNC(log10, ::log10f, ::log10)
+SLANG_CPP_FLOAT_FUNC(sin, ::sinf, ::sin)
+SLANG_CPP_FLOAT_FUNC(cos, ::cosf, ::cos)
+SLANG_CPP_FLOAT_FUNC(tan, ::tanf, ::tan)
+SLANG_CPP_FLOAT_FUNC(asin, ::asinf, ::asin)
+SLANG_CPP_FLOAT_FUNC(acos, ::acosf, ::acos)
+SLANG_CPP_FLOAT_FUNC(atan, ::atanf, ::atan)
+SLANG_CPP_FLOAT_FUNC(sinh, ::sinhf, ::sinh)
+SLANG_CPP_FLOAT_FUNC(cosh, ::coshf, ::cosh)
+SLANG_CPP_FLOAT_FUNC(tanh, ::tanhf, ::tanh)
+
+#undef SLANG_CPP_FLOAT_FUNC
+
+inline float abs(float x) { return ::fabsf(x); }
+inline double abs(double x) { return ::fabs(x); }
+inline int abs(int x) { return x < 0 ? -x : x; }
+
+inline float rsqrt(float x) { return 1.0f / ::sqrtf(x); }
+inline double rsqrt(double x) { return 1.0 / ::sqrt(x); }
+
+inline float frac(float x) { return x - ::floorf(x); }
+inline double frac(double x) { return x - ::floor(x); }
+
+inline float pow(float x, float y) { return ::powf(x, y); }
+inline double pow(double x, double y) { return ::pow(x, y); }
+
+inline float fmod(float x, float y) { return ::fmodf(x, y); }
+inline double fmod(double x, double y) { return ::fmod(x, y); }
+
+inline float atan2(float y, float x) { return ::atan2f(y, x); }
+inline double atan2(double y, double x) { return ::atan2(y, x); }
+
+template<typename T> T min(T a, T b) { return b < a ? b : a; }
+template<typename T> T max(T a, T b) { return a < b ? b : a; }
+template<typename T> T clamp(T x, T lo, T hi) { return min(max(x, lo), hi); }
+template<typename T> T saturate(T x) { return clamp(x, T(0), T(1)); }
+template<typename T> T lerp(T a, T b, T t) { return a + (b - a) * t; }
+template<typename T> T step(T edge, T x) { return x < edge ? T(0) : T(1); }
+template<typename T> T sign(T x) { return T((T(0) < x) - (x < T(0))); }
+template<typename T> T mad(T a, T b, T c) { return a * b + c; }
+
+template<typename T>
+T smoothstep(T lo, T hi, T x)
+{
+    T t = saturate((x - lo) / (hi - lo));
+    return t * t * (T(3) - T(2) * t);
+}
+
+inline float asfloat(uint x) { float r; memcpy(&r, &x, sizeof(r)); return r; }
+inline float asfloat(int x) { float r; memcpy(&r, &x, sizeof(r)); return r; }
+inline uint asuint(float x) { uint r; memcpy(&r, &x, sizeof(r)); return r; }
+inline int asint(float x) { int r; memcpy(&r, &x, sizeof(r)); return r; }
+
+inline bool any(bool x) { return x; }
+inline bool all(bool x) { return x; }
+
+// Vector versions of the above, applied element by element
+
+#define SLANG_CPP_VECTOR_FUNC_1(NAME)                                                       \
+    template<typename T, int N>                                                             \
+    vector<T, N> NAME(vector<T, N> const& x)                                                \
+    {                                                                                       \
+        vector<T, N> r;                                                                     \
+        for (int i = 0; i < N; ++i) r[i] = NAME(x[i]);                                      \
+        return r;                                                                           \
+    }
+
+#define SLANG_CPP_VECTOR_FUNC_2(NAME)                                                       \
+    template<typename T, int N>                                                             \
+    vector<T, N> NAME(vector<T, N> const& x, vector<T, N> const& y)                         \
+    {                                                                                       \
+        vector<T, N> r;                                                                     \
+        for (int i = 0; i < N; ++i) r[i] = NAME(x[i], y[i]);                                \
+        return r;                                                                           \
+    }
+
+#define SLANG_CPP_VECTOR_FUNC_3(NAME)                                                       \
+    template<typename T, int N>                                                             \
+    vector<T, N> NAME(vector<T, N> const& x, vector<T, N> const& y, vector<T, N> const& z)  \
+    {                                                                                       \
+        vector<T, N> r;                                                                     \
+        for (int i = 0; i < N; ++i) r[i] = NAME(x[i], y[i], z[i]);                          \
+        return r;                                                                           \
+    }
+
+SLANG_CPP_VECTOR_FUNC_1(sqrt)
+SLANG_CPP_VECTOR_FUNC_1(rsqrt)
+SLANG_CPP_VECTOR_FUNC_1(abs)
+SLANG_CPP_VECTOR_FUNC_1(floor)
+SLANG_CPP_VECTOR_FUNC_1(ceil)
+SLANG_CPP_VECTOR_FUNC_1(round)
+SLANG_CPP_VECTOR_FUNC_1(trunc)
+SLANG_CPP_VECTOR_FUNC_1(frac)
+SLANG_CPP_VECTOR_FUNC_1(exp)
+SLANG_CPP_VECTOR_FUNC_1(exp2)
+SLANG_CPP_VECTOR_FUNC_1(log)
+SLANG_CPP_VECTOR_FUNC_1(log2)
+SLANG_CPP_VECTOR_FUNC_1(log10)
+SLANG_CPP_VECTOR_FUNC_1(sin)
+SLANG_CPP_VECTOR_FUNC_1(cos)
+SLANG_CPP_VECTOR_FUNC_1(tan)
+SLANG_CPP_VECTOR_FUNC_1(asin)
+SLANG_CPP_VECTOR_FUNC_1(acos)
+SLANG_CPP_VECTOR_FUNC_1(atan)
+SLANG_CPP_VECTOR_FUNC_1(sinh)
+SLANG_CPP_VECTOR_FUNC_1(cosh)
+SLANG_CPP_VECTOR_FUNC_1(tanh)
+SLANG_CPP_VECTOR_FUNC_1(saturate)
+SLANG_CPP_VECTOR_FUNC_1(sign)
+SLANG_CPP_VECTOR_FUNC_2(pow)
+SLANG_CPP_VECTOR_FUNC_2(fmod)
+SLANG_CPP_VECTOR_FUNC_2(atan2)
+SLANG_CPP_VECTOR_FUNC_2(min)
+SLANG_CPP_VECTOR_FUNC_2(max)
+SLANG_CPP_VECTOR_FUNC_2(step)
+SLANG_CPP_VECTOR_FUNC_3(clamp)
+SLANG_CPP_VECTOR_FUNC_3(lerp)
+SLANG_CPP_VECTOR_FUNC_3(mad)
+SLANG_CPP_VECTOR_FUNC_3(smoothstep)
+
+#undef SLANG_CPP_VECTOR_FUNC_1
+#undef SLANG_CPP_VECTOR_FUNC_2
+#undef SLANG_CPP_VECTOR_FUNC_3
+
+template<typename T, int N>
+T dot(vector<T, N> const& a, vector<T, N> const& b)
+{
+    T r = T(0);
+    for (int i = 0; i < N; ++i) r += a[i] * b[i];
+    return r;
+}
+
+template<typename T>
+vector<T, 3> cross(vector<T, 3> const& a, vector<T, 3> const& b)
+{
+    return vector<T, 3>(
+        a.y * b.z - a.z * b.y,
+        a.z * b.x - a.x * b.z,
+        a.x * b.y - a.y * b.x);
+}
+
+template<typename T, int N>
+T length(vector<T, N> const& v) { return sqrt(dot(v, v)); }
+
+template<typename T, int N>
+T distance(vector<T, N> const& a, vector<T, N> const& b) { return length(a - b); }
+
+template<typename T, int N>
+vector<T, N> normalize(vector<T, N> const& v) { return v * rsqrt(dot(v, v)); }
+
+template<typename T, int N>
+bool any(vector<T, N> const& v)
+{
+    for (int i = 0; i < N; ++i) if (v[i]) return true;
+    return false;
+}
+
+template<typename T, int N>
+bool all(vector<T, N> const& v)
+{
+    for (int i = 0; i < N; ++i) if (!v[i]) return false;
+    return true;
+}
+
+// `mul`, with the HLSL convention that a vector on the left is a row
+// vector and a vector on the right is a column vector.
+
+template<typename T, int R, int N, int C>
+matrix<T, R, C> mul(matrix<T, R, N> const& a, matrix<T, N, C> const& b)
+{
+    matrix<T, R, C> r;
+    for (int i = 0; i < R; ++i)
+        for (int j = 0; j < C; ++j)
+        {
+            T sum = T(0);
+            for (int k = 0; k < N; ++k) sum += a[i][k] * b[k][j];
+            r[i][j] = sum;
+        }
+    return r;
+}
+
+template<typename T, int R, int C>
+vector<T, R> mul(matrix<T, R, C> const& m, vector<T, C> const& v)
+{
+    vector<T, R> r;
+    for (int i = 0; i < R; ++i) r[i] = dot(m[i], v);
+    return r;
+}
+
+template<typename T, int R, int C>
+vector<T, C> mul(vector<T, R> const& v, matrix<T, R, C> const& m)
+{
+    vector<T, C> r;
+    for (int j = 0; j < C; ++j)
+    {
+        T sum = T(0);
+        for (int i = 0; i < R; ++i) sum += v[i] * m[i][j];
+        r[j] = sum;
+    }
+    return r;
+}
+
+// Resources
+
+template<typename T>
+struct StructuredBuffer
+{
+    T const*    data;
+    size_t      count;
+
+    T const& operator[](size_t index) const { return data[index]; }
+    void GetDimensions(uint& outCount, uint& outStride) const
+    {
+        outCount = uint(count);
+        outStride = uint(sizeof(T));
+    }
+};
+
+template<typename T>
+struct RWStructuredBuffer
+{
+    T*          data;
+    size_t      count;
+
+    T& operator[](size_t index) const { return data[index]; }
+    void GetDimensions(uint& outCount, uint& outStride) const
+    {
+        outCount = uint(count);
+        outStride = uint(sizeof(T));
+    }
+};
+
+// Barriers. The compiler reports calls to these as errors (see the note on
+// limitations at the top of this file); they are only here to keep the
+// declarations of the intrinsics complete.
+
+inline void GroupMemoryBarrier() {}
+inline void GroupMemoryBarrierWithGroupSync() {}
+inline void DeviceMemoryBarrier() {}
+inline void DeviceMemoryBarrierWithGroupSync() {}
+inline void AllMemoryBarrier() {}
+inline void AllMemoryBarrierWithGroupSync() {}
+
+} // namespace SlangCPP
+
+#endif
@@ -0,0 +1,393 @@
+#ifndef SLANG_FLAT_REFLECTION_H
+#define SLANG_FLAT_REFLECTION_H
+
+/** \file slang-flat-reflection.h
+
+A header-only reader for "flat" reflection data, as produced by `spGetFlatReflectionBlob`, or by
+`slangc` when given an output path ending in `.slang-reflection`.
+
+Flat reflection holds what the reflection API reports about a program's layout for one target
+(parameters, bindings and spaces, uniform offsets and sizes, entry point parameters and varyings,
+and the tree of types and type layouts) in a single block of memory. All references inside it are
+byte offsets relative to where the reference is stored, so the block can be used in place wherever
+it is loaded or memory mapped (at any 4 byte aligned address), and reading it doesn't need the Slang
+compiler.
+
+The types in `slang::flat` mirror the `slang::*Reflection` types of the reflection API, and are
+used the same way:
+
+\code
+slang::flat::ShaderReflection const* reflection = slang::flat::ShaderReflection::get(data, size);
+if (!reflection) { ... not a valid blob ... }
+
+for (unsigned pp = 0; pp < reflection->getParameterCount(); ++pp)
+{
+    slang::flat::VariableLayoutReflection const* parameter = reflection->getParameterByIndex(pp);
+    ...
+}
+\endcode
+
+Queries that need the compiler (such as looking up a type by name, or laying out a type that isn't
+used by the program) aren't available.
+
+`ShaderReflection::get` checks the header of the blob, but the rest of the contents are trusted,
+so blobs should only be read from trusted sources.
+*/
+
+#include "slang.h"
+
+#include <string.h>
+
+namespace slang {
+namespace flat {
+
+enum
+{
+    kVersion = 1,                   ///< Changed whenever the format changes
+};
+
+/// The magic at the start of a blob
+static const char kMagic[8] = { 's', 'l', 'a', 'n', 'g', 'r', 'f', 'l' };
+
+/// A reference to something in the blob, stored as the byte offset from the reference to it. 0 is null.
+template<typename T>
+struct Ptr
+{
+    T const* get() const { return offset ? (T const*)((char const*)this + offset) : nullptr; }
+
+    operator T const*() const { return get(); }
+    T const* operator->() const { return get(); }
+
+    int32_t offset;
+};
+
+/// A count followed by a reference to that many contiguous items
+template<typename T>
+struct Array
+{
+    T const& operator[](uint32_t index) const { return items.get()[index]; }
+
+    uint32_t count;
+    Ptr<T> items;
+};
+
+/// A value that applies to one parameter category, such as the size a type takes up in it
+struct CategoryValue
+{
+    uint32_t category;                  ///< SlangParameterCategory
+    uint32_t value;
+};
+
+/// Where a variable is bound for one parameter category
+struct Binding
+{
+    uint32_t category;                  ///< SlangParameterCategory
+    uint32_t offset;                    ///< The index (or byte offset for uniforms)
+    uint32_t space;                     ///< The register space/descriptor set
+};
+
+// Find the value for category, or 0 if there isn't one
+inline uint32_t findCategoryValue(Array<CategoryValue> const& values, SlangParameterCategory category)
+{
+    for (uint32_t ii = 0; ii < values.count; ++ii)
+    {
+        if (values[ii].category == uint32_t(category))
+            return values[ii].value;
+    }
+    return 0;
+}
+
+inline bool isNameEqual(Ptr<char> const& name, char const* text)
+{
+    return name.get() && strcmp(name.get(), text) == 0;
+}
+
+struct TypeLayoutReflection;
+struct TypeReflection;
+struct VariableLayoutReflection;
+struct VariableReflection;
+
+struct TypeReflection
+{
+    slang::TypeReflection::Kind getKind() const { return slang::TypeReflection::Kind(kind); }
+
+    // only useful if `getKind() == Kind::Struct`
+    unsigned int getFieldCount() const { return fields.count; }
+    VariableReflection const* getFieldByIndex(unsigned int index) const { return fields[index]; }
+
+    bool isArray() const { return getKind() == slang::TypeReflection::Kind::Array; }
+
+    // only useful if `getKind() == Kind::Array`
+    size_t getElementCount() const { return elementCount; }
+    TypeReflection const* getElementType() const { return elementType; }
+
+    unsigned getRowCount() const { return rowCount; }
+    unsigned getColumnCount() const { return columnCount; }
+    slang::TypeReflection::ScalarType getScalarType() const { return slang::TypeReflection::ScalarType(scalarType); }
+
+    TypeReflection const* getResourceResultType() const { return resourceResultType; }
+    SlangResourceShape getResourceShape() const { return SlangResourceShape(resourceShape); }
+    SlangResourceAccess getResourceAccess() const { return SlangResourceAccess(resourceAccess); }
+
+    char const* getName() const { return name; }
+
+    uint32_t kind;                      ///< SlangTypeKind
+    uint32_t scalarType;                ///< SlangScalarType
+    uint32_t elementCount;
+    uint32_t rowCount;
+    uint32_t columnCount;
+    uint32_t resourceShape;             ///< SlangResourceShape
+    uint32_t resourceAccess;            ///< SlangResourceAccess
+    Ptr<char> name;
+    Ptr<TypeReflection> elementType;
+    Ptr<TypeReflection> resourceResultType;
+    Array<Ptr<VariableReflection>> fields;
+};
+
+struct VariableReflection
+{
+    char const* getName() const { return name; }
+    TypeReflection const* getType() const { return type; }
+    bool hasModifier(slang::Modifier::ID id) const { return (modifiers & (1u << id)) != 0; }
+
+    Ptr<char> name;
+    Ptr<TypeReflection> type;
+    uint32_t modifiers;                 ///< Bit (1 << SlangModifierID) is set for each modifier
+};
+
+struct TypeLayoutReflection
+{
+    TypeReflection const* getType() const { return type; }
+    slang::TypeReflection::Kind getKind() const { return type ? type->getKind() : slang::TypeReflection::Kind::None; }
+
+    size_t getSize(SlangParameterCategory category = SLANG_PARAMETER_CATEGORY_UNIFORM) const { return findCategoryValue(sizes, category); }
+
+    unsigned int getFieldCount() const { return fields.count; }
+    VariableLayoutReflection const* getFieldByIndex(unsigned int index) const { return fields[index]; }
+    SlangInt findFieldIndexByName(char const* name) const;
+
+    bool isArray() const { return type && type->isArray(); }
+
+    // only useful if `getKind() == Kind::Array`
+    size_t getElementCount() const { return type ? type->getElementCount() : 0; }
+    size_t getElementStride(SlangParameterCategory category) const { return findCategoryValue(elementStrides, category); }
+    TypeLayoutReflection const* getElementTypeLayout() const { return elementTypeLayout; }
+    VariableLayoutReflection const* getElementVarLayout() const { return elementVarLayout; }
+
+    // How is this type supposed to be bound?
+    slang::ParameterCategory getParameterCategory() const
+    {
+        switch (categories.count)
+        {
+            case 0:     return slang::ParameterCategory::None;
+            case 1:     return slang::ParameterCategory(categories[0]);
+            default:    return slang::ParameterCategory::Mixed;
+        }
+    }
+    unsigned int getCategoryCount() const { return categories.count; }
+    slang::ParameterCategory getCategoryByIndex(unsigned int index) const { return slang::ParameterCategory(categories[index]); }
+
+    unsigned getRowCount() const { return type ? type->getRowCount() : 0; }
+    unsigned getColumnCount() const { return type ? type->getColumnCount() : 0; }
+    slang::TypeReflection::ScalarType getScalarType() const { return type ? type->getScalarType() : slang::TypeReflection::None; }
+    TypeReflection const* getResourceResultType() const { return type ? type->getResourceResultType() : nullptr; }
+    SlangResourceShape getResourceShape() const { return type ? type->getResourceShape() : SlangResourceShape(SLANG_RESOURCE_NONE); }
+    SlangResourceAccess getResourceAccess() const { return type ? type->getResourceAccess() : SlangResourceAccess(SLANG_RESOURCE_ACCESS_NONE); }
+    char const* getName() const { return type ? type->getName() : nullptr; }
+
+    SlangMatrixLayoutMode getMatrixLayoutMode() const { return SlangMatrixLayoutMode(matrixLayoutMode); }
+    int getGenericParamIndex() const { return genericParamIndex; }
+
+    Ptr<TypeReflection> type;
+    uint32_t matrixLayoutMode;          ///< SlangMatrixLayoutMode
+    int32_t genericParamIndex;
+    Array<uint32_t> categories;         ///< The SlangParameterCategory of each category, in order
+    Array<CategoryValue> sizes;         ///< The size for each category with a non zero size
+    Array<CategoryValue> elementStrides;    ///< The element stride for each category with a non zero stride
+    Array<Ptr<VariableLayoutReflection>> fields;
+    Ptr<TypeLayoutReflection> elementTypeLayout;
+    Ptr<VariableLayoutReflection> elementVarLayout;
+};
+
+struct VariableLayoutReflection
+{
+    VariableReflection const* getVariable() const { return variable; }
+    char const* getName() const { return variable ? variable->getName() : nullptr; }
+    bool hasModifier(slang::Modifier::ID id) const { return variable && variable->hasModifier(id); }
+
+    TypeLayoutReflection const* getTypeLayout() const { return typeLayout; }
+    TypeReflection const* getType() const { return variable ? variable->getType() : nullptr; }
+
+    slang::ParameterCategory getCategory() const { return getTypeLayout()->getParameterCategory(); }
+    unsigned int getCategoryCount() const { return getTypeLayout()->getCategoryCount(); }
+    slang::ParameterCategory getCategoryByIndex(unsigned int index) const { return getTypeLayout()->getCategoryByIndex(index); }
+
+    size_t getOffset(SlangParameterCategory category = SLANG_PARAMETER_CATEGORY_UNIFORM) const
+    {
+        Binding const* binding = findBinding(category);
+        return binding ? binding->offset : 0;
+    }
+    size_t getBindingSpace(SlangParameterCategory category) const
+    {
+        Binding const* binding = findBinding(category);
+        return binding ? binding->space : 0;
+    }
+    unsigned getBindingIndex() const { return unsigned(getOffset(getCategory())); }
+    unsigned getBindingSpace() const { return unsigned(getBindingSpace(getCategory())); }
+
+    char const* getSemanticName() const { return semanticName; }
+    size_t getSemanticIndex() const { return semanticIndex; }
+
+    SlangStage getStage() const { return SlangStage(stage); }
+
+        /// Find the binding for category, or null if the variable has no offset or space for it
+    Binding const* findBinding(SlangParameterCategory category) const
+    {
+        for (uint32_t ii = 0; ii < bindings.count; ++ii)
+        {
+            if (bindings[ii].category == uint32_t(category))
+                return &bindings[ii];
+        }
+        return nullptr;
+    }
+
+    Ptr<VariableReflection> variable;
+    Ptr<TypeLayoutReflection> typeLayout;
+    Ptr<char> semanticName;
+    uint32_t semanticIndex;
+    uint32_t stage;                     ///< SlangStage
+    Array<Binding> bindings;            ///< Every category with a non zero offset or space, and all of the type layout's categories
+};
+
+inline SlangInt TypeLayoutReflection::findFieldIndexByName(char const* name) const
+{
+    for (uint32_t ii = 0; ii < fields.count; ++ii)
+    {
+        if (VariableReflection const* variable = fields[ii]->getVariable())
+        {
+            if (isNameEqual(variable->name, name))
+                return SlangInt(ii);
+        }
+    }
+    return -1;
+}
+
+struct TypeParameterReflection
+{
+    char const* getName() const { return name; }
+    unsigned getIndex() const { return index; }
+    unsigned getConstraintCount() const { return constraints.count; }
+    TypeReflection const* getConstraintByIndex(unsigned index) const { return constraints[index]; }
+
+    Ptr<char> name;
+    uint32_t index;
+    Array<Ptr<TypeReflection>> constraints;
+};
+
+struct EntryPointReflection
+{
+    char const* getName() const { return name; }
+
+    unsigned getParameterCount() const { return parameters.count; }
+    VariableLayoutReflection const* getParameterByIndex(unsigned index) const { return parameters[index]; }
+    VariableLayoutReflection const* findParameterByName(char const* name) const
+    {
+        for (uint32_t ii = 0; ii < parameters.count; ++ii)
+        {
+            VariableLayoutReflection const* parameter = parameters[ii];
+            if (parameter->variable && isNameEqual(parameter->variable->name, name))
+                return parameter;
+        }
+        return nullptr;
+    }
+
+    SlangStage getStage() const { return SlangStage(stage); }
+
+    void getComputeThreadGroupSize(SlangUInt axisCount, SlangUInt* outSizeAlongAxis) const
+    {
+        for (SlangUInt ii = 0; ii < axisCount; ++ii)
+        {
+            outSizeAlongAxis[ii] = (ii < 3) ? threadGroupSize[ii] : 1;
+        }
+    }
+
+    bool usesAnySampleRateInput() const { return usesSampleRateInput != 0; }
+
+    Ptr<char> name;
+    uint32_t stage;                     ///< SlangStage
+    uint32_t usesSampleRateInput;
+    uint32_t threadGroupSize[3];
+    Array<Ptr<VariableLayoutReflection>> parameters;
+};
+
+/// The start of a blob
+struct ShaderReflection
+{
+        /// Get the reflection held in the blob at data, or null if it isn't a valid blob of this version
+    static ShaderReflection const* get(void const* data, size_t size)
+    {
+        ShaderReflection const* reflection = (ShaderReflection const*)data;
+        if (!data || (size_t(data) & 3) || size < sizeof(ShaderReflection) ||
+            memcmp(reflection->magic, kMagic, sizeof(kMagic)) != 0 ||
+            reflection->version != kVersion ||
+            reflection->size > size)
+        {
+            return nullptr;
+        }
+        return reflection;
+    }
+
+    unsigned getParameterCount() const { return parameters.count; }
+    VariableLayoutReflection const* getParameterByIndex(unsigned index) const { return parameters[index]; }
+    VariableLayoutReflection const* findParameterByName(char const* name) const
+    {
+        for (uint32_t ii = 0; ii < parameters.count; ++ii)
+        {
+            VariableLayoutReflection const* parameter = parameters[ii];
+            if (parameter->variable && isNameEqual(parameter->variable->name, name))
+                return parameter;
+        }
+        return nullptr;
+    }
+
+    unsigned getTypeParameterCount() const { return typeParameters.count; }
+    TypeParameterReflection const* getTypeParameterByIndex(unsigned index) const { return typeParameters[index]; }
+    TypeParameterReflection const* findTypeParameter(char const* name) const
+    {
+        for (uint32_t ii = 0; ii < typeParameters.count; ++ii)
+        {
+            if (isNameEqual(typeParameters[ii]->name, name))
+                return typeParameters[ii];
+        }
+        return nullptr;
+    }
+
+    SlangUInt getEntryPointCount() const { return entryPoints.count; }
+    EntryPointReflection const* getEntryPointByIndex(SlangUInt index) const { return entryPoints[uint32_t(index)]; }
+    EntryPointReflection const* findEntryPointByName(char const* name) const
+    {
+        for (uint32_t ii = 0; ii < entryPoints.count; ++ii)
+        {
+            if (isNameEqual(entryPoints[ii]->name, name))
+                return entryPoints[ii];
+        }
+        return nullptr;
+    }
+
+    SlangUInt getGlobalConstantBufferBinding() const { return globalConstantBufferBinding; }
+    size_t getGlobalConstantBufferSize() const { return globalConstantBufferSize; }
+
+    char magic[8];                      ///< kMagic
+    uint32_t version;                   ///< kVersion
+    uint32_t size;                      ///< The size of the whole blob in bytes
+    uint32_t globalConstantBufferBinding;
+    uint32_t globalConstantBufferSize;
+    Array<Ptr<VariableLayoutReflection>> parameters;
+    Array<Ptr<EntryPointReflection>> entryPoints;
+    Array<Ptr<TypeParameterReflection>> typeParameters;
+};
+
+} // namespace flat
+} // namespace slang
+
+#endif // SLANG_FLAT_REFLECTION_H
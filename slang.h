@@ -396,6 +396,7 @@ extern "C"
         SLANG_DXBC_ASM,
         SLANG_DXIL,
         SLANG_DXIL_ASM,
+        SLANG_CPP_SOURCE,           //< C++ source for running compute kernels on the CPU
     };
 
     /* A "container format" describes the way that the outputs
@@ -845,6 +846,51 @@ extern "C"
     SLANG_API ISlangSharedLibraryLoader* spSessionGetSharedLibraryLoader(
         SlangSession*   session);
 
+    /*!
+    @brief Counters describing use of a session's file system cache, from `spSessionGetFileSystemCacheStats`.
+    */
+    typedef struct SlangFileSystemCacheStats
+    {
+        uint64_t bytesRead;             /**< Total bytes of files read from disk */
+        uint32_t loadFileHits;          /**< File loads answered from the cache */
+        uint32_t loadFileMisses;        /**< File loads that read from disk */
+        uint32_t pathTypeHits;
+        uint32_t pathTypeMisses;
+        uint32_t canonicalPathHits;
+        uint32_t canonicalPathMisses;
+        uint32_t revalidations;         /**< Cached entries checked against the file's modification time and size */
+        uint32_t invalidations;         /**< Cached entries discarded because the file changed, or through `spSessionInvalidateFileSystemCache` */
+    } SlangFileSystemCacheStats;
+
+    /*!
+    @brief Enable or disable a file system cache shared by compile requests of the session.
+
+    When enabled, requests created afterwards that use the default file system share loaded files, canonical 
+    paths and path types. At the start of each request, cached entries are checked against the modification 
+    time and size of the file on disk the next time they are used, and reloaded if they have changed.
+    Requests that have their own file system set with `spSetFileSystem` do not use the cache.
+    Disabled by default. Disabling it discards the cache.
+    */
+    SLANG_API void spSessionSetFileSystemCacheEnabled(
+        SlangSession*   session,
+        int             enable);
+
+    /*!
+    @brief Discard what the session file system cache holds for a file.
+    @param path The path of the file. If nullptr the whole cache is discarded.
+    */
+    SLANG_API void spSessionInvalidateFileSystemCache(
+        SlangSession*   session,
+        char const*     path);
+
+    /*!
+    @brief Get the counters of the session file system cache.
+    @return SLANG_E_UNINITIALIZED if the cache isn't enabled
+    */
+    SLANG_API SlangResult spSessionGetFileSystemCacheStats(
+        SlangSession*               session,
+        SlangFileSystemCacheStats*  outStats);
+
     /*!
     @brief Add new builtin declarations to be used in subsequent compiles.
     */
@@ -880,6 +926,30 @@ extern "C"
         SlangCompileRequest*    request,
         ISlangFileSystem*       fileSystem);
 
+    /** Write a packed, read-only archive containing all of the files in (and beneath) a directory.
+
+    Loading files from an archive (see `spLoadArchiveFileSystem`) avoids opening each file 
+    separately, which helps when there are many include or module files.
+
+    @param directoryPath The directory to archive. Paths in the archive are relative to it.
+    @param archivePath The path of the archive file to write
+    */
+    SLANG_API SlangResult spCreateArchiveFromDirectory(
+        char const*     directoryPath,
+        char const*     archivePath);
+
+    /** Load an archive written by `spCreateArchiveFromDirectory` as a file system.
+
+    The archive is mapped into memory, and paths are looked up relative to the archived directory.
+    The returned file system can be set on a compile request with `spSetFileSystem`.
+
+    @param archivePath The path of the archive file
+    @param outFileSystem Set to the file system. The caller is responsible for releasing it.
+    */
+    SLANG_API SlangResult spLoadArchiveFileSystem(
+        char const*             archivePath,
+        ISlangFileSystemExt**   outFileSystem);
+
 
     /*!
     @brief Set flags to be used for compilation.
@@ -1243,19 +1313,128 @@ extern "C"
     SLANG_API SlangVMThread* SlangVMThread_create(
         SlangVM*    vm);
 
+    /** Create a thread that runs `laneCount` invocations of a function in lockstep.
+
+    Each lane has its own copy of the registers of every call frame, so
+    that the lanes may pass different arguments and take different
+    paths through the code. Lanes that take different branches are run
+    separately until their paths merge again.
+
+    @param laneCount The number of lanes, between 1 and 64.
+    @returns The new thread, or null if `laneCount` is out of range.
+    */
+    SLANG_API SlangVMThread* SlangVMThread_createWithLanes(
+        SlangVM*    vm,
+        SlangUInt   laneCount);
+
     SLANG_API void SlangVMThread_beginCall(
         SlangVMThread*  thread,
         SlangVMFunc*    func);
 
+    /** Set an argument for the call begun with `SlangVMThread_beginCall`.
+
+    For a thread with multiple lanes, the same value is used for all lanes.
+    */
     SLANG_API void SlangVMThread_setArg(
         SlangVMThread*  thread,
         SlangUInt       argIndex,
         void const*     data,
         size_t          size);
 
+    /** Set an argument for a single lane of the call begun with `SlangVMThread_beginCall`.
+    */
+    SLANG_API void SlangVMThread_setLaneArg(
+        SlangVMThread*  thread,
+        SlangUInt       laneIndex,
+        SlangUInt       argIndex,
+        void const*     data,
+        size_t          size);
+
     SLANG_API void SlangVMThread_resume(
         SlangVMThread*  thread);
 
+    /** Describes a grid of thread groups to run with `SlangVM_dispatch`.
+    */
+    typedef struct SlangVMDispatchDesc
+    {
+        /** The number of thread groups along each axis */
+        SlangUInt   groupCount[3];
+
+        /** The number of threads in each group along each axis (the `numthreads` of the kernel) */
+        SlangUInt   groupSize[3];
+
+        /** The largest number of threads of a group to run in lockstep on one VM thread,
+        or zero to use as many as possible (up to 64). */
+        SlangUInt   laneCount;
+
+        /** The number of host threads to run groups on, or zero to use one per hardware thread. */
+        SlangUInt   workerCount;
+    } SlangVMDispatchDesc;
+
+    /** Run `func` for every thread of a grid of thread groups.
+
+    Thread groups are spread over a pool of worker threads, and each group
+    gets its own copy of the `groupshared` variables of the module. Group
+    barriers (e.g., `GroupMemoryBarrierWithGroupSync`) wait for all threads
+    of the group. Other global variables, such as buffers bound with
+    `SlangVMModule_findGlobalSymbolPtr`, are shared by all threads.
+
+    The parameters of `func` identify the thread, and are passed by position:
+
+    0. The index of the thread in the whole dispatch (`SV_DispatchThreadID`,
+       flattened with the X axis varying fastest)
+    1. The index of the thread in its group (`SV_GroupIndex`)
+    2. The index of the group (`SV_GroupID`, flattened)
+
+    A function may declare any prefix of these, as scalar 32-bit integers.
+
+    @returns `SLANG_E_INVALID_ARG` if `func` has no body, doesn't belong to
+    `module`, or has more than three parameters.
+    */
+    SLANG_API SlangResult SlangVM_dispatch(
+        SlangVMModule*              module,
+        SlangVMFunc*                func,
+        SlangVMDispatchDesc const*  desc);
+
+    /** Formats for a VM profile report, from `SlangVM_getProfileReport`.
+    */
+    typedef unsigned int SlangVMProfileFormat;
+    enum
+    {
+        SLANG_VM_PROFILE_FORMAT_TABLE = 0,  /**< Human-readable tables, sorted by cycles */
+        SLANG_VM_PROFILE_FORMAT_JSON,       /**< A JSON object with `ops`, `functions`, and `callSites` arrays */
+    };
+
+    /** Set whether VM threads created from now on are profiled.
+
+    A profiled thread counts the instructions it executes, and the
+    cycles spent on them, per opcode and per function. It also counts
+    calls and cycles (including callees) per call site. Profiling is
+    off by default, and adds no overhead to threads that aren't profiled.
+
+    Counters are added to the profile of the VM each time a call to
+    `SlangVMThread_resume` or `SlangVM_dispatch` finishes.
+    */
+    SLANG_API void SlangVM_setProfilingEnabled(
+        SlangVM*    vm,
+        int         enable);
+
+    /** Clear the profile counters of the VM.
+    */
+    SLANG_API void SlangVM_resetProfile(
+        SlangVM*    vm);
+
+    /** Get a report of the profile counters of the VM.
+
+    Cycles are CPU timestamp counter ticks where available, and nanoseconds otherwise.
+
+    @returns A null-terminated string, which stays valid until the next
+    call to this function for the same VM.
+    */
+    SLANG_API char const* SlangVM_getProfileReport(
+        SlangVM*                vm,
+        SlangVMProfileFormat    format);
+
     /* Note(tfoley): working on new reflection interface...
     */
 
@@ -1272,6 +1451,22 @@ extern "C"
     SLANG_API SlangReflection* spGetReflection(
         SlangCompileRequest*    request);
 
+    /** Get the reflection data for a target of a compilation request as a single "flat" blob.
+
+    The blob holds what the reflection API reports about the target's layout, and is read with the
+    header-only `slang-flat-reflection.h`, without needing the compiler. It can be saved and loaded
+    (or memory mapped) and used in place.
+
+    @param request The compile request, which must have been compiled successfully
+    @param targetIndex The index of the target to get reflection data for
+    @param outBlob Set to the blob
+    @return SLANG_OK on success, SLANG_FAIL if a size or binding doesn't fit in the 32 bits the format stores it in
+    */
+    SLANG_API SlangResult spGetFlatReflectionBlob(
+        SlangCompileRequest*    request,
+        int                     targetIndex,
+        ISlangBlob**            outBlob);
+
     // type reflection
 
     typedef unsigned int SlangTypeKind;
@@ -1426,6 +1621,7 @@ extern "C"
     SLANG_API size_t spReflectionTypeLayout_GetSize(SlangReflectionTypeLayout* type, SlangParameterCategory category);
 
     SLANG_API SlangReflectionVariableLayout* spReflectionTypeLayout_GetFieldByIndex(SlangReflectionTypeLayout* type, unsigned index);
+    SLANG_API SlangInt spReflectionTypeLayout_FindFieldIndexByName(SlangReflectionTypeLayout* type, char const* name);
 
     SLANG_API size_t spReflectionTypeLayout_GetElementStride(SlangReflectionTypeLayout* type, SlangParameterCategory category);
     SLANG_API SlangReflectionTypeLayout* spReflectionTypeLayout_GetElementTypeLayout(SlangReflectionTypeLayout* type);
@@ -1488,6 +1684,10 @@ extern "C"
         SlangReflectionEntryPoint*  entryPoint,
         unsigned                    index);
 
+    SLANG_API SlangReflectionVariableLayout* spReflectionEntryPoint_findParameterByName(
+        SlangReflectionEntryPoint*  entryPoint,
+        char const*                 name);
+
     SLANG_API SlangStage spReflectionEntryPoint_getStage(SlangReflectionEntryPoint* entryPoint);
 
     SLANG_API void spReflectionEntryPoint_getComputeThreadGroupSize(
@@ -1508,6 +1708,7 @@ extern "C"
 
     SLANG_API unsigned spReflection_GetParameterCount(SlangReflection* reflection);
     SLANG_API SlangReflectionParameter* spReflection_GetParameterByIndex(SlangReflection* reflection, unsigned index);
+    SLANG_API SlangReflectionParameter* spReflection_FindParameterByName(SlangReflection* reflection, char const* name);
 
     SLANG_API unsigned int spReflection_GetTypeParameterCount(SlangReflection* reflection);
     SLANG_API SlangReflectionTypeParameter* spReflection_GetTypeParameterByIndex(SlangReflection* reflection, unsigned int index);
@@ -1713,6 +1914,11 @@ namespace slang
             return (VariableLayoutReflection*) spReflectionTypeLayout_GetFieldByIndex((SlangReflectionTypeLayout*) this, index);
         }
 
+        SlangInt findFieldIndexByName(char const* name)
+        {
+            return spReflectionTypeLayout_FindFieldIndexByName((SlangReflectionTypeLayout*) this, name);
+        }
+
         bool isArray() { return getType()->isArray(); }
 
         TypeLayoutReflection* unwrapArray()
@@ -1936,6 +2142,11 @@ namespace slang
             return (VariableLayoutReflection*) spReflectionEntryPoint_getParameterByIndex((SlangReflectionEntryPoint*) this, index);
         }
 
+        VariableLayoutReflection* findParameterByName(char const* name)
+        {
+            return (VariableLayoutReflection*) spReflectionEntryPoint_findParameterByName((SlangReflectionEntryPoint*) this, name);
+        }
+
         SlangStage getStage()
         {
             return spReflectionEntryPoint_getStage((SlangReflectionEntryPoint*) this);
@@ -2006,6 +2217,11 @@ namespace slang
             return (VariableLayoutReflection*) spReflection_GetParameterByIndex((SlangReflection*) this, index);
         }
 
+        VariableLayoutReflection* findParameterByName(char const* name)
+        {
+            return (VariableLayoutReflection*) spReflection_FindParameterByName((SlangReflection*) this, name);
+        }
+
         static ShaderReflection* get(SlangCompileRequest* request)
         {
             return (ShaderReflection*) spGetReflection(request);
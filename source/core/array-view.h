@@ -33,7 +33,7 @@ namespace Slang
 		}
 		ArrayView(T * buffer, int count)
 		{
-			SetData(buffer, count, sizeof(T));
+			SetData((void*)buffer, count, sizeof(T));
 		}
 		ArrayView(void * buffer, int count, int _stride)
 		{
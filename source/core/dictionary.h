@@ -2,10 +2,26 @@
 #define CORE_LIB_DICTIONARY_H
 #include "list.h"
 #include "common.h"
-#include "int-set.h"
 #include "exception.h"
 #include "slang-math.h"
 #include "hash.h"
+#include "slang-cpu-defines.h"
+
+#include <new>
+#include <string.h>
+
+// Dictionary lookups test the control bytes of a group of slots at once. With SSE2 a group is
+// tested with a couple of instructions, otherwise a loop is used.
+#if SLANG_PROCESSOR_FAMILY_X86 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#	define SLANG_DICTIONARY_SIMD_SSE2 1
+#	include <emmintrin.h>
+#else
+#	define SLANG_DICTIONARY_SIMD_SSE2 0
+#endif
+
+#if SLANG_VC
+#	include <intrin.h>
+#endif
 
 namespace Slang
 {
@@ -65,152 +81,276 @@ namespace Slang
 		return KeyValuePair<TKey, TValue>(k, v);
 	}
 
-	const float MaxLoadFactor = 0.7f;
+	// The maximum proportion of slots that can be in use (including deleted slots) before a Dictionary grows.
+	// Past this, most groups are full, and a miss usually has to probe a second group.
+	const float MaxLoadFactor = 0.8f;
+
+	/* The control bytes of a group of Dictionary slots. Each slot has a control byte that is either
+	kCtrlEmpty, kCtrlDeleted or (if the slot holds a value) 7 bits of the slot's hash. A group of
+	control bytes can be tested in parallel, so most lookups only compare keys that almost certainly match. */
+	struct DictionaryGroup
+	{
+		static const int kSize = 16;
+
+		static const int8_t kCtrlEmpty = -128;
+		static const int8_t kCtrlDeleted = -2;
+
+			/// True if a control byte is for a slot that holds a value
+		static SLANG_FORCE_INLINE bool isFull(int8_t ctrl) { return ctrl >= 0; }
+
+			/// Returns the index of the lowest set bit. bits must be non zero.
+		static SLANG_FORCE_INLINE int getLowestBitIndex(uint32_t bits)
+		{
+#if SLANG_VC
+			unsigned long index;
+			_BitScanForward(&index, bits);
+			return int(index);
+#elif defined(__GNUC__) || defined(__clang__)
+			return __builtin_ctz(bits);
+#else
+			int index = 0;
+			while ((bits & 1) == 0)
+			{
+				bits >>= 1;
+				index++;
+			}
+			return index;
+#endif
+		}
+
+#if SLANG_DICTIONARY_SIMD_SSE2
+		explicit DictionaryGroup(const int8_t* ctrl) : m_ctrl(_mm_loadu_si128((const __m128i*)ctrl)) {}
+
+			/// Returns a bit per slot, set if the control byte is h2
+		SLANG_FORCE_INLINE uint32_t match(int8_t h2) const { return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(m_ctrl, _mm_set1_epi8(h2)))); }
+			/// Returns a bit per slot, set if the slot is empty
+		SLANG_FORCE_INLINE uint32_t matchEmpty() const { return match(kCtrlEmpty); }
+			/// Returns a bit per slot, set if the slot is empty or deleted (ie the control byte is negative)
+		SLANG_FORCE_INLINE uint32_t matchEmptyOrDeleted() const { return uint32_t(_mm_movemask_epi8(m_ctrl)); }
+
+		__m128i m_ctrl;
+#else
+		explicit DictionaryGroup(const int8_t* ctrl) : m_ctrl(ctrl) {}
+
+		SLANG_FORCE_INLINE uint32_t match(int8_t h2) const
+		{
+			uint32_t bits = 0;
+			for (int i = 0; i < kSize; ++i)
+				bits |= uint32_t(m_ctrl[i] == h2) << i;
+			return bits;
+		}
+		SLANG_FORCE_INLINE uint32_t matchEmpty() const { return match(kCtrlEmpty); }
+		SLANG_FORCE_INLINE uint32_t matchEmptyOrDeleted() const
+		{
+			uint32_t bits = 0;
+			for (int i = 0; i < kSize; ++i)
+				bits |= uint32_t(m_ctrl[i] < 0) << i;
+			return bits;
+		}
+
+		const int8_t* m_ctrl;
+#endif
+	};
+
+	/// Mix a hash code for use by Dictionary, as hash codes (for example of pointers) often only vary in some bits
+	SLANG_FORCE_INLINE uint32_t mixDictionaryHashCode(int hashCode)
+	{
+		const uint64_t h = uint64_t(uint32_t(hashCode)) * 0x9E3779B97F4A7C15ull;
+		return uint32_t(h >> 32) ^ uint32_t(h);
+	}
+
+	/* Storage for an entry of a Dictionary. If the key is a class type its hash is stored with it, so growing
+	doesn't have to recompute hashes, and keys are only compared if the hashes match. Hashes of scalar keys
+	(integers, enums and pointers) are cheap to recompute, so aren't stored, which keeps slots small. */
+	template<typename TKey, typename TValue, bool kCacheHash = !std::is_scalar<TKey>::value>
+	struct DictionarySlot
+	{
+		SLANG_FORCE_INLINE uint32_t getHash() const { return hash; }
+		SLANG_FORCE_INLINE void setHash(uint32_t inHash) { hash = inHash; }
+		SLANG_FORCE_INLINE bool mayHaveHash(uint32_t inHash) const { return hash == inHash; }
+
+		KeyValuePair<TKey, TValue> pair;
+		uint32_t hash;
+	};
 
 	template<typename TKey, typename TValue>
+	struct DictionarySlot<TKey, TValue, false>
+	{
+		SLANG_FORCE_INLINE uint32_t getHash() const { return mixDictionaryHashCode(GetHashCode((TKey&)pair.Key)); }
+		SLANG_FORCE_INLINE void setHash(uint32_t) {}
+		SLANG_FORCE_INLINE bool mayHaveHash(uint32_t) const { return true; }
+
+		KeyValuePair<TKey, TValue> pair;
+	};
+
+	/* An open addressing hash map.
+
+	Slots are split into groups of DictionaryGroup::kSize, and each slot has a control byte (stored
+	separately from the slots) holding part of its hash. Lookups probe a group at a time, comparing all
+	of its control bytes at once, and only compare keys for slots whose control byte matches.
+
+	Pointers to values remain valid until the Dictionary grows (which can only happen when adding).
+	Removing entries doesn't move other entries, so it is safe to Remove while iterating.
+
+	Storage is allocated through TAllocator, which must return memory with at least the alignment of the heap. */
+	template<typename TKey, typename TValue, typename TAllocator = StandardAllocator>
 	class Dictionary
 	{
 		friend class Iterator;
 		friend class ItemProxy;
 	private:
-		inline int GetProbeOffset(int /*probeId*/) const
-		{
-			// quadratic probing
-			return 1;
-		}
-	private:
-		int bucketSizeMinusOne, shiftBits;
-		int _count;
-		IntSet marks;
-		KeyValuePair<TKey, TValue>* hashMap;
-		void Free()
-		{
-			if (hashMap)
-				delete[] hashMap;
-			hashMap = 0;
-		}
-		inline bool IsDeleted(int pos) const
+		typedef DictionarySlot<TKey, TValue> Slot;
+
+		int8_t* m_ctrl = nullptr;		///< A control byte per slot. Groups are loaded unaligned, so this only has the alignment of TAllocator.
+		Slot* m_slots = nullptr;		///< Storage for the slots. Only slots with a 'full' control byte are constructed.
+		int m_capacity = 0;				///< Total number of slots (a power of 2 multiple of the group size, or 0)
+		int _count = 0;					///< Number of slots that hold values
+		int m_growthLeft = 0;			///< Number of empty slots that can be used before having to grow
+
+		static_assert(alignof(Slot) <= DictionaryGroup::kSize, "Slot alignment is not supported");
+
+		template<typename T>
+		static SLANG_FORCE_INLINE uint32_t _getHash(const T & key)
 		{
-			return marks.Contains((pos << 1) + 1);
+			return mixDictionaryHashCode(GetHashCode((T&)key));
 		}
-		inline bool IsEmpty(int pos) const
-		{
-			return !marks.Contains((pos << 1));
+		static SLANG_FORCE_INLINE int8_t _getH2(uint32_t hash) { return int8_t(hash & 0x7f); }
+		static SLANG_FORCE_INLINE int _getMaxCount(int capacity) { return int(capacity * MaxLoadFactor); }
+
+		template<typename T>
+		int _find(const T & key, uint32_t hash) const
+		{
+			if (m_capacity == 0)
+				return -1;
+			const int groupMask = (m_capacity / DictionaryGroup::kSize) - 1;
+			const int8_t h2 = _getH2(hash);
+			int groupIndex = int(hash >> 7) & groupMask;
+			// Triangular probing visits every group, as the group count is a power of 2
+			for (int probe = 1; probe <= groupMask + 1; ++probe)
+			{
+				const int base = groupIndex * DictionaryGroup::kSize;
+				const DictionaryGroup group(m_ctrl + base);
+				for (uint32_t bits = group.match(h2); bits; bits &= bits - 1)
+				{
+					const int pos = base + DictionaryGroup::getLowestBitIndex(bits);
+					// Non-const, as some key types only have a non-const operator==
+					Slot& slot = m_slots[pos];
+					if (slot.mayHaveHash(hash) && slot.pair.Key == key)
+						return pos;
+				}
+				// If there is an empty slot, the key would have been inserted here (or before)
+				if (group.matchEmpty())
+					return -1;
+				groupIndex = (groupIndex + probe) & groupMask;
+			}
+			return -1;
 		}
-		inline void SetDeleted(int pos, bool val)
+		int _findInsertPosition(uint32_t hash) const
 		{
-			if (val)
-				marks.Add((pos << 1) + 1);
-			else
-				marks.Remove((pos << 1) + 1);
+			const int groupMask = (m_capacity / DictionaryGroup::kSize) - 1;
+			int groupIndex = int(hash >> 7) & groupMask;
+			for (int probe = 1; probe <= groupMask + 1; ++probe)
+			{
+				const int base = groupIndex * DictionaryGroup::kSize;
+				const uint32_t bits = DictionaryGroup(m_ctrl + base).matchEmptyOrDeleted();
+				if (bits)
+					return base + DictionaryGroup::getLowestBitIndex(bits);
+				groupIndex = (groupIndex + probe) & groupMask;
+			}
+			throw InvalidOperationException("Hash map is full. This is a bug in Dictionary implementation.");
 		}
-		inline void SetEmpty(int pos, bool val)
+		void _allocate(int capacity)
 		{
-			if (val)
-				marks.Remove((pos << 1));
-			else
-				marks.Add((pos << 1));
+			SLANG_ASSERT(capacity >= DictionaryGroup::kSize && (capacity & (capacity - 1)) == 0);
+			// Control bytes come first, and the slots follow at a multiple of the group size (so keep the allocation's alignment)
+			uint8_t* data = (uint8_t*)TAllocator().Alloc(size_t(capacity) * (1 + sizeof(Slot)));
+			m_ctrl = (int8_t*)data;
+			m_slots = (Slot*)(data + capacity);
+			m_capacity = capacity;
+			::memset(m_ctrl, uint8_t(DictionaryGroup::kCtrlEmpty), size_t(capacity));
+			m_growthLeft = _getMaxCount(capacity);
 		}
-		struct FindPositionResult
+		void _destroyAll()
 		{
-			int ObjectPosition;
-			int InsertionPosition;
-			FindPositionResult()
+			for (int i = 0; i < m_capacity; i++)
 			{
-				ObjectPosition = -1;
-				InsertionPosition = -1;
+				if (DictionaryGroup::isFull(m_ctrl[i]))
+					m_slots[i].~Slot();
 			}
-			FindPositionResult(int objPos, int insertPos)
+		}
+		void Free()
+		{
+			if (m_ctrl)
 			{
-				ObjectPosition = objPos;
-				InsertionPosition = insertPos;
+				_destroyAll();
+				TAllocator().Free(m_ctrl);
 			}
-
-		};
-		template<typename T>
-		inline int GetHashPos(T & key) const
-		{
-			return ((unsigned int)(GetHashCode(key) * 2654435761)) >> shiftBits;
+			m_ctrl = nullptr;
+			m_slots = nullptr;
+			m_capacity = 0;
+			m_growthLeft = 0;
+			_count = 0;
 		}
-		template<typename T>
-		FindPositionResult FindPosition(const T & key) const
+		void _resize(int newCapacity)
 		{
-			int hashPos = GetHashPos((T&)key);
-			int insertPos = -1;
-			int numProbes = 0;
-			while (numProbes <= bucketSizeMinusOne)
+			int8_t* oldCtrl = m_ctrl;
+			Slot* oldSlots = m_slots;
+			const int oldCapacity = m_capacity;
+
+			_allocate(newCapacity);
+			m_growthLeft -= _count;
+
+			// Move everything across. Keys are known to be unique, so just need to find a free slot.
+			for (int i = 0; i < oldCapacity; i++)
 			{
-				if (IsEmpty(hashPos))
-				{
-					if (insertPos == -1)
-						return FindPositionResult(-1, hashPos);
-					else
-						return FindPositionResult(-1, insertPos);
-				}
-				else if (IsDeleted(hashPos))
+				if (DictionaryGroup::isFull(oldCtrl[i]))
 				{
-					if (insertPos == -1)
-						insertPos = hashPos;
+					Slot& oldSlot = oldSlots[i];
+					const uint32_t hash = oldSlot.getHash();
+					const int pos = _findInsertPosition(hash);
+					m_ctrl[pos] = _getH2(hash);
+					new (&m_slots[pos]) Slot(_Move(oldSlot));
+					oldSlot.~Slot();
 				}
-				else if (hashMap[hashPos].Key == key)
-				{
-					return FindPositionResult(hashPos, -1);
-				}
-				numProbes++;
-				hashPos = (hashPos + GetProbeOffset(numProbes)) & bucketSizeMinusOne;
 			}
-			if (insertPos != -1)
-				return FindPositionResult(-1, insertPos);
-			throw InvalidOperationException("Hash map is full. This indicates an error in Key::Equal or Key::GetHashCode.");
+			if (oldCtrl)
+				TAllocator().Free(oldCtrl);
 		}
-		TValue & _Insert(KeyValuePair<TKey, TValue> && kvPair, int pos)
+		void _growForInsert()
 		{
-			hashMap[pos] = _Move(kvPair);
-			SetEmpty(pos, false);
-			SetDeleted(pos, false);
-			return hashMap[pos].Value;
+			// If a lot of the used slots are deleted, it is enough to rehash at the same size to remove them
+			const int newCapacity = (m_capacity == 0) ? DictionaryGroup::kSize :
+				((_count * 2 <= _getMaxCount(m_capacity)) ? m_capacity : m_capacity * 2);
+			_resize(newCapacity);
 		}
-		void Rehash()
+		TValue & _Insert(KeyValuePair<TKey, TValue> && kvPair, uint32_t hash)
 		{
-			if (bucketSizeMinusOne == -1 || _count / (float)bucketSizeMinusOne >= MaxLoadFactor)
+			if (m_capacity == 0)
+				_growForInsert();
+			int pos = _findInsertPosition(hash);
+			if (m_growthLeft == 0 && m_ctrl[pos] == DictionaryGroup::kCtrlEmpty)
 			{
-				int newSize = (bucketSizeMinusOne + 1) * 2;
-				int newShiftBits = shiftBits - 1;
-				if (newSize == 0)
-				{
-					newSize = 16;
-					newShiftBits = 28;
-				}
-				Dictionary<TKey, TValue> newDict;
-				newDict.shiftBits = newShiftBits;
-				newDict.bucketSizeMinusOne = newSize - 1;
-				newDict.hashMap = new KeyValuePair<TKey, TValue>[newSize];
-				newDict.marks.SetMax(newSize * 2);
-				if (hashMap)
-				{
-					for (auto & kvPair : *this)
-					{
-						newDict.Add(_Move(kvPair));
-					}
-				}
-				*this = _Move(newDict);
+				_growForInsert();
+				pos = _findInsertPosition(hash);
 			}
+			// Reusing a deleted slot doesn't use up any growth
+			m_growthLeft -= (m_ctrl[pos] == DictionaryGroup::kCtrlEmpty) ? 1 : 0;
+			m_ctrl[pos] = _getH2(hash);
+
+			Slot* slot = &m_slots[pos];
+			new (&slot->pair) KeyValuePair<TKey, TValue>(_Move(kvPair));
+			slot->setHash(hash);
+			_count++;
+			return slot->pair.Value;
 		}
 
 		bool AddIfNotExists(KeyValuePair<TKey, TValue> && kvPair)
 		{
-			Rehash();
-			auto pos = FindPosition(kvPair.Key);
-			if (pos.ObjectPosition != -1)
+			const uint32_t hash = _getHash(kvPair.Key);
+			if (_find(kvPair.Key, hash) != -1)
 				return false;
-			else if (pos.InsertionPosition != -1)
-			{
-				_count++;
-				_Insert(_Move(kvPair), pos.InsertionPosition);
-				return true;
-			}
-			else
-				throw InvalidOperationException("Inconsistent find result returned. This is a bug in Dictionary implementation.");
+			_Insert(_Move(kvPair), hash);
+			return true;
 		}
 		void Add(KeyValuePair<TKey, TValue> && kvPair)
 		{
@@ -219,39 +359,36 @@ namespace Slang
 		}
 		TValue & Set(KeyValuePair<TKey, TValue> && kvPair)
 		{
-			Rehash();
-			auto pos = FindPosition(kvPair.Key);
-			if (pos.ObjectPosition != -1)
-				return _Insert(_Move(kvPair), pos.ObjectPosition);
-			else if (pos.InsertionPosition != -1)
+			const uint32_t hash = _getHash(kvPair.Key);
+			const int pos = _find(kvPair.Key, hash);
+			if (pos != -1)
 			{
-				_count++;
-				return _Insert(_Move(kvPair), pos.InsertionPosition);
+				m_slots[pos].pair = _Move(kvPair);
+				return m_slots[pos].pair.Value;
 			}
-			else
-				throw InvalidOperationException("Inconsistent find result returned. This is a bug in Dictionary implementation.");
+			return _Insert(_Move(kvPair), hash);
 		}
 	public:
 		class Iterator
 		{
 		private:
-			const Dictionary<TKey, TValue> * dict;
+			const Dictionary<TKey, TValue, TAllocator> * dict;
 			int pos;
 		public:
 			KeyValuePair<TKey, TValue> & operator *() const
 			{
-				return dict->hashMap[pos];
+				return dict->m_slots[pos].pair;
 			}
 			KeyValuePair<TKey, TValue> * operator ->() const
 			{
-				return dict->hashMap + pos;
+				return &dict->m_slots[pos].pair;
 			}
 			Iterator & operator ++()
 			{
-				if (pos > dict->bucketSizeMinusOne)
+				if (pos >= dict->m_capacity)
 					return *this;
 				pos++;
-				while (pos <= dict->bucketSizeMinusOne && (dict->IsDeleted(pos) || dict->IsEmpty(pos)))
+				while (pos < dict->m_capacity && !DictionaryGroup::isFull(dict->m_ctrl[pos]))
 				{
 					pos++;
 				}
@@ -271,7 +408,7 @@ namespace Slang
 			{
 				return pos == _that.pos && dict == _that.dict;
 			}
-			Iterator(const Dictionary<TKey, TValue> * _dict, int _pos)
+			Iterator(const Dictionary<TKey, TValue, TAllocator> * _dict, int _pos)
 			{
 				this->dict = _dict;
 				this->pos = _pos;
@@ -286,18 +423,13 @@ namespace Slang
 		Iterator begin() const
 		{
 			int pos = 0;
-			while (pos < bucketSizeMinusOne + 1)
-			{
-				if (IsEmpty(pos) || IsDeleted(pos))
-					pos++;
-				else
-					break;
-			}
+			while (pos < m_capacity && !DictionaryGroup::isFull(m_ctrl[pos]))
+				pos++;
 			return Iterator(this, pos);
 		}
 		Iterator end() const
 		{
-			return Iterator(this, bucketSizeMinusOne + 1);
+			return Iterator(this, m_capacity);
 		}
 	public:
 		void Add(const TKey & key, const TValue & value)
@@ -320,37 +452,59 @@ namespace Slang
 		{
 			if (_count == 0)
 				return;
-			auto pos = FindPosition(key);
-			if (pos.ObjectPosition != -1)
+			const int pos = _find(key, _getHash(key));
+			if (pos == -1)
+				return;
+			m_slots[pos].~Slot();
+			_count--;
+
+			// If the group has an empty slot, no probe sequence can have continued past it, so this slot
+			// can be made empty. Otherwise it must be marked deleted, so that lookups continue past it.
+			const int base = pos & ~(DictionaryGroup::kSize - 1);
+			if (DictionaryGroup(m_ctrl + base).matchEmpty())
+			{
+				m_ctrl[pos] = DictionaryGroup::kCtrlEmpty;
+				m_growthLeft++;
+			}
+			else
 			{
-				SetDeleted(pos.ObjectPosition, true);
-				_count--;
+				m_ctrl[pos] = DictionaryGroup::kCtrlDeleted;
 			}
 		}
 		void Clear()
 		{
+			// Keeps the capacity
+			if (m_ctrl)
+			{
+				_destroyAll();
+				::memset(m_ctrl, uint8_t(DictionaryGroup::kCtrlEmpty), size_t(m_capacity));
+				m_growthLeft = _getMaxCount(m_capacity);
+			}
 			_count = 0;
-
-			marks.Clear();
+		}
+			/// Make sure count entries can be held without having to grow
+		void Reserve(int count)
+		{
+			if (count <= _count + m_growthLeft)
+				return;
+			int capacity = (m_capacity == 0) ? DictionaryGroup::kSize : m_capacity;
+			while (_getMaxCount(capacity) < count)
+				capacity *= 2;
+			_resize(capacity);
 		}
 
 		template<typename T>
 		bool ContainsKey(const T & key) const
 		{
-			if (bucketSizeMinusOne == -1)
-				return false;
-			auto pos = FindPosition(key);
-			return pos.ObjectPosition != -1;
+			return _find(key, _getHash(key)) != -1;
 		}
 		template<typename T>
 		bool TryGetValue(const T & key, TValue & value) const
 		{
-			if (bucketSizeMinusOne == -1)
-				return false;
-			auto pos = FindPosition(key);
-			if (pos.ObjectPosition != -1)
+			const int pos = _find(key, _getHash(key));
+			if (pos != -1)
 			{
-				value = hashMap[pos.ObjectPosition].Value;
+				value = m_slots[pos].pair.Value;
 				return true;
 			}
 			return false;
@@ -358,38 +512,30 @@ namespace Slang
 		template<typename T>
 		TValue * TryGetValue(const T & key) const
 		{
-			if (bucketSizeMinusOne == -1)
-				return nullptr;
-			auto pos = FindPosition(key);
-			if (pos.ObjectPosition != -1)
-			{
-				return &hashMap[pos.ObjectPosition].Value;
-			}
-			return nullptr;
+			const int pos = _find(key, _getHash(key));
+			return (pos != -1) ? &m_slots[pos].pair.Value : nullptr;
 		}
 		class ItemProxy
 		{
 		private:
-			const Dictionary<TKey, TValue> * dict;
+			const Dictionary<TKey, TValue, TAllocator> * dict;
 			TKey key;
 		public:
-			ItemProxy(const TKey & _key, const Dictionary<TKey, TValue> * _dict)
+			ItemProxy(const TKey & _key, const Dictionary<TKey, TValue, TAllocator> * _dict)
 			{
 				this->dict = _dict;
 				this->key = _key;
 			}
-			ItemProxy(TKey && _key, const Dictionary<TKey, TValue> * _dict)
+			ItemProxy(TKey && _key, const Dictionary<TKey, TValue, TAllocator> * _dict)
 			{
 				this->dict = _dict;
 				this->key = _Move(_key);
 			}
 			TValue & GetValue() const
 			{
-				auto pos = dict->FindPosition(key);
-				if (pos.ObjectPosition != -1)
-				{
-					return dict->hashMap[pos.ObjectPosition].Value;
-				}
+				TValue* value = dict->TryGetValue(key);
+				if (value)
+					return *value;
 				else
 					throw KeyNotFoundException("The key does not exists in dictionary.");
 			}
@@ -403,11 +549,11 @@ namespace Slang
 			}
 			TValue & operator = (const TValue & val) const
 			{
-				return ((Dictionary<TKey, TValue>*)dict)->Set(KeyValuePair<TKey, TValue>(_Move(key), val));
+				return ((Dictionary<TKey, TValue, TAllocator>*)dict)->Set(KeyValuePair<TKey, TValue>(_Move(key), val));
 			}
 			TValue & operator = (TValue && val) const
 			{
-				return ((Dictionary<TKey, TValue>*)dict)->Set(KeyValuePair<TKey, TValue>(_Move(key), _Move(val)));
+				return ((Dictionary<TKey, TValue, TAllocator>*)dict)->Set(KeyValuePair<TKey, TValue>(_Move(key), _Move(val)));
 			}
 		};
 		ItemProxy operator [](const TKey & key) const
@@ -423,6 +569,9 @@ namespace Slang
 			return _count;
 		}
 	private:
+		void Init()
+		{
+		}
 		template<typename... Args>
 		void Init(const KeyValuePair<TKey, TValue> & kvPair, Args... args)
 		{
@@ -432,53 +581,55 @@ namespace Slang
 	public:
 		Dictionary()
 		{
-			bucketSizeMinusOne = -1;
-			shiftBits = 32;
-			_count = 0;
-			hashMap = 0;
 		}
 		template<typename Arg, typename... Args>
 		Dictionary(Arg arg, Args... args)
 		{
 			Init(arg, args...);
 		}
-		Dictionary(const Dictionary<TKey, TValue> & other)
-			: bucketSizeMinusOne(-1), _count(0), hashMap(0)
+		Dictionary(const Dictionary<TKey, TValue, TAllocator> & other)
 		{
 			*this = other;
 		}
-		Dictionary(Dictionary<TKey, TValue> && other)
-			: bucketSizeMinusOne(-1), _count(0), hashMap(0)
+		Dictionary(Dictionary<TKey, TValue, TAllocator> && other)
 		{
 			*this = (_Move(other));
 		}
-		Dictionary<TKey, TValue> & operator = (const Dictionary<TKey, TValue> & other)
+		Dictionary<TKey, TValue, TAllocator> & operator = (const Dictionary<TKey, TValue, TAllocator> & other)
 		{
 			if (this == &other)
 				return *this;
 			Free();
-			bucketSizeMinusOne = other.bucketSizeMinusOne;
-			_count = other._count;
-			shiftBits = other.shiftBits;
-			hashMap = new KeyValuePair<TKey, TValue>[other.bucketSizeMinusOne + 1];
-			marks = other.marks;
-			for (int i = 0; i <= bucketSizeMinusOne; i++)
-				hashMap[i] = other.hashMap[i];
+			if (other.m_capacity)
+			{
+				// Same layout, so just copy the control bytes and the slots in use
+				_allocate(other.m_capacity);
+				::memcpy(m_ctrl, other.m_ctrl, size_t(m_capacity));
+				for (int i = 0; i < m_capacity; i++)
+				{
+					if (DictionaryGroup::isFull(m_ctrl[i]))
+						new (&m_slots[i]) Slot(other.m_slots[i]);
+				}
+				_count = other._count;
+				m_growthLeft = other.m_growthLeft;
+			}
 			return *this;
 		}
-		Dictionary<TKey, TValue> & operator = (Dictionary<TKey, TValue> && other)
+		Dictionary<TKey, TValue, TAllocator> & operator = (Dictionary<TKey, TValue, TAllocator> && other)
 		{
 			if (this == &other)
 				return *this;
 			Free();
-			bucketSizeMinusOne = other.bucketSizeMinusOne;
+			m_ctrl = other.m_ctrl;
+			m_slots = other.m_slots;
+			m_capacity = other.m_capacity;
 			_count = other._count;
-			hashMap = other.hashMap;
-			shiftBits = other.shiftBits;
-			marks = _Move(other.marks);
-			other.hashMap = 0;
+			m_growthLeft = other.m_growthLeft;
+			other.m_ctrl = nullptr;
+			other.m_slots = nullptr;
+			other.m_capacity = 0;
 			other._count = 0;
-			other.bucketSizeMinusOne = -1;
+			other.m_growthLeft = 0;
 			return *this;
 		}
 		~Dictionary()
@@ -601,8 +752,8 @@ namespace Slang
 			return dict.ContainsKey(obj);
 		}
 	};
-	template <typename T>
-	class HashSet : public HashSetBase<T, Dictionary<T, _DummyClass>>
+	template <typename T, typename TAllocator = StandardAllocator>
+	class HashSet : public HashSetBase<T, Dictionary<T, _DummyClass, TAllocator>>
 	{};
 }
 
@@ -2,9 +2,15 @@
 #define CORELIB_HASH_H
 
 #include "slang-math.h"
+#include "../../slang.h"
+#include <stdint.h>
 #include <string.h>
 #include <type_traits>
 
+#if defined(_MSC_VER) && defined(_M_X64)
+#   include <intrin.h>
+#endif
+
 namespace Slang
 {
 	inline int GetHashCode(double key)
@@ -15,35 +21,115 @@ namespace Slang
 	{
 		return FloatAsInt(key);
 	}
+    /* !!!!!!!!!!!!!!!!!!!!!!!!!! Byte hashing !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+    Strings (and other byte sequences) are hashed a 64 bit word at a time, using a multiply and fold mixing
+    step in the style of wyhash. This is much faster than a byte at a time loop on identifiers and long
+    mangled names, and mixes well enough to be used directly by Dictionary.
+
+    The hash of a sequence only depends on its bytes, so the hash of a String, UnownedStringSlice and a
+    zero terminated char* with the same contents are the same. */
+
+    static const uint64_t kHashPrime0 = 0xa0761d6478bd642full;
+    static const uint64_t kHashPrime1 = 0xe7037ed1a0b428dbull;
+    static const uint64_t kHashPrime2 = 0x8ebc6af09c88c6e3ull;
+    static const uint64_t kHashPrime3 = 0x589965cc75374cc3ull;
+
+        /// Multiply a and b to 128 bits and xor the high and low halves together
+    SLANG_FORCE_INLINE uint64_t _hashMulFold(uint64_t a, uint64_t b)
+    {
+#if defined(__SIZEOF_INT128__)
+        const __uint128_t r = __uint128_t(a) * b;
+        return uint64_t(r) ^ uint64_t(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        uint64_t hi;
+        const uint64_t lo = _umul128(a, b, &hi);
+        return lo ^ hi;
+#else
+        const uint64_t aLo = uint32_t(a), aHi = a >> 32;
+        const uint64_t bLo = uint32_t(b), bHi = b >> 32;
+        const uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+        const uint64_t mid = (ll >> 32) + uint32_t(lh) + uint32_t(hl);
+        const uint64_t lo = (mid << 32) | uint32_t(ll);
+        const uint64_t hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+        return lo ^ hi;
+#endif
+    }
+    SLANG_FORCE_INLINE uint64_t _hashRead64(const uint8_t* p) { uint64_t v; memcpy(&v, p, sizeof(v)); return v; }
+    SLANG_FORCE_INLINE uint64_t _hashRead32(const uint8_t* p) { uint32_t v; memcpy(&v, p, sizeof(v)); return v; }
+
+        /// Get a 64 bit hash of size bytes at data
+    inline uint64_t GetHashCode64(const void* data, size_t size)
+    {
+        const uint8_t* p = (const uint8_t*)data;
+        uint64_t seed = kHashPrime0;
+        uint64_t a, b;
+        if (size <= 16)
+        {
+            if (size >= 4)
+            {
+                // Two (possibly overlapping) pairs of 32 bit reads cover all the bytes
+                const size_t mid = (size >> 3) << 2;
+                a = (_hashRead32(p) << 32) | _hashRead32(p + mid);
+                b = (_hashRead32(p + size - 4) << 32) | _hashRead32(p + size - 4 - mid);
+            }
+            else if (size > 0)
+            {
+                a = (uint64_t(p[0]) << 16) | (uint64_t(p[size >> 1]) << 8) | p[size - 1];
+                b = 0;
+            }
+            else
+            {
+                a = b = 0;
+            }
+        }
+        else
+        {
+            size_t remaining = size;
+            if (remaining > 48)
+            {
+                // Three independent lanes, to keep multipliers busy on long names
+                uint64_t seed1 = seed, seed2 = seed;
+                do
+                {
+                    seed = _hashMulFold(_hashRead64(p) ^ kHashPrime1, _hashRead64(p + 8) ^ seed);
+                    seed1 = _hashMulFold(_hashRead64(p + 16) ^ kHashPrime2, _hashRead64(p + 24) ^ seed1);
+                    seed2 = _hashMulFold(_hashRead64(p + 32) ^ kHashPrime3, _hashRead64(p + 40) ^ seed2);
+                    p += 48;
+                    remaining -= 48;
+                }
+                while (remaining > 48);
+                seed ^= seed1 ^ seed2;
+            }
+            while (remaining > 16)
+            {
+                seed = _hashMulFold(_hashRead64(p) ^ kHashPrime1, _hashRead64(p + 8) ^ seed);
+                p += 16;
+                remaining -= 16;
+            }
+            // The last 16 bytes (which may overlap bytes already hashed)
+            a = _hashRead64(p + remaining - 16);
+            b = _hashRead64(p + remaining - 8);
+        }
+        return _hashMulFold(kHashPrime1 ^ uint64_t(size), _hashMulFold(a ^ kHashPrime1, b ^ seed));
+    }
+
+    inline int GetHashCode(const char * buffer, size_t numChars)
+    {
+        const uint64_t hash = GetHashCode64(buffer, numChars);
+        return int(uint32_t(hash ^ (hash >> 32)));
+    }
 	inline int GetHashCode(const char * buffer)
 	{
 		if (!buffer)
 			return 0;
-		int hash = 0;
-		int c;
-		auto str = buffer;
-		c = *str++;
-		while (c)
-		{
-			hash = c + (hash << 6) + (hash << 16) - hash;
-			c = *str++;
-		}
-		return hash;
+		return GetHashCode(buffer, strlen(buffer));
 	}
 	inline int GetHashCode(char * buffer)
 	{
 		return GetHashCode(const_cast<const char *>(buffer));
 	}
-    inline int GetHashCode(const char * buffer, size_t numChars)
-    {
-        int hash = 0;
-        for (size_t i = 0; i < numChars; ++i)
-        {      
-            hash = int(buffer[i]) + (hash << 6) + (hash << 16) - hash;
-        }
-        return hash;
-    }
-    
+
 	template<int IsInt>
 	class Hash
 	{
@@ -109,8 +109,19 @@ namespace Slang
 
 /* static */void SharedLibrary::appendPlatformFileName(const UnownedStringSlice& name, StringBuilder& dst)
 {
+    // The prefix goes on the file name, not on any directory before it
+    const char* fileName = name.begin();
+    for (const char* cursor = name.begin(); cursor != name.end(); ++cursor)
+    {
+        if (*cursor == '/')
+        {
+            fileName = cursor + 1;
+        }
+    }
+
+    dst.Append(UnownedStringSlice(name.begin(), fileName));
     dst.Append("lib");
-    dst.Append(name);
+    dst.Append(UnownedStringSlice(fileName, name.end()));
     dst.Append(".so");
 }
 
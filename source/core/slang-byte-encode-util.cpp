@@ -1,6 +1,19 @@
 #include "slang-byte-encode-util.h"
 
-
+// StreamVByte decoding can use SSSE3 shuffles. SSSE3 isn't enabled for the whole build, so the decoding
+// function is compiled for it, and only used if the processor supports it.
+#if SLANG_PROCESSOR_FAMILY_X86 && (SLANG_VC || SLANG_GCC || SLANG_CLANG)
+#   define SLANG_BYTE_ENCODE_USE_SSSE3 1
+#   include <tmmintrin.h>
+#   if SLANG_VC
+#       include <intrin.h>
+#       define SLANG_BYTE_ENCODE_SSSE3_FUNC
+#   else
+#       define SLANG_BYTE_ENCODE_SSSE3_FUNC __attribute__((target("ssse3")))
+#   endif
+#else
+#   define SLANG_BYTE_ENCODE_USE_SSSE3 0
+#endif
 
 namespace Slang {
 
@@ -280,4 +293,199 @@ static const uint32_t s_unalignedUInt32Mask[5] =
     return size_t(encodeIn - encodeStart);
 }
 
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! StreamVByte !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+// https://arxiv.org/abs/1709.08990
+
+namespace { // anonymous
+
+struct StreamVByteTables
+{
+    StreamVByteTables()
+    {
+        for (int control = 0; control < 256; ++control)
+        {
+            uint8_t* shuffle = shuffles[control];
+            int offset = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                const int numBytes = ((control >> (i * 2)) & 3) + 1;
+                for (int j = 0; j < 4; ++j)
+                {
+                    // A shuffle index with the top bit set produces 0
+                    shuffle[i * 4 + j] = (j < numBytes) ? uint8_t(offset + j) : uint8_t(0x80);
+                }
+                offset += numBytes;
+            }
+            lengths[control] = uint8_t(offset);
+        }
+    }
+
+    uint8_t shuffles[256][16];          ///< For each control byte, shuffle to take the value bytes to 4 uint32_t
+    uint8_t lengths[256];               ///< For each control byte, the total number of value bytes
+};
+
+} // anonymous
+
+static const StreamVByteTables& _getStreamVByteTables()
+{
+    static const StreamVByteTables tables;
+    return tables;
+}
+
+SLANG_FORCE_INLINE static int _calcStreamVByteCode(uint32_t v)
+{
+    return (v < 0x100) ? 0 : ((v < 0x10000) ? 1 : ((v < 0x1000000) ? 2 : 3));
+}
+
+/* static */size_t ByteEncodeUtil::calcEncodeStreamVByteSizeUInt32(const uint32_t* in, size_t num)
+{
+    size_t totalNumEncodeBytes = (num + 3) >> 2;
+    for (size_t i = 0; i < num; ++i)
+    {
+        totalNumEncodeBytes += _calcStreamVByteCode(in[i]) + 1;
+    }
+    return totalNumEncodeBytes;
+}
+
+/* static */size_t ByteEncodeUtil::encodeStreamVByteUInt32(const uint32_t* in, size_t num, uint8_t* encodeOut)
+{
+    uint8_t* controlOut = encodeOut;
+    uint8_t* dataOut = encodeOut + ((num + 3) >> 2);
+
+    for (size_t i = 0; i < num; i += 4)
+    {
+        const size_t numGroupValues = (num - i < 4) ? (num - i) : 4;
+
+        uint32_t control = 0;
+        for (size_t j = 0; j < numGroupValues; ++j)
+        {
+            uint32_t v = in[i + j];
+            const int code = _calcStreamVByteCode(v);
+            control |= uint32_t(code) << (j * 2);
+
+            for (int k = 0; k <= code; ++k)
+            {
+                *dataOut++ = uint8_t(v);
+                v >>= 8;
+            }
+        }
+        *controlOut++ = uint8_t(control);
+    }
+
+    return size_t(dataOut - encodeOut);
+}
+
+/* static */void ByteEncodeUtil::encodeStreamVByteUInt32(const uint32_t* in, size_t num, List<uint8_t>& encodeOut)
+{
+    encodeOut.SetSize(UInt(calcEncodeStreamVByteSizeUInt32(in, num)));
+    const size_t numEncodeBytes = encodeStreamVByteUInt32(in, num, encodeOut.begin());
+    SLANG_ASSERT(numEncodeBytes == size_t(encodeOut.Count()));
+    SLANG_UNUSED(numEncodeBytes);
+}
+
+// Decodes a group of (up to) 4 values, returning the position after the values' bytes
+SLANG_FORCE_INLINE static const uint8_t* _decodeStreamVByteGroup(uint32_t control, size_t numGroupValues, const uint8_t* dataIn, uint32_t* valuesOut)
+{
+    for (size_t i = 0; i < numGroupValues; ++i)
+    {
+        const int code = int(control & 3);
+        control >>= 2;
+
+        uint32_t value = dataIn[0];
+        switch (code)
+        {
+            case 3: value |= uint32_t(dataIn[3]) << 24;         /* fall thru */
+            case 2: value |= uint32_t(dataIn[2]) << 16;         /* fall thru */
+            case 1: value |= uint32_t(dataIn[1]) << 8;          /* fall thru */
+            case 0: break;
+        }
+        valuesOut[i] = value;
+        dataIn += code + 1;
+    }
+    return dataIn;
+}
+
+#if SLANG_BYTE_ENCODE_USE_SSSE3
+
+static bool _isSSSE3Supported()
+{
+#if SLANG_VC
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    return __builtin_cpu_supports("ssse3") != 0;
+#endif
+}
+
+// Decodes groups of 4 values whilst a 16 byte load for a group can't read past dataEnd. Returns the number of groups decoded.
+SLANG_BYTE_ENCODE_SSSE3_FUNC static size_t _decodeStreamVByteGroupsSSSE3(const uint8_t* controlIn, size_t numGroups, const uint8_t** dataInOut, const uint8_t* dataEnd, uint32_t* valuesOut)
+{
+    const StreamVByteTables& tables = _getStreamVByteTables();
+    const uint8_t* dataIn = *dataInOut;
+
+    // A group has at most 16 bytes of values, so whilst there are 32 bytes remaining two groups (8 values) can be decoded
+    size_t i = 0;
+    for (; i + 2 <= numGroups && dataIn + 32 <= dataEnd; i += 2)
+    {
+        const uint32_t control0 = controlIn[i];
+        const uint32_t control1 = controlIn[i + 1];
+
+        const __m128i data0 = _mm_loadu_si128((const __m128i*)dataIn);
+        const __m128i values0 = _mm_shuffle_epi8(data0, _mm_loadu_si128((const __m128i*)tables.shuffles[control0]));
+        dataIn += tables.lengths[control0];
+
+        const __m128i data1 = _mm_loadu_si128((const __m128i*)dataIn);
+        const __m128i values1 = _mm_shuffle_epi8(data1, _mm_loadu_si128((const __m128i*)tables.shuffles[control1]));
+        dataIn += tables.lengths[control1];
+
+        _mm_storeu_si128((__m128i*)(valuesOut + i * 4), values0);
+        _mm_storeu_si128((__m128i*)(valuesOut + i * 4 + 4), values1);
+    }
+    for (; i < numGroups && dataIn + 16 <= dataEnd; ++i)
+    {
+        const uint32_t control = controlIn[i];
+        const __m128i data = _mm_loadu_si128((const __m128i*)dataIn);
+        _mm_storeu_si128((__m128i*)(valuesOut + i * 4), _mm_shuffle_epi8(data, _mm_loadu_si128((const __m128i*)tables.shuffles[control])));
+        dataIn += tables.lengths[control];
+    }
+
+    *dataInOut = dataIn;
+    return i;
+}
+
+#endif // SLANG_BYTE_ENCODE_USE_SSSE3
+
+/* static */size_t ByteEncodeUtil::decodeStreamVByteUInt32(const uint8_t* encodeIn, size_t encodeSize, size_t numValues, uint32_t* valuesOut)
+{
+    const uint8_t* controlIn = encodeIn;
+    const uint8_t* dataIn = encodeIn + ((numValues + 3) >> 2);
+    const uint8_t* dataEnd = encodeIn + encodeSize;
+
+    // Only complete groups of 4 are decoded with SIMD, as the values are written 4 at a time
+    const size_t numFullGroups = numValues >> 2;
+    size_t numGroupsDecoded = 0;
+
+#if SLANG_BYTE_ENCODE_USE_SSSE3
+    static const bool isSSSE3Supported = _isSSSE3Supported();
+    if (isSSSE3Supported)
+    {
+        numGroupsDecoded = _decodeStreamVByteGroupsSSSE3(controlIn, numFullGroups, &dataIn, dataEnd, valuesOut);
+    }
+#endif
+
+    for (size_t i = numGroupsDecoded; i < numFullGroups; ++i)
+    {
+        dataIn = _decodeStreamVByteGroup(controlIn[i], 4, dataIn, valuesOut + i * 4);
+    }
+    if (numValues & 3)
+    {
+        dataIn = _decodeStreamVByteGroup(controlIn[numFullGroups], numValues & 3, dataIn, valuesOut + numFullGroups * 4);
+    }
+
+    SLANG_ASSERT(dataIn <= dataEnd);
+    SLANG_UNUSED(dataEnd);
+    return size_t(dataIn - encodeIn);
+}
+
 } // namespace Slang
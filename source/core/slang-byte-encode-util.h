@@ -81,6 +81,37 @@ struct ByteEncodeUtil
         */
     static size_t decodeLiteUInt32(const uint8_t* encodeIn, size_t numValues, uint32_t* valuesOut); 
 
+        /** Calculate the size of the 'StreamVByte' encoding of an array of uint32_t.
+
+        The StreamVByte encoding stores the control bytes, which hold 2 bits per value (the number of bytes used - 1), for
+        all the values first, followed by the bytes of the values (little endian, with leading zero bytes dropped). As the
+        lengths of 4 values are known from a single control byte, the values can be decoded 4 at a time with a byte shuffle.
+        @param in The values to encode
+        @param num The amount of values
+        @return The size of the encoding in bytes */
+    static size_t calcEncodeStreamVByteSizeUInt32(const uint32_t* in, size_t num);
+
+        /** Encode an array of uint32_t with StreamVByte encoding
+        @param in The values to encode
+        @param num The amount of values to encode
+        @param encodeOut The buffer to hold the encoding. MUST be large enough to hold the encoding (see calcEncodeStreamVByteSizeUInt32)
+        @return The size of the encoding in bytes */
+    static size_t encodeStreamVByteUInt32(const uint32_t* in, size_t num, uint8_t* encodeOut);
+
+        /** Encode an array of uint32_t with StreamVByte encoding
+        @param in The values to encode
+        @param num The amount of values to encode
+        @param encodeOut The buffer to hold the encoding. */
+    static void encodeStreamVByteUInt32(const uint32_t* in, size_t num, List<uint8_t>& encodeOut);
+
+        /** Decode a StreamVByte encoding. Uses SSSE3 when the processor supports it.
+        @param encodeIn The encoded values
+        @param encodeSize The size of the encoding in bytes. Used so that decoding never reads past the end of the encoding.
+        @param numValues The amount of values to be decoded
+        @param valuesOut The buffer to hold the decoded values.
+        @return The amount of bytes decoded */
+    static size_t decodeStreamVByteUInt32(const uint8_t* encodeIn, size_t encodeSize, size_t numValues, uint32_t* valuesOut);
+
         /// Table that maps 8 bits to it's most significant bit. If 0 returns -1.
     static const int8_t s_msb8[256];
 };
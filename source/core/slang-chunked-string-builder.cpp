@@ -0,0 +1,111 @@
+#include "slang-chunked-string-builder.h"
+
+namespace Slang {
+
+void ChunkedStringBuilder::_appendToNewChunks(const char* textBegin, const char* textEnd)
+{
+    if (textBegin == textEnd)
+    {
+        return;
+    }
+
+    // Fill whatever space is left in the last chunk
+    if (m_isLastChunkWritable)
+    {
+        StringRepresentation* chunk = m_chunks.Last();
+        const UInt length = chunk->capacity - chunk->length;
+        char* dst = chunk->getData() + chunk->length;
+        memcpy(dst, textBegin, length);
+        dst[length] = 0;
+        chunk->length += length;
+        m_length += length;
+        textBegin += length;
+    }
+
+    // The remainder goes in a new chunk
+    const UInt length = UInt(textEnd - textBegin);
+    StringRepresentation* chunk = StringRepresentation::createWithCapacityAndLength(length > kChunkSize ? length : kChunkSize, length);
+    memcpy(chunk->getData(), textBegin, length);
+    m_chunks.Add(RefPtr<StringRepresentation>(chunk));
+    m_isLastChunkWritable = true;
+    m_length += length;
+}
+
+void ChunkedStringBuilder::append(const String& str)
+{
+    const UInt length = str.Length();
+    if (length < kMinReferenceLength)
+    {
+        append(str.begin(), str.end());
+        return;
+    }
+
+    // Strings are copied on write, so the representation can be shared
+    m_chunks.Add(RefPtr<StringRepresentation>(str.getStringRepresentation()));
+    m_isLastChunkWritable = false;
+    m_length += length;
+}
+
+void ChunkedStringBuilder::appendChunks(ChunkedStringBuilder& other)
+{
+    if (other.m_chunks.Count() == 0)
+    {
+        return;
+    }
+    m_chunks.AddRange(other.m_chunks);
+    m_isLastChunkWritable = other.m_isLastChunkWritable;
+    m_length += other.m_length;
+    other.clear();
+}
+
+void ChunkedStringBuilder::prependChunks(ChunkedStringBuilder& other)
+{
+    if (other.m_chunks.Count() == 0)
+    {
+        return;
+    }
+    if (m_chunks.Count() == 0)
+    {
+        m_isLastChunkWritable = other.m_isLastChunkWritable;
+    }
+    m_chunks.InsertRange(0, other.m_chunks.Buffer(), other.m_chunks.Count());
+    m_length += other.m_length;
+    other.clear();
+}
+
+String ChunkedStringBuilder::produceString()
+{
+    switch (m_chunks.Count())
+    {
+        case 0:
+        {
+            return String();
+        }
+        case 1:
+        {
+            // The chunk becomes the contents of the String, so can't be written into any more
+            m_isLastChunkWritable = false;
+            return String(m_chunks[0]);
+        }
+        default: break;
+    }
+
+    StringRepresentation* rep = StringRepresentation::createWithLength(m_length);
+    char* dst = rep->getData();
+    for (const auto& chunk : m_chunks)
+    {
+        memcpy(dst, chunk->getData(), chunk->length);
+        dst += chunk->length;
+    }
+    SLANG_ASSERT(dst == rep->getData() + m_length);
+    return String(rep);
+}
+
+void ChunkedStringBuilder::clear()
+{
+    m_chunks.Clear();
+    m_isLastChunkWritable = false;
+    m_length = 0;
+}
+
+} // namespace Slang
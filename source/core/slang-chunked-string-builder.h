@@ -0,0 +1,86 @@
+#ifndef SLANG_CHUNKED_STRING_BUILDER_H
+#define SLANG_CHUNKED_STRING_BUILDER_H
+
+#include "slang-string.h"
+#include "list.h"
+
+namespace Slang {
+
+/* Builds up text as a list of chunks (a simple rope), rather than in a single contiguous buffer.
+
+Appending writes into the space left in the last chunk, and starts a new chunk when that is full, so text that has
+already been written is never moved as the builder grows. Long Strings are added as chunks of their own, by
+reference. The contents of one builder can be spliced onto the start or end of another by moving its chunks, so
+text that is only known after the rest has been written (such as a prefix) can be added without copying the rest.
+
+The text is only made contiguous by produceString, which copies each chunk once into a String of exactly the
+required size (or if there is only one chunk, returns it without copying). */
+class ChunkedStringBuilder
+{
+public:
+    enum
+    {
+        kChunkSize = 64 * 1024,             ///< The capacity of the chunks text is written into
+        kMinReferenceLength = 1024,         ///< Strings at least this long are referenced, rather than copied
+    };
+
+        /// Append text
+    SLANG_FORCE_INLINE void append(const char* textBegin, const char* textEnd);
+    void append(const char* text) { append(text, text + strlen(text)); }
+    void append(const UnownedStringSlice& slice) { append(slice.begin(), slice.end()); }
+        /// Append a String. If it's long it's referenced rather than copied.
+    void append(const String& str);
+
+        /// Move the contents of other onto the end, leaving other empty
+    void appendChunks(ChunkedStringBuilder& other);
+        /// Move the contents of other onto the start, leaving other empty
+    void prependChunks(ChunkedStringBuilder& other);
+
+        /// Get the length of the text
+    UInt getLength() const { return m_length; }
+        /// Get the number of chunks the text is held in
+    UInt getChunkCount() const { return m_chunks.Count(); }
+        /// Get the text held in a chunk
+    UnownedStringSlice getChunk(UInt index) const { return StringRepresentation::asSlice(m_chunks[index]); }
+
+        /// Get the text as a contiguous String
+    String produceString();
+
+        /// Make empty
+    void clear();
+
+    ChunkedStringBuilder& operator<<(const char* text) { append(text); return *this; }
+    ChunkedStringBuilder& operator<<(const String& str) { append(str); return *this; }
+    ChunkedStringBuilder& operator<<(const UnownedStringSlice& slice) { append(slice); return *this; }
+
+protected:
+    void _appendToNewChunks(const char* textBegin, const char* textEnd);
+
+    List<RefPtr<StringRepresentation>> m_chunks;
+    bool m_isLastChunkWritable = false;         ///< True if the last chunk is only referenced by this builder, so can be written into
+    UInt m_length = 0;                          ///< The total length of all chunks
+};
+
+// ---------------------------------------------------------------------------
+SLANG_FORCE_INLINE void ChunkedStringBuilder::append(const char* textBegin, const char* textEnd)
+{
+    const UInt length = UInt(textEnd - textBegin);
+    if (m_isLastChunkWritable)
+    {
+        StringRepresentation* chunk = m_chunks.Last();
+        if (chunk->capacity - chunk->length >= length)
+        {
+            char* dst = chunk->getData() + chunk->length;
+            memcpy(dst, textBegin, length);
+            dst[length] = 0;
+            chunk->length += length;
+            m_length += length;
+            return;
+        }
+    }
+    _appendToNewChunks(textBegin, textEnd);
+}
+
+} // namespace Slang
+
+#endif // SLANG_CHUNKED_STRING_BUILDER_H
@@ -9,6 +9,16 @@
 
 #ifdef _WIN32
 #   include <direct.h>
+#   define WIN32_LEAN_AND_MEAN
+#   define NOMINMAX
+#   include <Windows.h>
+#   undef WIN32_LEAN_AND_MEAN
+#   undef NOMINMAX
+#else
+#   include <errno.h>
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <unistd.h>
 #endif
 
 #include <limits.h> /* PATH_MAX */
@@ -231,6 +241,31 @@ namespace Slang
 #endif
 	}
 
+    /* static */SlangResult File::GetModificationInfo(const String& fileName, uint64_t& modifiedTimeOut, uint64_t& sizeOut)
+    {
+#ifdef _WIN32
+        struct _stat64 statVar;
+        if (::_wstat64(fileName.ToWString(), &statVar) != 0)
+        {
+            return SLANG_E_NOT_FOUND;
+        }
+        modifiedTimeOut = uint64_t(statVar.st_mtime) * 1000000000;
+#else
+        struct stat statVar;
+        if (::stat(fileName.Buffer(), &statVar) != 0)
+        {
+            return SLANG_E_NOT_FOUND;
+        }
+#   if defined(__linux__)
+        modifiedTimeOut = uint64_t(statVar.st_mtim.tv_sec) * 1000000000 + uint64_t(statVar.st_mtim.tv_nsec);
+#   else
+        modifiedTimeOut = uint64_t(statVar.st_mtime) * 1000000000;
+#   endif
+#endif
+        sizeOut = uint64_t(statVar.st_size);
+        return SLANG_OK;
+    }
+
     /* static */SlangResult Path::GetPathType(const String & path, SlangPathType* pathTypeOut)
     {
 #ifdef _WIN32
@@ -309,16 +344,31 @@ namespace Slang
 	Slang::List<unsigned char> File::ReadAllBytes(const Slang::String & fileName)
 	{
 		RefPtr<FileStream> fs = new FileStream(fileName, FileMode::Open, FileAccess::Read, FileShare::ReadWrite);
+
+		fs->Seek(SeekOrigin::End, 0);
+		const UInt fileSize = UInt(fs->GetPosition());
+		fs->Seek(SeekOrigin::Start, 0);
+
+		// Leave a byte spare, so that the read which hits the end of the file
+		// doesn't have to grow the buffer first.
 		List<unsigned char> buffer;
-		while (!fs->IsEnd())
+		buffer.SetSize(fileSize + 1);
+
+		UInt readSize = 0;
+		for (;;)
 		{
-			unsigned char ch;
-			int read = (int)fs->Read(&ch, 1);
-			if (read)
-				buffer.Add(ch);
-			else
+			// The file may have grown since we asked for its size
+			if (readSize == buffer.Count())
+			{
+				buffer.SetSize(readSize * 2);
+			}
+
+			Int64 read = fs->Read(buffer.Buffer() + readSize, Int64(buffer.Count() - readSize));
+			if (read <= 0)
 				break;
+			readSize += UInt(read);
 		}
+		buffer.SetSize(readSize);
 		return _Move(buffer);
 	}
 
@@ -328,6 +378,138 @@ namespace Slang
 		writer.Write(text);
 	}
 
+    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! MappedFileBlob !!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+    static const Guid IID_ISlangUnknown = SLANG_UUID_ISlangUnknown;
+    static const Guid IID_ISlangBlob = SLANG_UUID_ISlangBlob;
+
+    // Only used to recognize a MappedFileBlob (it's not an interface that can be used through COM)
+    static const Guid IID_MappedFileBlob = { 0x7e1cbd2b, 0x3f7a, 0x4b3e, { 0x9b, 0x51, 0x8d, 0x2e, 0x6c, 0x40, 0x1f, 0xa3 } };
+
+    ISlangUnknown* MappedFileBlob::getInterface(const Guid& guid)
+    {
+        return (guid == IID_ISlangUnknown || guid == IID_ISlangBlob || guid == IID_MappedFileBlob) ? static_cast<ISlangBlob*>(this) : nullptr;
+    }
+
+    /* static */MappedFileBlob* MappedFileBlob::getMappedFileBlob(ISlangBlob* blob)
+    {
+        // The blob may have been created outside of slang, so it can't be dynamic_cast
+        ComPtr<ISlangBlob> mappedBlob;
+        if (!blob || SLANG_FAILED(blob->queryInterface(IID_MappedFileBlob, (void**)mappedBlob.writeRef())))
+        {
+            return nullptr;
+        }
+        return static_cast<MappedFileBlob*>(mappedBlob.get());
+    }
+
+    bool MappedFileBlob::isFileUnchanged() const
+    {
+        uint64_t modifiedTime, fileSize;
+        return SLANG_SUCCEEDED(File::GetModificationInfo(m_path, modifiedTime, fileSize)) &&
+            modifiedTime == m_modifiedTime && fileSize == uint64_t(m_size);
+    }
+
+#ifdef _WIN32
+
+    /* static */SlangResult MappedFileBlob::create(const String& path, ComPtr<ISlangBlob>& blobOut)
+    {
+        // Get the modification time first, so if the file changes while it's being mapped the blob looks stale
+        uint64_t modifiedTime, statSize;
+        if (SLANG_FAILED(File::GetModificationInfo(path, modifiedTime, statSize)))
+        {
+            return SLANG_E_NOT_FOUND;
+        }
+
+        HANDLE fileHandle = CreateFileW(path.ToWString(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+        {
+            const DWORD lastError = GetLastError();
+            return (lastError == ERROR_FILE_NOT_FOUND || lastError == ERROR_PATH_NOT_FOUND) ? SLANG_E_NOT_FOUND : SLANG_E_CANNOT_OPEN;
+        }
+
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+
+        // The zero fill after the end of the file is what terminates the contents, so there must be some
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0 || uint64_t(fileSize.QuadPart) > uint64_t(SIZE_MAX) ||
+            (uint64_t(fileSize.QuadPart) % systemInfo.dwPageSize) == 0)
+        {
+            CloseHandle(fileHandle);
+            return SLANG_E_CANNOT_OPEN;
+        }
+
+        // The view keeps the mapping (and the file) open, so we don't need to hold onto the handles
+        HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(fileHandle);
+        if (!mappingHandle)
+        {
+            return SLANG_E_CANNOT_OPEN;
+        }
+
+        void* data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mappingHandle);
+        if (!data)
+        {
+            return SLANG_E_CANNOT_OPEN;
+        }
+
+        blobOut = new MappedFileBlob(path, data, size_t(fileSize.QuadPart), modifiedTime);
+        return SLANG_OK;
+    }
+
+    MappedFileBlob::~MappedFileBlob()
+    {
+        UnmapViewOfFile(m_data);
+    }
+
+#else
+
+    /* static */SlangResult MappedFileBlob::create(const String& path, ComPtr<ISlangBlob>& blobOut)
+    {
+        // Get the modification time first, so if the file changes while it's being mapped the blob looks stale
+        uint64_t modifiedTime, statSize;
+        if (SLANG_FAILED(File::GetModificationInfo(path, modifiedTime, statSize)))
+        {
+            return SLANG_E_NOT_FOUND;
+        }
+
+        int fd = ::open(path.Buffer(), O_RDONLY);
+        if (fd < 0)
+        {
+            return (errno == ENOENT) ? SLANG_E_NOT_FOUND : SLANG_E_CANNOT_OPEN;
+        }
+
+        // The zero fill after the end of the file is what terminates the contents, so there must be some
+        const long pageSize = ::sysconf(_SC_PAGESIZE);
+        struct stat statVar;
+        if (pageSize <= 0 || ::fstat(fd, &statVar) != 0 || !S_ISREG(statVar.st_mode) || statVar.st_size == 0 ||
+            (statVar.st_size % pageSize) == 0)
+        {
+            ::close(fd);
+            return SLANG_E_CANNOT_OPEN;
+        }
+
+        // The mapping stays valid after the file descriptor is closed
+        const size_t size = size_t(statVar.st_size);
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED)
+        {
+            return SLANG_E_CANNOT_OPEN;
+        }
+
+        blobOut = new MappedFileBlob(path, data, size, modifiedTime);
+        return SLANG_OK;
+    }
+
+    MappedFileBlob::~MappedFileBlob()
+    {
+        ::munmap(m_data, m_size);
+    }
+
+#endif
+
 
 }
 
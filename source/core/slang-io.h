@@ -6,6 +6,9 @@
 #include "text-io.h"
 #include "secure-crt.h"
 
+#include "../../slang-com-helper.h"
+#include "../../slang-com-ptr.h"
+
 namespace Slang
 {
 	class File
@@ -15,8 +18,65 @@ namespace Slang
 		static Slang::String ReadAllText(const Slang::String & fileName);
 		static Slang::List<unsigned char> ReadAllBytes(const Slang::String & fileName);
 		static void WriteAllText(const Slang::String & fileName, const Slang::String & text);
+			/// Get the last modification time (in nanoseconds, if the platform supports that resolution) and the size of a file.
+			/// Returns SLANG_E_NOT_FOUND if there is no file at the path.
+		static SlangResult GetModificationInfo(const Slang::String& fileName, uint64_t& modifiedTimeOut, uint64_t& sizeOut);
 	};
 
+    /** A blob holding the contents of a file, mapped read-only into memory rather than
+    copied into a buffer. The mapping is released when the blob is destroyed.
+
+    Like a blob made from a `String`, the contents are always followed by a zero byte
+    (which isn't included in the size). The OS zero fills the rest of the last page of a
+    mapping, so this holds as long as the file size isn't a multiple of the page size.
+    Files that are, can't be mapped.
+
+    NOTE! The contents will reflect any changes made to the file while the blob is alive
+    (and truncating the file underneath it is fatal on some platforms). So it should only be
+    used for files that are large enough for the copy to matter, and anything holding onto
+    the blob should check `isFileUnchanged` before using it again.
+    */
+    class MappedFileBlob : public ISlangBlob, public RefObject
+    {
+    public:
+        // ISlangUnknown
+        SLANG_REF_OBJECT_IUNKNOWN_ALL
+
+        // ISlangBlob
+        SLANG_NO_THROW void const* SLANG_MCALL getBufferPointer() SLANG_OVERRIDE { return m_data; }
+        SLANG_NO_THROW size_t SLANG_MCALL getBufferSize() SLANG_OVERRIDE { return m_size; }
+
+            /// Map the file at `path`.
+            /// Returns SLANG_E_NOT_FOUND if there is no such file, and SLANG_E_CANNOT_OPEN if it can't be mapped
+            /// (which includes empty files, as a mapping can't be zero sized, and files whose size is a multiple
+            /// of the page size, as there is nowhere for the terminating zero). Callers should fall back to
+            /// reading the file in that case.
+        static SlangResult create(const String& path, ComPtr<ISlangBlob>& blobOut);
+
+            /// Returns the blob as a MappedFileBlob if it is one, else nullptr. Doesn't add a reference.
+        static MappedFileBlob* getMappedFileBlob(ISlangBlob* blob);
+
+            /// True if the file still has the size and modification time it had when it was mapped
+        bool isFileUnchanged() const;
+
+        ~MappedFileBlob();
+
+    protected:
+        MappedFileBlob(const String& path, void* data, size_t size, uint64_t modifiedTime) :
+            m_path(path),
+            m_data(data),
+            m_size(size),
+            m_modifiedTime(modifiedTime)
+        {}
+
+        ISlangUnknown* getInterface(const Guid& guid);
+
+        String m_path;
+        void* m_data;
+        size_t m_size;
+        uint64_t m_modifiedTime;                ///< Modification time of the file when it was mapped
+    };
+
 	class Path
 	{
 	public:
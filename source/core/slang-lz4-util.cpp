@@ -0,0 +1,252 @@
+#include "slang-lz4-util.h"
+
+#include <string.h>
+
+namespace Slang {
+
+SLANG_FORCE_INLINE static uint32_t _read32(const uint8_t* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+SLANG_FORCE_INLINE static uint32_t _hash(uint32_t sequence)
+{
+    // Fibonacci hashing of the 4 bytes
+    return (sequence * 2654435761u) >> (32 - LZ4Util::kHashBits);
+}
+
+// Write a length that didn't fit in the token's 4 bits
+SLANG_FORCE_INLINE static uint8_t* _writeExtraLength(uint8_t* dst, size_t length)
+{
+    while (length >= 255)
+    {
+        *dst++ = 255;
+        length -= 255;
+    }
+    *dst++ = uint8_t(length);
+    return dst;
+}
+
+// Write a sequence of literals, followed by a match (if matchLength is not 0)
+static uint8_t* _writeSequence(uint8_t* dst, const uint8_t* literals, size_t numLiterals, size_t offset, size_t matchLength)
+{
+    uint8_t* token = dst++;
+
+    if (numLiterals >= 15)
+    {
+        *token = 15 << 4;
+        dst = _writeExtraLength(dst, numLiterals - 15);
+    }
+    else
+    {
+        *token = uint8_t(numLiterals << 4);
+    }
+
+    memcpy(dst, literals, numLiterals);
+    dst += numLiterals;
+
+    if (matchLength)
+    {
+        dst[0] = uint8_t(offset);
+        dst[1] = uint8_t(offset >> 8);
+        dst += 2;
+
+        const size_t length = matchLength - LZ4Util::kMinMatch;
+        if (length >= 15)
+        {
+            *token |= 15;
+            dst = _writeExtraLength(dst, length - 15);
+        }
+        else
+        {
+            *token |= uint8_t(length);
+        }
+    }
+    return dst;
+}
+
+/* static */size_t LZ4Util::compress(const void* srcIn, size_t srcSize, void* dstIn)
+{
+    const uint8_t* src = (const uint8_t*)srcIn;
+    uint8_t* dst = (uint8_t*)dstIn;
+    uint8_t* const dstStart = dst;
+
+    size_t anchor = 0;
+
+    if (srcSize > kMatchFindLimit)
+    {
+        // Positions of the last 4 byte sequence seen for each hash. As all entries start as 0, matches are always verified.
+        uint32_t table[1 << kHashBits];
+        memset(table, 0, sizeof(table));
+
+        // Matches must start before matchFindEnd, and end before matchEnd
+        const size_t matchFindEnd = srcSize - kMatchFindLimit;
+        const size_t matchEnd = srcSize - kLastLiterals;
+
+        size_t pos = 0;
+        while (pos < matchFindEnd)
+        {
+            const uint32_t sequence = _read32(src + pos);
+            const uint32_t hash = _hash(sequence);
+            const size_t candidate = table[hash];
+            table[hash] = uint32_t(pos);
+
+            if (candidate < pos && pos - candidate <= kMaxOffset && _read32(src + candidate) == sequence)
+            {
+                // Extend the match forwards
+                size_t matchLength = kMinMatch;
+                while (pos + matchLength < matchEnd && src[candidate + matchLength] == src[pos + matchLength])
+                {
+                    matchLength++;
+                }
+                // And backwards, over literals that haven't been written
+                size_t start = pos;
+                size_t matchStart = candidate;
+                while (start > anchor && matchStart > 0 && src[start - 1] == src[matchStart - 1])
+                {
+                    start--;
+                    matchStart--;
+                    matchLength++;
+                }
+
+                dst = _writeSequence(dst, src + anchor, start - anchor, start - matchStart, matchLength);
+
+                pos = start + matchLength;
+                anchor = pos;
+
+                // Add a position inside the match, so repeats of the same data are found
+                if (pos - 2 < matchFindEnd)
+                {
+                    table[_hash(_read32(src + pos - 2))] = uint32_t(pos - 2);
+                }
+            }
+            else
+            {
+                // Step further the longer no match has been found, so incompressible data is passed over quickly
+                pos += 1 + ((pos - anchor) >> 6);
+            }
+        }
+    }
+
+    // The remainder are literals
+    dst = _writeSequence(dst, src + anchor, srcSize - anchor, 0, 0);
+
+    SLANG_ASSERT(size_t(dst - dstStart) <= calcMaxCompressedSize(srcSize));
+    return size_t(dst - dstStart);
+}
+
+/* static */void LZ4Util::compress(const void* src, size_t srcSize, List<uint8_t>& dstOut)
+{
+    const UInt startSize = dstOut.Count();
+    dstOut.SetSize(startSize + calcMaxCompressedSize(srcSize));
+    const size_t size = compress(src, srcSize, dstOut.Buffer() + startSize);
+    dstOut.SetSize(startSize + size);
+}
+
+// Read a length that didn't fit in the token's 4 bits. Returns false if the input ends before the length does.
+SLANG_FORCE_INLINE static bool _readExtraLength(const uint8_t*& src, const uint8_t* srcEnd, size_t& lengthInOut)
+{
+    uint8_t v;
+    do
+    {
+        if (src >= srcEnd)
+        {
+            return false;
+        }
+        v = *src++;
+        lengthInOut += v;
+    } while (v == 255);
+    return true;
+}
+
+/* static */SlangResult LZ4Util::decompress(const void* srcIn, size_t srcSize, void* dstIn, size_t dstSize)
+{
+    const uint8_t* src = (const uint8_t*)srcIn;
+    const uint8_t* const srcEnd = src + srcSize;
+
+    uint8_t* dst = (uint8_t*)dstIn;
+    uint8_t* const dstStart = dst;
+    uint8_t* const dstEnd = dst + dstSize;
+
+    while (src < srcEnd)
+    {
+        const uint8_t token = *src++;
+
+        // Literals
+        size_t numLiterals = token >> 4;
+        if (numLiterals == 15 && !_readExtraLength(src, srcEnd, numLiterals))
+        {
+            return SLANG_FAIL;
+        }
+        if (numLiterals > size_t(srcEnd - src) || numLiterals > size_t(dstEnd - dst))
+        {
+            return SLANG_FAIL;
+        }
+        memcpy(dst, src, numLiterals);
+        src += numLiterals;
+        dst += numLiterals;
+
+        // The last sequence only has literals
+        if (src == srcEnd)
+        {
+            break;
+        }
+
+        // Match
+        if (srcEnd - src < 2)
+        {
+            return SLANG_FAIL;
+        }
+        const size_t offset = size_t(src[0]) | (size_t(src[1]) << 8);
+        src += 2;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !_readExtraLength(src, srcEnd, matchLength))
+        {
+            return SLANG_FAIL;
+        }
+        matchLength += kMinMatch;
+
+        if (offset == 0 || offset > size_t(dst - dstStart) || matchLength > size_t(dstEnd - dst))
+        {
+            return SLANG_FAIL;
+        }
+
+        const uint8_t* match = dst - offset;
+        if (offset >= matchLength)
+        {
+            memcpy(dst, match, matchLength);
+            dst += matchLength;
+        }
+        else if (offset >= 8)
+        {
+            // Overlapping, but can still copy 8 bytes at a time
+            uint8_t* const end = dst + matchLength;
+            while (end - dst >= 8)
+            {
+                memcpy(dst, match, 8);
+                dst += 8;
+                match += 8;
+            }
+            while (dst < end)
+            {
+                *dst++ = *match++;
+            }
+        }
+        else
+        {
+            // Short repeating pattern
+            uint8_t* const end = dst + matchLength;
+            while (dst < end)
+            {
+                *dst++ = *match++;
+            }
+        }
+    }
+
+    return (dst == dstEnd) ? SLANG_OK : SLANG_FAIL;
+}
+
+} // namespace Slang
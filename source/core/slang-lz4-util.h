@@ -0,0 +1,53 @@
+#ifndef SLANG_LZ4_UTIL_H
+#define SLANG_LZ4_UTIL_H
+
+#include "list.h"
+
+#include "../../slang.h"
+
+namespace Slang {
+
+/* Compression and decompression of the LZ4 block format.
+
+An LZ4 block is a sequence of (literals, match) pairs, where a match copies bytes from earlier in the output. It
+doesn't compress as well as entropy coders, but decompression is very fast (it is little more than a series of
+copies), so it is suitable for data that is loaded frequently.
+
+The compressor is a simple greedy matcher over a hash table of 4 byte sequences. The output can be decompressed by
+any LZ4 block decompressor, and decompress can decompress any LZ4 block. */
+struct LZ4Util
+{
+    enum
+    {
+        kMinMatch = 4,                      ///< The shortest match that can be encoded
+        kMaxOffset = 0xffff,                ///< The maximum distance back a match can be
+        kLastLiterals = 5,                  ///< The last bytes of a block are always literals
+        kMatchFindLimit = 12,               ///< A match can't start within this many bytes of the end of the block
+        kHashBits = 12,                     ///< Bits in hash table index. The table is kept small, as it's cleared for every block.
+    };
+
+        /// Get the maximum size compressing srcSize bytes can produce
+    static size_t calcMaxCompressedSize(size_t srcSize) { return srcSize + (srcSize / 255) + 16; }
+
+        /** Compress a block
+        @param src The data to compress
+        @param srcSize The size of src in bytes
+        @param dst Where to write the compressed data. Must be at least calcMaxCompressedSize(srcSize) bytes.
+        @return The size of the compressed data in bytes */
+    static size_t compress(const void* src, size_t srcSize, void* dst);
+
+        /// Compress src, appending the result to dstOut
+    static void compress(const void* src, size_t srcSize, List<uint8_t>& dstOut);
+
+        /** Decompress a block
+        @param src The compressed data
+        @param srcSize The size of the compressed data in bytes
+        @param dst Where to write the decompressed data
+        @param dstSize The size of the decompressed data. The block must decompress to exactly this size.
+        @return SLANG_OK if the block is valid and decompresses to dstSize bytes */
+    static SlangResult decompress(const void* src, size_t srcSize, void* dst, size_t dstSize);
+};
+
+} // namespace Slang
+
+#endif // SLANG_LZ4_UTIL_H
@@ -151,6 +151,51 @@ void MemoryArena::reset()
     _resetCurrentBlock();
 }
 
+void MemoryArena::rewind(const Mark& mark)
+{
+    // Free the odd blocks allocated since the mark
+    Block* markOddBlocks = (Block*)mark.m_usedOddBlocks;
+    while (m_usedOddBlocks != markOddBlocks)
+    {
+        assert(m_usedOddBlocks);
+        Block* block = m_usedOddBlocks;
+        m_usedOddBlocks = block->m_next;
+
+        ::free(block->m_alloc);
+        m_blockFreeList.deallocate(block);
+    }
+
+    // Regular blocks become available again
+    Block* markUsedBlocks = (Block*)mark.m_usedBlocks;
+    while (m_usedBlocks != markUsedBlocks)
+    {
+        assert(m_usedBlocks);
+        Block* block = m_usedBlocks;
+        m_usedBlocks = block->m_next;
+
+        block->m_next = m_availableBlocks;
+        m_availableBlocks = block;
+    }
+
+    if (m_usedBlocks)
+    {
+        m_start = m_usedBlocks->m_start;
+        m_end = m_usedBlocks->m_end;
+        assert(mark.m_current >= m_start && mark.m_current <= m_end);
+        m_current = mark.m_current;
+    }
+    else
+    {
+        _resetCurrentBlock();
+    }
+}
+
+/* static */MemoryArena& MemoryArena::getThreadScratch()
+{
+    static thread_local MemoryArena arena(16 * 1024, 16);
+    return arena;
+}
+
 const MemoryArena::Block* MemoryArena::_findNonCurrent(const void* data, size_t size) const
 {
     // It must either be m_usedOversizedBlocks or after m_usedBlocks (because m_usedBlocks is m_current)
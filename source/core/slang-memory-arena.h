@@ -24,6 +24,9 @@ If not a new block is allocated that can hold at least the allocation with requi
 All memory allocated can be deallocated very quickly and without a client having to track any memory. 
 All memory allocated will be freed on destruction - or with reset.
 
+The current position can be recorded with mark, and a later call to rewind with that mark will deallocate everything
+allocated since. This allows an arena to be used for scoped temporaries - see MemoryArenaScope.
+
 A memory arena can have requests larger than the block size. When that happens they will just be allocated
 from the heap. As such 'odd blocks' are seen as unusual and potentially wasteful so they are deallocated
 when deallocateAll is called, whereas regular size blocks will remain allocated for fast subsequent allocation.
@@ -122,6 +125,24 @@ public:
 
         /// Resets to the initial state when constructed (and all backing memory will be deallocated)  
     void reset();
+
+        /// A position in the arena, as returned by mark
+    struct Mark
+    {
+        void* m_usedBlocks;             ///< The current block when marked
+        void* m_usedOddBlocks;          ///< The most recent odd block when marked
+        uint8_t* m_current;             ///< The position in the current block when marked
+    };
+        /// Get the current position in the arena
+    Mark mark() const;
+        /** Deallocates everything that was allocated since mark was taken. As with deallocateAll, regular blocks are kept for
+        subsequent allocations, and odd blocks are freed.
+        The mark must be from this arena, and not from before a more recent rewind, deallocateAll or reset. */
+    void rewind(const Mark& mark);
+
+        /** Get an arena for temporary allocations on the current thread. Allocations should only be made within
+        a MemoryArenaScope for the arena, so that they are deallocated when the scope ends. */
+    static MemoryArena& getThreadScratch();
         /// Adjusts such that the next allocate will be at least to the block alignment.
     void adjustToBlockAlignment();
  
@@ -197,6 +218,56 @@ protected:
     void operator=(const ThisType& rhs) = delete;
 };
 
+/* Marks an arena on construction, and rewinds it to the mark on destruction, so everything allocated from the arena
+within the scope is deallocated when the scope ends. Scopes can be nested. */
+class MemoryArenaScope
+{
+public:
+        /// Scope the thread scratch arena
+    MemoryArenaScope() : MemoryArenaScope(MemoryArena::getThreadScratch()) {}
+        /// Scope the arena
+    explicit MemoryArenaScope(MemoryArena& arena) : m_arena(arena), m_mark(arena.mark()) {}
+    ~MemoryArenaScope() { m_arena.rewind(m_mark); }
+
+protected:
+    MemoryArena& m_arena;
+    MemoryArena::Mark m_mark;
+
+private:
+    // Disable
+    MemoryArenaScope(const MemoryArenaScope& rhs) = delete;
+    void operator=(const MemoryArenaScope& rhs) = delete;
+};
+
+/* An allocator for containers (such as List and Dictionary) that allocates from the thread scratch arena.
+
+Free does nothing - memory is only reclaimed when the enclosing MemoryArenaScope ends. So a container using it
+must be within a scope on the thread scratch arena, must not outlive that scope, and must not grow while a more
+deeply nested scope is active (the new storage would be deallocated when the nested scope ends). */
+class ScratchAllocator
+{
+public:
+    void* Alloc(size_t size)
+    {
+        // Aligned to 16 to match the heap, as some containers rely on it
+        return MemoryArena::getThreadScratch().allocateAligned(size ? size : 1, 16);
+    }
+    void Free(void* ptr)
+    {
+        SLANG_UNUSED(ptr);
+    }
+};
+
+// --------------------------------------------------------------------------
+SLANG_FORCE_INLINE MemoryArena::Mark MemoryArena::mark() const
+{
+    Mark mark;
+    mark.m_usedBlocks = m_usedBlocks;
+    mark.m_usedOddBlocks = m_usedOddBlocks;
+    mark.m_current = m_current;
+    return mark;
+}
+
 // --------------------------------------------------------------------------
 SLANG_FORCE_INLINE bool MemoryArena::isValid(const void* data, size_t size) const
 {
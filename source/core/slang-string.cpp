@@ -227,7 +227,11 @@ namespace Slang
     void String::ensureUniqueStorageWithCapacity(UInt requiredCapacity)
     {
         if (buffer && buffer->isUniquelyReferenced() && buffer->capacity >= requiredCapacity)
+        {
+            // The caller is about to change the contents in place
+            buffer->invalidateHashCode();
             return;
+        }
 
         UInt newCapacity = buffer ? 2*buffer->capacity : 16;
         if (newCapacity < requiredCapacity)
@@ -163,6 +163,19 @@ namespace Slang
             return length;
         }
 
+            /// Get the hash of the contents. The hash is calculated on first use, and cached until the contents change.
+        SLANG_FORCE_INLINE int getHashCode() const
+        {
+            if (!hasHashCode)
+            {
+                hashCode = Slang::GetHashCode(getData(), size_t(length));
+                hasHashCode = true;
+            }
+            return hashCode;
+        }
+            /// Must be called before the contents of a representation that may have been hashed is changed
+        SLANG_FORCE_INLINE void invalidateHashCode() { hasHashCode = false; }
+
         SLANG_FORCE_INLINE char* getData()
         {
             return (char*) (this + 1);
@@ -194,6 +207,7 @@ namespace Slang
             StringRepresentation* obj = new(allocation) StringRepresentation();
             obj->capacity = capacity;
             obj->length = length;
+            obj->hasHashCode = false;
             obj->getData()[length] = 0;
             return obj;
         }
@@ -234,6 +248,10 @@ namespace Slang
 
             return cloneWithCapacity(newCapacity);
         }
+
+    protected:
+        mutable int hashCode;
+        mutable bool hasHashCode;
     };
 
     class String;
@@ -720,7 +738,7 @@ namespace Slang
 
 		int GetHashCode() const
 		{
-			return Slang::GetHashCode((const char*)begin());
+			return buffer ? buffer->getHashCode() : Slang::GetHashCode("", 0);
 		}
 
         UnownedStringSlice getUnownedSlice() const
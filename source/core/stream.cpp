@@ -215,4 +215,105 @@ namespace Slang
 	{
 		return endReached;
 	}
+
+	MemoryStream::MemoryStream()
+		: m_data(nullptr)
+		, m_size(0)
+		, m_isWritable(true)
+	{
+	}
+	MemoryStream::MemoryStream(const void* data, size_t size)
+		: m_data((const uint8_t*)data)
+		, m_size(size)
+		, m_isWritable(false)
+	{
+	}
+	Int64 MemoryStream::GetPosition()
+	{
+		return Int64(m_position);
+	}
+	void MemoryStream::Seek(SeekOrigin origin, Int64 offset)
+	{
+		Int64 position;
+		switch (origin)
+		{
+		case Slang::SeekOrigin::Start:
+			position = offset;
+			m_endReached = false;
+			break;
+		case Slang::SeekOrigin::End:
+			position = Int64(m_size) + offset;
+			m_endReached = true;
+			break;
+		case Slang::SeekOrigin::Current:
+			position = Int64(m_position) + offset;
+			m_endReached = false;
+			break;
+		default:
+			throw NotSupportedException("Unsupported seek origin.");
+		}
+		if (position < 0 || position > Int64(m_size))
+		{
+			throw IOException("MemoryStream seek failed.");
+		}
+		m_position = size_t(position);
+	}
+	Int64 MemoryStream::Read(void * buffer, Int64 length)
+	{
+		const size_t remaining = m_size - m_position;
+		if (length > 0 && remaining == 0)
+		{
+			// The same as FileStream - the first read at the end reads nothing, and the next throws
+			if (m_endReached)
+				throw EndOfStreamException("End of stream is reached.");
+			m_endReached = true;
+			return 0;
+		}
+		const size_t bytes = (size_t(length) < remaining) ? size_t(length) : remaining;
+		::memcpy(buffer, m_data + m_position, bytes);
+		m_position += bytes;
+		return Int64(bytes);
+	}
+	Int64 MemoryStream::Write(const void * buffer, Int64 length)
+	{
+		if (!m_isWritable)
+		{
+			throw IOException("MemoryStream is read only.");
+		}
+		const size_t end = m_position + size_t(length);
+		if (end > m_size)
+		{
+			m_contents.GrowToSize(UInt(end));
+			m_size = end;
+		}
+		::memcpy(m_contents.Buffer() + m_position, buffer, size_t(length));
+		m_data = m_contents.Buffer();
+		m_position = end;
+		return length;
+	}
+	bool MemoryStream::CanRead()
+	{
+		return true;
+	}
+	bool MemoryStream::CanWrite()
+	{
+		return m_isWritable;
+	}
+	void MemoryStream::Close()
+	{
+	}
+	bool MemoryStream::IsEnd()
+	{
+		return m_endReached;
+	}
+	void MemoryStream::swapContents(List<uint8_t>& contentsInOut)
+	{
+		SLANG_ASSERT(m_isWritable);
+		m_contents.SetSize(UInt(m_size));
+		m_contents.SwapWith(contentsInOut);
+
+		m_data = m_contents.Buffer();
+		m_size = m_contents.Count();
+		m_position = 0;
+	}
 }
@@ -82,6 +82,40 @@ namespace Slang
 		virtual void Close();
 		virtual bool IsEnd();
 	};
+
+	/* A stream held in memory.
+	A MemoryStream constructed without any data is writable, and owns its contents. A MemoryStream constructed
+	with data is read only, and the data must stay in scope whilst the stream is used.
+	Reaching the end behaves as for a FileStream (so it can be read with a StreamReader). */
+	class MemoryStream : public Stream
+	{
+	public:
+		MemoryStream();
+		MemoryStream(const void* data, size_t size);
+	public:
+		virtual Int64 GetPosition();
+		virtual void Seek(SeekOrigin origin, Int64 offset);
+		virtual Int64 Read(void * buffer, Int64 length);
+		virtual Int64 Write(const void * buffer, Int64 length);
+		virtual bool CanRead();
+		virtual bool CanWrite();
+		virtual void Close();
+		virtual bool IsEnd();
+
+			/// Get the contents of the stream
+		const uint8_t* getContents() const { return m_data; }
+			/// Get the size of the contents in bytes
+		size_t getContentsSize() const { return m_size; }
+			/// Take the contents of a writable stream (which is then empty)
+		void swapContents(List<uint8_t>& contentsInOut);
+	private:
+		List<uint8_t> m_contents;			///< Holds the contents if writable
+		const uint8_t* m_data;
+		size_t m_size;
+		size_t m_position = 0;
+		bool m_endReached = false;
+		bool m_isWritable;
+	};
 }
 
 #endif
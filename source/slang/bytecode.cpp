@@ -859,8 +859,12 @@ BytecodeGenerationPtr<BCSymbol> generateBytecodeSymbolForInst(
         {
             auto bcVar = allocate<BCSymbol>(context);
 
+            // Note: emitting the type may grow the bytecode buffer,
+            // so we must compute the ID before we write through `bcVar`.
+            uint32_t typeID = getTypeID(context, inst->getFullType());
+
             bcVar->op = inst->op;
-            bcVar->typeID = getTypeID(context, inst->getFullType());
+            bcVar->typeID = typeID;
 
             // TODO: actually need to intialize with body instructions
 
@@ -884,6 +888,9 @@ BytecodeGenerationPtr<BCModule> generateBytecodeForModule(
         return BytecodeGenerationPtr<BCModule>();
     }
 
+    // All of the bodies are needed
+    materializeIRModule(irModule);
+
     // A module in the bytecode is mostly just a list of the
     // global symbols in the module.
     //
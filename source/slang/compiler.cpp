@@ -91,7 +91,7 @@ namespace Slang
 
         if (appendTo == ResultFormat::Text)
         {
-            outputString.append(result.outputString.Buffer());
+            outputString.append(result.outputString);
         }
         else if (appendTo == ResultFormat::Binary)
         {
@@ -281,6 +281,22 @@ namespace Slang
         }
     }
 
+    String emitCPPForEntryPoint(
+        EntryPointRequest*  entryPoint,
+        TargetRequest*      targetReq)
+    {
+        // C++ output is generated as a dialect of HLSL: the
+        // same target intrinsics are selected, and the emit
+        // logic checks the final target to spell things the
+        // way a C++ compiler (plus `slang-cpp-prelude.h`)
+        // expects.
+        return emitEntryPoint(
+            entryPoint,
+            targetReq->layout.Ptr(),
+            CodeGenTarget::HLSL,
+            targetReq);
+    }
+
     String GetHLSLProfileName(Profile profile)
     {
         switch( profile.getFamily() )
@@ -684,6 +700,14 @@ SlangResult dissassembleDXILUsingDXC(
             }
             break;
 
+        case CodeGenTarget::CPPSource:
+            {
+                String code = emitCPPForEntryPoint(entryPoint, targetReq);
+                maybeDumpIntermediate(compileRequest, code.Buffer(), target);
+                result = CompileResult(code);
+            }
+            break;
+
 #if SLANG_ENABLE_DXBC_SUPPORT
         case CodeGenTarget::DXBytecode:
             {
@@ -1045,6 +1069,26 @@ SlangResult dissassembleDXILUsingDXC(
                     data.end() - data.begin(),
                     OutputFileKind::Binary);
             }
+
+            if (compileRequest->flatReflectionOutputPath.Length() != 0 && compileRequest->targets.Count() != 0)
+            {
+                List<uint8_t> data;
+                if (SLANG_SUCCEEDED(writeFlatReflection(compileRequest->targets[0]->layout, data)))
+                {
+                    writeOutputFile(compileRequest,
+                        compileRequest->flatReflectionOutputPath,
+                        data.Buffer(),
+                        data.Count(),
+                        OutputFileKind::Binary);
+                }
+                else
+                {
+                    compileRequest->mSink.diagnose(
+                        SourceLoc(),
+                        Diagnostics::cannotWriteFlatReflection,
+                        compileRequest->flatReflectionOutputPath);
+                }
+            }
         }
     }
 
@@ -1126,6 +1170,10 @@ SlangResult dissassembleDXILUsingDXC(
             dumpIntermediateText(compileRequest, data, size, ".glsl");
             break;
 
+        case CodeGenTarget::CPPSource:
+            dumpIntermediateText(compileRequest, data, size, ".cpp");
+            break;
+
         case CodeGenTarget::SPIRVAssembly:
             dumpIntermediateText(compileRequest, data, size, ".spv.asm");
             break;
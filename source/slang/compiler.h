@@ -9,6 +9,7 @@
 #include "diagnostics.h"
 #include "name.h"
 #include "profile.h"
+#include "slang-file-system.h"
 #include "syntax.h"
 
 #include "../../slang.h"
@@ -21,6 +22,7 @@ namespace Slang
     class ProgramLayout;
     class PtrType;
     class TypeLayout;
+    struct TypeLayoutCache;
 
     enum class CompilerMode
     {
@@ -54,6 +56,7 @@ namespace Slang
         DXBytecodeAssembly  = SLANG_DXBC_ASM,
         DXIL                = SLANG_DXIL,
         DXILAssembly        = SLANG_DXIL_ASM,
+        CPPSource           = SLANG_CPP_SOURCE,
     };
 
     enum class ContainerFormat
@@ -304,6 +307,9 @@ namespace Slang
         // Path to output container to
         String containerOutputPath;
 
+        // Path to output flat reflection (for the first target) to
+        String flatReflectionOutputPath;
+
         // Directories to search for `#include` files or `import`ed modules
         List<SearchDirectory> searchDirectories;
 
@@ -320,6 +326,12 @@ namespace Slang
         // Types constructed by reflection API
         Dictionary<String, RefPtr<Type>> types;
 
+        // Type layouts shared between the targets of this request, for types
+        // that can't be cached on the session (implemented in type-layout.cpp)
+        TypeLayoutCache* typeLayoutCache = nullptr;
+        TypeLayoutCache* getTypeLayoutCache();
+        void destroyTypeLayoutCache();
+
         /// The layout to use for matrices by default (row/column major)
         MatrixLayoutMode defaultMatrixLayoutMode = kMatrixLayoutMode_ColumnMajor;
         MatrixLayoutMode getDefaultMatrixLayoutMode() { return defaultMatrixLayoutMode; }
@@ -340,6 +352,12 @@ namespace Slang
         // If true then generateIR will serialize out IR, and serialize back in again. Making 
         // serialization a bottleneck or firewall between the front end and the backend
         bool useSerialIRBottleneck = false; 
+        // The compression used for the serialized IR when useSerialIRBottleneck is set. Holds an
+        // IRSerialBinary::CompressionType (which can't be named here without a circular include)
+        uint32_t serialIRCompressionType = 0;
+        // If true (and the IR is serialized) check the container is the same when its chunks
+        // are written on a single thread and on as many threads as possible
+        bool shouldVerifySerialIRThreading = false;
 
         // How should `#line` directives be emitted (if at all)?
         LineDirectiveMode lineDirectiveMode = LineDirectiveMode::Default;
@@ -395,6 +413,10 @@ namespace Slang
         /// or a wrapped impl that makes fileSystem operate as fileSystemExt
         ComPtr<ISlangFileSystemExt> fileSystemExt;
 
+        /// Set up the file system used when one hasn't been set on the request. This is the
+        /// session's shared cache if enabled, otherwise a cache for just this request.
+        void setDefaultFileSystem();
+
         /// Load a file into memory using the configured file system.
         ///
         /// @param path The path to attempt to load from
@@ -404,6 +426,7 @@ namespace Slang
         SlangResult loadFile(String const& path, ISlangBlob** outBlob);
 
         CompileRequest(Session* session);
+        ~CompileRequest();
 
         RefPtr<Expr> parseTypeString(TranslationUnitRequest * translationUnit, String typeStr, RefPtr<Scope> scope);
 
@@ -559,6 +582,8 @@ namespace Slang
         ComPtr<ISlangSharedLibrary> sharedLibraries[int(SharedLibraryType::CountOf)];   ///< The loaded shared libraries
         SlangFuncPtr sharedLibraryFunctions[int(SharedLibraryFuncType::CountOf)];
 
+        RefPtr<CacheFileSystem> fileSystemCache;                                        ///< File system cache shared by requests that use the default file system (null if not enabled)
+
         Dictionary<int, RefPtr<Type>> builtinTypes;
         Dictionary<String, Decl*> magicDecls;
 
@@ -617,6 +642,12 @@ namespace Slang
         void destroyTypeCheckingCache();
         //
 
+        // Type layouts shared between requests, for types that only
+        // depend on the builtin modules (implemented in type-layout.cpp)
+        TypeLayoutCache* typeLayoutCache = nullptr;
+        TypeLayoutCache* getTypeLayoutCache();
+        void destroyTypeLayoutCache();
+
             /// Will try to load the library by specified name (using the set loader), if not one already available.
         ISlangSharedLibrary* getOrLoadSharedLibrary(SharedLibraryType type, DiagnosticSink* sink);
 
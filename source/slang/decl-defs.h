@@ -27,6 +27,11 @@ ABSTRACT_SYNTAX_CLASS(ContainerDecl, Decl)
     // Should be set to `false` if any members get added/remoed.
     bool memberDictionaryIsValid = false;
 
+    // The number of `Members` that have been added to `memberDictionary`.
+    // Members are only ever appended, so the dictionary is brought up to
+    // date by adding just the members after these.
+    UInt memberDictionaryCount = 0;
+
     // A list of transparent members, to be used in lookup
     // Note: this is only valid if `memberDictionaryIsValid` is true
     List<TransparentMemberInfo> transparentMembers;
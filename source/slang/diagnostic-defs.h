@@ -74,6 +74,7 @@ DIAGNOSTIC(    21, Error, expectedArgumentForOption, "expected an argument for c
 
 DIAGNOSTIC(    24, Error, unknownLineDirectiveMode, "unknown '#line' directive mode '$0'");
 DIAGNOSTIC(    25, Error, unknownFloatingPointMode, "unknown floating-point mode '$0'");
+DIAGNOSTIC(    26, Error, unknownSerialIRCompressionType, "unknown serialized IR compression type '$0'");
 
 DIAGNOSTIC(    30, Warning, sameStageSpecifiedMoreThanOnce, "the stage '$0' was specified more than once for entry point '$1'")
 DIAGNOSTIC(    31, Error, conflictingStagesForEntryPoint, "conflicting stages have been specified for entry point '$0'")
@@ -102,6 +103,8 @@ DIAGNOSTIC(    70, Error, cannotMatchOutputFileToEntryPoint, "the output path '$
 
 DIAGNOSTIC(    80, Error, duplicateOutputPathsForEntryPointAndTarget, "multiple output paths have been specified entry point '$0' on target '$1'")
 
+DIAGNOSTIC(    90, Error, cannotWriteFlatReflection, "cannot write flat reflection to '$0', as a size or binding doesn't fit in 32 bits")
+
 //
 // 1xxxx - Lexical anaylsis
 //
@@ -390,6 +393,8 @@ DIAGNOSTIC(40007, Internal, irValidationFailed, "IR validation failed: $0")
 
 DIAGNOSTIC(40008, Error, invalidLValueForRefParameter, "the form of this l-value argument is not valid for a `ref` parameter")
 
+DIAGNOSTIC(40009, Internal, serialIRRoundTripFailed, "serialized IR round trip failed: $0")
+
 // 41000 - IR-level validation issues
 
 DIAGNOSTIC(41000, Warning, unreachableCode, "unreachable code detected")
@@ -434,6 +439,9 @@ DIAGNOSTIC(51092, Error, stageDoesntHaveInputWorld, "'$0' doesn't appear to have
 
 DIAGNOSTIC(52000, Error, multiLevelBreakUnsupported, "control flow appears to require multi-level `break`, which Slang does not yet support");
 
+DIAGNOSTIC(52010, Error, groupSharedUnsupportedForCPPTarget, "'$0' is 'groupshared', which the C++ target doesn't support, as it runs the threads of a group one after another")
+DIAGNOSTIC(52011, Error, barrierUnsupportedForCPPTarget, "'$0' is a barrier, which the C++ target doesn't support, as it runs the threads of a group one after another")
+
 
 // 99999 - Internal compiler errors, and not-yet-classified diagnostics.
 
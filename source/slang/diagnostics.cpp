@@ -101,6 +101,7 @@ void printDiagnosticArg(StringBuilder& sb, CodeGenTarget val)
     CASE(DXBytecodeAssembly,    "dxbc-assembly");
     CASE(DXIL,                  "dxil");
     CASE(DXILAssembly,          "dxil-assembly");
+    CASE(CPPSource,             "cpp");
 #undef CASE
     }
 }
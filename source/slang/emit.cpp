@@ -1,6 +1,7 @@
 // emit.cpp
 #include "emit.h"
 
+#include "../core/slang-chunked-string-builder.h"
 #include "ir-insts.h"
 #include "ir-restructure.h"
 #include "ir-restructure-scoping.h"
@@ -85,14 +86,20 @@ struct SharedEmitContext
     // For example, `target` might be `GLSL`, while `finalTarget` might be `SPIRV`
     CodeGenTarget finalTarget;
 
-    // The string of code we've built so far
-    StringBuilder sb;
+    // The code we've built so far. It is held in chunks, so it isn't
+    // copied as it grows, and a prefix can be added once it is complete.
+    ChunkedStringBuilder sb;
 
     // Current source position for tracking purposes...
     HumaneSourceLoc loc;
     HumaneSourceLoc nextSourceLocation;
     bool needToUpdateSourceLocation;
 
+    // The humane locations of the instructions in the function body being
+    // emitted, which are looked up all at once. The `scratchData` of each
+    // instruction holds its index in the list plus one.
+    List<HumaneSourceLoc> instHumaneLocs;
+
     // For GLSL output, we can't emit traidtional `#line` directives
     // with a file path in them, so we maintain a map that associates
     // each path with a unique integer, and then we output those
@@ -149,6 +156,16 @@ struct SharedEmitContext
 
     Dictionary<IRInst*, UInt> mapIRValueToRayPayloadLocation;
     Dictionary<IRInst*, UInt> mapIRValueToCallablePayloadLocation;
+
+    // For C++ output, we record each shader parameter that gets
+    // declared as a global, so that the generated code can look
+    // them up by their original name (see `slang_findGlobalParam`).
+    struct CPPGlobalParam
+    {
+        String name;
+        String emittedName;
+    };
+    List<CPPGlobalParam> cppGlobalParams;
 };
 
 struct EmitContext
@@ -335,9 +352,7 @@ struct EmitVisitor
 
     void emitRawTextSpan(char const* textBegin, char const* textEnd)
     {
-        // TODO(tfoley): Need to make "corelib" not use `int` for pointer-sized things...
-        auto len = textEnd - textBegin;
-        context->shared->sb.Append(textBegin, len);
+        context->shared->sb.append(textBegin, textEnd);
     }
 
     void emitRawText(char const* text)
@@ -724,6 +739,19 @@ struct EmitVisitor
         advanceToSourceLocation(getSourceManager()->getHumaneLoc(sourceLocation));
     }
 
+    void advanceToSourceLocation(
+        IRInst* inst)
+    {
+        // Use the location looked up with the rest of the function body, if there is one
+        const UInt index = inst->scratchData;
+        if(index != 0)
+        {
+            advanceToSourceLocation(context->shared->instHumaneLocs[index - 1]);
+            return;
+        }
+        advanceToSourceLocation(inst->sourceLoc);
+    }
+
     void flushSourceLocationChange()
     {
         if(!context->shared->needToUpdateSourceLocation)
@@ -1972,6 +2000,10 @@ struct EmitVisitor
 
         auto matrixLayoutMode = targetReq->getDefaultMatrixLayoutMode();
 
+        // The C++ prelude has a single fixed layout for matrices.
+        if(isCPPTarget(context))
+            return;
+
         switch(context->shared->target)
         {
         default:
@@ -2303,17 +2335,29 @@ struct EmitVisitor
     }
 
     void emitIRSimpleValue(
-        EmitContext*    /*context*/,
+        EmitContext*    ctx,
         IRInst*         inst)
     {
         switch(inst->op)
         {
         case kIROp_IntLit:
             emit(((IRConstant*) inst)->value.intVal);
+
+            // C++ overload resolution and template argument deduction
+            // are sensitive to the exact type of a literal, so we
+            // spell out `uint` literals there.
+            if(isCPPTarget(ctx) && inst->getDataType()->op == kIROp_UIntType)
+            {
+                emit("u");
+            }
             break;
 
         case kIROp_FloatLit:
             Emit(((IRConstant*) inst)->value.floatVal);
+            if(isCPPTarget(ctx) && inst->getDataType()->op == kIROp_FloatType)
+            {
+                emit("f");
+            }
             break;
 
         case kIROp_BoolLit:
@@ -2335,6 +2379,13 @@ struct EmitVisitor
         return ctx->shared->target;
     }
 
+    // C++ output is generated with HLSL as the syntax target,
+    // so checks for C++-specific spellings look at the final target.
+    bool isCPPTarget(EmitContext* ctx)
+    {
+        return ctx->shared->finalTarget == CodeGenTarget::CPPSource;
+    }
+
     // Hack to allow IR emit for global constant to override behavior
     enum class IREmitMode
     {
@@ -2636,7 +2687,12 @@ struct EmitVisitor
             switch( getTarget(ctx) )
             {
             case CodeGenTarget::HLSL:
-                Emit("groupshared ");
+                // The generated C++ runs the threads of a group one
+                // after another, so an ordinary global is sufficient.
+                if(!isCPPTarget(ctx))
+                {
+                    Emit("groupshared ");
+                }
                 break;
 
             case CodeGenTarget::GLSL:
@@ -3383,6 +3439,29 @@ struct EmitVisitor
         }
     }
 
+    // If the intrinsic the user is calling is a generic,
+    // then the mangled name will have been set on the
+    // outer-most generic, and not on the leaf value
+    // (which is `func`), so we need to walk upwards to
+    // find it.
+    IRGlobalValue* getIntrinsicValueForName(IRFunc* func)
+    {
+        IRGlobalValue* valueForName = func;
+        for(;;)
+        {
+            auto parentBlock = as<IRBlock>(valueForName->parent);
+            if(!parentBlock)
+                break;
+
+            auto parentGeneric = as<IRGeneric>(parentBlock->parent);
+            if(!parentGeneric)
+                break;
+
+            valueForName = parentGeneric;
+        }
+        return valueForName;
+    }
+
     void emitIntrinsicCallExpr(
         EmitContext*    ctx,
         IRCall*         inst,
@@ -3421,29 +3500,9 @@ struct EmitVisitor
         // be better strategies (including just stuffing
         // a pointer to the original decl onto the callee).
 
-        // If the intrinsic the user is calling is a generic,
-        // then the mangled name will have been set on the
-        // outer-most generic, and not on the leaf value
-        // (which is `func` above), so we need to walk
-        // upwards to find it.
-        //
-        IRGlobalValue* valueForName = func;
-        for(;;)
-        {
-            auto parentBlock = as<IRBlock>(valueForName->parent);
-            if(!parentBlock)
-                break;
-
-            auto parentGeneric = as<IRGeneric>(parentBlock->parent);
-            if(!parentGeneric)
-                break;
-
-            valueForName = parentGeneric;
-        }
-
         // We will use the `UnmangleContext` utility to
         // help us split the original name into its pieces.
-        UnmangleContext um(getText(valueForName->mangledName));
+        UnmangleContext um(getText(getIntrinsicValueForName(func)->mangledName));
         um.startUnmangling();
 
         // We'll read through the qualified name of the
@@ -3571,6 +3630,29 @@ struct EmitVisitor
         }
     }
 
+    // Emit a reference to one of the swizzle helpers in the C++ prelude,
+    // with the element indices as template arguments (e.g., `slang_swizzle<2, 0>`).
+    template<typename T>
+    void emitCPPSwizzleTemplateName(
+        EmitContext*    /*ctx*/,
+        char const*     name,
+        T*              swizzle)
+    {
+        emit(name);
+        emit("<");
+        UInt elementCount = swizzle->getElementCount();
+        for (UInt ee = 0; ee < elementCount; ++ee)
+        {
+            IRInst* irElementIndex = swizzle->getElementIndex(ee);
+            SLANG_RELEASE_ASSERT(irElementIndex->op == kIROp_IntLit);
+            IRConstant* irConst = (IRConstant*)irElementIndex;
+
+            if (ee != 0) emit(", ");
+            emit(irConst->value.intVal);
+        }
+        emit(">");
+    }
+
     void emitIRInstExpr(
         EmitContext*    ctx,
         IRInst*         inst,
@@ -3887,10 +3969,22 @@ struct EmitVisitor
 
         case kIROp_swizzle:
             {
+                auto ii = (IRSwizzle*)inst;
+
+                // C++ has no syntax for multi-component swizzles,
+                // so the prelude provides a function template instead.
+                if(isCPPTarget(ctx) && ii->getElementCount() > 1)
+                {
+                    emitCPPSwizzleTemplateName(ctx, "slang_swizzle", ii);
+                    emit("(");
+                    emitIROperand(ctx, ii->getBase(), mode, kEOp_General);
+                    emit(")");
+                    break;
+                }
+
                 auto prec = kEOp_Postfix;
                 needClose = maybeEmitParens(outerPrec, prec);
 
-                auto ii = (IRSwizzle*)inst;
                 emitIROperand(ctx, ii->getBase(), mode, leftSide(outerPrec, prec));
                 emit(".");
                 UInt elementCount = ii->getElementCount();
@@ -3986,7 +4080,7 @@ struct EmitVisitor
             return;
         }
 
-        advanceToSourceLocation(inst->sourceLoc);
+        advanceToSourceLocation(inst);
 
         switch(inst->op)
         {
@@ -4052,6 +4146,17 @@ struct EmitVisitor
                 emitIROperand(ctx, inst->getOperand(0), mode, kEOp_General);
                 emit(";\n");
 
+                if(isCPPTarget(ctx) && ii->getElementCount() > 1)
+                {
+                    emitCPPSwizzleTemplateName(ctx, "slang_swizzle_store", ii);
+                    emit("(");
+                    emitIROperand(ctx, inst, mode, kEOp_General);
+                    emit(", ");
+                    emitIROperand(ctx, inst->getOperand(1), mode, kEOp_General);
+                    emit(");\n");
+                    break;
+                }
+
                 auto subscriptOuter = kEOp_General;
                 auto subscriptPrec = kEOp_Postfix;
                 bool needCloseSubscript = maybeEmitParens(subscriptOuter, subscriptPrec);
@@ -4081,12 +4186,22 @@ struct EmitVisitor
 
         case kIROp_SwizzledStore:
             {
+                auto ii = cast<IRSwizzledStore>(inst);
+                if(isCPPTarget(ctx) && ii->getElementCount() > 1)
+                {
+                    emitCPPSwizzleTemplateName(ctx, "slang_swizzle_store", ii);
+                    emit("(");
+                    emitIROperand(ctx, ii->getDest(), mode, kEOp_General);
+                    emit(", ");
+                    emitIROperand(ctx, ii->getSource(), mode, kEOp_General);
+                    emit(");\n");
+                    break;
+                }
+
                 auto subscriptOuter = kEOp_General;
                 auto subscriptPrec = kEOp_Postfix;
                 bool needCloseSubscript = maybeEmitParens(subscriptOuter, subscriptPrec);
 
-
-                auto ii = cast<IRSwizzledStore>(inst);
                 emitIROperand(ctx, ii->getDest(), mode, leftSide(subscriptOuter, subscriptPrec));
                 emit(".");
                 UInt elementCount = ii->getElementCount();
@@ -4140,6 +4255,8 @@ struct EmitVisitor
         default:
             return;
         }
+        if(isCPPTarget(ctx))
+            return;
 
         if (auto semanticDecoration = inst->findDecoration<IRSemanticDecoration>())
         {
@@ -4181,6 +4298,9 @@ struct EmitVisitor
         IRInst*         inst,
         char const*     uniformSemanticSpelling = "register")
     {
+        if(isCPPTarget(ctx))
+            return;
+
         auto layout = getVarLayout(ctx, inst);
         if (layout)
         {
@@ -4259,7 +4379,7 @@ struct EmitVisitor
                     // of terminators are simple enough that we just fold
                     // them into the current block.
                     //
-                    advanceToSourceLocation(terminator->sourceLoc);
+                    advanceToSourceLocation(terminator);
                     switch(terminator->op)
                     {
                     default:
@@ -4394,7 +4514,7 @@ struct EmitVisitor
                         {
                         case kIRLoopControl_Unroll:
                             // Note: loop unrolling control is only available in HLSL, not GLSL
-                            if(getTarget(ctx) == CodeGenTarget::HLSL)
+                            if(getTarget(ctx) == CodeGenTarget::HLSL && !isCPPTarget(ctx))
                             {
                                 emit("[unroll]\n");
                             }
@@ -4816,6 +4936,11 @@ struct EmitVisitor
         EmitContext*        ctx,
         EntryPointLayout*   entryPointLayout)
     {
+        // For C++ the thread-group size is used by the generated
+        // dispatch function instead (see `emitCPPDispatchFunc`).
+        if(isCPPTarget(ctx))
+            return;
+
         switch(getTarget(ctx))
         {
         case CodeGenTarget::HLSL:
@@ -4877,9 +5002,56 @@ struct EmitVisitor
         //
         fixValueScoping(regionTree);
 
+        // Look up the humane locations of all of the instructions at
+        // once, rather than one at a time as they are emitted. They
+        // are mostly in the same view (and in order), so this saves
+        // searching for the view of each one.
+        //
+        auto mode = context->shared->entryPoint->compileRequest->lineDirectiveMode;
+        if(mode != LineDirectiveMode::None)
+        {
+            lookUpInstHumaneLocs(code);
+        }
+
         // Now emit high-level code from that structured region tree.
         //
         emitRegionTree(ctx, regionTree);
+
+        if(mode != LineDirectiveMode::None)
+        {
+            clearInstHumaneLocs(code);
+        }
+    }
+
+    void lookUpInstHumaneLocs(
+        IRGlobalValueWithCode*  code)
+    {
+        List<SourceLoc> sourceLocs;
+        for(auto block : code->getBlocks())
+        {
+            for(auto inst : block->getChildren())
+            {
+                sourceLocs.Add(inst->sourceLoc);
+                inst->scratchData = uint32_t(sourceLocs.Count());
+            }
+        }
+
+        auto& instHumaneLocs = context->shared->instHumaneLocs;
+        instHumaneLocs.SetSize(sourceLocs.Count());
+        getSourceManager()->getHumaneLocs(sourceLocs.Buffer(), sourceLocs.Count(), instHumaneLocs.Buffer());
+    }
+
+    void clearInstHumaneLocs(
+        IRGlobalValueWithCode*  code)
+    {
+        for(auto block : code->getBlocks())
+        {
+            for(auto inst : block->getChildren())
+            {
+                inst->scratchData = 0;
+            }
+        }
+        context->shared->instHumaneLocs.Clear();
     }
 
     void emitIRSimpleFunc(
@@ -4976,6 +5148,18 @@ struct EmitVisitor
         IRType*         type,
         String const&   name)
     {
+        // In C++, all of `out`, `inout` and by-reference
+        // parameters are passed as references.
+        //
+        if(isCPPTarget(ctx))
+        {
+            if( auto ptrType = as<IRPtrTypeBase>(type))
+            {
+                emitIRType(ctx, ptrType->getValueType(), "&" + name);
+                return;
+            }
+        }
+
         // An `out` or `inout` parameter will have been
         // encoded as a parameter of pointer type, so
         // we need to decode that here.
@@ -5865,11 +6049,69 @@ struct EmitVisitor
         emit("};\n");
     }
 
+    // Record a shader parameter declared in the C++ output, so that it
+    // can be found by `slang_findGlobalParam`.
+    void addCPPGlobalParam(
+        EmitContext*    ctx,
+        IRInst*         inst)
+    {
+        auto nameHintDecoration = inst->findDecoration<IRNameHintDecoration>();
+        if(!nameHintDecoration)
+            return;
+
+        SharedEmitContext::CPPGlobalParam param;
+        param.name = nameHintDecoration->name->text;
+        param.emittedName = getIRName(inst);
+        ctx->shared->cppGlobalParams.Add(param);
+    }
+
+    void emitCPPParameterGroup(
+        EmitContext*                    ctx,
+        IRGlobalVar*                    varDecl,
+        IRUniformParameterGroupType*    type)
+    {
+        // The C++ output has no notion of a constant buffer, so the
+        // fields of a `cbuffer` become ordinary globals (which is how
+        // code that uses them will refer to them), while a parameter
+        // block is a single global of its element type.
+        //
+        auto elementType = type->getElementType();
+        auto structType = as<IRStructType>(elementType);
+        if(structType && !as<IRParameterBlockType>(type))
+        {
+            for(auto ff : structType->getFields())
+            {
+                auto fieldKey = ff->getKey();
+                auto fieldType = ff->getFieldType();
+                if(as<IRVoidType>(fieldType))
+                    continue;
+
+                emitIRType(ctx, fieldType, getIRName(fieldKey));
+                emit(";\n");
+
+                addCPPGlobalParam(ctx, fieldKey);
+            }
+        }
+        else
+        {
+            emitIRType(ctx, elementType, getIRName(varDecl));
+            emit(";\n");
+
+            addCPPGlobalParam(ctx, varDecl);
+        }
+    }
+
     void emitIRParameterGroup(
         EmitContext*                    ctx,
         IRGlobalVar*                    varDecl,
         IRUniformParameterGroupType*    type)
     {
+        if(isCPPTarget(ctx))
+        {
+            emitCPPParameterGroup(ctx, varDecl, type);
+            return;
+        }
+
         switch (ctx->shared->target)
         {
         case CodeGenTarget::HLSL:
@@ -6083,6 +6325,11 @@ struct EmitVisitor
         }
 
         emit(";\n\n");
+
+        if(layout && isCPPTarget(ctx) && !as<IRGroupSharedRate>(varDecl->getRate()))
+        {
+            addCPPGlobalParam(ctx, varDecl);
+        }
     }
 
     void emitIRGlobalConstantInitializer(
@@ -6146,7 +6393,7 @@ struct EmitVisitor
         EmitContext*    ctx,
         IRInst*         inst)
     {
-        advanceToSourceLocation(inst->sourceLoc);
+        advanceToSourceLocation(inst);
 
         switch(inst->op)
         {
@@ -6339,7 +6586,261 @@ struct EmitVisitor
         List<EmitAction> actions;
 
         computeIREmitActions(module, actions);
+
+        if(isCPPTarget(ctx))
+        {
+            emitCPPModule(ctx, module, actions);
+            return;
+        }
+
+        executeIREmitActions(ctx, actions);
+    }
+
+    // Emit the C++ code for a module. The declarations themselves are
+    // emitted just as for HLSL, but inside a namespace (where the names
+    // from `slang-cpp-prelude.h` are found ahead of any in the global
+    // namespace), followed by the `extern "C"` functions that a host
+    // uses to bind parameters and run the kernel.
+    void emitCPPModule(
+        EmitContext*                ctx,
+        IRModule*                   module,
+        List<EmitAction> const&     actions)
+    {
+        checkCPPGroupSync(ctx, module->getModuleInst());
+        if(ctx->getSink()->GetErrorCount() != 0)
+            return;
+
+        emit("#include \"slang-cpp-prelude.h\"\n\n");
+        emit("namespace SlangCPP {\n");
+        emit("namespace Kernel {\n\n");
+
         executeIREmitActions(ctx, actions);
+
+        bool hasEntryPoint = false;
+        for(auto inst : module->getGlobalInsts())
+        {
+            auto func = as<IRFunc>(inst);
+            if(!func)
+                continue;
+
+            if(auto entryPointLayout = asEntryPoint(func))
+            {
+                emitCPPDispatchFunc(ctx, func, entryPointLayout);
+                hasEntryPoint = true;
+                break;
+            }
+        }
+
+        emit("} // namespace Kernel\n");
+        emit("} // namespace SlangCPP\n\n");
+
+        emit("extern \"C\" SLANG_CPP_EXPORT void* slang_findGlobalParam(char const* name)\n{\n");
+        indent();
+        for(auto param : ctx->shared->cppGlobalParams)
+        {
+            emit("if(strcmp(name, \"");
+            emit(param.name);
+            emit("\") == 0) return &SlangCPP::Kernel::");
+            emit(param.emittedName);
+            emit(";\n");
+        }
+        emit("return 0;\n");
+        dedent();
+        emit("}\n");
+
+        if(hasEntryPoint)
+        {
+            emit("\nextern \"C\" SLANG_CPP_EXPORT void slang_getThreadGroupSize(uint32_t* outSize)\n{\n");
+            emit("    SlangCPP::Kernel::getThreadGroupSize(outSize);\n");
+            emit("}\n\n");
+            emit("extern \"C\" SLANG_CPP_EXPORT void slang_dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)\n{\n");
+            emit("    SlangCPP::Kernel::dispatch(groupCountX, groupCountY, groupCountZ);\n");
+            emit("}\n");
+        }
+    }
+
+    // The threads of a group are run one after another (see
+    // `emitCPPDispatchFunc`), so they can't share data through
+    // `groupshared` memory or wait for each other at a barrier.
+    // Rather than emit code that compiles but gives the wrong
+    // results, diagnose any use of either.
+    void checkCPPGroupSync(
+        EmitContext*    ctx,
+        IRParentInst*   parent)
+    {
+        for(auto inst : parent->getChildren())
+        {
+            switch(inst->op)
+            {
+            case kIROp_GlobalVar:
+                if(as<IRGroupSharedRate>(inst->getRate()))
+                {
+                    auto nameHintDecoration = inst->findDecoration<IRNameHintDecoration>();
+                    ctx->getSink()->diagnose(inst->sourceLoc, Diagnostics::groupSharedUnsupportedForCPPTarget, nameHintDecoration ? nameHintDecoration->name->text : getIRName(inst));
+                }
+                break;
+
+            case kIROp_Call:
+                if(auto func = asTargetIntrinsic(ctx, inst->getOperand(0)))
+                {
+                    UnmangleContext um(getText(getIntrinsicValueForName(func)->mangledName));
+                    um.startUnmangling();
+                    auto name = um.readSimpleName();
+                    if(name.endsWith("MemoryBarrier") || name.endsWith("MemoryBarrierWithGroupSync"))
+                    {
+                        ctx->getSink()->diagnose(inst->sourceLoc, Diagnostics::barrierUnsupportedForCPPTarget, name);
+                    }
+                }
+                break;
+
+            default:
+                break;
+            }
+
+            if(auto childParent = as<IRParentInst>(inst))
+            {
+                checkCPPGroupSync(ctx, childParent);
+            }
+        }
+    }
+
+    // Emit `dispatch`, which runs every thread of a grid of thread
+    // groups by calling the entry point in a loop, passing in the
+    // system values that its parameters ask for. The threads of a
+    // group run one after another, so group barriers are not
+    // supported.
+    void emitCPPDispatchFunc(
+        EmitContext*        ctx,
+        IRFunc*             func,
+        EntryPointLayout*   entryPointLayout)
+    {
+        static const UInt kAxisCount = 3;
+        UInt sizeAlongAxis[kAxisCount];
+        spReflectionEntryPoint_getComputeThreadGroupSize(
+            (SlangReflectionEntryPoint*)entryPointLayout,
+            kAxisCount,
+            &sizeAlongAxis[0]);
+
+        emit("void getThreadGroupSize(uint32_t* outSize)\n{\n");
+        indent();
+        for(UInt ii = 0; ii < kAxisCount; ++ii)
+        {
+            emit("outSize[");
+            Emit(ii);
+            emit("] = ");
+            Emit(sizeAlongAxis[ii]);
+            emit(";\n");
+        }
+        dedent();
+        emit("}\n\n");
+
+        emit("void dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)\n{\n");
+        indent();
+        emit("for(uint32_t groupZ = 0; groupZ < groupCountZ; ++groupZ)\n");
+        emit("for(uint32_t groupY = 0; groupY < groupCountY; ++groupY)\n");
+        emit("for(uint32_t groupX = 0; groupX < groupCountX; ++groupX)\n");
+        emit("for(uint32_t threadZ = 0; threadZ < ");
+        Emit(sizeAlongAxis[2]);
+        emit("; ++threadZ)\n");
+        emit("for(uint32_t threadY = 0; threadY < ");
+        Emit(sizeAlongAxis[1]);
+        emit("; ++threadY)\n");
+        emit("for(uint32_t threadX = 0; threadX < ");
+        Emit(sizeAlongAxis[0]);
+        emit("; ++threadX)\n{\n");
+        indent();
+        emit(getIRFuncName(func));
+        emit("(");
+        auto firstParam = func->getFirstParam();
+        for(auto pp = firstParam; pp; pp = pp->getNextParam())
+        {
+            if(pp != firstParam)
+                emit(", ");
+            emitCPPSystemValueArg(ctx, pp, sizeAlongAxis);
+        }
+        emit(");\n");
+
+        dedent();
+        emit("}\n");
+        dedent();
+        emit("}\n\n");
+    }
+
+    // Emit the argument for an entry point parameter in the loop
+    // generated by `emitCPPDispatchFunc`, built from the loop counters.
+    void emitCPPSystemValueArg(
+        EmitContext*    ctx,
+        IRParam*        param,
+        UInt const*     sizeAlongAxis)
+    {
+        String semanticName;
+        if(auto varLayout = getVarLayout(ctx, param))
+        {
+            if(varLayout->flags & VarLayoutFlag::HasSemantic)
+                semanticName = varLayout->semanticName.ToUpper();
+        }
+
+        char const* const kGroupNames[] = { "groupX", "groupY", "groupZ" };
+        char const* const kThreadNames[] = { "threadX", "threadY", "threadZ" };
+
+        // The value of each component of the system value, with
+        // `SV_GroupIndex` treated as a vector of one element.
+        List<String> components;
+        if(semanticName == "SV_DISPATCHTHREADID")
+        {
+            for(UInt ii = 0; ii < 3; ++ii)
+            {
+                StringBuilder sb;
+                sb << "(" << kGroupNames[ii] << " * " << sizeAlongAxis[ii] << "u + " << kThreadNames[ii] << ")";
+                components.Add(sb.ProduceString());
+            }
+        }
+        else if(semanticName == "SV_GROUPID")
+        {
+            for(UInt ii = 0; ii < 3; ++ii)
+                components.Add(kGroupNames[ii]);
+        }
+        else if(semanticName == "SV_GROUPTHREADID")
+        {
+            for(UInt ii = 0; ii < 3; ++ii)
+                components.Add(kThreadNames[ii]);
+        }
+        else if(semanticName == "SV_GROUPINDEX")
+        {
+            StringBuilder sb;
+            sb << "((threadZ * " << sizeAlongAxis[1] << "u + threadY) * " << sizeAlongAxis[0] << "u + threadX)";
+            components.Add(sb.ProduceString());
+        }
+        else
+        {
+            // Any other kind of entry point parameter would need
+            // to be supplied by the host, which isn't supported yet.
+            emit("\n#error \"unsupported entry point parameter for C++ output: ");
+            emit(getIRName(param));
+            emit("\"\n");
+            return;
+        }
+
+        auto paramType = param->getDataType();
+        if(auto vectorType = as<IRVectorType>(paramType))
+        {
+            emitIRType(ctx, vectorType);
+            emit("(");
+            auto elementCount = GetIntVal(vectorType->getElementCount());
+            for(IRIntegerValue ee = 0; ee < elementCount; ++ee)
+            {
+                if(ee != 0) emit(", ");
+                emit(ee < (IRIntegerValue)components.Count() ? components[(UInt)ee] : String("0"));
+            }
+            emit(")");
+        }
+        else
+        {
+            emit("(");
+            emitIRType(ctx, paramType);
+            emit(") ");
+            emit(components[0]);
+        }
     }
 };
 
@@ -6586,8 +7087,9 @@ String emitEntryPoint(
         break;
     }
 
-    String code = sharedContext.sb.ProduceString();
-    sharedContext.sb.Clear();
+    // Set aside the code emitted so far, so the prefix can be emitted
+    ChunkedStringBuilder code;
+    code.appendChunks(sharedContext.sb);
 
     // Now that we've emitted the code for all the declaratiosn in the file,
     // it is time to stich together the final output.
@@ -6597,19 +7099,14 @@ String emitEntryPoint(
 
     visitor.emitLayoutDirectives(targetRequest);
 
-    String prefix = sharedContext.sb.ProduceString();
-
-
-    StringBuilder finalResultBuilder;
-    finalResultBuilder << prefix;
-
-    finalResultBuilder << sharedContext.extensionUsageTracker.glslExtensionRequireLines.ProduceString();
-
-    finalResultBuilder << code;
-
-    String finalResult = finalResultBuilder.ProduceString();
+    // The prefix and extension lines go in front of the code by splicing
+    // chunks, so the code is only copied once, when it is made contiguous
+    // for the downstream compiler or output blob
+    ChunkedStringBuilder& finalResultBuilder = sharedContext.sb;
+    finalResultBuilder.append(sharedContext.extensionUsageTracker.glslExtensionRequireLines);
+    finalResultBuilder.appendChunks(code);
 
-    return finalResult;
+    return finalResultBuilder.produceString();
 }
 
 } // namespace Slang
@@ -0,0 +1,467 @@
+// flat-reflection.cpp
+#include "reflection.h"
+
+#include "../../slang-flat-reflection.h"
+
+#include "type-layout.h"
+
+#include <stddef.h>
+
+// Writes the flat reflection format (see `slang-flat-reflection.h`).
+//
+// The blob is filled in through the public reflection API, so that
+// whatever the API would report (including its "do what I mean" handling
+// of parameter categories) is exactly what a reader of the blob sees.
+
+namespace Slang {
+
+namespace flat = slang::flat;
+
+namespace { // anonymous
+
+struct FlatReflectionWriter
+{
+    typedef uint32_t Offset;
+
+        /// Allocate count zeroed items, returning their offset in the blob
+    template <typename T>
+    Offset allocate(UInt count = 1)
+    {
+        // Everything in the format is 4 byte aligned
+        SLANG_COMPILE_TIME_ASSERT(alignof(T) <= 4);
+        const UInt oldCount = m_data.Count();
+        const UInt offset = (oldCount + 3) & ~UInt(3);
+        const UInt size = sizeof(T) * count;
+        m_data.SetSize(offset + size);
+        // Zero the padding too, so the output doesn't depend on uninitialized memory
+        memset(m_data.Buffer() + oldCount, 0, offset + size - oldCount);
+        return toOffset(offset);
+    }
+
+        /// Narrow a value to the 32 bits the format stores it in. If it doesn't fit the blob can't be written.
+    uint32_t narrow(UInt64 value)
+    {
+        if (value > 0xffffffff)
+        {
+            m_isOverflowed = true;
+        }
+        return uint32_t(value);
+    }
+
+        /// Narrow a position in the blob to an offset. Ptrs are stored relative and signed, so the blob is
+        /// limited to 2GB.
+    Offset toOffset(UInt value)
+    {
+        if (value > 0x7fffffff)
+        {
+            m_isOverflowed = true;
+        }
+        return Offset(value);
+    }
+
+        /// Get an item in the blob. Any allocation can move the blob, so the pointer is only valid until the next one.
+    template <typename T>
+    T* get(Offset offset) { return (T*)(m_data.Buffer() + offset); }
+
+        /// Set the flat::Ptr at offset to reference target (or to null if target is 0)
+    void setPtr(Offset offset, Offset target)
+    {
+        get<int32_t>(offset)[0] = target ? int32_t(target) - int32_t(offset) : 0;
+    }
+
+        /// Allocate the items of the flat::Array at arrayOffset
+    template <typename T>
+    Offset allocateArray(Offset arrayOffset, UInt count)
+    {
+        if (count == 0)
+        {
+            return 0;
+        }
+        const Offset itemsOffset = allocate<T>(count);
+        get<uint32_t>(arrayOffset)[0] = narrow(count);
+        setPtr(arrayOffset + offsetof(flat::Array<T>, items), itemsOffset);
+        return itemsOffset;
+    }
+
+        /// Set the flat::Array<flat::Ptr> at arrayOffset to reference targets
+    void setPtrArray(Offset arrayOffset, const List<Offset>& targets)
+    {
+        const Offset itemsOffset = allocateArray<flat::Ptr<void>>(arrayOffset, targets.Count());
+        for (UInt ii = 0; ii < targets.Count(); ++ii)
+        {
+            setPtr(itemsOffset + toOffset(ii * sizeof(flat::Ptr<void>)), targets[ii]);
+        }
+    }
+
+    Offset writeString(char const* text);
+    Offset writeType(SlangReflectionType* type);
+    Offset writeVariable(SlangReflectionVariable* variable);
+    Offset writeTypeLayout(SlangReflectionTypeLayout* typeLayout);
+    Offset writeVarLayout(SlangReflectionVariableLayout* varLayout);
+    Offset writeTypeParameter(SlangReflectionTypeParameter* typeParameter);
+    Offset writeEntryPoint(SlangReflectionEntryPoint* entryPoint);
+    void writeProgram(SlangReflection* program);
+
+    // Map from each reflection object (or string) that has been written to its offset, so
+    // objects referenced from several places are only written once
+    Dictionary<void*, Offset> m_objectOffsets;
+    Dictionary<String, Offset> m_stringOffsets;
+
+    // Set if any value didn't fit in the format
+    bool m_isOverflowed = false;
+
+    List<uint8_t> m_data;
+};
+
+} // anonymous
+
+FlatReflectionWriter::Offset FlatReflectionWriter::writeString(char const* text)
+{
+    if (!text)
+    {
+        return 0;
+    }
+
+    Offset offset;
+    if (m_stringOffsets.TryGetValue(text, offset))
+    {
+        return offset;
+    }
+
+    const UInt size = ::strlen(text) + 1;
+    offset = toOffset(m_data.Count());
+    m_data.AddRange((const uint8_t*)text, size);
+
+    m_stringOffsets.Add(text, offset);
+    return offset;
+}
+
+FlatReflectionWriter::Offset FlatReflectionWriter::writeType(SlangReflectionType* type)
+{
+    if (!type)
+    {
+        return 0;
+    }
+
+    Offset offset;
+    if (m_objectOffsets.TryGetValue(type, offset))
+    {
+        return offset;
+    }
+    // Add before writing anything the type references, as it may reference itself
+    offset = allocate<flat::TypeReflection>();
+    m_objectOffsets.Add(type, offset);
+
+    const Offset nameOffset = writeString(spReflectionType_GetName(type));
+    const Offset elementTypeOffset = writeType(spReflectionType_GetElementType(type));
+    const Offset resourceResultTypeOffset = writeType(spReflectionType_GetResourceResultType(type));
+
+    List<Offset> fieldOffsets;
+    const unsigned fieldCount = spReflectionType_GetFieldCount(type);
+    for (unsigned ii = 0; ii < fieldCount; ++ii)
+    {
+        fieldOffsets.Add(writeVariable(spReflectionType_GetFieldByIndex(type, ii)));
+    }
+
+    {
+        flat::TypeReflection* dst = get<flat::TypeReflection>(offset);
+        dst->kind = uint32_t(spReflectionType_GetKind(type));
+        dst->scalarType = uint32_t(spReflectionType_GetScalarType(type));
+        dst->elementCount = narrow(spReflectionType_GetElementCount(type));
+        dst->rowCount = uint32_t(spReflectionType_GetRowCount(type));
+        dst->columnCount = uint32_t(spReflectionType_GetColumnCount(type));
+        dst->resourceShape = uint32_t(spReflectionType_GetResourceShape(type));
+        dst->resourceAccess = uint32_t(spReflectionType_GetResourceAccess(type));
+    }
+
+    setPtr(offset + offsetof(flat::TypeReflection, name), nameOffset);
+    setPtr(offset + offsetof(flat::TypeReflection, elementType), elementTypeOffset);
+    setPtr(offset + offsetof(flat::TypeReflection, resourceResultType), resourceResultTypeOffset);
+    setPtrArray(offset + offsetof(flat::TypeReflection, fields), fieldOffsets);
+    return offset;
+}
+
+FlatReflectionWriter::Offset FlatReflectionWriter::writeVariable(SlangReflectionVariable* variable)
+{
+    if (!variable)
+    {
+        return 0;
+    }
+
+    Offset offset;
+    if (m_objectOffsets.TryGetValue(variable, offset))
+    {
+        return offset;
+    }
+    offset = allocate<flat::VariableReflection>();
+    m_objectOffsets.Add(variable, offset);
+
+    const Offset nameOffset = writeString(spReflectionVariable_GetName(variable));
+    const Offset typeOffset = writeType(spReflectionVariable_GetType(variable));
+
+    uint32_t modifiers = 0;
+    if (spReflectionVariable_FindModifier(variable, SLANG_MODIFIER_SHARED))
+    {
+        modifiers |= 1u << SLANG_MODIFIER_SHARED;
+    }
+    get<flat::VariableReflection>(offset)->modifiers = modifiers;
+
+    setPtr(offset + offsetof(flat::VariableReflection, name), nameOffset);
+    setPtr(offset + offsetof(flat::VariableReflection, type), typeOffset);
+    return offset;
+}
+
+FlatReflectionWriter::Offset FlatReflectionWriter::writeTypeLayout(SlangReflectionTypeLayout* typeLayout)
+{
+    if (!typeLayout)
+    {
+        return 0;
+    }
+
+    Offset offset;
+    if (m_objectOffsets.TryGetValue(typeLayout, offset))
+    {
+        return offset;
+    }
+    offset = allocate<flat::TypeLayoutReflection>();
+    m_objectOffsets.Add(typeLayout, offset);
+
+    const Offset typeOffset = writeType(spReflectionTypeLayout_GetType(typeLayout));
+
+    // The API indexes the fields of the layout, so that is what is counted (the type
+    // can have fields that aren't laid out, such as static ones)
+    List<Offset> fieldOffsets;
+    if (auto structTypeLayout = dynamic_cast<StructTypeLayout*>((TypeLayout*)typeLayout))
+    {
+        const unsigned fieldCount = unsigned(structTypeLayout->fields.Count());
+        for (unsigned ii = 0; ii < fieldCount; ++ii)
+        {
+            fieldOffsets.Add(writeVarLayout(spReflectionTypeLayout_GetFieldByIndex(typeLayout, ii)));
+        }
+    }
+
+    const Offset elementTypeLayoutOffset = writeTypeLayout(spReflectionTypeLayout_GetElementTypeLayout(typeLayout));
+    const Offset elementVarLayoutOffset = writeVarLayout(spReflectionTypeLayout_GetElementVarLayout(typeLayout));
+
+    {
+        flat::TypeLayoutReflection* dst = get<flat::TypeLayoutReflection>(offset);
+        dst->matrixLayoutMode = uint32_t(spReflectionTypeLayout_GetMatrixLayoutMode(typeLayout));
+        // Stored signed, as -1 means it isn't a generic parameter
+        const SlangInt genericParamIndex = spReflectionTypeLayout_getGenericParamIndex(typeLayout);
+        if (genericParamIndex < -1 || genericParamIndex > 0x7fffffff)
+        {
+            m_isOverflowed = true;
+        }
+        dst->genericParamIndex = int32_t(genericParamIndex);
+    }
+
+    {
+        const unsigned categoryCount = spReflectionTypeLayout_GetCategoryCount(typeLayout);
+        const Offset categoriesOffset = allocateArray<uint32_t>(offset + offsetof(flat::TypeLayoutReflection, categories), categoryCount);
+        for (unsigned ii = 0; ii < categoryCount; ++ii)
+        {
+            get<uint32_t>(categoriesOffset)[ii] = uint32_t(spReflectionTypeLayout_GetCategoryByIndex(typeLayout, ii));
+        }
+    }
+
+    // Only the categories with a non zero size or stride are stored, as a look up for any other is 0
+    List<flat::CategoryValue> sizes;
+    List<flat::CategoryValue> elementStrides;
+    for (int category = 0; category < SLANG_PARAMETER_CATEGORY_COUNT; ++category)
+    {
+        if (const size_t size = spReflectionTypeLayout_GetSize(typeLayout, SlangParameterCategory(category)))
+        {
+            flat::CategoryValue value = { uint32_t(category), narrow(size) };
+            sizes.Add(value);
+        }
+        if (const size_t stride = spReflectionTypeLayout_GetElementStride(typeLayout, SlangParameterCategory(category)))
+        {
+            flat::CategoryValue value = { uint32_t(category), narrow(stride) };
+            elementStrides.Add(value);
+        }
+    }
+    if (const Offset sizesOffset = allocateArray<flat::CategoryValue>(offset + offsetof(flat::TypeLayoutReflection, sizes), sizes.Count()))
+    {
+        memcpy(get<flat::CategoryValue>(sizesOffset), sizes.Buffer(), sizeof(flat::CategoryValue) * sizes.Count());
+    }
+    if (const Offset stridesOffset = allocateArray<flat::CategoryValue>(offset + offsetof(flat::TypeLayoutReflection, elementStrides), elementStrides.Count()))
+    {
+        memcpy(get<flat::CategoryValue>(stridesOffset), elementStrides.Buffer(), sizeof(flat::CategoryValue) * elementStrides.Count());
+    }
+
+    setPtr(offset + offsetof(flat::TypeLayoutReflection, type), typeOffset);
+    setPtrArray(offset + offsetof(flat::TypeLayoutReflection, fields), fieldOffsets);
+    setPtr(offset + offsetof(flat::TypeLayoutReflection, elementTypeLayout), elementTypeLayoutOffset);
+    setPtr(offset + offsetof(flat::TypeLayoutReflection, elementVarLayout), elementVarLayoutOffset);
+    return offset;
+}
+
+FlatReflectionWriter::Offset FlatReflectionWriter::writeVarLayout(SlangReflectionVariableLayout* varLayout)
+{
+    if (!varLayout)
+    {
+        return 0;
+    }
+
+    Offset offset;
+    if (m_objectOffsets.TryGetValue(varLayout, offset))
+    {
+        return offset;
+    }
+    offset = allocate<flat::VariableLayoutReflection>();
+    m_objectOffsets.Add(varLayout, offset);
+
+    SlangReflectionTypeLayout* typeLayout = spReflectionVariableLayout_GetTypeLayout(varLayout);
+
+    const Offset variableOffset = writeVariable(spReflectionVariableLayout_GetVariable(varLayout));
+    const Offset typeLayoutOffset = writeTypeLayout(typeLayout);
+    const Offset semanticNameOffset = writeString(spReflectionVariableLayout_GetSemanticName(varLayout));
+
+    {
+        flat::VariableLayoutReflection* dst = get<flat::VariableLayoutReflection>(offset);
+        dst->semanticIndex = narrow(spReflectionVariableLayout_GetSemanticIndex(varLayout));
+        dst->stage = uint32_t(spReflectionVariableLayout_getStage(varLayout));
+    }
+
+    // A binding is stored for each of the type layout's categories (even if it's at offset 0 in space 0, so
+    // it can be told apart from not being bound at all), and for any other category the API reports
+    // a non zero offset or space for
+    List<flat::Binding> bindings;
+    for (int category = 0; category < SLANG_PARAMETER_CATEGORY_COUNT; ++category)
+    {
+        const size_t bindingOffset = spReflectionVariableLayout_GetOffset(varLayout, SlangParameterCategory(category));
+        const size_t bindingSpace = spReflectionVariableLayout_GetSpace(varLayout, SlangParameterCategory(category));
+
+        bool isUsed = (bindingOffset != 0 || bindingSpace != 0);
+        if (!isUsed && typeLayout)
+        {
+            const unsigned categoryCount = spReflectionTypeLayout_GetCategoryCount(typeLayout);
+            for (unsigned ii = 0; ii < categoryCount && !isUsed; ++ii)
+            {
+                isUsed = (spReflectionTypeLayout_GetCategoryByIndex(typeLayout, ii) == SlangParameterCategory(category));
+            }
+        }
+
+        if (isUsed)
+        {
+            flat::Binding binding = { uint32_t(category), narrow(bindingOffset), narrow(bindingSpace) };
+            bindings.Add(binding);
+        }
+    }
+    if (const Offset bindingsOffset = allocateArray<flat::Binding>(offset + offsetof(flat::VariableLayoutReflection, bindings), bindings.Count()))
+    {
+        memcpy(get<flat::Binding>(bindingsOffset), bindings.Buffer(), sizeof(flat::Binding) * bindings.Count());
+    }
+
+    setPtr(offset + offsetof(flat::VariableLayoutReflection, variable), variableOffset);
+    setPtr(offset + offsetof(flat::VariableLayoutReflection, typeLayout), typeLayoutOffset);
+    setPtr(offset + offsetof(flat::VariableLayoutReflection, semanticName), semanticNameOffset);
+    return offset;
+}
+
+FlatReflectionWriter::Offset FlatReflectionWriter::writeTypeParameter(SlangReflectionTypeParameter* typeParameter)
+{
+    const Offset offset = allocate<flat::TypeParameterReflection>();
+
+    const Offset nameOffset = writeString(spReflectionTypeParameter_GetName(typeParameter));
+
+    List<Offset> constraintOffsets;
+    const unsigned constraintCount = spReflectionTypeParameter_GetConstraintCount(typeParameter);
+    for (unsigned ii = 0; ii < constraintCount; ++ii)
+    {
+        constraintOffsets.Add(writeType(spReflectionTypeParameter_GetConstraintByIndex(typeParameter, ii)));
+    }
+
+    get<flat::TypeParameterReflection>(offset)->index = spReflectionTypeParameter_GetIndex(typeParameter);
+
+    setPtr(offset + offsetof(flat::TypeParameterReflection, name), nameOffset);
+    setPtrArray(offset + offsetof(flat::TypeParameterReflection, constraints), constraintOffsets);
+    return offset;
+}
+
+FlatReflectionWriter::Offset FlatReflectionWriter::writeEntryPoint(SlangReflectionEntryPoint* entryPoint)
+{
+    const Offset offset = allocate<flat::EntryPointReflection>();
+
+    const Offset nameOffset = writeString(spReflectionEntryPoint_getName(entryPoint));
+
+    List<Offset> parameterOffsets;
+    const unsigned parameterCount = spReflectionEntryPoint_getParameterCount(entryPoint);
+    for (unsigned ii = 0; ii < parameterCount; ++ii)
+    {
+        parameterOffsets.Add(writeVarLayout(spReflectionEntryPoint_getParameterByIndex(entryPoint, ii)));
+    }
+
+    {
+        SlangUInt threadGroupSize[3];
+        spReflectionEntryPoint_getComputeThreadGroupSize(entryPoint, 3, threadGroupSize);
+
+        flat::EntryPointReflection* dst = get<flat::EntryPointReflection>(offset);
+        dst->stage = uint32_t(spReflectionEntryPoint_getStage(entryPoint));
+        dst->usesSampleRateInput = spReflectionEntryPoint_usesAnySampleRateInput(entryPoint) ? 1 : 0;
+        for (int ii = 0; ii < 3; ++ii)
+        {
+            dst->threadGroupSize[ii] = narrow(threadGroupSize[ii]);
+        }
+    }
+
+    setPtr(offset + offsetof(flat::EntryPointReflection, name), nameOffset);
+    setPtrArray(offset + offsetof(flat::EntryPointReflection, parameters), parameterOffsets);
+    return offset;
+}
+
+void FlatReflectionWriter::writeProgram(SlangReflection* program)
+{
+    // The header must come first
+    const Offset offset = allocate<flat::ShaderReflection>();
+    SLANG_ASSERT(offset == 0);
+
+    List<Offset> parameterOffsets;
+    const unsigned parameterCount = spReflection_GetParameterCount(program);
+    for (unsigned ii = 0; ii < parameterCount; ++ii)
+    {
+        parameterOffsets.Add(writeVarLayout((SlangReflectionVariableLayout*)spReflection_GetParameterByIndex(program, ii)));
+    }
+
+    List<Offset> entryPointOffsets;
+    const SlangUInt entryPointCount = spReflection_getEntryPointCount(program);
+    for (SlangUInt ii = 0; ii < entryPointCount; ++ii)
+    {
+        entryPointOffsets.Add(writeEntryPoint(spReflection_getEntryPointByIndex(program, ii)));
+    }
+
+    List<Offset> typeParameterOffsets;
+    const unsigned typeParameterCount = spReflection_GetTypeParameterCount(program);
+    for (unsigned ii = 0; ii < typeParameterCount; ++ii)
+    {
+        typeParameterOffsets.Add(writeTypeParameter(spReflection_GetTypeParameterByIndex(program, ii)));
+    }
+
+    setPtrArray(offset + offsetof(flat::ShaderReflection, parameters), parameterOffsets);
+    setPtrArray(offset + offsetof(flat::ShaderReflection, entryPoints), entryPointOffsets);
+    setPtrArray(offset + offsetof(flat::ShaderReflection, typeParameters), typeParameterOffsets);
+
+    // Pad the end (after the last string) to a multiple of 4 bytes
+    allocate<uint8_t>(0);
+
+    flat::ShaderReflection* dst = get<flat::ShaderReflection>(offset);
+    memcpy(dst->magic, flat::kMagic, sizeof(flat::kMagic));
+    dst->version = flat::kVersion;
+    dst->size = toOffset(m_data.Count());
+    dst->globalConstantBufferBinding = narrow(spReflection_getGlobalConstantBufferBinding(program));
+    dst->globalConstantBufferSize = narrow(spReflection_getGlobalConstantBufferSize(program));
+}
+
+SlangResult writeFlatReflection(ProgramLayout* programLayout, List<uint8_t>& outData)
+{
+    FlatReflectionWriter writer;
+    writer.writeProgram((SlangReflection*)programLayout);
+    if (writer.m_isOverflowed)
+    {
+        return SLANG_FAIL;
+    }
+    outData.SwapWith(writer.m_data);
+    return SLANG_OK;
+}
+
+} // namespace Slang
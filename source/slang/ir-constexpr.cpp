@@ -4,6 +4,8 @@
 #include "ir.h"
 #include "ir-insts.h"
 
+#include "../core/slang-memory-arena.h"
+
 namespace Slang {
 
 struct PropagateConstExprContext
@@ -16,8 +18,9 @@ struct PropagateConstExprContext
     SharedIRBuilder sharedBuilder;
     IRBuilder builder;
 
-    List<IRGlobalValue*> workList;
-    HashSet<IRGlobalValue*> onWorkList;
+    // Allocated from the thread scratch arena, for the duration of the pass
+    List<IRGlobalValue*, ScratchAllocator> workList;
+    HashSet<IRGlobalValue*, ScratchAllocator> onWorkList;
 
     IRBuilder* getBuilder() { return &builder; }
 
@@ -455,6 +458,7 @@ void propagateConstExpr(
 {
     auto session = module->session;
 
+    MemoryArenaScope scratchScope;
     PropagateConstExprContext context;
     context.module = module;
     context.sink = sink;
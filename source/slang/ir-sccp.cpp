@@ -4,6 +4,8 @@
 #include "ir.h"
 #include "ir-insts.h"
 
+#include "../core/slang-memory-arena.h"
+
 namespace Slang {
 
 
@@ -19,7 +21,8 @@ struct SharedSCCPContext
 };
 //
 // Next we have a context struct that will be applied for each function (or other
-// code-bearing value) that we optimize:
+// code-bearing value) that we optimize. Its containers are only needed while
+// optimizing that function, so they allocate from the thread scratch arena:
 //
 struct SCCPContext
 {
@@ -167,7 +170,7 @@ struct SCCPContext
     // where any instruction not present in the map is assumed to default
     // to the `None` case (the empty set)
     //
-    Dictionary<IRInst*, LatticeVal> mapInstToLatticeVal;
+    Dictionary<IRInst*, LatticeVal, ScratchAllocator> mapInstToLatticeVal;
 
     // Updating the lattice value for an instruction is easy, but we'll
     // use a simple function to make our intention clear.
@@ -306,7 +309,7 @@ struct SCCPContext
     // state. We track this as a set of the blocks that have been
     // marked as possibly executed, plus a getter and setter function.
 
-    HashSet<IRBlock*> executedBlocks;
+    HashSet<IRBlock*, ScratchAllocator> executedBlocks;
 
     bool isMarkedAsExecuted(IRBlock* block)
     {
@@ -324,8 +327,8 @@ struct SCCPContext
     // and the other holds SSA nodes (instructions) that need
     // their "estimated" value to be updated.
 
-    List<IRBlock*>  cfgWorkList;
-    List<IRInst*>   ssaWorkList;
+    List<IRBlock*, ScratchAllocator>    cfgWorkList;
+    List<IRInst*, ScratchAllocator>     ssaWorkList;
 
     // A key operation is to take an IR instruction and update
     // its "estimated" value on the lattice. This might happen when
@@ -699,7 +702,7 @@ struct SCCPContext
         // First, we will walk through all the code and replace instructions
         // with constants where it is possible.
         //
-        List<IRInst*> instsToRemove;
+        List<IRInst*, ScratchAllocator> instsToRemove;
         for( auto block : code->getBlocks() )
         {
             for( auto inst : block->getChildren() )
@@ -812,7 +815,7 @@ struct SCCPContext
         // of blocks to be removed, and then go about trying to
         // remove them.
         //
-        List<IRBlock*> unreachableBlocks;
+        List<IRBlock*, ScratchAllocator> unreachableBlocks;
         for( auto block : code->getBlocks() )
         {
             if( !isMarkedAsExecuted(block) )
@@ -922,6 +925,7 @@ static void applySparseConditionalConstantPropagationRec(
     {
         if( code->getFirstBlock() )
         {
+            MemoryArenaScope scratchScope;
             SCCPContext context;
             context.shared = shared;
             context.code = code;
@@ -3,11 +3,18 @@
 
 #include "../core/text-io.h"
 #include "../core/slang-byte-encode-util.h"
+#include "../core/slang-lz4-util.h"
 
 #include "ir-insts.h"
 
 #include "../core/slang-math.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
 namespace Slang {
 
 // Needed for linkage with some compilers
@@ -44,6 +51,8 @@ bother to check if it's correct, and just casts it.
     { 0, 0 }    // Int64,
 };
 
+/* static */const size_t IRSerialBinary::kLZ4BlockSize;
+
 static bool isParentDerived(IROp opIn)
 {
     const int op = (kIROpMeta_PseudoOpMask & opIn);
@@ -84,13 +93,12 @@ struct CharReader
 // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! StringRepresentationCache !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 
 StringRepresentationCache::StringRepresentationCache():
-    m_stringTable(nullptr),
     m_namePool(nullptr),
     m_scopeManager(nullptr)
 {
 }
 
-void StringRepresentationCache::init(const List<char>* stringTable, NamePool* namePool, ObjectScopeManager* scopeManager)
+void StringRepresentationCache::init(const ArrayView<const char>& stringTable, NamePool* namePool, ObjectScopeManager* scopeManager)
 {
     m_stringTable = stringTable;
     m_namePool = namePool;
@@ -104,19 +112,21 @@ void StringRepresentationCache::init(const List<char>* stringTable, NamePool* na
         Entry& entry = m_entries[0];
         entry.m_numChars = 0;
         entry.m_startIndex = 0;
-        entry.m_object = nullptr;
+        entry.m_stringRep = nullptr;
+        entry.m_name = nullptr;
     }
     {
         Entry& entry = m_entries[1];
         entry.m_numChars = 0;
         entry.m_startIndex = 0;
-        entry.m_object = nullptr;
+        entry.m_stringRep = nullptr;
+        entry.m_name = nullptr;
     }
 
     {
-        const char* start = stringTable->begin();
+        const char* start = stringTable.begin();
         const char* cur = start;
-        const char* end = stringTable->end();
+        const char* end = stringTable.end();
 
         while (cur < end)
         {
@@ -126,7 +136,8 @@ void StringRepresentationCache::init(const List<char>* stringTable, NamePool* na
             Entry entry;
             entry.m_startIndex = uint32_t(reader.m_pos - start);
             entry.m_numChars = len;
-            entry.m_object = nullptr;
+            entry.m_stringRep = nullptr;
+            entry.m_name = nullptr;
 
             m_entries.Add(entry);
 
@@ -145,23 +156,11 @@ Name* StringRepresentationCache::getName(Handle handle)
     }
 
     Entry& entry = m_entries[int(handle)];
-    if (entry.m_object)
+    if (!entry.m_name)
     {
-        Name* name = dynamic_cast<Name*>(entry.m_object);
-        if (name)
-        {
-            return name;
-        }
-        StringRepresentation* stringRep = static_cast<StringRepresentation*>(entry.m_object);
-        // Promote it to a name
-        name = m_namePool->getName(String(stringRep));
-        entry.m_object = name;
-        return name;
+        entry.m_name = m_namePool->getName(getStringSlice(handle));
     }
-
-    Name* name = m_namePool->getName(String(getStringSlice(handle)));
-    entry.m_object = name;
-    return name;
+    return entry.m_name;
 }
 
 String StringRepresentationCache::getString(Handle handle)
@@ -172,7 +171,7 @@ String StringRepresentationCache::getString(Handle handle)
 UnownedStringSlice StringRepresentationCache::getStringSlice(Handle handle) const
 {
     const Entry& entry = m_entries[int(handle)];
-    const char* start = m_stringTable->begin();
+    const char* start = m_stringTable.begin();
 
     return UnownedStringSlice(start + entry.m_startIndex, int(entry.m_numChars));
 }
@@ -185,14 +184,15 @@ StringRepresentation* StringRepresentationCache::getStringRepresentation(Handle
     }
 
     Entry& entry = m_entries[int(handle)];
-    if (entry.m_object)
+    if (entry.m_stringRep)
     {
-        Name* name = dynamic_cast<Name*>(entry.m_object);
-        if (name)
-        {
-            return name->text.getStringRepresentation();
-        }
-        return static_cast<StringRepresentation*>(entry.m_object);
+        return entry.m_stringRep;
+    }
+    if (entry.m_name)
+    {
+        // The name keeps the representation in scope
+        entry.m_stringRep = entry.m_name->text.getStringRepresentation();
+        return entry.m_stringRep;
     }
 
     const UnownedStringSlice slice = getStringSlice(handle);
@@ -200,7 +200,7 @@ StringRepresentation* StringRepresentationCache::getStringRepresentation(Handle
 
     StringRepresentation* stringRep = StringRepresentation::createWithCapacityAndLength(size, size);
     memcpy(stringRep->getData(), slice.begin(), size);
-    entry.m_object = stringRep;
+    entry.m_stringRep = stringRep;
 
     // Keep the StringRepresentation in scope
     m_scopeManager->add(stringRep);
@@ -236,7 +236,8 @@ char* StringRepresentationCache::getCStr(Handle handle)
         const int numPrefixBytes = EncodeUnicodePointToUTF8(prefixBytes, len);
         const int baseIndex = int(stringTable.Count());
 
-        stringTable.SetSize(baseIndex + numPrefixBytes + len);
+        // Grow geometrically, as the table is built up one string at a time
+        stringTable.GrowToSize(baseIndex + numPrefixBytes + len);
 
         char* dst = stringTable.begin() + baseIndex;
 
@@ -278,6 +279,8 @@ size_t IRSerialData::calcSizeInBytes() const
         _calcArraySize(m_stringTable) + 
         /* Raw source locs */
         _calcArraySize(m_rawSourceLocs) +
+        _calcArraySize(m_sourceLocTable) +
+        _calcArraySize(m_globalValueBodies) +
         /* Debug */
         _calcArraySize(m_debugSourceFiles) + 
         _calcArraySize(m_debugLineOffsets) + 
@@ -296,6 +299,8 @@ void IRSerialData::clear()
     m_decorationRuns.Clear();
     m_externalOperands.Clear();
     m_rawSourceLocs.Clear();
+    m_sourceLocTable.Clear();
+    m_globalValueBodies.Clear();
 
     // Debug data
     m_debugSourceFiles.Clear(); 
@@ -350,18 +355,42 @@ bool IRSerialData::operator==(const ThisType& rhs) const
         _isEqual(m_decorationRuns, rhs.m_decorationRuns) &&
         _isEqual(m_externalOperands, rhs.m_externalOperands) &&
         _isEqual(m_rawSourceLocs, rhs.m_rawSourceLocs) &&
+        _isEqual(m_sourceLocTable, rhs.m_sourceLocTable) &&
+        _isEqual(m_globalValueBodies, rhs.m_globalValueBodies) &&
         _isEqual(m_stringTable, rhs.m_stringTable));
 }
 
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! IRSerialDataView !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+template <typename T>
+static ArrayView<const T> _getView(const List<T>& list)
+{
+    return ArrayView<const T>(list.begin(), int(list.Count()));
+}
+
+void IRSerialDataView::set(const IRSerialData& data)
+{
+    m_insts = _getView(data.m_insts);
+    m_childRuns = _getView(data.m_childRuns);
+    m_decorationRuns = _getView(data.m_decorationRuns);
+    m_externalOperands = _getView(data.m_externalOperands);
+    m_stringTable = _getView(data.m_stringTable);
+    m_rawSourceLocs = _getView(data.m_rawSourceLocs);
+    m_sourceLocTable = _getView(data.m_sourceLocTable);
+    m_globalValueBodies = _getView(data.m_globalValueBodies);
+
+    m_decorationBaseIndex = data.m_decorationBaseIndex;
+}
+
 // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! IRSerialWriter !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 
 void IRSerialWriter::_addInstruction(IRInst* inst)
 {
-    // It cannot already be in the map
-    SLANG_ASSERT(!m_instMap.ContainsKey(inst));
+    // It cannot already have been added
+    SLANG_ASSERT(inst->scratchData == 0);
 
-    // Add to the map
-    m_instMap.Add(inst, Ser::InstIndex(m_insts.Count()));
+    // Record the index on the instruction
+    inst->scratchData = uint32_t(m_insts.Count());
     m_insts.Add(inst);
 
     // Add all the decorations, to the list. 
@@ -382,7 +411,7 @@ void IRSerialWriter::_addInstruction(IRInst* inst)
         const Ser::SizeType numDecor = Ser::SizeType(int(m_decorations.Count()) - initialNumDecor);
         
         Ser::InstRun run;
-        run.m_parentIndex = m_instMap[inst];
+        run.m_parentIndex = getInstIndex(inst);
 
         // NOTE! This isn't quite correct, as we need to correct for when all the instructions are added, this is done at the end
         run.m_startInstIndex = Ser::InstIndex(initialNumDecor);
@@ -392,6 +421,104 @@ void IRSerialWriter::_addInstruction(IRInst* inst)
     }
 }
 
+void IRSerialWriter::_startGlobalValueBody(IRInst* globalValue)
+{
+    Ser::GlobalValueBody body;
+    body.m_globalValueIndex = getInstIndex(globalValue);
+    body.m_startInstIndex = Ser::InstIndex(m_insts.Count());
+    body.m_numInsts = 0;
+    body.m_startChildRunIndex = Ser::SizeType(m_serialData->m_childRuns.Count());
+    body.m_numChildRuns = 0;
+    body.m_startDecorationRunIndex = Ser::SizeType(m_serialData->m_decorationRuns.Count());
+    body.m_numDecorationRuns = 0;
+
+    m_serialData->m_globalValueBodies.Add(body);
+}
+
+void IRSerialWriter::_endGlobalValueBody()
+{
+    Ser::GlobalValueBody& body = m_serialData->m_globalValueBodies.Last();
+    body.m_numInsts = Ser::SizeType(m_insts.Count() - int(body.m_startInstIndex));
+    body.m_numChildRuns = Ser::SizeType(m_serialData->m_childRuns.Count()) - body.m_startChildRunIndex;
+    body.m_numDecorationRuns = Ser::SizeType(m_serialData->m_decorationRuns.Count()) - body.m_startDecorationRunIndex;
+
+    // Nothing to defer if it's empty
+    if (body.m_numInsts == 0)
+    {
+        m_serialData->m_globalValueBodies.RemoveLast();
+    }
+}
+
+void IRSerialWriter::_removeReferencedGlobalValueBodies()
+{
+    // A body can only be created on demand if no instruction outside of it references an instruction inside of it.
+    // Mark any body that is referenced, and then remove them.
+    List<Ser::GlobalValueBody>& bodies = m_serialData->m_globalValueBodies;
+    const int numBodies = int(bodies.Count());
+    if (numBodies == 0)
+    {
+        return;
+    }
+
+    const int numInsts = int(m_insts.Count());
+
+    // The body index for each instruction, or -1 if not in a body
+    List<int> instBodyIndices;
+    instBodyIndices.SetSize(numInsts);
+    for (int i = 0; i < numInsts; ++i)
+    {
+        instBodyIndices[i] = -1;
+    }
+    for (int i = 0; i < numBodies; ++i)
+    {
+        const Ser::GlobalValueBody& body = bodies[i];
+        for (int j = 0; j < int(body.m_numInsts); ++j)
+        {
+            instBodyIndices[int(body.m_startInstIndex) + j] = i;
+        }
+    }
+
+    List<bool> isReferenced;
+    isReferenced.SetSize(numBodies);
+    for (int i = 0; i < numBodies; ++i)
+    {
+        isReferenced[i] = false;
+    }
+
+    for (int i = 1; i < numInsts; ++i)
+    {
+        const Ser::Inst& inst = m_serialData->m_insts[i];
+        const int bodyIndex = instBodyIndices[i];
+
+        const int resultTypeBodyIndex = instBodyIndices[int(inst.m_resultTypeIndex)];
+        if (resultTypeBodyIndex >= 0 && resultTypeBodyIndex != bodyIndex)
+        {
+            isReferenced[resultTypeBodyIndex] = true;
+        }
+
+        const Ser::InstIndex* operands;
+        const int numOperands = m_serialData->getOperands(inst, &operands);
+        for (int j = 0; j < numOperands; ++j)
+        {
+            const int operandBodyIndex = instBodyIndices[int(operands[j])];
+            if (operandBodyIndex >= 0 && operandBodyIndex != bodyIndex)
+            {
+                isReferenced[operandBodyIndex] = true;
+            }
+        }
+    }
+
+    int numLazyBodies = 0;
+    for (int i = 0; i < numBodies; ++i)
+    {
+        if (!isReferenced[i])
+        {
+            bodies[numLazyBodies++] = bodies[i];
+        }
+    }
+    bodies.SetSize(numLazyBodies);
+}
+
 // Find a view index that matches the view by file (and perhaps other characteristics in the future)
 int _findSourceViewIndex(const List<SourceView*>& viewsIn, SourceView* view)
 {
@@ -415,6 +542,21 @@ int _findSourceViewIndex(const List<SourceView*>& viewsIn, SourceView* view)
 
 
 Result IRSerialWriter::write(IRModule* module, SourceManager* sourceManager, OptionFlags options, IRSerialData* serialData)
+{
+    const Result res = _write(module, sourceManager, options, serialData);
+
+    // Clear the indices held on the instructions
+    for (IRInst* inst : m_insts)
+    {
+        if (inst)
+        {
+            inst->scratchData = 0;
+        }
+    }
+    return res;
+}
+
+Result IRSerialWriter::_write(IRModule* module, SourceManager* sourceManager, OptionFlags options, IRSerialData* serialData)
 {
     typedef Ser::Inst::PayloadType PayloadType;
 
@@ -429,7 +571,6 @@ Result IRSerialWriter::write(IRModule* module, SourceManager* sourceManager, Opt
     m_insts.Add(nullptr);
 
     // Reset
-    m_instMap.Clear();
     m_decorations.Clear();
     
     // Stack for parentInst
@@ -438,16 +579,34 @@ Result IRSerialWriter::write(IRModule* module, SourceManager* sourceManager, Opt
     IRModuleInst* moduleInst = module->getModuleInst();
     parentInstStack.Add(moduleInst);
 
-    // Add to the map
+    // Add the module instruction
     _addInstruction(moduleInst);
 
+    // True if the last entry in m_globalValueBodies is the body being traversed
+    bool isInBody = false;
+
     // Traverse all of the instructions
     while (parentInstStack.Count())
     {
         // If it's in the stack it is assumed it is already in the inst map
         IRParentInst* parentInst = parentInstStack.Last();
         parentInstStack.RemoveLast();
-        SLANG_ASSERT(m_instMap.ContainsKey(parentInst));
+        SLANG_ASSERT(parentInst->scratchData != 0);
+
+        // The stack means everything beneath an instruction at module scope is traversed before the next one at module scope,
+        // so the body of a global value with code is a contiguous range of instructions (and of child and decoration runs)
+        if (parentInst->getParent() == moduleInst)
+        {
+            if (isInBody)
+            {
+                _endGlobalValueBody();
+            }
+            isInBody = as<IRGlobalValueWithCode>(parentInst) != nullptr;
+            if (isInBody)
+            {
+                _startGlobalValueBody(parentInst);
+            }
+        }
 
         // Okay we go through each of the children in order. If they are IRInstParent derived, we add to stack to process later 
         // cos we want breadth first so the order of children is the same as their index order, meaning we don't need to store explicit indices
@@ -456,9 +615,6 @@ Result IRSerialWriter::write(IRModule* module, SourceManager* sourceManager, Opt
         IRInstListBase childrenList = parentInst->getChildren();
         for (IRInst* child : childrenList)
         {
-            // This instruction can't be in the map...
-            SLANG_ASSERT(!m_instMap.ContainsKey(child));
-
             _addInstruction(child);
             
             IRParentInst* childAsParent = as<IRParentInst>(child);
@@ -472,13 +628,17 @@ Result IRSerialWriter::write(IRModule* module, SourceManager* sourceManager, Opt
         if (Ser::InstIndex(m_insts.Count()) != startChildInstIndex)
         {
             Ser::InstRun run;
-            run.m_parentIndex = m_instMap[parentInst];
+            run.m_parentIndex = getInstIndex(parentInst);
             run.m_startInstIndex = startChildInstIndex;
             run.m_numChildren = Ser::SizeType(m_insts.Count() - int(startChildInstIndex));
 
             m_serialData->m_childRuns.Add(run);
         }
     }
+    if (isInBody)
+    {
+        _endGlobalValueBody();
+    }
 
     // Now fix the decorations 
     {
@@ -599,7 +759,7 @@ Result IRSerialWriter::write(IRModule* module, SourceManager* sourceManager, Opt
                 dstInst.m_payloadType = PayloadType::OperandExternal;
 
                 int operandArrayBaseIndex = int(m_serialData->m_externalOperands.Count());
-                m_serialData->m_externalOperands.SetSize(operandArrayBaseIndex + numOperands);
+                m_serialData->m_externalOperands.GrowToSize(operandArrayBaseIndex + numOperands);
 
                 dstOperands = m_serialData->m_externalOperands.begin() + operandArrayBaseIndex; 
 
@@ -616,6 +776,8 @@ Result IRSerialWriter::write(IRModule* module, SourceManager* sourceManager, Opt
         }
     }
 
+    _removeReferencedGlobalValueBodies();
+
     // Now need to do the decorations
 
     {
@@ -757,41 +919,43 @@ Result IRSerialWriter::write(IRModule* module, SourceManager* sourceManager, Opt
             dstLocs[i] = Ser::RawSourceLoc(srcInst->sourceLoc.getRaw());
         }
     }
+    else if (options & OptionFlag::SourceLocationTable)
+    {
+        const int numInsts = int(m_insts.Count());
+        List<SourceLoc::RawValue> locs;
+        locs.SetSize(numInsts);
+        locs[0] = 0;
+        for (int i = 1; i < numInsts; ++i)
+        {
+            locs[i] = m_insts[i]->sourceLoc.getRaw();
+        }
+        SerialSourceLocTableUtil::encode(locs.Buffer(), numInsts, serialData->m_sourceLocTable);
+    }
     
     m_serialData = nullptr;
     return SLANG_OK;
 }
 
-template <typename T>
-static size_t _calcChunkSize(IRSerialBinary::CompressionType compressionType, const List<T>& array)
+// Compress data as a sequence of independent LZ4 blocks, each prefixed with its compressed size
+static void _encodeLZ4(const void* data, size_t size, List<uint8_t>& encodeOut)
 {
     typedef IRSerialBinary Bin;
 
-    if (array.Count())
-    {
-        switch (compressionType)
-        {
-            case Bin::CompressionType::None:
-            {
-                const size_t size = sizeof(Bin::ArrayHeader) + sizeof(T) * array.Count();
-                return (size + 3) & ~size_t(3);
-            }
-            case Bin::CompressionType::VariableByteLite:
-            {
-                const size_t payloadSize = ByteEncodeUtil::calcEncodeLiteSizeUInt32((const uint32_t*)array.begin(), (array.Count() * sizeof(T)) / sizeof(uint32_t));
-                const size_t size = sizeof(Bin::CompressedArrayHeader) + payloadSize;
-                return (size + 3) & ~size_t(3);
-            }
-            default:
-            {
-                SLANG_ASSERT(!"Unhandled compression type");
-                return 0;
-            }
-        }
-    }
-    else
+    const uint8_t* src = (const uint8_t*)data;
+    while (size > 0)
     {
-        return 0;
+        const size_t blockSize = Math::Min(size, Bin::kLZ4BlockSize);
+
+        const UInt sizeIndex = encodeOut.Count();
+        encodeOut.SetSize(sizeIndex + sizeof(uint32_t));
+
+        LZ4Util::compress(src, blockSize, encodeOut);
+
+        const uint32_t compressedSize = uint32_t(encodeOut.Count() - sizeIndex - sizeof(uint32_t));
+        memcpy(encodeOut.Buffer() + sizeIndex, &compressedSize, sizeof(compressedSize));
+
+        src += blockSize;
+        size -= blockSize;
     }
 }
 
@@ -823,12 +987,26 @@ static Result _writeArrayChunk(IRSerialBinary::CompressionType compressionType,
             break;
         }
         case Bin::CompressionType::VariableByteLite:
+        case Bin::CompressionType::StreamVByte:
+        case Bin::CompressionType::LZ4:
         {
             List<uint8_t> compressedPayload;
 
             size_t numCompressedEntries = (numEntries * typeSize) / sizeof(uint32_t);
 
-            ByteEncodeUtil::encodeLiteUInt32((const uint32_t*)data, numCompressedEntries, compressedPayload);
+            if (compressionType == Bin::CompressionType::LZ4)
+            {
+                numCompressedEntries = numEntries * typeSize;
+                _encodeLZ4(data, numCompressedEntries, compressedPayload);
+            }
+            else if (compressionType == Bin::CompressionType::VariableByteLite)
+            {
+                ByteEncodeUtil::encodeLiteUInt32((const uint32_t*)data, numCompressedEntries, compressedPayload);
+            }
+            else
+            {
+                ByteEncodeUtil::encodeStreamVByteUInt32((const uint32_t*)data, numCompressedEntries, compressedPayload);
+            }
 
             payloadSize = sizeof(Bin::CompressedArrayHeader) - sizeof(Bin::Chunk) + compressedPayload.Count();
 
@@ -866,11 +1044,87 @@ Result _writeArrayChunk(IRSerialBinary::CompressionType compressionType, uint32_
     return _writeArrayChunk(compressionType, chunkId, array.begin(), size_t(array.Count()), sizeof(T), stream);
 }
 
-Result _encodeInsts(IRSerialBinary::CompressionType compressionType, const List<IRSerialData::Inst>& instsIn, List<uint8_t>& encodeArrayOut)
+// Get the amount of uint32_t values that hold an instructions payload
+static int _getNumPayloadValues(IRSerialData::Inst::PayloadType payloadType)
+{
+    typedef IRSerialData::Inst::PayloadType PayloadType;
+    switch (payloadType)
+    {
+        case PayloadType::Empty:
+        {
+            return 0;
+        }
+        case PayloadType::Operand_1:
+        case PayloadType::String_1:
+        case PayloadType::UInt32:
+        {
+            return 1;
+        }
+        case PayloadType::Operand_2:
+        case PayloadType::OperandAndUInt32:
+        case PayloadType::OperandExternal:
+        case PayloadType::String_2:
+        case PayloadType::Float64:
+        case PayloadType::Int64:
+        {
+            // 64 bit payloads are stored as 2 uint32_t values
+            return 2;
+        }
+    }
+    SLANG_ASSERT(!"Unhandled payload type");
+    return 0;
+}
+
+// With StreamVByte compression the instructions are stored as the ops of all the instructions, followed by
+// the payload types of all the instructions, followed by the StreamVByte encoding of the uint32_t values of
+// the result type and payload of each instruction. All the values can then be decoded in bulk.
+static void _getInstStreamVByteValues(const List<IRSerialData::Inst>& instsIn, List<uint32_t>& valuesOut)
+{
+    valuesOut.Clear();
+    for (const auto& inst : instsIn)
+    {
+        valuesOut.Add(uint32_t(inst.m_resultTypeIndex));
+
+        const int numPayloadValues = _getNumPayloadValues(inst.m_payloadType);
+        uint32_t payloadValues[2];
+        memcpy(payloadValues, &inst.m_payload, sizeof(uint32_t) * numPayloadValues);
+        valuesOut.AddRange(payloadValues, UInt(numPayloadValues));
+    }
+}
+
+static void _encodeInstsStreamVByte(const List<IRSerialData::Inst>& instsIn, List<uint8_t>& encodeArrayOut, size_t* numValuesOut)
+{
+    List<uint32_t> values;
+    _getInstStreamVByteValues(instsIn, values);
+
+    const size_t numInsts = size_t(instsIn.Count());
+    const size_t numValues = size_t(values.Count());
+
+    encodeArrayOut.SetSize(UInt(numInsts * 2 + ByteEncodeUtil::calcEncodeStreamVByteSizeUInt32(values.begin(), numValues)));
+
+    uint8_t* encodeOut = encodeArrayOut.begin();
+    for (size_t i = 0; i < numInsts; ++i)
+    {
+        encodeOut[i] = uint8_t(instsIn[i].m_op);
+        encodeOut[numInsts + i] = uint8_t(instsIn[i].m_payloadType);
+    }
+    ByteEncodeUtil::encodeStreamVByteUInt32(values.begin(), numValues, encodeOut + numInsts * 2);
+
+    *numValuesOut = numValues;
+}
+
+Result _encodeInsts(IRSerialBinary::CompressionType compressionType, const List<IRSerialData::Inst>& instsIn, List<uint8_t>& encodeArrayOut, size_t* numCompressedEntriesOut)
 {
     typedef IRSerialBinary Bin;
     typedef IRSerialData::Inst::PayloadType PayloadType;
 
+    *numCompressedEntriesOut = 0;
+
+    if (compressionType == Bin::CompressionType::StreamVByte)
+    {
+        _encodeInstsStreamVByte(instsIn, encodeArrayOut, numCompressedEntriesOut);
+        return SLANG_OK;
+    }
     if (compressionType != Bin::CompressionType::VariableByteLite)
     {
         return SLANG_FAIL;
@@ -967,13 +1221,17 @@ Result _writeInstArrayChunk(IRSerialBinary::CompressionType compressionType, uin
     switch (compressionType)
     {
         case Bin::CompressionType::None:
+        case Bin::CompressionType::LZ4:
         {
+            // LZ4 compresses the instructions bytes as is
             return _writeArrayChunk(compressionType, chunkId, array, stream);
         }
         case Bin::CompressionType::VariableByteLite:
+        case Bin::CompressionType::StreamVByte:
         {
             List<uint8_t> compressedPayload;
-            SLANG_RETURN_ON_FAIL(_encodeInsts(compressionType, array, compressedPayload));
+            size_t numCompressedEntries;
+            SLANG_RETURN_ON_FAIL(_encodeInsts(compressionType, array, compressedPayload, &numCompressedEntries));
             
             size_t payloadSize = sizeof(Bin::CompressedArrayHeader) - sizeof(Bin::Chunk) + compressedPayload.Count();
 
@@ -981,7 +1239,7 @@ Result _writeInstArrayChunk(IRSerialBinary::CompressionType compressionType, uin
             header.m_chunk.m_type = SLANG_MAKE_COMPRESSED_FOUR_CC(chunkId);
             header.m_chunk.m_size = uint32_t(payloadSize);
             header.m_numEntries = uint32_t(array.Count());
-            header.m_numCompressedEntries = 0;          
+            header.m_numCompressedEntries = uint32_t(numCompressedEntries);
 
             stream->Write(&header, sizeof(header));
             stream->Write(compressedPayload.begin(), compressedPayload.Count());
@@ -1001,116 +1259,221 @@ Result _writeInstArrayChunk(IRSerialBinary::CompressionType compressionType, uin
     return SLANG_FAIL;
 }
 
-static size_t _calcInstChunkSize(IRSerialBinary::CompressionType compressionType, const List<IRSerialData::Inst>& instsIn)
+// Calculate the size of a junk chunk needed, such that offset + the size is a multiple of alignment. Offset must be a multiple of 4.
+static size_t _calcJunkChunkSize(size_t offset, size_t alignment)
 {
-    typedef IRSerialBinary Bin;
-    typedef IRSerialData::Inst::PayloadType PayloadType;
+    SLANG_ASSERT((offset & 3) == 0);
+    if ((offset & (alignment - 1)) == 0)
+    {
+        return 0;
+    }
+    size_t size = sizeof(IRSerialBinary::Chunk);
+    while ((offset + size) & (alignment - 1))
+    {
+        size += 4;
+    }
+    return size;
+}
 
-    switch (compressionType)
+static Result _writeJunkChunk(size_t size, Stream* stream)
+{
+    typedef IRSerialBinary Bin;
+    if (size == 0)
     {
-        case Bin::CompressionType::None:
-        {
-            return _calcChunkSize(compressionType, instsIn);
-        }
-        case Bin::CompressionType::VariableByteLite:
-        {
-            size_t size = sizeof(Bin::CompressedArrayHeader);
+        return SLANG_OK;
+    }
+    SLANG_ASSERT(size >= sizeof(Bin::Chunk) && (size & 3) == 0);
 
-            size_t numInsts = size_t(instsIn.Count());
-            size += numInsts * 2;           // op and payload
+    Bin::Chunk chunk;
+    chunk.m_type = Bin::kJunkFourCc;
+    chunk.m_size = uint32_t(size - sizeof(Bin::Chunk));
+    stream->Write(&chunk, sizeof(chunk));
 
-            
-            IRSerialData::Inst* insts = instsIn.begin();
+    const uint32_t zero = 0;
+    for (size_t i = sizeof(Bin::Chunk); i < size; i += sizeof(zero))
+    {
+        stream->Write(&zero, sizeof(zero));
+    }
+    return SLANG_OK;
+}
 
-            for (size_t i = 0; i < numInsts; ++i)
-            {
-                const auto& inst = insts[i];
+// The array chunks in a container, in the order they are written
+enum class IRSerialChunkKind
+{
+    Insts,
+    ChildRuns,
+    DecorationRuns,
+    ExternalOperands,
+    GlobalValueBodies,
+    StringTable,
+    RawSourceLocs,
+    SourceLocTable,
+    CountOf,
+};
 
-                size += ByteEncodeUtil::calcEncodeLiteSizeUInt32((uint32_t)inst.m_resultTypeIndex);
+// The string table and source locations aren't arrays of small integers, so are only compressed with LZ4
+static IRSerialBinary::CompressionType _getByteDataCompressionType(IRSerialBinary::CompressionType compressionType)
+{
+    return (compressionType == IRSerialBinary::CompressionType::LZ4) ? compressionType : IRSerialBinary::CompressionType::None;
+}
 
-                switch (inst.m_payloadType)
-                {
-                    case PayloadType::Empty:    
-                    {
-                        break;
-                    }
-                    case PayloadType::Operand_1:
-                    case PayloadType::String_1:
-                    case PayloadType::UInt32:
-                    {
-                        // 1 UInt32
-                        size += ByteEncodeUtil::calcEncodeLiteSizeUInt32((uint32_t)inst.m_payload.m_operands[0]);
-                        break;
-                    }
-                    case PayloadType::Operand_2:
-                    case PayloadType::OperandAndUInt32:
-                    case PayloadType::OperandExternal:
-                    case PayloadType::String_2:
-                    {
-                        // 2 UInt32
-                        size += ByteEncodeUtil::calcEncodeLiteSizeUInt32((uint32_t)inst.m_payload.m_operands[0]);
-                        size += ByteEncodeUtil::calcEncodeLiteSizeUInt32((uint32_t)inst.m_payload.m_operands[1]);
-                        break;
-                    }
-                    case PayloadType::Float64:
-                    {
-                        size += sizeof(inst.m_payload.m_float64);
-                        break;
-                    }
-                    case PayloadType::Int64:
-                    {
-                        size += sizeof(inst.m_payload.m_int64);
-                        break;
-                    }
-                }
-            }
+// Write a single array chunk. Chunks only depend on data, so can be written concurrently to different streams.
+static Result _writeChunk(const IRSerialData& data, IRSerialBinary::CompressionType compressionType, IRSerialChunkKind kind, Stream* stream)
+{
+    typedef IRSerialBinary Bin;
+    typedef IRSerialData Ser;
 
-            return (size + 3) & ~size_t(3);
+    switch (kind)
+    {
+        case IRSerialChunkKind::Insts:
+        {
+            // Uncompressed arrays are written such that their contents are aligned for their type (relative to the start of the container),
+            // so IRSerialReader::readContainer can use them in place. Only the instructions need more than 4 byte alignment. They are the first
+            // array, so a junk chunk is written before them when needed.
+            if (compressionType == Bin::CompressionType::None && data.m_insts.Count())
+            {
+                const size_t instOffset = sizeof(Bin::Chunk) + sizeof(Bin::SlangHeader) + sizeof(Bin::ArrayHeader);
+                SLANG_COMPILE_TIME_ASSERT(SLANG_ALIGN_OF(Ser::Inst) <= Bin::kContainerAlignment);
+                SLANG_RETURN_ON_FAIL(_writeJunkChunk(_calcJunkChunkSize(instOffset, SLANG_ALIGN_OF(Ser::Inst)), stream));
+            }
+            return _writeInstArrayChunk(compressionType, Bin::kInstFourCc, data.m_insts, stream);
         }
+        case IRSerialChunkKind::ChildRuns:          return _writeArrayChunk(compressionType, Bin::kChildRunFourCc, data.m_childRuns, stream);
+        case IRSerialChunkKind::DecorationRuns:     return _writeArrayChunk(compressionType, Bin::kDecoratorRunFourCc, data.m_decorationRuns, stream);
+        case IRSerialChunkKind::ExternalOperands:   return _writeArrayChunk(compressionType, Bin::kExternalOperandsFourCc, data.m_externalOperands, stream);
+        case IRSerialChunkKind::GlobalValueBodies:  return _writeArrayChunk(compressionType, Bin::kGlobalValueBodyFourCc, data.m_globalValueBodies, stream);
+        case IRSerialChunkKind::StringTable:        return _writeArrayChunk(_getByteDataCompressionType(compressionType), Bin::kStringFourCc, data.m_stringTable, stream);
+        case IRSerialChunkKind::RawSourceLocs:      return _writeArrayChunk(_getByteDataCompressionType(compressionType), Bin::kUInt32SourceLocFourCc, data.m_rawSourceLocs, stream);
+        case IRSerialChunkKind::SourceLocTable:     return _writeArrayChunk(_getByteDataCompressionType(compressionType), Bin::kSourceLocTableFourCc, data.m_sourceLocTable, stream);
         default: break;
     }
-
-    SLANG_ASSERT(!"Unhandled compression type");
-    return 0;
+    return SLANG_FAIL;
 }
 
-/* static */Result IRSerialWriter::writeStream(const IRSerialData& data, Bin::CompressionType compressionType, Stream* stream)
+/* static */Result IRSerialWriter::writeStream(const IRSerialData& data, Bin::CompressionType compressionType, Stream* stream, int maxThreadCount)
 {
-    size_t totalSize = 0;
-    
-    totalSize += sizeof(Bin::SlangHeader) + 
-        _calcInstChunkSize(compressionType, data.m_insts) +
-        _calcChunkSize(compressionType, data.m_childRuns) +
-        _calcChunkSize(compressionType, data.m_decorationRuns) +
-        _calcChunkSize(compressionType, data.m_externalOperands) +
-        _calcChunkSize(Bin::CompressionType::None, data.m_stringTable) + 
-        _calcChunkSize(Bin::CompressionType::None, data.m_rawSourceLocs);
+    const int numChunks = int(IRSerialChunkKind::CountOf);
+
+    // Each chunk is encoded into its own buffer, so chunks can be encoded concurrently
+    MemoryStream chunkStreams[numChunks];
+    Result chunkResults[numChunks];
+
+    // Threads (including the calling thread) take the next chunk that hasn't been started, so chunks are started in order.
+    // The first (typically largest) chunk is taken first.
+    std::atomic<int> nextChunkIndex(0);
+    std::mutex mutex;
+    std::condition_variable chunkEncoded;
+    bool isChunkEncoded[numChunks] = {};
 
+    auto encodeNextChunk = [&]() -> bool
     {
-        Bin::Chunk riffHeader;
-        riffHeader.m_type = Bin::kRiffFourCc;
-        riffHeader.m_size = uint32_t(totalSize);
-        
-        stream->Write(&riffHeader, sizeof(riffHeader));
+        const int index = nextChunkIndex++;
+        if (index >= numChunks)
+        {
+            return false;
+        }
+        chunkResults[index] = _writeChunk(data, compressionType, IRSerialChunkKind(index), &chunkStreams[index]);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isChunkEncoded[index] = true;
+        }
+        chunkEncoded.notify_all();
+        return true;
+    };
+    auto encodeChunks = [&]()
+    {
+        while (encodeNextChunk())
+        {
+        }
+    };
+
+    int threadCount = maxThreadCount;
+    if (threadCount <= 0)
+    {
+        threadCount = (compressionType != Bin::CompressionType::None && data.calcSizeInBytes() >= kMinParallelWriteSize) ? int(std::thread::hardware_concurrency()) : 1;
+    }
+    SLANG_COMPILE_TIME_ASSERT(kMaxWriteThreadCount == int(IRSerialChunkKind::CountOf));
+    threadCount = Math::Clamp(threadCount, 1, int(kMaxWriteThreadCount));
+
+    // The calling thread is one of the threads. If a thread can't be created, the ones that have been take all of the chunks.
+    List<std::thread> threads;
+    threads.Reserve(UInt(threadCount));
+    for (int i = 1; i < threadCount; ++i)
+    {
+        try
+        {
+            threads.Add(std::thread(encodeChunks));
+        }
+        catch (const std::system_error&)
+        {
+            break;
+        }
     }
+
+    // The headers are written first, and the RIFF chunk's size is fixed up once all the chunks have been written
+    const Int64 startPosition = stream->GetPosition();
+
+    Bin::Chunk riffHeader;
+    riffHeader.m_type = Bin::kRiffFourCc;
+    riffHeader.m_size = 0;
+    stream->Write(&riffHeader, sizeof(riffHeader));
+
     {
         Bin::SlangHeader slangHeader;
         slangHeader.m_chunk.m_type = Bin::kSlangFourCc;
         slangHeader.m_chunk.m_size = uint32_t(sizeof(slangHeader) - sizeof(Bin::Chunk));
         slangHeader.m_decorationBase = uint32_t(data.m_decorationBaseIndex);
-        slangHeader.m_compressionType = uint32_t(Bin::CompressionType::VariableByteLite);
+        slangHeader.m_compressionType = uint32_t(compressionType);
 
         stream->Write(&slangHeader, sizeof(slangHeader));
     }
 
-    SLANG_RETURN_ON_FAIL(_writeInstArrayChunk(compressionType, Bin::kInstFourCc, data.m_insts, stream));
-    SLANG_RETURN_ON_FAIL(_writeArrayChunk(compressionType, Bin::kChildRunFourCc, data.m_childRuns, stream));
-    SLANG_RETURN_ON_FAIL(_writeArrayChunk(compressionType, Bin::kDecoratorRunFourCc, data.m_decorationRuns, stream));
-    SLANG_RETURN_ON_FAIL(_writeArrayChunk(compressionType, Bin::kExternalOperandsFourCc, data.m_externalOperands, stream));
-    SLANG_RETURN_ON_FAIL(_writeArrayChunk(Bin::CompressionType::None, Bin::kStringFourCc, data.m_stringTable, stream));
+    // Write out each chunk in order as soon as it has been encoded, whilst later chunks are still being encoded.
+    // The calling thread encodes the chunk it needs next if no other thread has started it.
+    Result result = SLANG_OK;
+    size_t totalSize = sizeof(Bin::SlangHeader);
+    for (int i = 0; i < numChunks; ++i)
+    {
+        if (nextChunkIndex.load() <= i)
+        {
+            encodeNextChunk();
+        }
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            chunkEncoded.wait(lock, [&]() { return isChunkEncoded[i]; });
+        }
+
+        if (SLANG_FAILED(chunkResults[i]))
+        {
+            // Don't start any more chunks
+            result = chunkResults[i];
+            nextChunkIndex = numChunks;
+            break;
+        }
+
+        MemoryStream& chunkStream = chunkStreams[i];
+        stream->Write(chunkStream.getContents(), chunkStream.getContentsSize());
+        totalSize += chunkStream.getContentsSize();
+
+        // Free the encoded chunk now it's been written
+        List<uint8_t> contents;
+        chunkStream.swapContents(contents);
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    SLANG_RETURN_ON_FAIL(result);
+
+    {
+        const Int64 endPosition = stream->GetPosition();
+        riffHeader.m_size = uint32_t(totalSize);
+        stream->Seek(SeekOrigin::Start, startPosition);
+        stream->Write(&riffHeader, sizeof(riffHeader));
+        stream->Seek(SeekOrigin::Start, endPosition);
+    }
 
-    SLANG_RETURN_ON_FAIL(_writeArrayChunk(Bin::CompressionType::None, Bin::kUInt32SourceLocFourCc, data.m_rawSourceLocs, stream));
-    
     return SLANG_OK;
 }
 
@@ -1148,17 +1511,76 @@ class ListResizerForType: public ListResizer
     List<T>& m_list;
 };
 
-static Result _readArrayChunk(IRSerialBinary::CompressionType compressionType, const IRSerialBinary::Chunk& chunk, Stream* stream, size_t* numReadInOut, ListResizer& listOut)
+// Decompress a payload written by _encodeLZ4 into dst. Only a single compressed block is held in memory at a time.
+static Result _readLZ4(Stream* stream, size_t payloadSize, void* dstIn, size_t dstSize)
 {
     typedef IRSerialBinary Bin;
 
-    const size_t typeSize = listOut.getTypeSize();
+    uint8_t* dst = (uint8_t*)dstIn;
 
-    switch (compressionType)
+    List<uint8_t> block;
+    block.SetSize(LZ4Util::calcMaxCompressedSize(Bin::kLZ4BlockSize));
+
+    while (dstSize > 0)
     {
-        case Bin::CompressionType::VariableByteLite:
+        uint32_t compressedSize;
+        if (payloadSize < sizeof(compressedSize))
+        {
+            return SLANG_FAIL;
+        }
+        stream->Read(&compressedSize, sizeof(compressedSize));
+        payloadSize -= sizeof(compressedSize);
+
+        if (compressedSize > payloadSize || compressedSize > UInt(block.Count()))
+        {
+            return SLANG_FAIL;
+        }
+        stream->Read(block.Buffer(), compressedSize);
+        payloadSize -= compressedSize;
+
+        const size_t blockSize = Math::Min(dstSize, Bin::kLZ4BlockSize);
+        SLANG_RETURN_ON_FAIL(LZ4Util::decompress(block.Buffer(), compressedSize, dst, blockSize));
+
+        dst += blockSize;
+        dstSize -= blockSize;
+    }
+
+    return (payloadSize == 0) ? SLANG_OK : SLANG_FAIL;
+}
+
+static Result _readArrayChunk(IRSerialBinary::CompressionType compressionType, const IRSerialBinary::Chunk& chunk, Stream* stream, size_t* numReadInOut, ListResizer& listOut)
+{
+    typedef IRSerialBinary Bin;
+
+    const size_t typeSize = listOut.getTypeSize();
+
+    switch (compressionType)
+    {
+        case Bin::CompressionType::LZ4:
         {
-            // We have a compressed header
+            Bin::CompressedArrayHeader header;
+            header.m_chunk = chunk;
+
+            stream->Read(&header.m_chunk + 1, sizeof(header) - sizeof(Bin::Chunk));
+            *numReadInOut += sizeof(header) - sizeof(Bin::Chunk);
+
+            const size_t dataSize = size_t(header.m_numEntries) * typeSize;
+            const size_t payloadSize = header.m_chunk.m_size - (sizeof(header) - sizeof(Bin::Chunk));
+            if (header.m_numCompressedEntries != dataSize)
+            {
+                return SLANG_FAIL;
+            }
+
+            // Decompress straight into the array
+            void* data = listOut.setSize(header.m_numEntries);
+            SLANG_RETURN_ON_FAIL(_readLZ4(stream, payloadSize, data, dataSize));
+            *numReadInOut += payloadSize;
+            break;
+        }
+        case Bin::CompressionType::VariableByteLite:
+        case Bin::CompressionType::StreamVByte:
+        {
+            // We have a compressed header
             Bin::CompressedArrayHeader header;
             header.m_chunk = chunk;
 
@@ -1179,7 +1601,14 @@ static Result _readArrayChunk(IRSerialBinary::CompressionType compressionType, c
             SLANG_ASSERT(header.m_numCompressedEntries == uint32_t((header.m_numEntries * typeSize) / sizeof(uint32_t)));
 
             // Decode..
-            ByteEncodeUtil::decodeLiteUInt32(compressedPayload.begin(), header.m_numCompressedEntries, (uint32_t*)data);
+            if (compressionType == Bin::CompressionType::VariableByteLite)
+            {
+                ByteEncodeUtil::decodeLiteUInt32(compressedPayload.begin(), header.m_numCompressedEntries, (uint32_t*)data);
+            }
+            else
+            {
+                ByteEncodeUtil::decodeStreamVByteUInt32(compressedPayload.begin(), payloadSize, header.m_numCompressedEntries, (uint32_t*)data);
+            }
             break;
         }
         case Bin::CompressionType::None:
@@ -1199,6 +1628,10 @@ static Result _readArrayChunk(IRSerialBinary::CompressionType compressionType, c
             *numReadInOut += payloadSize;
             break;
         }
+        default:
+        {
+            return SLANG_FAIL;
+        }
     }
 
     // All chunks have sizes rounded to dword size
@@ -1231,20 +1664,57 @@ Result _readArrayChunk(const IRSerialBinary::SlangHeader& header, const IRSerial
     return _readArrayChunk(compressionType, chunk, stream, numReadInOut, resizer);
 }  
 
-template <typename T>
-Result _readArrayUncompressedChunk(const IRSerialBinary::SlangHeader& header, const IRSerialBinary::Chunk& chunk, Stream* stream, size_t* numReadInOut, List<T>& arrayOut)
+static Result _decodeInstsStreamVByte(const List<uint8_t>& encodeIn, size_t numValues, List<IRSerialData::Inst>& instsOut)
 {
-    typedef IRSerialBinary Bin;
-    SLANG_UNUSED(header);
-    ListResizerForType<T> resizer(arrayOut);
-    return _readArrayChunk(Bin::CompressionType::None, chunk, stream, numReadInOut, resizer);
+    typedef IRSerialData::Inst::PayloadType PayloadType;
+
+    const size_t numInsts = size_t(instsOut.Count());
+    if (size_t(encodeIn.Count()) < numInsts * 2)
+    {
+        return SLANG_FAIL;
+    }
+
+    // Decode all the values in one go
+    List<uint32_t> values;
+    values.SetSize(UInt(numValues));
+    ByteEncodeUtil::decodeStreamVByteUInt32(encodeIn.begin() + numInsts * 2, size_t(encodeIn.Count()) - numInsts * 2, numValues, values.begin());
+
+    const uint8_t* ops = encodeIn.begin();
+    const uint8_t* payloadTypes = ops + numInsts;
+    const uint32_t* valuesCur = values.begin();
+    const uint32_t* valuesEnd = values.end();
+
+    IRSerialData::Inst* insts = instsOut.begin();
+    for (size_t i = 0; i < numInsts; ++i)
+    {
+        auto& inst = insts[i];
+
+        inst.m_op = ops[i];
+        inst.m_payloadType = PayloadType(payloadTypes[i]);
+
+        const int numPayloadValues = _getNumPayloadValues(inst.m_payloadType);
+        if (valuesCur + 1 + numPayloadValues > valuesEnd)
+        {
+            return SLANG_FAIL;
+        }
+
+        inst.m_resultTypeIndex = IRSerialData::InstIndex(*valuesCur++);
+        memcpy(&inst.m_payload, valuesCur, sizeof(uint32_t) * numPayloadValues);
+        valuesCur += numPayloadValues;
+    }
+
+    return SLANG_OK;
 }
 
-static Result _decodeInsts(IRSerialBinary::CompressionType compressionType, const List<uint8_t>& encodeIn, List<IRSerialData::Inst>& instsOut)
+static Result _decodeInsts(IRSerialBinary::CompressionType compressionType, const List<uint8_t>& encodeIn, size_t numCompressedEntries, List<IRSerialData::Inst>& instsOut)
 {
     typedef IRSerialBinary Bin;
     typedef IRSerialData::Inst::PayloadType PayloadType;
 
+    if (compressionType == Bin::CompressionType::StreamVByte)
+    {
+        return _decodeInstsStreamVByte(encodeIn, numCompressedEntries, instsOut);
+    }
     if (compressionType != Bin::CompressionType::VariableByteLite)
     {
         return SLANG_FAIL;
@@ -1320,11 +1790,13 @@ Result _readInstArrayChunk(const IRSerialBinary::SlangHeader& slangHeader, const
     switch (compressionType)
     {
         case Bin::CompressionType::None:
+        case Bin::CompressionType::LZ4:
         {
             ListResizerForType<IRSerialData::Inst> resizer(arrayOut);
             return _readArrayChunk(compressionType, chunk, stream, numReadInOut, resizer);
         }
         case Bin::CompressionType::VariableByteLite:
+        case Bin::CompressionType::StreamVByte:
         {
             // We have a compressed header
             Bin::CompressedArrayHeader header;
@@ -1344,7 +1816,7 @@ Result _readInstArrayChunk(const IRSerialBinary::SlangHeader& slangHeader, const
 
             arrayOut.SetSize(header.m_numEntries);
 
-            SLANG_RETURN_ON_FAIL(_decodeInsts(compressionType, compressedPayload, arrayOut));
+            SLANG_RETURN_ON_FAIL(_decodeInsts(compressionType, compressedPayload, header.m_numCompressedEntries, arrayOut));
             break;
         }
         default:
@@ -1460,16 +1932,31 @@ int64_t _calcChunkTotalSize(const IRSerialBinary::Chunk& chunk)
                 remainingBytes -= _calcChunkTotalSize(chunk);
                 break;
             }
+            case SLANG_MAKE_COMPRESSED_FOUR_CC(Bin::kGlobalValueBodyFourCc):
+            case Bin::kGlobalValueBodyFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(_readArrayChunk(slangHeader, chunk, stream, &bytesRead, dataOut->m_globalValueBodies));
+                remainingBytes -= _calcChunkTotalSize(chunk);
+                break;
+            }
+            case SLANG_MAKE_COMPRESSED_FOUR_CC(Bin::kStringFourCc):
             case Bin::kStringFourCc:
             {
-                SLANG_RETURN_ON_FAIL(_readArrayUncompressedChunk(slangHeader, chunk, stream, &bytesRead, dataOut->m_stringTable));
+                SLANG_RETURN_ON_FAIL(_readArrayChunk(slangHeader, chunk, stream, &bytesRead, dataOut->m_stringTable));
                 remainingBytes -= _calcChunkTotalSize(chunk);
                 break;
             }
+            case SLANG_MAKE_COMPRESSED_FOUR_CC(Bin::kUInt32SourceLocFourCc):
             case Bin::kUInt32SourceLocFourCc:
             {
-                
-                SLANG_RETURN_ON_FAIL(_readArrayUncompressedChunk(slangHeader, chunk, stream, &bytesRead, dataOut->m_rawSourceLocs));
+                SLANG_RETURN_ON_FAIL(_readArrayChunk(slangHeader, chunk, stream, &bytesRead, dataOut->m_rawSourceLocs));
+                remainingBytes -= _calcChunkTotalSize(chunk);
+                break;
+            }
+            case SLANG_MAKE_COMPRESSED_FOUR_CC(Bin::kSourceLocTableFourCc):
+            case Bin::kSourceLocTableFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(_readArrayChunk(slangHeader, chunk, stream, &bytesRead, dataOut->m_sourceLocTable));
                 remainingBytes -= _calcChunkTotalSize(chunk);
                 break;
             }
@@ -1484,6 +1971,167 @@ int64_t _calcChunkTotalSize(const IRSerialBinary::Chunk& chunk)
     return SLANG_OK;
 }
 
+// Get a view of an uncompressed array chunk held in memory. If the contents are not aligned for the type, they are copied into storage.
+template <typename T>
+static Result _getArrayChunkView(const uint8_t* chunkStart, List<T>& storage, ArrayView<const T>& viewOut)
+{
+    typedef IRSerialBinary Bin;
+
+    Bin::ArrayHeader header;
+    memcpy(&header, chunkStart, sizeof(header));
+
+    const size_t payloadSize = size_t(header.m_numEntries) * sizeof(T);
+    if (size_t(header.m_chunk.m_size) < sizeof(header) - sizeof(Bin::Chunk) + payloadSize)
+    {
+        return SLANG_FAIL;
+    }
+
+    const uint8_t* payload = chunkStart + sizeof(header);
+    if ((size_t(payload) & (SLANG_ALIGN_OF(T) - 1)) == 0)
+    {
+        viewOut = ArrayView<const T>((const T*)payload, int(header.m_numEntries));
+    }
+    else
+    {
+        storage.SetSize(header.m_numEntries);
+        memcpy(storage.Buffer(), payload, payloadSize);
+        viewOut = _getView(storage);
+    }
+    return SLANG_OK;
+}
+
+// Get a view of an array chunk held in memory, decoding into storage if it is compressed
+template <typename T>
+static Result _getArrayChunkView(const IRSerialBinary::SlangHeader& slangHeader, const uint8_t* chunkStart, Stream* stream, List<T>& storage, ArrayView<const T>& viewOut)
+{
+    IRSerialBinary::Chunk chunk;
+    memcpy(&chunk, chunkStart, sizeof(chunk));
+
+    if (chunk.m_type == SLANG_MAKE_COMPRESSED_FOUR_CC(chunk.m_type))
+    {
+        size_t bytesRead = sizeof(chunk);
+        SLANG_RETURN_ON_FAIL(_readArrayChunk(slangHeader, chunk, stream, &bytesRead, storage));
+        viewOut = _getView(storage);
+        return SLANG_OK;
+    }
+    return _getArrayChunkView(chunkStart, storage, viewOut);
+}
+
+/* static */Result IRSerialReader::readContainer(const void* data, size_t size, IRSerialData* storageOut, IRSerialDataView* viewOut)
+{
+    typedef IRSerialBinary Bin;
+
+    storageOut->clear();
+    viewOut->set(*storageOut);
+
+    const uint8_t* start = (const uint8_t*)data;
+    
+    Bin::Chunk riffHeader;
+    if (size < sizeof(riffHeader))
+    {
+        return SLANG_FAIL;
+    }
+    memcpy(&riffHeader, start, sizeof(riffHeader));
+    if (riffHeader.m_type != Bin::kRiffFourCc || riffHeader.m_size > size - sizeof(riffHeader))
+    {
+        return SLANG_FAIL;
+    }
+
+    // Compressed chunks are decoded with the same functions as readStream
+    MemoryStream stream(data, size);
+
+    Bin::SlangHeader slangHeader;
+    memset(&slangHeader, 0, sizeof(slangHeader));
+
+    const uint8_t* cur = start + sizeof(riffHeader);
+    const uint8_t* end = cur + riffHeader.m_size;
+
+    while (cur + sizeof(Bin::Chunk) <= end)
+    {
+        Bin::Chunk chunk;
+        memcpy(&chunk, cur, sizeof(chunk));
+
+        const int64_t chunkTotalSize = _calcChunkTotalSize(chunk);
+        if (chunkTotalSize > int64_t(size - size_t(cur - start)))
+        {
+            return SLANG_FAIL;
+        }
+
+        // Position the stream after the chunk header, as the stream readers expect
+        stream.Seek(SeekOrigin::Start, Int64(cur - start) + sizeof(chunk));
+
+        switch (chunk.m_type)
+        {
+            case Bin::kSlangFourCc:
+            {
+                memcpy(&slangHeader, cur, Math::Min(sizeof(slangHeader), size_t(chunkTotalSize)));
+                storageOut->m_decorationBaseIndex = slangHeader.m_decorationBase;
+                viewOut->m_decorationBaseIndex = slangHeader.m_decorationBase;
+                break;
+            }
+            case SLANG_MAKE_COMPRESSED_FOUR_CC(Bin::kInstFourCc):
+            {
+                size_t bytesRead = sizeof(chunk);
+                SLANG_RETURN_ON_FAIL(_readInstArrayChunk(slangHeader, chunk, &stream, &bytesRead, storageOut->m_insts));
+                viewOut->m_insts = _getView(storageOut->m_insts);
+                break;
+            }
+            case Bin::kInstFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(_getArrayChunkView(cur, storageOut->m_insts, viewOut->m_insts));
+                break;
+            }
+            case SLANG_MAKE_COMPRESSED_FOUR_CC(Bin::kDecoratorRunFourCc):
+            case Bin::kDecoratorRunFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(_getArrayChunkView(slangHeader, cur, &stream, storageOut->m_decorationRuns, viewOut->m_decorationRuns));
+                break;
+            }
+            case SLANG_MAKE_COMPRESSED_FOUR_CC(Bin::kChildRunFourCc):
+            case Bin::kChildRunFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(_getArrayChunkView(slangHeader, cur, &stream, storageOut->m_childRuns, viewOut->m_childRuns));
+                break;
+            }
+            case SLANG_MAKE_COMPRESSED_FOUR_CC(Bin::kExternalOperandsFourCc):
+            case Bin::kExternalOperandsFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(_getArrayChunkView(slangHeader, cur, &stream, storageOut->m_externalOperands, viewOut->m_externalOperands));
+                break;
+            }
+            case SLANG_MAKE_COMPRESSED_FOUR_CC(Bin::kGlobalValueBodyFourCc):
+            case Bin::kGlobalValueBodyFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(_getArrayChunkView(slangHeader, cur, &stream, storageOut->m_globalValueBodies, viewOut->m_globalValueBodies));
+                break;
+            }
+            case SLANG_MAKE_COMPRESSED_FOUR_CC(Bin::kStringFourCc):
+            case Bin::kStringFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(_getArrayChunkView(slangHeader, cur, &stream, storageOut->m_stringTable, viewOut->m_stringTable));
+                break;
+            }
+            case SLANG_MAKE_COMPRESSED_FOUR_CC(Bin::kUInt32SourceLocFourCc):
+            case Bin::kUInt32SourceLocFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(_getArrayChunkView(slangHeader, cur, &stream, storageOut->m_rawSourceLocs, viewOut->m_rawSourceLocs));
+                break;
+            }
+            case SLANG_MAKE_COMPRESSED_FOUR_CC(Bin::kSourceLocTableFourCc):
+            case Bin::kSourceLocTableFourCc:
+            {
+                SLANG_RETURN_ON_FAIL(_getArrayChunkView(slangHeader, cur, &stream, storageOut->m_sourceLocTable, viewOut->m_sourceLocTable));
+                break;
+            }
+            default: break;
+        }
+
+        cur += chunkTotalSize;
+    }
+
+    return SLANG_OK;
+}
+
 IRDecoration* IRSerialReader::_createDecoration(const Ser::Inst& srcInst)
 {
     typedef Ser::Inst::PayloadType PayloadType;
@@ -1601,56 +2249,24 @@ IRDecoration* IRSerialReader::_createDecoration(const Ser::Inst& srcInst)
     }
 }
 
-/* static */Result IRSerialReader::read(const IRSerialData& data, Session* session, RefPtr<IRModule>& moduleOut)
+Result IRSerialReader::read(const IRSerialData& data, Session* session, RefPtr<IRModule>& moduleOut)
 {
-    typedef Ser::Inst::PayloadType PayloadType;
-
-    m_serialData = &data;
- 
-    auto module = new IRModule();
-    moduleOut = module;
-    m_module = module;
-
-    module->session = session;
-
-    // Set up the string rep cache
-    m_stringRepresentationCache.init(&data.m_stringTable, session->getNamePool(), module->getObjectScopeManager());
-    
-    // Add all the instructions
-
-    List<IRInst*> insts;
-    List<IRDecoration*> decorations;
-
-    const int numInsts = data.m_decorationBaseIndex;
-    const int numDecorations = int(data.m_insts.Count() - numInsts);
-
-    SLANG_ASSERT(numInsts > 0);
-
-    insts.SetSize(numInsts);
-    insts[0] = nullptr;
-
-    decorations.SetSize(numDecorations);
-
-    // 0 holds null
-    // 1 holds the IRModuleInst
-    {
-        // Check that insts[1] is the module inst
-        const Ser::Inst& srcInst = data.m_insts[1];
-        SLANG_RELEASE_ASSERT(srcInst.m_op == kIROp_Module);
-        SLANG_ASSERT(srcInst.m_payloadType == PayloadType::Empty);
+    IRSerialDataView view;
+    view.set(data);
+    return read(view, session, moduleOut);
+}
 
-        // Create the module inst
-        auto moduleInst = static_cast<IRModuleInst*>(createEmptyInstWithSize(module, kIROp_Module, sizeof(IRModuleInst)));
-        module->moduleInst = moduleInst;
-        moduleInst->module = module;
+Result IRSerialReader::_createInsts(int start, int end)
+{
+    typedef Ser::Inst::PayloadType PayloadType;
 
-        // Set the IRModuleInst
-        insts[1] = moduleInst; 
-    }
+    IRModule* module = m_module;
+    const IRSerialDataView& data = *m_serialData;
 
-    for (int i = 2; i < numInsts; ++i)
+    for (int i = start; i < end; ++i)
     {
         const Ser::Inst& srcInst = data.m_insts[i];
+        SLANG_ASSERT(m_insts[i] == nullptr);
 
         const IROp op((IROp)srcInst.m_op);
 
@@ -1662,7 +2278,7 @@ IRDecoration* IRSerialReader::_createDecoration(const Ser::Inst& srcInst)
             if (isGlobalValueDerived(op))
             {
                 IRGlobalValue* globalValueInst = static_cast<IRGlobalValue*>(createEmptyInstWithSize(module, op, sizeof(IRGlobalValue)));
-                insts[i] = globalValueInst;
+                m_insts[i] = globalValueInst;
                 // Set the global value
                 SLANG_ASSERT(srcInst.m_payloadType == PayloadType::String_1);
                 globalValueInst->mangledName = m_stringRepresentationCache.getName(StringHandle(srcInst.m_payload.m_stringIndices[0]));
@@ -1671,7 +2287,7 @@ IRDecoration* IRSerialReader::_createDecoration(const Ser::Inst& srcInst)
             {
                 // Just needs to big enough to hold IRParentInst
                 IRParentInst* parentInst = static_cast<IRParentInst*>(createEmptyInstWithSize(module, op, sizeof(IRParentInst)));
-                insts[i] = parentInst;
+                m_insts[i] = parentInst;
             }
         }
         else
@@ -1734,7 +2350,7 @@ IRDecoration* IRSerialReader::_createDecoration(const Ser::Inst& srcInst)
                     }
                 }
 
-                insts[i] = irConst;
+                m_insts[i] = irConst;
             }
             else if (isTextureTypeBase(op))
             {
@@ -1745,28 +2361,31 @@ IRDecoration* IRSerialReader::_createDecoration(const Ser::Inst& srcInst)
                 const uint32_t other = srcInst.m_payload.m_operandAndUInt32.m_uint32;
                 inst->op = IROp(uint32_t(inst->op) | (other << kIROpMeta_OtherShift));
 
-                insts[i] = inst;
+                m_insts[i] = inst;
             }
             else
             {
                 int numOperands = srcInst.getNumOperands();
-                insts[i] = createEmptyInst(module, op, numOperands);
+                m_insts[i] = createEmptyInst(module, op, numOperands);
             }
         }                    
-    } 
+    }
 
-    // Patch up the operands
-    for (int i = 1; i < numInsts; ++i)
+    return SLANG_OK;
+}
+
+void IRSerialReader::_setOperands(int start, int end)
+{
+    const IRSerialDataView& data = *m_serialData;
+    for (int i = start; i < end; ++i)
     {
         const Ser::Inst& srcInst = data.m_insts[i];
-        const IROp op((IROp)srcInst.m_op);
-
-        IRInst* dstInst = insts[i];
+        IRInst* dstInst = m_insts[i];
 
         // Set the result type
         if (srcInst.m_resultTypeIndex != Ser::InstIndex(0))
         {
-            IRInst* resultInst = insts[int(srcInst.m_resultTypeIndex)];
+            IRInst* resultInst = m_insts[int(srcInst.m_resultTypeIndex)];
             // NOTE! Counter intuitively the IRType* paramter may not be IRType* derived for example 
             // IRGlobalGenericParam is valid, but isn't IRType* derived
 
@@ -1774,95 +2393,309 @@ IRDecoration* IRSerialReader::_createDecoration(const Ser::Inst& srcInst)
             dstInst->setFullType(static_cast<IRType*>(resultInst));
         }
        
-        //if (!isParentDerived(op))
-        {
-            const Ser::InstIndex* srcOperandIndices;
-            const int numOperands = data.getOperands(srcInst, &srcOperandIndices);
+        const Ser::InstIndex* srcOperandIndices;
+        const int numOperands = data.getOperands(srcInst, &srcOperandIndices);
                          
-            for (int j = 0; j < numOperands; j++)
-            {
-                dstInst->setOperand(j, insts[int(srcOperandIndices[j])]);
-            }
+        for (int j = 0; j < numOperands; j++)
+        {
+            dstInst->setOperand(j, m_insts[int(srcOperandIndices[j])]);
         }
     }
-    
-    // Patch up the children
+}
+
+void IRSerialReader::_addChildren(int startRun, int endRun)
+{
+    for (int i = startRun; i < endRun; i++)
     {
-        const int numChildRuns = int(data.m_childRuns.Count());
-        for (int i = 0; i < numChildRuns; i++)
+        const auto& run = m_serialData->m_childRuns[i];
+
+        IRInst* inst = m_insts[int(run.m_parentIndex)];
+        IRParentInst* parentInst = as<IRParentInst>(inst);
+        SLANG_ASSERT(parentInst);
+
+        for (int j = 0; j < int(run.m_numChildren); ++j)
         {
-            const auto& run = data.m_childRuns[i];
+            IRInst* child = m_insts[j + int(run.m_startInstIndex)];
+            SLANG_ASSERT(child->parent == nullptr);
+            child->insertAtEnd(parentInst);
+        }
+    }
+}
+
+Result IRSerialReader::_addDecorations(int startRun, int endRun)
+{
+    const int decorationBaseIndex = m_serialData->m_decorationBaseIndex;
+
+    for (int i = startRun; i < endRun; ++i)
+    {
+        const Ser::InstRun& run = m_serialData->m_decorationRuns[i];
 
-            IRInst* inst = insts[int(run.m_parentIndex)];
-            IRParentInst* parentInst = as<IRParentInst>(inst);
-            SLANG_ASSERT(parentInst);
+        // Decorations must be associated with instructions
+        SLANG_ASSERT(int(run.m_parentIndex) < decorationBaseIndex);
 
-            for (int j = 0; j < int(run.m_numChildren); ++j)
+        IRInst* inst = m_insts[int(run.m_parentIndex)];
+        SLANG_ASSERT(int(run.m_startInstIndex) >= decorationBaseIndex && int(run.m_startInstIndex) + run.m_numChildren <= m_serialData->m_insts.Count());
+
+        // Go in reverse order so that linked list is in same order as original
+        for (int j = int(run.m_numChildren) - 1; j >= 0; --j)
+        {
+            IRDecoration* decor = _createDecoration(m_serialData->m_insts[int(run.m_startInstIndex) + j]);
+            if (!decor)
             {
-                IRInst* child = insts[j + int(run.m_startInstIndex)];
-                SLANG_ASSERT(child->parent == nullptr);
-                //child->parent = parentInst;
-                child->insertAtEnd(parentInst);
+                return SLANG_FAIL;
             }
+            // And to the linked list on the 
+            decor->next = inst->firstDecoration;
+            inst->firstDecoration = decor;
         }
     }
+    return SLANG_OK;
+}
 
-    // Create the decorations
-    for (int i = 0; i < numDecorations; ++i)
+void IRSerialReader::_setSourceLocs(int start, int end)
+{
+    // Re-add source locations, if they are defined
+    if (m_serialData->m_rawSourceLocs.Count() == int(m_insts.Count()))
     {
-        IRDecoration* decor = _createDecoration(data.m_insts[i + numInsts]);
-        if (!decor)
+        const Ser::RawSourceLoc* srcLocs = m_serialData->m_rawSourceLocs.begin();
+        for (int i = start; i < end; ++i)
         {
-            return SLANG_FAIL;
+            IRInst* dstInst = m_insts[i];
+            dstInst->sourceLoc.setRaw(Slang::SourceLoc::RawValue(srcLocs[i]));
+        }
+    }
+    else if (m_serialData->m_sourceLocTable.Count())
+    {
+        // The table is only decoded when instructions are first created, so the locations of bodies that are never created are never decoded
+        if (!m_hasSourceLocRuns)
+        {
+            m_hasSourceLocRuns = true;
+            if (SLANG_FAILED(SerialSourceLocTableUtil::decode(m_serialData->m_sourceLocTable.begin(), size_t(m_serialData->m_sourceLocTable.Count()), m_sourceLocRuns)))
+            {
+                SLANG_ASSERT(!"Invalid source location table");
+                m_sourceLocRuns.Clear();
+            }
+        }
+
+        // Find the first run that ends after start
+        const Ser::DebugLocRun* runs = m_sourceLocRuns.Buffer();
+        int lo = 0;
+        int hi = int(m_sourceLocRuns.Count());
+        while (lo < hi)
+        {
+            const int mid = (lo + hi) >> 1;
+            if (int(runs[mid].startInstIndex + runs[mid].numInst) <= start)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+
+        for (int i = lo; i < int(m_sourceLocRuns.Count()) && int(runs[i].startInstIndex) < end; ++i)
+        {
+            const Ser::DebugLocRun& run = runs[i];
+            const int runStart = Math::Max(start, int(run.startInstIndex));
+            const int runEnd = Math::Min(end, int(run.startInstIndex + run.numInst));
+            for (int j = runStart; j < runEnd; ++j)
+            {
+                m_insts[j]->sourceLoc.setRaw(run.m_sourceLoc);
+            }
         }
-        decorations[i] = decor;
     }
+}
 
-    // Associate the decorations with the instructions
+Result IRSerialReader::read(const IRSerialDataView& data, Session* session, RefPtr<IRModule>& moduleOut)
+{
+    return _read(data, session, false, moduleOut);
+}
 
+Result IRSerialReader::_read(const IRSerialDataView& data, Session* session, bool isLazy, RefPtr<IRModule>& moduleOut)
+{
+    m_serialData = &data;
+    m_hasSourceLocRuns = false;
+    m_sourceLocRuns.Clear();
+ 
+    auto module = new IRModule();
+    moduleOut = module;
+    m_module = module;
+
+    module->session = session;
+
+    // Set up the string rep cache
+    m_stringRepresentationCache.init(data.m_stringTable, session->getNamePool(), module->getObjectScopeManager());
+    
+    // Add all the instructions
+
+    const int numInsts = data.m_decorationBaseIndex;
+    SLANG_ASSERT(numInsts > 0);
+
+    m_insts.SetSize(numInsts);
+    memset(m_insts.Buffer(), 0, sizeof(IRInst*) * numInsts);
+
+    // 0 holds null
+    // 1 holds the IRModuleInst
     {
-        const int decorationBaseIndex = m_serialData->m_decorationBaseIndex;
+        // Check that insts[1] is the module inst
+        const Ser::Inst& srcInst = data.m_insts[1];
+        SLANG_RELEASE_ASSERT(srcInst.m_op == kIROp_Module);
+        SLANG_ASSERT(srcInst.m_payloadType == Ser::Inst::PayloadType::Empty);
+
+        // Create the module inst
+        auto moduleInst = static_cast<IRModuleInst*>(createEmptyInstWithSize(module, kIROp_Module, sizeof(IRModuleInst)));
+        module->moduleInst = moduleInst;
+        moduleInst->module = module;
 
-        const int numRuns = int(m_serialData->m_decorationRuns.Count());
-        for (int i = 0; i < numRuns; ++i)
+        // Set the IRModuleInst
+        m_insts[1] = moduleInst; 
+
+        _setSourceLocs(1, 2);
+    }
+
+    // Work out the ranges of instructions (and child and decoration runs) to create now. If reading lazily the bodies are 
+    // skipped, otherwise everything is created.
+    struct Range
+    {
+        int m_startInst, m_endInst;
+        int m_startChildRun, m_endChildRun;
+        int m_startDecorationRun, m_endDecorationRun;
+    };
+    List<Range> ranges;
+    {
+        Range range = { 2, numInsts, 0, int(data.m_childRuns.Count()), 0, int(data.m_decorationRuns.Count()) };
+        if (isLazy)
         {
-            const Ser::InstRun& run = m_serialData->m_decorationRuns[i];
+            for (const auto& body : data.m_globalValueBodies)
+            {
+                Range bodyRange = range;
+                bodyRange.m_endInst = int(body.m_startInstIndex);
+                bodyRange.m_endChildRun = int(body.m_startChildRunIndex);
+                bodyRange.m_endDecorationRun = int(body.m_startDecorationRunIndex);
+                ranges.Add(bodyRange);
+
+                range.m_startInst = int(body.m_startInstIndex) + int(body.m_numInsts);
+                range.m_startChildRun = int(body.m_startChildRunIndex + body.m_numChildRuns);
+                range.m_startDecorationRun = int(body.m_startDecorationRunIndex + body.m_numDecorationRuns);
+            }
+        }
+        ranges.Add(range);
+    }
+
+    // Instructions can reference instructions in later ranges, so they must all be created before setting operands
+    for (const auto& range : ranges)
+    {
+        SLANG_RETURN_ON_FAIL(_createInsts(range.m_startInst, range.m_endInst));
+    }
+    for (const auto& range : ranges)
+    {
+        _setOperands(range.m_startInst, range.m_endInst);
+        _addChildren(range.m_startChildRun, range.m_endChildRun);
+        SLANG_RETURN_ON_FAIL(_addDecorations(range.m_startDecorationRun, range.m_endDecorationRun));
+        _setSourceLocs(range.m_startInst, range.m_endInst);
+    }
+
+    return SLANG_OK;
+}
+
+Result IRSerialReader::materializeBody(int bodyIndex)
+{
+    const Ser::GlobalValueBody& body = m_serialData->m_globalValueBodies[bodyIndex];
 
-            // Decorations must be associated with instructions
-            SLANG_ASSERT(int(run.m_parentIndex) < decorationBaseIndex);
+    const int startInst = int(body.m_startInstIndex);
+    const int endInst = startInst + int(body.m_numInsts);
+    const int startChildRun = int(body.m_startChildRunIndex);
+    const int startDecorationRun = int(body.m_startDecorationRunIndex);
 
-            IRInst* inst = insts[int(run.m_parentIndex)];
-            SLANG_ASSERT(int(run.m_startInstIndex) >= decorationBaseIndex && int(run.m_startInstIndex) + run.m_numChildren <= m_serialData->m_insts.Count());
+    SLANG_RETURN_ON_FAIL(_createInsts(startInst, endInst));
+    _setOperands(startInst, endInst);
+    _addChildren(startChildRun, startChildRun + int(body.m_numChildRuns));
+    SLANG_RETURN_ON_FAIL(_addDecorations(startDecorationRun, startDecorationRun + int(body.m_numDecorationRuns)));
+    _setSourceLocs(startInst, endInst);
 
-            // Calculate the offset in the decoration list, which index 0, is decorationBaseIndex in instruction indices
-            const int decorStartIndex = int(run.m_startInstIndex) - decorationBaseIndex;
+    return SLANG_OK;
+}
 
-            // Go in reverse order so that linked list is in same order as original
-            for (int j = int(run.m_numChildren) - 1; j >= 0; --j)
+// Creates the bodies of a module read with IRSerialReader::readLazy, when they are needed
+class IRSerialLazyMaterializer : public IRModuleMaterializer
+{
+public:
+    // IRModuleMaterializer
+    virtual void materialize(IRGlobalValue* globalValue) SLANG_OVERRIDE
+    {
+        int bodyIndex;
+        if (m_bodyIndexMap.TryGetValue(globalValue, bodyIndex) && !m_isMaterialized[bodyIndex])
+        {
+            _materialize(bodyIndex);
+        }
+    }
+    virtual void materializeAll() SLANG_OVERRIDE
+    {
+        for (int i = 0; i < int(m_isMaterialized.Count()); ++i)
+        {
+            if (!m_isMaterialized[i])
             {
-                IRDecoration* decor = decorations[decorStartIndex + j]; 
-                // And to the linked list on the 
-                decor->next = inst->firstDecoration;
-                inst->firstDecoration = decor;
+                _materialize(i);
             }
         }
     }
 
-    // Re-add source locations, if they are defined
-    if (int(m_serialData->m_rawSourceLocs.Count()) == numInsts)
+    IRSerialLazyMaterializer(IRSerialContainer* container, DiagnosticSink* sink):
+        m_container(container),
+        m_sink(sink)
     {
-        const Ser::RawSourceLoc* srcLocs = m_serialData->m_rawSourceLocs.begin();
-        for (int i = 1; i < numInsts; ++i)
+    }
+
+    void _materialize(int bodyIndex)
+    {
+        m_isMaterialized[bodyIndex] = true;
+        if (SLANG_FAILED(m_reader.materializeBody(bodyIndex)))
         {
-            IRInst* dstInst = insts[i];
-            
-            dstInst->sourceLoc.setRaw(Slang::SourceLoc::RawValue(srcLocs[i]));
+            if (m_sink)
+            {
+                m_sink->diagnose(SourceLoc(), Diagnostics::serialIRRoundTripFailed, "unable to create the body of a global value");
+            }
         }
     }
 
+    IRSerialReader m_reader;
+    RefPtr<IRSerialContainer> m_container;      ///< Holds the data the reader uses
+    DiagnosticSink* m_sink;                     ///< Failures to create a body are reported here (can be nullptr)
+    Dictionary<IRInst*, int> m_bodyIndexMap;    ///< Map from a global value to the index of its body
+    List<bool> m_isMaterialized;                ///< True for a body index if it has been created
+};
+
+/* static */Result IRSerialReader::readLazy(IRSerialContainer* container, Session* session, DiagnosticSink* sink, RefPtr<IRModule>& moduleOut)
+{
+    RefPtr<IRSerialLazyMaterializer> materializer(new IRSerialLazyMaterializer(container, sink));
+    IRSerialReader& reader = materializer->m_reader;
+
+    const IRSerialDataView& data = container->getView();
+    SLANG_RETURN_ON_FAIL(reader._read(data, session, true, moduleOut));
+
+    const int numBodies = int(data.m_globalValueBodies.Count());
+    if (numBodies)
+    {
+        materializer->m_isMaterialized.SetSize(numBodies);
+        for (int i = 0; i < numBodies; ++i)
+        {
+            materializer->m_isMaterialized[i] = false;
+            materializer->m_bodyIndexMap.Add(reader.m_insts[int(data.m_globalValueBodies[i].m_globalValueIndex)], i);
+        }
+        moduleOut->materializer = materializer;
+    }
     return SLANG_OK;
 }
 
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! IRSerialContainer !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+Result IRSerialContainer::init(List<uint8_t>& contentsInOut)
+{
+    m_contents.SwapWith(contentsInOut);
+    return IRSerialReader::readContainer(m_contents.Buffer(), size_t(m_contents.Count()), &m_storage, &m_view);
+}
+
 // !!!!!!!!!!!!!!!!!!!!!!!!!!!! Free functions !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 
 #if 0
@@ -8,6 +8,7 @@
 #include "../core/slang-object-scope-manager.h"
 
 #include "ir.h"
+#include "serial-source-loc-table.h"
 
 // For TranslationUnitRequest
 #include "compiler.h"
@@ -23,7 +24,8 @@ class StringRepresentationCache
     {
         uint32_t m_startIndex;
         uint32_t m_numChars;
-        RefObject* m_object;                ///< Could be nullptr, Name, or StringRepresentation. 
+        StringRepresentation* m_stringRep;  ///< Could be nullptr
+        Name* m_name;                       ///< Could be nullptr
     };
 
         /// Get as a name
@@ -37,8 +39,8 @@ class StringRepresentationCache
         /// Get as a 0 terminated 'c style' string
     char* getCStr(Handle handle);
 
-        /// Initialize a cache to use a string table, namePool and scopeManager
-    void init(const List<char>* stringTable, NamePool* namePool, ObjectScopeManager* scopeManager);
+        /// Initialize a cache to use a string table, namePool and scopeManager. The string table must stay in scope whilst the cache is used.
+    void init(const ArrayView<const char>& stringTable, NamePool* namePool, ObjectScopeManager* scopeManager);
 
         /// Ctor
     StringRepresentationCache(); 
@@ -46,7 +48,7 @@ class StringRepresentationCache
     protected:
     ObjectScopeManager* m_scopeManager;
     NamePool* m_namePool;
-    const List<char>* m_stringTable;
+    ArrayView<const char> m_stringTable;
     List<Entry> m_entries;
 };
 
@@ -61,6 +63,7 @@ struct SerialStringTableUtil
 
 // Pre-declare
 class Name;
+class IRSerialContainer;
 
 struct IRSerialData
 {
@@ -95,6 +98,33 @@ struct IRSerialData
         SizeType m_numChildren;                 ///< The number of children
     };
 
+    /// The instructions beneath a global value with code (such as a function or generic) that is held at module scope.
+    /// The instructions of the body (its blocks and everything in them) are contiguous, as are the child and decoration
+    /// runs for them, so a reader can defer creating them until the body is needed.
+    struct GlobalValueBody
+    {
+        typedef GlobalValueBody ThisType;
+        SLANG_FORCE_INLINE bool operator==(const ThisType& rhs) const 
+        {
+            return m_globalValueIndex == rhs.m_globalValueIndex &&
+                m_startInstIndex == rhs.m_startInstIndex &&
+                m_numInsts == rhs.m_numInsts &&
+                m_startChildRunIndex == rhs.m_startChildRunIndex &&
+                m_numChildRuns == rhs.m_numChildRuns &&
+                m_startDecorationRunIndex == rhs.m_startDecorationRunIndex &&
+                m_numDecorationRuns == rhs.m_numDecorationRuns;
+        }
+        SLANG_FORCE_INLINE bool operator!=(const ThisType& rhs) const { return !(*this == rhs); }
+
+        InstIndex m_globalValueIndex;           ///< The global value the body belongs to
+        InstIndex m_startInstIndex;             ///< The first instruction of the body
+        SizeType m_numInsts;                    ///< The number of instructions in the body
+        SizeType m_startChildRunIndex;          ///< The first run in m_childRuns for the body
+        SizeType m_numChildRuns;                ///< The number of child runs
+        SizeType m_startDecorationRunIndex;     ///< The first run in m_decorationRuns for the body
+        SizeType m_numDecorationRuns;           ///< The number of decoration runs
+    };
+
     struct PayloadInfo
     {
         uint8_t m_numOperands;
@@ -192,12 +222,7 @@ struct IRSerialData
         int32_t m_lineAdjust;                   ///< The line adjustment
     };
 
-    struct DebugLocRun
-    {
-        uint32_t m_sourceLoc;                   ///< The location
-        uint32_t startInstIndex;                ///< The start instruction index
-        uint32_t numInst;                       ///< The amount of instructions
-    };
+    typedef SerialSourceLocRun DebugLocRun;
 
         /// Clear to initial state
     void clear();
@@ -226,6 +251,9 @@ struct IRSerialData
     List<char> m_stringTable;                       ///< All strings. Indexed into by StringIndex
 
     List<RawSourceLoc> m_rawSourceLocs;         ///< A source location per instruction (saved without modification from IRInst)s
+    List<uint8_t> m_sourceLocTable;             ///< Source locations of instructions as a compact table (see SerialSourceLocTableUtil)
+
+    List<GlobalValueBody> m_globalValueBodies;  ///< Bodies that can be created on demand, in order of instruction index
 
     List<DebugSourceFile> m_debugSourceFiles;   ///< The files associated 
     List<uint32_t> m_debugLineOffsets;          ///< All of the debug line offsets
@@ -297,6 +325,47 @@ SLANG_FORCE_INLINE int IRSerialData::getOperands(const Inst& inst, const InstInd
 }
 
 
+/* A view of the arrays of serialized IR, which can be read into an IRModule by IRSerialReader.
+
+The arrays can be those held in an IRSerialData, or can point directly into a serialized container held in memory
+(see IRSerialReader::readContainer), so that they don't have to be copied. */
+struct IRSerialDataView
+{
+    typedef IRSerialData Ser;
+
+        /// Set to view the arrays held in data
+    void set(const IRSerialData& data);
+
+        /// Get the operands of an instruction
+    SLANG_FORCE_INLINE int getOperands(const Ser::Inst& inst, const Ser::InstIndex** operandsOut) const;
+
+    ArrayView<const Ser::Inst> m_insts;
+    ArrayView<const Ser::InstRun> m_childRuns;
+    ArrayView<const Ser::InstRun> m_decorationRuns;
+    ArrayView<const Ser::InstIndex> m_externalOperands;
+    ArrayView<const char> m_stringTable;
+    ArrayView<const Ser::RawSourceLoc> m_rawSourceLocs;
+    ArrayView<const uint8_t> m_sourceLocTable;
+    ArrayView<const Ser::GlobalValueBody> m_globalValueBodies;
+
+    int m_decorationBaseIndex = 0;
+};
+
+// --------------------------------------------------------------------------
+SLANG_FORCE_INLINE int IRSerialDataView::getOperands(const Ser::Inst& inst, const Ser::InstIndex** operandsOut) const
+{
+    if (inst.m_payloadType == Ser::Inst::PayloadType::OperandExternal)
+    {
+        *operandsOut = m_externalOperands.begin() + int(inst.m_payload.m_externalOperand.m_arrayIndex);
+        return int(inst.m_payload.m_externalOperand.m_size);
+    }
+    else
+    {
+        *operandsOut = inst.m_payload.m_operands;
+        return Ser::s_payloadInfos[int(inst.m_payloadType)].m_numOperands;
+    }
+}
+
 #define SLANG_FOUR_CC(c0, c1, c2, c3) ((uint32_t(c0) << 0) | (uint32_t(c1) << 8) | (uint32_t(c2) << 16) | (uint32_t(c3) << 24)) 
 
 #define SLANG_MAKE_COMPRESSED_FOUR_CC(fourCc) (((fourCc) & 0xffff00ff) | (uint32_t('c') << 8))
@@ -316,6 +385,8 @@ struct IRSerialBinary
     {
         None,
         VariableByteLite,
+        StreamVByte,                        ///< Control bytes are separate from the value bytes, so can be decoded with SIMD (see ByteEncodeUtil)
+        LZ4,                                ///< Arrays are stored as a sequence of LZ4 blocks (see LZ4Util). Applies to all chunks, including strings and source locations.
     };
 
     
@@ -326,15 +397,32 @@ struct IRSerialBinary
     static const uint32_t kDecoratorRunFourCc = SLANG_FOUR_CC('S', 'L', 'd', 'r');
     static const uint32_t kChildRunFourCc = SLANG_FOUR_CC('S', 'L', 'c', 'r');
     static const uint32_t kExternalOperandsFourCc = SLANG_FOUR_CC('S', 'L', 'e', 'o');
+    static const uint32_t kGlobalValueBodyFourCc = SLANG_FOUR_CC('S', 'L', 'g', 'b');
 
     static const uint32_t kCompressedInstFourCc = SLANG_MAKE_COMPRESSED_FOUR_CC(kInstFourCc);
     static const uint32_t kCompressedDecoratorRunFourCc = SLANG_MAKE_COMPRESSED_FOUR_CC(kDecoratorRunFourCc);
     static const uint32_t kCompressedChildRunFourCc = SLANG_MAKE_COMPRESSED_FOUR_CC(kChildRunFourCc);
     static const uint32_t kCompressedExternalOperandsFourCc = SLANG_MAKE_COMPRESSED_FOUR_CC(kExternalOperandsFourCc);
+    static const uint32_t kCompressedGlobalValueBodyFourCc = SLANG_MAKE_COMPRESSED_FOUR_CC(kGlobalValueBodyFourCc);
 
     static const uint32_t kStringFourCc = SLANG_FOUR_CC('S', 'L', 's', 't');
+    static const uint32_t kCompressedStringFourCc = SLANG_MAKE_COMPRESSED_FOUR_CC(kStringFourCc);
+        /// Padding, that is skipped by readers. Used to align the contents of the chunk that follows.
+    static const uint32_t kJunkFourCc = SLANG_FOUR_CC('J', 'U', 'N', 'K');
+
+        /// A container written by IRSerialWriter::writeStream keeps the contents of uncompressed arrays aligned for their type, as long as
+        /// the container starts on this alignment. IRSerialReader::readContainer can then use the arrays in place.
+    static const size_t kContainerAlignment = 8;
         /// 4 bytes per entry
     static const uint32_t kUInt32SourceLocFourCc = SLANG_FOUR_CC('S', 'r', 's', '4');
+    static const uint32_t kCompressedUInt32SourceLocFourCc = SLANG_MAKE_COMPRESSED_FOUR_CC(kUInt32SourceLocFourCc);
+        /// Bytes of a SerialSourceLocTableUtil table
+    static const uint32_t kSourceLocTableFourCc = SLANG_FOUR_CC('S', 'r', 'l', 't');
+    static const uint32_t kCompressedSourceLocTableFourCc = SLANG_MAKE_COMPRESSED_FOUR_CC(kSourceLocTableFourCc);
+
+        /// With LZ4 compression an array's bytes are split into blocks of at most this size. Each block is written as a uint32_t compressed size followed
+        /// by the compressed bytes, so a reader only needs a buffer for a single block, and can decompress directly into the array.
+    static const size_t kLZ4BlockSize = 64 * 1024;
 
     struct SlangHeader
     {
@@ -351,7 +439,7 @@ struct IRSerialBinary
     {
         Chunk m_chunk;
         uint32_t m_numEntries;              ///< The number of entries
-        uint32_t m_numCompressedEntries;    ///< The amount of compressed entries
+        uint32_t m_numCompressedEntries;    ///< The amount of compressed entries. For LZ4 the size of the uncompressed array in bytes.
     };
 };
 
@@ -361,23 +449,40 @@ struct IRSerialWriter
     typedef IRSerialData Ser;
     typedef IRSerialBinary Bin;
 
+        /// Source locations are only written if one of the source location options is set, so they can be stripped for release containers by setting neither.
+        /// Either way the raw SourceLoc values of the session's SourceManager are written, so they are only meaningful when read back in the same session.
     struct OptionFlag
     {
         typedef uint32_t Type;
         enum Enum: Type
         {
-            RawSourceLocation       = 0x01,
+            RawSourceLocation       = 0x01,     ///< Write a source location per instruction as is
+            SourceLocationTable     = 0x02,     ///< Write source locations as a compact table (see SerialSourceLocTableUtil)
         };
     };
     typedef OptionFlag::Type OptionFlags;
 
     Result write(IRModule* module, SourceManager* sourceManager, OptionFlags options, IRSerialData* serialData);
 
-    static Result writeStream(const IRSerialData& data, Bin::CompressionType compressionType, Stream* stream);
+        /// Write data as a container to the stream. Each chunk is encoded to its own buffer, and written to the stream as soon as it and the chunks before it have been
+        /// encoded, whilst later chunks are still being encoded. The stream must be seekable.
+        /// Chunks are encoded on up to maxThreadCount threads (including the calling thread), and never more than kMaxWriteThreadCount. If maxThreadCount is 0, threads are only
+        /// used if the data is at least kMinParallelWriteSize bytes and is compressed, and then as many as there are hardware threads. The output is the same however many
+        /// threads are used, and if a thread can't be created the chunks are encoded on the threads that could be.
+    static Result writeStream(const IRSerialData& data, Bin::CompressionType compressionType, Stream* stream, int maxThreadCount = 0);
+
+        /// Below this size in bytes, compressing chunks on other threads costs more than it saves
+    static const size_t kMinParallelWriteSize = 256 * 1024;
+        /// The most threads writeStream uses (a chunk is only ever encoded by one thread)
+    static const int kMaxWriteThreadCount = 8;
 
     
-    /// Get an instruction index from an instruction
-    Ser::InstIndex getInstIndex(IRInst* inst) const { return inst ? Ser::InstIndex(m_instMap[inst]) : Ser::InstIndex(0); }
+    /// Get an instruction index from an instruction. The instruction must have been added.
+    Ser::InstIndex getInstIndex(IRInst* inst) const
+    {
+        SLANG_ASSERT(inst == nullptr || m_insts[inst->scratchData] == inst);
+        return inst ? Ser::InstIndex(inst->scratchData) : Ser::InstIndex(0);
+    }
 
         /// Get a slice from an index
     UnownedStringSlice getStringSlice(Ser::StringIndex index) const { return m_stringSlicePool.getSlice(StringSlicePool::Handle(index)); }
@@ -393,15 +498,22 @@ struct IRSerialWriter
     {}
 
 protected:
+    Result _write(IRModule* module, SourceManager* sourceManager, OptionFlags options, IRSerialData* serialData);
+
     void _addInstruction(IRInst* inst);
+
+        /// Start recording the body of globalValue, which is the next instruction with children to be traversed
+    void _startGlobalValueBody(IRInst* globalValue);
+        /// Finish recording the body being traversed
+    void _endGlobalValueBody();
+        /// Remove bodies that have instructions referenced from outside of them, as they can't be created on demand
+    void _removeReferencedGlobalValueBodies();
     
-    List<IRInst*> m_insts;                              ///< Instructions in same order as stored in the 
+    List<IRInst*> m_insts;                              ///< Instructions in same order as stored in the serial data. An instruction's index is held in its scratchData whilst writing.
 
     List<IRDecoration*> m_decorations;                  ///< Holds all decorations in order of the instructions as found
     List<IRInst*> m_instWithFirstDecoration;            ///< All decorations are held in this order after all the regular instructions
 
-    Dictionary<IRInst*, Ser::InstIndex> m_instMap;      ///< Map an instruction to an instruction index
-
     StringSlicePool m_stringSlicePool;    
     IRSerialData* m_serialData;                         ///< Where the data is stored
 
@@ -416,8 +528,24 @@ struct IRSerialReader
         /// Read a stream to fill in dataOut IRSerialData
     static Result readStream(Stream* stream, IRSerialData* dataOut);
 
+        /** Read a serialized container held in memory (as written by IRSerialWriter::writeStream).
+        Uncompressed arrays are referenced in place by viewOut, so data must stay in scope whilst viewOut is used. Arrays
+        that are compressed (or not aligned for their type) are decoded into storageOut, which viewOut then references.
+        data should be aligned to IRSerialBinary::kContainerAlignment, otherwise the instructions will be copied. */
+    static Result readContainer(const void* data, size_t size, IRSerialData* storageOut, IRSerialDataView* viewOut);
+
         /// Read a module from serial data
     Result read(const IRSerialData& data, Session* session, RefPtr<IRModule>& moduleOut);
+        /// Read a module from a view of serial data
+    Result read(const IRSerialDataView& data, Session* session, RefPtr<IRModule>& moduleOut);
+
+        /// Read a module from a container, only creating stubs for global values with code (functions, generics etc).
+        /// The body of a global value is created when it is first needed (see IRModuleMaterializer). The module keeps the container in scope.
+        /// As bodies are created long after this returns, a failure to create one is reported to sink (if set), and leaves the body empty.
+    static Result readLazy(IRSerialContainer* container, Session* session, DiagnosticSink* sink, RefPtr<IRModule>& moduleOut);
+
+        /// Create the instructions of a body that was deferred. bodyIndex indexes into the data's m_globalValueBodies.
+    Result materializeBody(int bodyIndex);
 
         /// Get the representation cache
     StringRepresentationCache& getStringRepresentationCache() { return m_stringRepresentationCache; }
@@ -430,15 +558,49 @@ struct IRSerialReader
 
     protected:
 
+    Result _read(const IRSerialDataView& data, Session* session, bool isLazy, RefPtr<IRModule>& moduleOut);
+
+        /// Create the instructions in the index range [start, end)
+    Result _createInsts(int start, int end);
+        /// Set the result types and operands for the instructions in the range
+    void _setOperands(int start, int end);
+        /// Set the source locations (if there are any) for the instructions in the range
+    void _setSourceLocs(int start, int end);
+        /// Add the children in the child runs in the range
+    void _addChildren(int startRun, int endRun);
+        /// Create and add the decorations in the decoration runs in the range
+    Result _addDecorations(int startRun, int endRun);
+
     IRDecoration* _createDecoration(const Ser::Inst& srcIns);
     static Result _skip(const IRSerialBinary::Chunk& chunk, Stream* stream, int64_t* remainingBytesInOut);
 
     StringRepresentationCache m_stringRepresentationCache;
 
-    const IRSerialData* m_serialData;
+    List<IRInst*> m_insts;                  ///< Created instructions, by instruction index. nullptr if not created (yet).
+
+    bool m_hasSourceLocRuns = false;        ///< True once the source location table has been decoded into m_sourceLocRuns
+    List<Ser::DebugLocRun> m_sourceLocRuns; ///< Runs of instructions with a location, in order of instruction index
+
+    const IRSerialDataView* m_serialData;
     IRModule* m_module;
 };
 
+    /// Holds a serialized container in memory, and a view of its contents. 
+class IRSerialContainer : public RefObject
+{
+public:
+        /// Take the contents of a container (as written by IRSerialWriter::writeStream) and read it
+    Result init(List<uint8_t>& contentsInOut);
+
+        /// Get the view of the serial data
+    const IRSerialDataView& getView() const { return m_view; }
+
+protected:
+    List<uint8_t> m_contents;               ///< The container
+    IRSerialData m_storage;                 ///< Holds any arrays that could not be used in place
+    IRSerialDataView m_view;
+};
+
 } // namespace Slang
 
 #endif
@@ -4,6 +4,8 @@
 #include "ir.h"
 #include "ir-insts.h"
 
+#include "../core/slang-memory-arena.h"
+
 namespace Slang {
 
 // Track information on a phi node we are in
@@ -26,7 +28,7 @@ struct PhiInfo : RefObject
     //
     // The order of elements in this list must match the
     // order in which the predecessor blocks get enumerated.
-    List<IRUse> operands;
+    List<IRUse, ScratchAllocator> operands;
 
     // If this phi ended up being removed as trivial, then
     // this will be the value that we replaced it with.
@@ -39,7 +41,7 @@ struct SSABlockInfo : RefObject
 {
     // Map a promotable variable to the value to
     // use for that variable
-    Dictionary<IRVar*, IRInst*> valueForVar;
+    Dictionary<IRVar*, IRInst*, ScratchAllocator> valueForVar;
 
     // The underlying basic block.
     IRBlock* block;
@@ -59,15 +61,19 @@ struct SSABlockInfo : RefObject
     IRBuilder builder;
 
     // Phi nodes we are creating for this block.
-    List<PhiInfo*> phis;
+    List<PhiInfo*, ScratchAllocator> phis;
 
     // Arguments that this block needs to pass along
     // to the phi nodes defined by is sucessor
-    List<IRInst*> successorArgs;
+    List<IRInst*, ScratchAllocator> successorArgs;
 };
 
 // State for constructing SSA form for a global value
 // with code (usually a function).
+//
+// The containers used during construction are only
+// needed until it completes, so they allocate from the
+// thread scratch arena, which is rewound when done.
 struct ConstructSSAContext
 {
     // The value that we want to rewrite into SSA form
@@ -76,22 +82,22 @@ struct ConstructSSAContext
 
     // Variables that we've identified for promotion
     // to SSA values.
-    List<IRVar*> promotableVars;
+    List<IRVar*, ScratchAllocator> promotableVars;
 
     // Information about each basic block
-    Dictionary<IRBlock*, RefPtr<SSABlockInfo>> blockInfos;
+    Dictionary<IRBlock*, RefPtr<SSABlockInfo>, ScratchAllocator> blockInfos;
 
     // IR building state to use during the operation
     SharedIRBuilder sharedBuilder;
 
     // Instructions to remove during cleanup
-    List<IRInst*> instsToRemove;
+    List<IRInst*, ScratchAllocator> instsToRemove;
 
     IRBuilder builder;
     IRBuilder* getBuilder() { return &builder; }
 
 
-    Dictionary<IRParam*, RefPtr<PhiInfo>> phiInfos;
+    Dictionary<IRParam*, RefPtr<PhiInfo>, ScratchAllocator> phiInfos;
 
     PhiInfo* getPhiInfo(IRParam* phi)
     {
@@ -446,7 +452,7 @@ IRInst* tryRemoveTrivialPhi(
     // Removing this phi as trivial may make other phi nodes
     // become trivial. We will recognize such candidates
     // by looking for phi nodes that use this node.
-    List<PhiInfo*> otherPhis;
+    List<PhiInfo*, ScratchAllocator> otherPhis;
     for( auto u = phi->firstUse; u; u = u->nextUse )
     {
         auto user = u->user;
@@ -497,7 +503,7 @@ IRInst* addPhiOperands(
 
     auto block = blockInfo->block;
 
-    List<IRInst*> operandValues;
+    List<IRInst*, ScratchAllocator> operandValues;
     for (auto predBlock : block->getPredecessors())
     {
         // Precondition: if we have multiple predecessors, then
@@ -834,7 +840,7 @@ static void breakCriticalEdges(
     // We will make a pass over the CFG to collect all the critical
     // edges, and then we will break them in a follow-up pass.
 
-    List<IRUse*> criticalEdges;
+    List<IRUse*, ScratchAllocator> criticalEdges;
 
     auto globalVal = context->globalVal;
     for (auto pred = globalVal->getFirstBlock(); pred; pred = pred->getNextBlock())
@@ -1015,7 +1021,7 @@ void constructSSA(ConstructSSAContext* context)
         auto oldArgCount = oldTerminator->getOperandCount();
         auto newArgCount = oldArgCount + addedArgCount;
 
-        List<IRInst*> newArgs;
+        List<IRInst*, ScratchAllocator> newArgs;
         for (UInt aa = 0; aa < oldArgCount; ++aa)
         {
             newArgs.Add(oldTerminator->getOperand(aa));
@@ -1069,6 +1075,10 @@ void constructSSA(ConstructSSAContext* context)
 // Construct SSA form for a global value with code
 void constructSSA(IRModule* module, IRGlobalValueWithCode* globalVal)
 {
+    // Must be before the context, so the context's containers
+    // are destroyed before their memory is rewound
+    MemoryArenaScope scratchScope;
+
     ConstructSSAContext context;
     context.globalVal = globalVal;
 
@@ -3192,8 +3192,27 @@ namespace Slang
         }
     }
 
+    void materializeIRGlobalValue(IRGlobalValue* globalValue)
+    {
+        auto moduleInst = as<IRModuleInst>(globalValue->getParent());
+        if (moduleInst && moduleInst->module && moduleInst->module->materializer)
+        {
+            moduleInst->module->materializer->materialize(globalValue);
+        }
+    }
+
+    void materializeIRModule(IRModule* module)
+    {
+        if (module->materializer)
+        {
+            module->materializer->materializeAll();
+        }
+    }
+
     void printSlangIRAssembly(StringBuilder& builder, IRModule* module)
     {
+        materializeIRModule(module);
+
         IRDumpContext context;
         context.builder = &builder;
         context.indent = 0;
@@ -5776,6 +5795,9 @@ namespace Slang
         IRGlobalValueWithCode*  clonedValue,
         IRGlobalValueWithCode*  originalValue)
     {
+        // The original may have been read lazily, so make sure its body is available
+        materializeIRGlobalValue(originalValue);
+
         // Next we are going to clone the actual code.
         IRBuilder builderStorage = *context->builder;
         IRBuilder* builder = &builderStorage;
@@ -6008,6 +6030,8 @@ namespace Slang
         // those functions are being returned by a generic. This
         // means that we need to try and inspect the value being
         // returned by the generic if we are looking at a generic.
+        materializeIRGlobalValue(inVal);
+
         IRInst* val = inVal;
         while( auto genericVal = as<IRGeneric>(val) )
         {
@@ -6071,6 +6095,8 @@ namespace Slang
     bool isDefinition(
         IRGlobalValue* inVal)
     {
+        materializeIRGlobalValue(inVal);
+
         IRInst* val = inVal;
         // unwrap any generic declarations to see
         // the value they return.
@@ -6457,6 +6483,22 @@ namespace Slang
         }
     };
 
+    // Clone every witness table in `originalModule` (with the best
+    // definition for the target of each, as for any global value).
+    static void cloneWitnessTables(
+        IRSpecContext*  context,
+        IRModule*       originalModule)
+    {
+        if (!originalModule)
+            return;
+
+        for (auto ii : originalModule->getGlobalInsts())
+        {
+            if (ii->op == kIROp_WitnessTable)
+                cloneGlobalValue(context, (IRWitnessTable*)ii);
+        }
+    }
+
     IRSpecializationState* createIRSpecializationState(
         EntryPointRequest*  entryPointRequest,
         ProgramLayout*      programLayout,
@@ -6523,11 +6565,13 @@ namespace Slang
             context->globalVarLayouts.AddIfNotExists(mangledName, globalVarLayout);
         }
 
-        // for now, clone all unreferenced witness tables
-        for (auto sym :context->getSymbols())
+        // for now, clone all unreferenced witness tables.
+        // They are visited in module order (rather than by iterating the symbol
+        // dictionary) so that the order they are emitted in is deterministic.
+        cloneWitnessTables(context, originalIRModule);
+        for (auto loadedModule : compileRequest->loadedModulesList)
         {
-            if (sym.Value->irGlobalValue->op == kIROp_WitnessTable)
-                cloneGlobalValue(context, (IRWitnessTable*)sym.Value->irGlobalValue);
+            cloneWitnessTables(context, loadedModule->irModule);
         }
         return state;
     }
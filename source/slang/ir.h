@@ -217,6 +217,12 @@ struct IRInst : public IRObject
     // Source location information for this value, if any
     SourceLoc sourceLoc;
 
+    // Free for a pass to associate a value with each instruction it visits, without
+    // needing a map. A pass that uses it must set it back to 0 when it is done.
+    // (IRSerialWriter holds instruction indices here.) It fills the padding after
+    // sourceLoc, so doesn't make IRInst any larger on 64-bit targets.
+    uint32_t scratchData = 0;
+
     // The linked list of decorations attached to this value
     IRDecoration* firstDecoration = nullptr;
 
@@ -1072,6 +1078,16 @@ struct IRModuleInst : IRParentInst
     IR_LEAF_ISA(Module)
 };
 
+    /// Creates the bodies of a module's global values on demand. A module that is read from a serialized form can
+    /// initially hold just stubs for global values with code, and only create their bodies once something needs them.
+struct IRModuleMaterializer : RefObject
+{
+        /// Make sure the body of globalValue (which must be in the module) has been created
+    virtual void materialize(IRGlobalValue* globalValue) = 0;
+        /// Create all of the bodies that haven't been created yet
+    virtual void materializeAll() = 0;
+};
+
 struct IRModule : RefObject
 {
     enum 
@@ -1099,11 +1115,20 @@ struct IRModule : RefObject
     Session*    session;
     IRModuleInst* moduleInst;
 
+        /// If set, global values with code may not have their bodies until materialized (see materializeIRGlobalValue)
+    RefPtr<IRModuleMaterializer> materializer;
+
     protected:
 
     ObjectScopeManager m_objectScopeManager;
 };
 
+    /// Make sure the body of a global value at module scope has been created. Must be called before the body of a global value
+    /// from a module that could be read lazily (such as the original module when linking) is accessed.
+void materializeIRGlobalValue(IRGlobalValue* globalValue);
+    /// Make sure all of the bodies in the module have been created
+void materializeIRModule(IRModule* module);
+
 void printSlangIRAssembly(StringBuilder& builder, IRModule* module);
 String getSlangIRAssembly(IRModule* module);
 
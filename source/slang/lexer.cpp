@@ -170,18 +170,21 @@ namespace Slang
             // We might have a backslash-escaped newline.
             // Look at the next byte (if any) to see.
             //
-            // Note(tfoley): We are assuming a null-terminated input here,
-            // so that we can safely look at the next byte without issue.
-            int d = lexer->cursor[1];
+            // Note that the input may not be null-terminated (e.g. a
+            // file mapped into memory), so every look ahead is
+            // checked against the end.
+            char const* end = lexer->end;
+            char const* cursor = lexer->cursor;
+            int d = (end - cursor > 1) ? cursor[1] : kEOF;
             switch (d)
             {
             case '\r': case '\n':
                 {
                     // The newline was escaped, so return the code point after *that*
 
-                    int e = lexer->cursor[2];
+                    int e = (end - cursor > 2) ? cursor[2] : kEOF;
                     if ((d ^ e) == ('\r' ^ '\n'))
-                        return lexer->cursor[3];
+                        return (end - cursor > 3) ? cursor[3] : kEOF;
                     return e;
                 }
 
@@ -213,10 +216,7 @@ namespace Slang
             {
                 // We might have a backslash-escaped newline.
                 // Look at the next byte (if any) to see.
-                //
-                // Note(tfoley): We are assuming a null-terminated input here,
-                // so that we can safely look at the next byte without issue.
-                int d = *lexer->cursor;
+                int d = peekRaw(lexer);
                 switch (d)
                 {
                 case '\r': case '\n':
@@ -1265,8 +1265,28 @@ namespace Slang
 
             char const* textEnd = cursor;
 
+            Name* name = nullptr;
+
+            // Escaped newlines are the only thing that can make the value of a
+            // token differ from its text, so tokens without a backslash can use
+            // the text directly.
+            if(textEnd != textBegin && !memchr(textBegin, '\\', textEnd - textBegin))
+            {
+                const UnownedStringSlice text(textBegin, textEnd);
+                if (tokenType == TokenType::Identifier)
+                {
+                    // Look up the name from the source text, and share its
+                    // string rather than creating a new one
+                    name = this->namePool->getName(text);
+                    token.Content = name->text;
+                }
+                else
+                {
+                    token.Content = String(text);
+                }
+            }
             // Note(tfoley): `StringBuilder::Append()` seems to crash when appending zero bytes
-            if(textEnd != textBegin)
+            else if(textEnd != textBegin)
             {
                 // HACK(tfoley): "scrubbing" token value here to remove escaped newlines...
                 //
@@ -1310,7 +1330,7 @@ namespace Slang
 
             if (tokenType == TokenType::Identifier)
             {
-                token.ptrValue = this->namePool->getName(token.Content);
+                token.ptrValue = name ? name : this->namePool->getName(token.Content);
             }
 
             return token;
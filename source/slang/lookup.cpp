@@ -41,21 +41,23 @@ void buildMemberDictionary(ContainerDecl* decl)
     if (decl->memberDictionaryIsValid)
         return;
 
-    decl->memberDictionary.Clear();
-    decl->transparentMembers.Clear();
-
     // are we a generic?
     GenericDecl* genericDecl = dynamic_cast<GenericDecl*>(decl);
 
-    for (auto m : decl->Members)
+    // Only add the members added since the dictionary was last built,
+    // so that a container built up one member at a time (with lookups
+    // in between, as when parsing) isn't quadratic
+    const UInt memberCount = decl->Members.Count();
+    for (UInt mm = decl->memberDictionaryCount; mm < memberCount; ++mm)
     {
+        Decl* m = decl->Members[mm].Ptr();
         auto name = m->getName();
 
         // Add any transparent members to a separate list for lookup
         if (m->HasModifier<TransparentModifier>())
         {
             TransparentMemberInfo info;
-            info.decl = m.Ptr();
+            info.decl = m;
             decl->transparentMembers.Add(info);
         }
 
@@ -74,9 +76,10 @@ void buildMemberDictionary(ContainerDecl* decl)
         if (decl->memberDictionary.TryGetValue(name, next))
             m->nextInContainerWithSameName = next;
 
-        decl->memberDictionary[name] = m.Ptr();
+        decl->memberDictionary[name] = m;
 
     }
+    decl->memberDictionaryCount = memberCount;
     decl->memberDictionaryIsValid = true;
 }
 
@@ -9,16 +9,175 @@ String getText(Name* name)
     return name->text;
 }
 
-Name* NamePool::getName(String const& text)
+char const* getCstr(Name* name)
 {
-    RefPtr<Name> name;
-    if (rootPool->names.TryGetValue(text, name))
+    if (!name) return "";
+    return name->text.Buffer();
+}
+
+// RootNamePool
+
+RootNamePool::RootNamePool()
+    : m_arena(4096)
+{
+    m_entries.SetSize(1024);
+    memset(m_entries.Buffer(), 0, sizeof(Entry) * m_entries.Count());
+}
+
+RootNamePool::~RootNamePool()
+{
+    // The names are in the arena, so only need destructing
+    for (auto& entry : m_entries)
+    {
+        if (entry.name)
+        {
+            entry.name->~Name();
+        }
+    }
+}
+
+Name* RootNamePool::getName(UnownedStringSlice const& text, int hash, String const* textString)
+{
+    if (Name* name = findName(text, hash))
         return name;
 
-    name = new Name();
-    name->text = text;
-    rootPool->names.Add(text, name);
+    Name* name = new (m_arena.allocate<Name>()) Name();
+    if (textString)
+    {
+        SLANG_ASSERT(textString->getUnownedSlice() == text);
+        name->text = *textString;
+    }
+    else
+    {
+        name->text = String(text);
+    }
+    name->hash = hash;
+
+    _insert(name);
     return name;
 }
 
+Name* RootNamePool::findName(UnownedStringSlice const& text, int hash)
+{
+    if (m_isKeywordTableDirty)
+    {
+        _buildKeywordTable();
+    }
+    if (m_keywordTable.Count())
+    {
+        const Entry& entry = m_keywordTable[(uint32_t(hash) * m_keywordMultiplier) >> m_keywordShift];
+        if (entry.name && _isMatch(entry, text, hash))
+            return entry.name;
+    }
+
+    const UInt mask = m_entries.Count() - 1;
+    for (UInt i = UInt(uint32_t(hash)) & mask;; i = (i + 1) & mask)
+    {
+        const Entry& entry = m_entries[i];
+        if (!entry.name)
+            return nullptr;
+        if (_isMatch(entry, text, hash))
+            return entry.name;
+    }
+}
+
+void RootNamePool::addKeyword(Name* name)
+{
+    if (m_keywords.IndexOf(name) == UInt(-1))
+    {
+        m_keywords.Add(name);
+        m_isKeywordTableDirty = true;
+    }
+}
+
+void RootNamePool::_insert(Name* name)
+{
+    // Keep the table at most half full, so probe sequences stay short
+    if ((m_nameCount + 1) * 2 > m_entries.Count())
+    {
+        _grow();
+    }
+
+    const UInt mask = m_entries.Count() - 1;
+    UInt i = UInt(uint32_t(name->hash)) & mask;
+    while (m_entries[i].name)
+    {
+        i = (i + 1) & mask;
+    }
+    m_entries[i].name = name;
+    m_entries[i].hash = name->hash;
+    m_nameCount++;
+}
+
+void RootNamePool::_grow()
+{
+    List<Entry> oldEntries;
+    oldEntries.SwapWith(m_entries);
+
+    m_entries.SetSize(oldEntries.Count() * 2);
+    memset(m_entries.Buffer(), 0, sizeof(Entry) * m_entries.Count());
+    m_nameCount = 0;
+
+    for (auto& entry : oldEntries)
+    {
+        if (entry.name)
+        {
+            _insert(entry.name);
+        }
+    }
+}
+
+void RootNamePool::_buildKeywordTable()
+{
+    m_isKeywordTableDirty = false;
+    m_keywordTable.Clear();
+
+    const UInt keywordCount = m_keywords.Count();
+    if (keywordCount == 0)
+        return;
+
+    // Search for a multiplier that maps every keyword hash to a different slot.
+    // With the table at least twice the number of keywords this is typically
+    // found after a handful of attempts, if not the table size is doubled.
+    int bitCount = 4;
+    while ((UInt(1) << bitCount) < keywordCount * 2)
+        bitCount++;
+
+    List<Entry> table;
+    for (; bitCount <= 16; bitCount++)
+    {
+        const UInt size = UInt(1) << bitCount;
+        const int shift = 32 - bitCount;
+        table.SetSize(size);
+
+        uint32_t multiplier = 0x9e3779b1;
+        for (int attempt = 0; attempt < 256; ++attempt, multiplier += 0xc657cb56u)
+        {
+            memset(table.Buffer(), 0, sizeof(Entry) * size);
+
+            bool isPerfect = true;
+            for (auto name : m_keywords)
+            {
+                Entry& entry = table[(uint32_t(name->hash) * multiplier) >> shift];
+                if (entry.name)
+                {
+                    isPerfect = false;
+                    break;
+                }
+                entry.name = name;
+                entry.hash = name->hash;
+            }
+
+            if (isPerfect)
+            {
+                m_keywordTable.SwapWith(table);
+                m_keywordMultiplier = multiplier;
+                m_keywordShift = shift;
+                return;
+            }
+        }
+    }
+    // No perfect hash was found, so keywords are just found through the main table
+}
+
 } // namespace Slang
@@ -6,6 +6,7 @@
 // the name of types, variables, etc. in the AST.
 
 #include "../core/basic.h"
+#include "../core/slang-memory-arena.h"
 
 namespace Slang {
 
@@ -21,7 +22,7 @@ namespace Slang {
 // cleaned up when the pool is deleted), and which is responsible for
 // ensuring the uniqueness of name objects.
 //
-class Name : public RefObject
+class Name
 {
 public:
     // The raw text of the name.
@@ -30,21 +31,85 @@ public:
     // of name than "simple" names, and so this might change to a structured
     // ADT instead of a simple string.
     String text;
+
+    // The hash of `text` (as returned by `GetHashCode`)
+    int hash;
 };
 
 // Get the textual string representation of a name
 // (e.g., so that it can be printed).
 String getText(Name* name);
 
+// Get the text of a name as a zero-terminated string, which
+// remains valid for as long as the name does. Returns an empty
+// string if `name` is null.
+char const* getCstr(Name* name);
+
 // A `RootNamePool` is used to store and look up names.
 // If two systems need to work together with names, and be sure that they
 // get equivalent names for a string like `"Foo"`, then they need to use
 // the same root name pool (directly or indirectly).
 //
+// Names are allocated from an arena owned by the pool, and found through
+// an open-addressed table keyed on the hash of their text. Lookups take
+// an `UnownedStringSlice` and its hash, so that callers like the lexer
+// can find a name without first building a `String`.
+//
+// Names that are expected to be very common (such as keywords) can be
+// registered with `addKeyword`, and are then found through a perfect
+// hash table that is checked before the main table.
+//
 struct RootNamePool
 {
-    // The mapping from text strings to the corresponding name.
-    Dictionary<String, RefPtr<Name> > names;
+    RootNamePool();
+    ~RootNamePool();
+
+    // Find or create the `Name` with the given `text`, where `hash`
+    // must be `GetHashCode(text)`. If the name is created and
+    // `textString` is non-null it must hold the same text, and
+    // is used (shared) for the name's text.
+    Name* getName(UnownedStringSlice const& text, int hash, String const* textString = nullptr);
+
+    // Find the `Name` with the given `text` and `hash`, or return
+    // nullptr if there isn't one.
+    Name* findName(UnownedStringSlice const& text, int hash);
+
+    // Add a name to the set found through the keyword table.
+    void addKeyword(Name* name);
+
+    // Get the number of names in the pool
+    UInt getNameCount() const { return m_nameCount; }
+
+protected:
+    struct Entry
+    {
+        Name* name;
+        int hash;
+    };
+
+    static bool _isMatch(Entry const& entry, UnownedStringSlice const& text, int hash)
+    {
+        return entry.hash == hash && entry.name->text.getUnownedSlice() == text;
+    }
+    void _buildKeywordTable();
+    void _insert(Name* name);
+    void _grow();
+
+    // Open-addressed table of names, with a power of 2 size.
+    // Empty entries have a null `name`.
+    List<Entry> m_entries;
+    UInt m_nameCount = 0;
+
+    // Perfect hash table for keywords. A keyword with hash `h`
+    // can only be at index `(uint32_t(h) * m_keywordMultiplier) >> m_keywordShift`
+    List<Name*> m_keywords;
+    List<Entry> m_keywordTable;
+    uint32_t m_keywordMultiplier = 0;
+    int m_keywordShift = 32;
+    bool m_isKeywordTableDirty = false;
+
+    // Holds the memory for all `Name`s
+    MemoryArena m_arena;
 };
 
 // A `NamePool` is effectively a way of storing a subset of the
@@ -62,7 +127,19 @@ struct RootNamePool
 struct NamePool
 {
     // Find or create the `Name` that represents the given `text`.
-    Name* getName(String const& text);
+    Name* getName(String const& text)
+    {
+        return rootPool->getName(text.getUnownedSlice(), text.GetHashCode(), &text);
+    }
+    Name* getName(UnownedStringSlice const& text)
+    {
+        return rootPool->getName(text, text.GetHashCode());
+    }
+    // Find or create a `Name`, where `hash` must be `GetHashCode(text)`.
+    Name* getName(UnownedStringSlice const& text, int hash)
+    {
+        return rootPool->getName(text, hash);
+    }
 
     // Set the parent name pool to use for lookup
     void setRootNamePool(RootNamePool* rootNamePool)
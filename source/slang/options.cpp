@@ -6,7 +6,9 @@
 #include "../../slang.h"
 
 #include "compiler.h"
+#include "ir-serialize.h"
 #include "profile.h"
+#include "slang-archive-file-system.h"
 
 #include <assert.h>
 
@@ -349,6 +351,8 @@ struct OptionsParser
         CASE(".dxil", DXIL);
         CASE(".dxil.asm", DXIL_ASM);
 
+        CASE(".cpp", CPP_SOURCE);
+
         CASE(".glsl", GLSL);
         CASE(".vert", GLSL);
         CASE(".frag", GLSL);
@@ -367,6 +371,10 @@ struct OptionsParser
             spSetOutputContainerFormat(compileRequest, SLANG_CONTAINER_FORMAT_SLANG_MODULE);
             requestImpl->containerOutputPath = path;
         }
+        else if (path.EndsWith(".slang-reflection"))
+        {
+            requestImpl->flatReflectionOutputPath = path;
+        }
         else
         {
             // Allow an unknown-format `-o`, assuming we get a target format
@@ -456,6 +464,44 @@ struct OptionsParser
                 {
                     requestImpl->useSerialIRBottleneck = true;
                 }
+                else if (argStr == "-serial-ir-compression")
+                {
+                    String name;
+                    SLANG_RETURN_ON_FAIL(tryReadCommandLineArgument(sink, arg, &argCursor, argEnd, name));
+
+                    IRSerialBinary::CompressionType compressionType = IRSerialBinary::CompressionType::None;
+                    if (name == "none")
+                    {
+                        compressionType = IRSerialBinary::CompressionType::None;
+                    }
+                    else if (name == "lite")
+                    {
+                        compressionType = IRSerialBinary::CompressionType::VariableByteLite;
+                    }
+                    else if (name == "stream-vbyte")
+                    {
+                        compressionType = IRSerialBinary::CompressionType::StreamVByte;
+                    }
+                    else if (name == "lz4")
+                    {
+                        compressionType = IRSerialBinary::CompressionType::LZ4;
+                    }
+                    else
+                    {
+                        sink->diagnose(SourceLoc(), Diagnostics::unknownSerialIRCompressionType, name);
+                        return SLANG_FAIL;
+                    }
+
+                    // Implies the IR is serialized
+                    requestImpl->useSerialIRBottleneck = true;
+                    requestImpl->serialIRCompressionType = uint32_t(compressionType);
+                }
+                else if (argStr == "-verify-serial-ir-threading")
+                {
+                    // Implies the IR is serialized
+                    requestImpl->useSerialIRBottleneck = true;
+                    requestImpl->shouldVerifySerialIRThreading = true;
+                }
                 else if(argStr == "-validate-ir" )
                 {
                     requestImpl->shouldValidateIR = true;
@@ -489,6 +535,7 @@ struct OptionsParser
                     CASE("dxil", DXIL)
                     CASE("dxil-assembly", DXIL_ASM)
                     CASE("dxil-asm", DXIL_ASM)
+                    CASE("cpp", CPP_SOURCE)
 
                 #undef CASE
                     /* else */
@@ -659,6 +706,23 @@ struct OptionsParser
                         compileRequest,
                         String(includeDirStr).begin());
                 }
+                else if (argStr == "-archive")
+                {
+                    // Mount an archive, so that its contents appear beneath the archive path.
+                    // Other paths are handled by the file system that was previously set.
+                    String archivePath;
+                    SLANG_RETURN_ON_FAIL(tryReadCommandLineArgument(sink, arg, &argCursor, argEnd, archivePath));
+
+                    RefPtr<ArchiveFileSystem> archiveFileSystem;
+                    if (SLANG_FAILED(ArchiveFileSystem::create(archivePath, archivePath, requestImpl->fileSystemExt, archiveFileSystem)))
+                    {
+                        sink->diagnose(SourceLoc(), Diagnostics::cannotOpenFile, archivePath);
+                        return SLANG_FAIL;
+                    }
+
+                    spSetFileSystem(compileRequest, archiveFileSystem);
+                    spAddSearchPath(compileRequest, archivePath.Buffer());
+                }
                 //
                 // A `-o` option is used to specify a desired output file.
                 else if (argStr == "-o")
@@ -7,6 +7,8 @@
 
 #include "../../slang.h"
 
+#include <map>
+
 namespace Slang {
 
 struct ParameterInfo;
@@ -21,37 +23,51 @@ struct UsedRange
     UInt begin;
     UInt end;
 };
-bool operator<(UsedRange left, UsedRange right)
-{
-    if (left.begin != right.begin)
-        return left.begin < right.begin;
-    if (left.end != right.end)
-        return left.end < right.end;
-    return false;
-}
 
-static bool rangesOverlap(UsedRange const& x, UsedRange const& y)
+struct UsedRanges
 {
-    SLANG_ASSERT(x.begin <= x.end);
-    SLANG_ASSERT(y.begin <= y.end);
+    // The ranges, keyed by `end`. Ranges never overlap, so they
+    // are also sorted by `begin`. A tree rather than a sorted list,
+    // because implicit allocations fill gaps between explicitly
+    // bound ranges, and inserting in the middle of a list is O(n).
+    typedef std::map<UInt, UsedRange> RangeMap;
+    RangeMap ranges;
 
-    // If they don't overlap, then one must be earlier than the other,
-    // and that one must therefore *end* before the other *begins*
+    // All of [0, packedEnd) is covered by ranges, without any gaps.
+    // There is no free space before it, so allocation can start
+    // searching from here.
+    UInt packedEnd = 0;
 
-    if (x.end <= y.begin) return false;
-    if (y.end <= x.begin) return false;
-
-    // Otherwise they must overlap
-    return true;
-}
+    // Find the first range that ends after `index`
+    RangeMap::iterator findFirstEndingAfter(UInt index)
+    {
+        return ranges.upper_bound(index);
+    }
 
+    // Insert a range that doesn't overlap any existing range
+    void insert(ParameterInfo* param, UInt begin, UInt end)
+    {
+        UsedRange range;
+        range.parameter = param;
+        range.begin = begin;
+        range.end = end;
+        ranges.insert(RangeMap::value_type(end, range));
 
-struct UsedRanges
-{
-    List<UsedRange> ranges;
+        // There is no space to insert before `packedEnd`, but
+        // the range might fill the gap after it
+        SLANG_ASSERT(begin >= packedEnd);
+        for (;;)
+        {
+            auto it = findFirstEndingAfter(packedEnd);
+            if (it == ranges.end() || it->second.begin != packedEnd)
+                break;
+            packedEnd = it->second.end;
+        }
+    }
 
-    // Add a range to the set, either by extending
-    // an existing range, or by adding a new one...
+    // Add a range to the set. Any parts of the range that
+    // are already used keep their existing parameter, and
+    // the rest is added for the new parameter.
     //
     // If we find that the new range overlaps with
     // an existing range for a *different* parameter
@@ -61,32 +77,34 @@ struct UsedRanges
     {
         ParameterInfo* newParam = range.parameter;
         ParameterInfo* existingParam = nullptr;
-        for (auto& rr : ranges)
+
+        // Walk the existing ranges that overlap, filling
+        // in the gaps between them with the new range
+        UInt begin = range.begin;
+        while (begin < range.end)
         {
-            if (rangesOverlap(rr, range)
-                && rr.parameter
-                && rr.parameter != newParam)
+            auto it = findFirstEndingAfter(begin);
+            if (it == ranges.end() || range.end <= it->second.begin)
             {
-                // there was an overlap!
-                existingParam = rr.parameter;
+                insert(newParam, begin, range.end);
+                break;
             }
-        }
 
-        for (auto& rr : ranges)
-        {
-            if (rr.begin == range.end)
+            const UsedRange existingRange = it->second;
+            if (begin < existingRange.begin)
             {
-                rr.begin = range.begin;
-                return existingParam;
+                insert(newParam, begin, existingRange.begin);
             }
-            else if (rr.end == range.begin)
+
+            // There was an overlap!
+            ParameterInfo* overlapParam = existingRange.parameter;
+            if (overlapParam && overlapParam != newParam)
             {
-                rr.end = range.end;
-                return existingParam;
+                existingParam = overlapParam;
             }
+
+            begin = existingRange.end;
         }
-        ranges.Add(range);
-        ranges.Sort();
         return existingParam;
     }
 
@@ -101,49 +119,39 @@ struct UsedRanges
 
     bool contains(UInt index)
     {
-        for (auto rr : ranges)
-        {
-            if (index < rr.begin)
-                return false;
-
-            if (index >= rr.end)
-                continue;
-
-            return true;
-        }
-
-        return false;
+        auto it = findFirstEndingAfter(index);
+        return it != ranges.end() && it->second.begin <= index;
     }
 
 
     // Try to find space for `count` entries
     UInt Allocate(ParameterInfo* param, UInt count)
     {
-        UInt begin = 0;
+        // Nothing can fit before the end of the packed ranges
+        UInt begin = packedEnd;
 
-        UInt rangeCount = ranges.Count();
-        for (UInt rr = 0; rr < rangeCount; ++rr)
+        for (auto it = findFirstEndingAfter(begin); it != ranges.end(); ++it)
         {
             // try to fit in before this range...
 
-            UInt end = ranges[rr].begin;
+            UInt end = it->second.begin;
 
             // If there is enough space...
             if (end >= begin + count)
             {
                 // ... then claim it and be done
-                Add(param, begin, begin + count);
+                insert(param, begin, begin + count);
                 return begin;
             }
 
             // ... otherwise, we need to look at the
             // space between this range and the next
-            begin = ranges[rr].end;
+            begin = it->second.end;
         }
 
         // We've run out of ranges to check, so we
         // can safely go after the last one!
-        Add(param, begin, begin + count);
+        insert(param, begin, begin + count);
         return begin;
     }
 };
@@ -426,14 +434,6 @@ LayoutSemanticInfo ExtractLayoutSemanticInfo(
     return info;
 }
 
-static Name* getReflectionName(VarDeclBase* varDecl)
-{
-    if (auto reflectionNameModifier = varDecl->FindModifier<ParameterGroupReflectionName>())
-        return reflectionNameModifier->nameAndLoc.name;
-
-    return varDecl->getName();
-}
-
 // Information tracked when doing a structural
 // match of types.
 struct StructuralTypeMatchStack
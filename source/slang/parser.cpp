@@ -4361,6 +4361,9 @@ namespace Slang
     {
         Name* name = session->getNamePool()->getName(nameText);
 
+        // Builtin syntax names are common in source, so make them fast to look up
+        session->getRootNamePool()->addKeyword(name);
+
         RefPtr<SyntaxDecl> syntaxDecl = new SyntaxDecl();
         syntaxDecl->nameAndLoc = NameLoc(name);
         syntaxDecl->syntaxClass = syntaxClass;
@@ -4773,6 +4776,19 @@ namespace Slang
 
     #undef EXPR
 
+        // Other keywords are matched by the parser directly, but are just
+        // as common so are also made fast to look up
+        static const char* const kParserKeywords[] =
+        {
+            "break", "case", "class", "continue", "default", "discard", "do", "else",
+            "enum", "for", "if", "let", "operator", "packoffset", "register", "return",
+            "struct", "switch", "void", "while",
+        };
+        for (auto keyword : kParserKeywords)
+        {
+            session->getRootNamePool()->addKeyword(session->getNamePool()->getName(keyword));
+        }
+
         return moduleDecl;
     }
 
@@ -439,7 +439,7 @@ SLANG_API char const* spReflectionType_GetName(SlangReflectionType* inType)
         if(decl->HasModifier<ImplicitParameterGroupElementTypeModifier>())
             return nullptr;
 
-        return getText(declRef.GetName()).begin();
+        return getCstr(declRef.GetName());
     }
 
     return nullptr;
@@ -537,6 +537,19 @@ SLANG_API SlangReflectionVariableLayout* spReflectionTypeLayout_GetFieldByIndex(
     return nullptr;
 }
 
+SLANG_API SlangInt spReflectionTypeLayout_FindFieldIndexByName(SlangReflectionTypeLayout* inTypeLayout, char const* name)
+{
+    auto typeLayout = convert(inTypeLayout);
+    if(!typeLayout) return -1;
+
+    if(auto structTypeLayout = dynamic_cast<StructTypeLayout*>(typeLayout))
+    {
+        return SlangInt(structTypeLayout->findFieldIndexByName(name));
+    }
+
+    return -1;
+}
+
 SLANG_API size_t spReflectionTypeLayout_GetElementStride(SlangReflectionTypeLayout* inTypeLayout, SlangParameterCategory category)
 {
     auto typeLayout = convert(inTypeLayout);
@@ -713,10 +726,7 @@ SLANG_API char const* spReflectionVariable_GetName(SlangReflectionVariable* inVa
 
     // If the variable is one that has an "external" name that is supposed
     // to be exposed for reflection, then report it here
-    if(auto reflectionNameMod = var->FindModifier<ParameterGroupReflectionName>())
-        return getText(reflectionNameMod->nameAndLoc.name).Buffer();
-
-    return getText(var->getName()).Buffer();
+    return getCstr(getReflectionName(var));
 }
 
 SLANG_API SlangReflectionType* spReflectionVariable_GetType(SlangReflectionVariable* inVar)
@@ -969,6 +979,23 @@ namespace Slang
 
         return 0;
     }
+
+    static VarLayout* findParameterByName(RefPtr<TypeLayout> typeLayout, char const* name)
+    {
+        if(auto parameterGroupLayout = typeLayout.As<ParameterGroupTypeLayout>())
+        {
+            typeLayout = parameterGroupLayout->offsetElementTypeLayout;
+        }
+
+        if(auto structLayout = typeLayout.As<StructTypeLayout>())
+        {
+            auto index = structLayout->findFieldIndexByName(name);
+            if(index >= 0)
+                return structLayout->fields[index];
+        }
+
+        return 0;
+    }
 }
 
 // Entry Point Reflection
@@ -979,7 +1006,7 @@ SLANG_API char const* spReflectionEntryPoint_getName(
     auto entryPointLayout = convert(inEntryPoint);
     if(!entryPointLayout) return 0;
 
-    return getText(entryPointLayout->entryPoint->getName()).begin();
+    return getCstr(entryPointLayout->entryPoint->getName());
 }
 
 SLANG_API unsigned spReflectionEntryPoint_getParameterCount(
@@ -1001,6 +1028,16 @@ SLANG_API SlangReflectionVariableLayout* spReflectionEntryPoint_getParameterByIn
     return convert(getParameterByIndex(entryPointLayout, index));
 }
 
+SLANG_API SlangReflectionVariableLayout* spReflectionEntryPoint_findParameterByName(
+    SlangReflectionEntryPoint*  inEntryPoint,
+    char const*                 name)
+{
+    auto entryPointLayout = convert(inEntryPoint);
+    if(!entryPointLayout) return 0;
+
+    return convert(findParameterByName(entryPointLayout, name));
+}
+
 SLANG_API SlangStage spReflectionEntryPoint_getStage(SlangReflectionEntryPoint* inEntryPoint)
 {
     auto entryPointLayout = convert(inEntryPoint);
@@ -1139,6 +1176,22 @@ SLANG_API SlangReflectionParameter* spReflection_GetParameterByIndex(SlangReflec
     return convert(globalStructLayout->fields[index].Ptr());
 }
 
+SLANG_API SlangReflectionParameter* spReflection_FindParameterByName(SlangReflection* inProgram, char const* name)
+{
+    auto program = convert(inProgram);
+    if(!program) return nullptr;
+
+    auto globalStructLayout = getGlobalStructLayout(program);
+    if (!globalStructLayout)
+        return 0;
+
+    auto index = globalStructLayout->findFieldIndexByName(name);
+    if (index < 0)
+        return 0;
+
+    return convert(globalStructLayout->fields[index].Ptr());
+}
+
 SLANG_API unsigned int spReflection_GetTypeParameterCount(SlangReflection * reflection)
 {
     auto program = convert(reflection);
@@ -1181,16 +1234,7 @@ SLANG_API SlangReflectionEntryPoint* spReflection_findEntryPointByName(SlangRefl
     auto program = convert(inProgram);
     if(!program) return 0;
 
-    // TODO: improve on dumb linear search
-    for(auto ep : program->entryPoints)
-    {
-        if(ep->entryPoint->getName()->text == name)
-        {
-            return convert(ep);
-        }
-    }
-
-    return nullptr;
+    return convert(program->findEntryPointByName(name));
 }
 
 
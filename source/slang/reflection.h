@@ -29,6 +29,12 @@ UInt getReflectionFieldCount(Type* type);
 UInt getReflectionFieldByIndex(Type* type, UInt index);
 UInt getReflectionFieldByIndex(TypeLayout* typeLayout, UInt index);
 
+// Write everything the reflection API reports for `programLayout` into
+// a single blob, in the format read by `slang-flat-reflection.h`.
+// Fails if a value (such as a size or binding) doesn't fit in the 32 bits
+// the format stores it in.
+SlangResult writeFlatReflection(ProgramLayout* programLayout, List<uint8_t>& outData);
+
 }
 
 #endif // SLANG_REFLECTION_H
@@ -0,0 +1,91 @@
+// serial-source-loc-table.cpp
+#include "serial-source-loc-table.h"
+
+#include "../core/slang-byte-encode-util.h"
+
+namespace Slang {
+
+/* static */void SerialSourceLocTableUtil::encode(const SourceLoc::RawValue* locs, int numLocs, List<uint8_t>& tableOut)
+{
+    tableOut.Clear();
+
+    SourceLoc::RawValue prevLoc = 0;
+    int i = 1;
+    while (i < numLocs)
+    {
+        const SourceLoc::RawValue loc = locs[i];
+        int end = i + 1;
+        while (end < numLocs && locs[end] == loc)
+        {
+            end++;
+        }
+
+        const int32_t delta = int32_t(loc - prevLoc);
+        const uint32_t values[2] = { uint32_t(end - i), (uint32_t(delta) << 1) ^ uint32_t(delta >> 31) };
+
+        uint8_t encode[ByteEncodeUtil::kMaxLiteEncodeUInt32 * 2];
+        const size_t encodeSize = ByteEncodeUtil::encodeLiteUInt32(values, 2, encode);
+        tableOut.AddRange(encode, encodeSize);
+
+        prevLoc = loc;
+        i = end;
+    }
+}
+
+// Decode a single lite encoded value, failing if it would read past end
+static bool _decodeLiteUInt32(const uint8_t*& cur, const uint8_t* end, uint32_t* valueOut)
+{
+    if (cur >= end)
+    {
+        return false;
+    }
+    if (size_t(end - cur) >= ByteEncodeUtil::kMaxLiteEncodeUInt32)
+    {
+        cur += ByteEncodeUtil::decodeLiteUInt32(cur, valueOut);
+        return true;
+    }
+    // Close to the end, so decode from a copy that can be safely read past
+    uint8_t buffer[ByteEncodeUtil::kMaxLiteEncodeUInt32] = { 0 };
+    const size_t remaining = size_t(end - cur);
+    memcpy(buffer, cur, remaining);
+    const size_t numRead = size_t(ByteEncodeUtil::decodeLiteUInt32(buffer, valueOut));
+    if (numRead > remaining)
+    {
+        return false;
+    }
+    cur += numRead;
+    return true;
+}
+
+/* static */Result SerialSourceLocTableUtil::decode(const uint8_t* table, size_t tableSize, List<SerialSourceLocRun>& runsOut)
+{
+    runsOut.Clear();
+
+    const uint8_t* cur = table;
+    const uint8_t* end = table + tableSize;
+
+    SourceLoc::RawValue loc = 0;
+    uint32_t instIndex = 1;
+    while (cur < end)
+    {
+        uint32_t numInsts, zigZagDelta;
+        if (!_decodeLiteUInt32(cur, end, &numInsts) || !_decodeLiteUInt32(cur, end, &zigZagDelta) || numInsts == 0)
+        {
+            return SLANG_FAIL;
+        }
+        loc += SourceLoc::RawValue((zigZagDelta >> 1) ^ (0 - (zigZagDelta & 1)));
+
+        if (loc)
+        {
+            SerialSourceLocRun run;
+            run.m_sourceLoc = loc;
+            run.startInstIndex = instIndex;
+            run.numInst = numInsts;
+            runsOut.Add(run);
+        }
+        instIndex += numInsts;
+    }
+    return SLANG_OK;
+}
+
+} // namespace Slang
@@ -0,0 +1,39 @@
+// serial-source-loc-table.h
+#ifndef SLANG_SERIAL_SOURCE_LOC_TABLE_H_INCLUDED
+#define SLANG_SERIAL_SOURCE_LOC_TABLE_H_INCLUDED
+
+#include "../core/basic.h"
+
+#include "source-loc.h"
+
+namespace Slang {
+
+/// A run of consecutive (serialized) instructions that have the same source location
+struct SerialSourceLocRun
+{
+    uint32_t m_sourceLoc;                   ///< The location
+    uint32_t startInstIndex;                ///< The start instruction index
+    uint32_t numInst;                       ///< The amount of instructions
+};
+
+/* Source locations of instructions, encoded as a table ordered by instruction index (similar to a DWARF line table).
+
+Consecutive instructions usually share a location, or have one close to the previous, so the table is a sequence of runs, each
+of which is the amount of instructions in the run followed by the difference of its location from the previous run's (zig-zag
+encoded so small negative differences are small). Both values are written with ByteEncodeUtil's lite encoding. The runs start
+at instruction index 1 (as 0 is null), and cover all of the instructions up to the decoration base index.
+
+The locations are the raw values of SourceLoc, which are only meaningful to the SourceManager that created them. So a table
+can only be decoded into locations that are meaningful when it's read in the same session that wrote it (and otherwise should
+be written without locations). */
+struct SerialSourceLocTableUtil
+{
+        /// Encode a location per instruction (as indexed in the serial data) into a table, ignoring index 0
+    static void encode(const SourceLoc::RawValue* locs, int numLocs, List<uint8_t>& tableOut);
+        /// Decode a table into runs of instructions with the same location. Runs with no location are not output.
+    static Result decode(const uint8_t* table, size_t tableSize, List<SerialSourceLocRun>& runsOut);
+};
+
+} // namespace Slang
+
+#endif
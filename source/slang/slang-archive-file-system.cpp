@@ -0,0 +1,491 @@
+#include "slang-archive-file-system.h"
+
+#include "../core/slang-io.h"
+#include "../core/stream.h"
+
+#include "compiler.h"
+#include "slang-file-system.h"
+
+#ifdef _WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   define NOMINMAX
+#   include <Windows.h>
+#   undef WIN32_LEAN_AND_MEAN
+#   undef NOMINMAX
+#else
+#   include <dirent.h>
+#   include <sys/stat.h>
+#endif
+
+namespace Slang
+{
+
+static const Guid IID_ISlangUnknown = SLANG_UUID_ISlangUnknown;
+static const Guid IID_ISlangBlob = SLANG_UUID_ISlangBlob;
+static const Guid IID_ISlangFileSystem = SLANG_UUID_ISlangFileSystem;
+static const Guid IID_ISlangFileSystemExt = SLANG_UUID_ISlangFileSystemExt;
+
+/* A blob for a file in an archive. Points into the contents of the archive, and keeps them alive. */
+class ArchiveFileBlob : public ISlangBlob, public RefObject
+{
+public:
+    // ISlangUnknown
+    SLANG_REF_OBJECT_IUNKNOWN_ALL
+
+    // ISlangBlob
+    SLANG_NO_THROW void const* SLANG_MCALL getBufferPointer() SLANG_OVERRIDE { return m_data; }
+    SLANG_NO_THROW size_t SLANG_MCALL getBufferSize() SLANG_OVERRIDE { return m_size; }
+
+    ArchiveFileBlob(ISlangBlob* archiveBlob, const void* data, size_t size) :
+        m_archiveBlob(archiveBlob),
+        m_data(data),
+        m_size(size)
+    {
+    }
+
+protected:
+    ISlangUnknown* getInterface(const Guid& guid)
+    {
+        return (guid == IID_ISlangUnknown || guid == IID_ISlangBlob) ? static_cast<ISlangBlob*>(this) : nullptr;
+    }
+
+    ComPtr<ISlangBlob> m_archiveBlob;
+    const void* m_data;
+    size_t m_size;
+};
+
+// Compares paths byte-wise, which is the order entries are stored in
+static int _comparePaths(const UnownedStringSlice& a, const UnownedStringSlice& b)
+{
+    const size_t aSize = a.size();
+    const size_t bSize = b.size();
+    const int res = ::memcmp(a.begin(), b.begin(), (aSize < bSize) ? aSize : bSize);
+    if (res != 0)
+    {
+        return res;
+    }
+    return (aSize < bSize) ? -1 : ((aSize > bSize) ? 1 : 0);
+}
+
+// Returns true if path starts with prefix
+static bool _startsWith(const UnownedStringSlice& path, const UnownedStringSlice& prefix)
+{
+    return path.size() >= prefix.size() && ::memcmp(path.begin(), prefix.begin(), prefix.size()) == 0;
+}
+
+/* !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! ArchiveFileSystem !!!!!!!!!!!!!!!!!!!!!!!!!!! */
+
+ISlangUnknown* ArchiveFileSystem::getInterface(const Guid& guid)
+{
+    return (guid == IID_ISlangUnknown || guid == IID_ISlangFileSystem || guid == IID_ISlangFileSystemExt) ? static_cast<ISlangFileSystemExt*>(this) : nullptr;
+}
+
+/* static */SlangResult ArchiveFileSystem::create(const String& archivePath, const String& mountPath, ISlangFileSystemExt* fallbackFileSystem, RefPtr<ArchiveFileSystem>& out)
+{
+    if (!File::Exists(archivePath))
+    {
+        return SLANG_E_NOT_FOUND;
+    }
+
+    ComPtr<ISlangBlob> blob;
+    if (SLANG_FAILED(MappedFileBlob::create(archivePath, blob)))
+    {
+        // Fall back to reading it into memory
+        try
+        {
+            List<unsigned char> bytes = File::ReadAllBytes(archivePath);
+            blob = createRawBlob(bytes.Buffer(), bytes.Count());
+        }
+        catch (const IOException&)
+        {
+            return SLANG_E_CANNOT_OPEN;
+        }
+    }
+
+    const uint8_t* data = (const uint8_t*)blob->getBufferPointer();
+    const size_t size = blob->getBufferSize();
+
+    // Check everything is in range, so lookups don't need to
+    if (size < sizeof(ArchiveHeader))
+    {
+        return SLANG_FAIL;
+    }
+    const ArchiveHeader* header = (const ArchiveHeader*)data;
+    if (header->fourCC != kArchiveFourCC || header->version != kArchiveVersion)
+    {
+        return SLANG_FAIL;
+    }
+
+    const size_t pathsOffset = sizeof(ArchiveHeader) + sizeof(ArchiveEntry) * size_t(header->entryCount);
+    if (pathsOffset + header->pathsSize > size)
+    {
+        return SLANG_FAIL;
+    }
+
+    const ArchiveEntry* entries = (const ArchiveEntry*)(data + sizeof(ArchiveHeader));
+    for (uint32_t i = 0; i < header->entryCount; ++i)
+    {
+        const ArchiveEntry& entry = entries[i];
+        // The contents must be followed by a terminating zero
+        if (uint64_t(entry.pathOffset) + entry.pathSize >= header->pathsSize ||
+            entry.dataOffset > size || entry.dataSize >= size - entry.dataOffset ||
+            data[entry.dataOffset + entry.dataSize] != 0)
+        {
+            return SLANG_FAIL;
+        }
+    }
+
+    RefPtr<ArchiveFileSystem> fileSystem(new ArchiveFileSystem);
+    fileSystem->m_archiveBlob = blob;
+    fileSystem->m_header = header;
+    fileSystem->m_entries = entries;
+    fileSystem->m_paths = (const char*)(data + pathsOffset);
+    fileSystem->m_mountPath = (mountPath.Length() > 0) ? Path::Simplify(mountPath) : String();
+    fileSystem->m_fallbackFileSystem = fallbackFileSystem;
+
+    out = fileSystem;
+    return SLANG_OK;
+}
+
+bool ArchiveFileSystem::_getArchivePath(const char* path, String& pathOut) const
+{
+    String simplifiedPath = Path::Simplify(UnownedStringSlice(path));
+
+    if (m_mountPath.Length() == 0)
+    {
+        // Everything is in the archive. The root is an empty path.
+        pathOut = (simplifiedPath == ".") ? String() : simplifiedPath;
+        return true;
+    }
+
+    const UnownedStringSlice mountPath = m_mountPath.getUnownedSlice();
+    const UnownedStringSlice slice = simplifiedPath.getUnownedSlice();
+    if (slice == mountPath)
+    {
+        pathOut = String();
+        return true;
+    }
+    if (slice.size() > mountPath.size() && _startsWith(slice, mountPath) && Path::IsDelimiter(slice[int(mountPath.size())]))
+    {
+        pathOut = UnownedStringSlice(slice.begin() + mountPath.size() + 1, slice.end());
+        return true;
+    }
+    return false;
+}
+
+const ArchiveFileSystem::ArchiveEntry* ArchiveFileSystem::_findEntry(const UnownedStringSlice& path) const
+{
+    // Binary search the sorted entries
+    int lo = 0;
+    int hi = int(m_header->entryCount);
+    while (lo < hi)
+    {
+        const int mid = (lo + hi) >> 1;
+        const int res = _comparePaths(_getPath(m_entries[mid]), path);
+        if (res == 0)
+        {
+            return &m_entries[mid];
+        }
+        if (res < 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return nullptr;
+}
+
+bool ArchiveFileSystem::_isDirectory(const UnownedStringSlice& path) const
+{
+    // The root is always a directory
+    if (path.size() == 0)
+    {
+        return true;
+    }
+
+    // Find the first entry that is >= "path/". It's a directory if that entry starts with "path/"
+    String prefix(path);
+    prefix.append('/');
+    const UnownedStringSlice prefixSlice = prefix.getUnownedSlice();
+
+    int lo = 0;
+    int hi = int(m_header->entryCount);
+    while (lo < hi)
+    {
+        const int mid = (lo + hi) >> 1;
+        if (_comparePaths(_getPath(m_entries[mid]), prefixSlice) < 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo < int(m_header->entryCount) && _startsWith(_getPath(m_entries[lo]), prefixSlice);
+}
+
+SlangResult ArchiveFileSystem::loadFile(char const* path, ISlangBlob** outBlob)
+{
+    *outBlob = nullptr;
+
+    String archivePath;
+    if (!_getArchivePath(path, archivePath))
+    {
+        return m_fallbackFileSystem ? m_fallbackFileSystem->loadFile(path, outBlob) : SLANG_E_NOT_FOUND;
+    }
+
+    const ArchiveEntry* entry = _findEntry(archivePath.getUnownedSlice());
+    if (!entry)
+    {
+        return SLANG_E_NOT_FOUND;
+    }
+
+    const uint8_t* data = (const uint8_t*)m_archiveBlob->getBufferPointer() + entry->dataOffset;
+    ComPtr<ISlangBlob> blob(new ArchiveFileBlob(m_archiveBlob, data, size_t(entry->dataSize)));
+    DefaultFileSystem::transcodeToUTF8IfNeeded(blob, outBlob);
+    return SLANG_OK;
+}
+
+SlangResult ArchiveFileSystem::getCanoncialPath(const char* path, ISlangBlob** canonicalPathOut)
+{
+    String archivePath;
+    if (!_getArchivePath(path, archivePath))
+    {
+        return m_fallbackFileSystem ? m_fallbackFileSystem->getCanoncialPath(path, canonicalPathOut) : SLANG_E_NOT_FOUND;
+    }
+
+    const UnownedStringSlice slice = archivePath.getUnownedSlice();
+    if (!_findEntry(slice) && !_isDirectory(slice))
+    {
+        return SLANG_E_NOT_FOUND;
+    }
+
+    // The simplified path is unique within the archive, and prefixing with the mount path makes it unique
+    // with respect to the fallback file system.
+    String canonicalPath;
+    if (m_mountPath.Length() == 0)
+    {
+        canonicalPath = archivePath;
+    }
+    else
+    {
+        canonicalPath = m_mountPath;
+        if (archivePath.Length() > 0)
+        {
+            canonicalPath.append('/');
+            canonicalPath.append(archivePath);
+        }
+    }
+
+    *canonicalPathOut = StringUtil::createStringBlob(canonicalPath).detach();
+    return SLANG_OK;
+}
+
+SlangResult ArchiveFileSystem::calcRelativePath(SlangPathType fromPathType, const char* fromPath, const char* path, ISlangBlob** pathOut)
+{
+    // Just string processing, so works the same inside and outside the archive
+    String relPath;
+    switch (fromPathType)
+    {
+        case SLANG_PATH_TYPE_FILE:
+        {
+            relPath = Path::Combine(Path::GetDirectoryName(fromPath), path);
+            break;
+        }
+        case SLANG_PATH_TYPE_DIRECTORY:
+        {
+            relPath = Path::Combine(fromPath, path);
+            break;
+        }
+    }
+
+    *pathOut = StringUtil::createStringBlob(relPath).detach();
+    return SLANG_OK;
+}
+
+SlangResult ArchiveFileSystem::getPathType(const char* path, SlangPathType* pathTypeOut)
+{
+    String archivePath;
+    if (!_getArchivePath(path, archivePath))
+    {
+        return m_fallbackFileSystem ? m_fallbackFileSystem->getPathType(path, pathTypeOut) : SLANG_E_NOT_FOUND;
+    }
+
+    const UnownedStringSlice slice = archivePath.getUnownedSlice();
+    if (_findEntry(slice))
+    {
+        *pathTypeOut = SLANG_PATH_TYPE_FILE;
+        return SLANG_OK;
+    }
+    if (_isDirectory(slice))
+    {
+        *pathTypeOut = SLANG_PATH_TYPE_DIRECTORY;
+        return SLANG_OK;
+    }
+    return SLANG_E_NOT_FOUND;
+}
+
+// Adds the paths (relative to the root directory) of all files in directoryPath and its sub directories
+static SlangResult _findFilesRecursively(const String& directoryPath, const String& relativePath, List<String>& relativePathsOut)
+{
+    List<String> subDirectories;
+
+#ifdef _WIN32
+    WIN32_FIND_DATAW fileData;
+    HANDLE findHandle = ::FindFirstFileW(Path::Combine(directoryPath, "*").ToWString(), &fileData);
+    if (findHandle == INVALID_HANDLE_VALUE)
+    {
+        return SLANG_E_NOT_FOUND;
+    }
+    do
+    {
+        const String name = String::FromWString(fileData.cFileName);
+        if (name == "." || name == "..")
+        {
+            continue;
+        }
+        if (fileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        {
+            subDirectories.Add(name);
+        }
+        else
+        {
+            relativePathsOut.Add((relativePath.Length() > 0) ? (relativePath + "/" + name) : name);
+        }
+    }
+    while (::FindNextFileW(findHandle, &fileData));
+    ::FindClose(findHandle);
+#else
+    DIR* directory = ::opendir(directoryPath.Buffer());
+    if (!directory)
+    {
+        return SLANG_E_NOT_FOUND;
+    }
+    while (dirent* entry = ::readdir(directory))
+    {
+        const String name(entry->d_name);
+        if (name == "." || name == "..")
+        {
+            continue;
+        }
+
+        // d_type isn't available on all file systems, so use stat
+        struct stat statVar;
+        if (::stat(Path::Combine(directoryPath, name).Buffer(), &statVar) != 0)
+        {
+            continue;
+        }
+        if (S_ISDIR(statVar.st_mode))
+        {
+            subDirectories.Add(name);
+        }
+        else if (S_ISREG(statVar.st_mode))
+        {
+            relativePathsOut.Add((relativePath.Length() > 0) ? (relativePath + "/" + name) : name);
+        }
+    }
+    ::closedir(directory);
+#endif
+
+    for (const auto& subDirectory : subDirectories)
+    {
+        SLANG_RETURN_ON_FAIL(_findFilesRecursively(Path::Combine(directoryPath, subDirectory), (relativePath.Length() > 0) ? (relativePath + "/" + subDirectory) : subDirectory, relativePathsOut));
+    }
+    return SLANG_OK;
+}
+
+/* static */SlangResult ArchiveFileSystem::writeArchive(const String& directoryPath, const String& archivePath)
+{
+    List<String> paths;
+    SLANG_RETURN_ON_FAIL(_findFilesRecursively(directoryPath, String(), paths));
+
+    // If the archive is being written into the directory, don't include a previous version of it
+    String canonicalArchivePath;
+    if (SLANG_SUCCEEDED(Path::GetCanonical(archivePath, canonicalArchivePath)))
+    {
+        for (UInt i = 0; i < paths.Count(); ++i)
+        {
+            String canonicalPath;
+            if (SLANG_SUCCEEDED(Path::GetCanonical(Path::Combine(directoryPath, paths[i]), canonicalPath)) && canonicalPath == canonicalArchivePath)
+            {
+                paths.RemoveAt(i);
+                break;
+            }
+        }
+    }
+
+    paths.Sort([](const String& a, const String& b) { return _comparePaths(a.getUnownedSlice(), b.getUnownedSlice()) < 0; });
+
+    const uint32_t entryCount = uint32_t(paths.Count());
+
+    // Work out the paths section
+    List<ArchiveEntry> entries;
+    entries.SetSize(entryCount);
+    uint32_t pathsSize = 0;
+    for (uint32_t i = 0; i < entryCount; ++i)
+    {
+        entries[i].pathOffset = pathsSize;
+        entries[i].pathSize = uint32_t(paths[i].Length());
+        entries[i].dataOffset = 0;
+        entries[i].dataSize = 0;
+        pathsSize += entries[i].pathSize + 1;
+    }
+
+    try
+    {
+        ArchiveHeader header;
+        header.fourCC = kArchiveFourCC;
+        header.version = kArchiveVersion;
+        header.entryCount = entryCount;
+        header.pathsSize = pathsSize;
+
+        // The entries are written again once the contents have been, as that's when their offsets and sizes are known
+        FileStream stream(archivePath, FileMode::Create);
+        stream.Write(&header, sizeof(header));
+        stream.Write(entries.Buffer(), sizeof(ArchiveEntry) * entryCount);
+        for (const auto& path : paths)
+        {
+            stream.Write(path.Buffer(), path.Length() + 1);
+        }
+
+        uint64_t position = sizeof(ArchiveHeader) + sizeof(ArchiveEntry) * uint64_t(entryCount) + pathsSize;
+        const uint8_t padding[kArchiveDataAlignment] = {};
+        List<uint8_t> buffer;
+        buffer.SetSize(64 * 1024);
+        for (uint32_t i = 0; i < entryCount; ++i)
+        {
+            const uint64_t offset = (position + kArchiveDataAlignment - 1) & ~uint64_t(kArchiveDataAlignment - 1);
+            stream.Write(padding, offset - position);
+
+            FileStream fileStream(Path::Combine(directoryPath, paths[i]), FileMode::Open, FileAccess::Read, FileShare::ReadWrite);
+            uint64_t dataSize = 0;
+            while (const Int64 readSize = fileStream.Read(buffer.Buffer(), Int64(buffer.Count())))
+            {
+                stream.Write(buffer.Buffer(), readSize);
+                dataSize += uint64_t(readSize);
+            }
+            // Terminating zero
+            stream.Write(padding, 1);
+
+            entries[i].dataOffset = offset;
+            entries[i].dataSize = dataSize;
+            position = offset + dataSize + 1;
+        }
+
+        stream.Seek(SeekOrigin::Start, Int64(sizeof(ArchiveHeader)));
+        stream.Write(entries.Buffer(), sizeof(ArchiveEntry) * entryCount);
+        stream.Close();
+    }
+    catch (const IOException&)
+    {
+        return SLANG_E_CANNOT_OPEN;
+    }
+
+    return SLANG_OK;
+}
+
+}
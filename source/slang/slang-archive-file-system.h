@@ -0,0 +1,115 @@
+#ifndef SLANG_ARCHIVE_FILE_SYSTEM_H_INCLUDED
+#define SLANG_ARCHIVE_FILE_SYSTEM_H_INCLUDED
+
+#include "../../slang.h"
+#include "../../slang-com-helper.h"
+#include "../../slang-com-ptr.h"
+
+#include "../core/slang-string-util.h"
+
+namespace Slang
+{
+
+/* A read-only file system that serves files from a single packed archive file.
+
+The archive is mapped into memory when loaded, and file contents are returned as blobs that point directly
+into the mapping, so loading a file doesn't require any file system calls. As with files loaded from disk, contents
+are followed by a zero (that isn't included in the blob size), and text that isn't UTF-8 is transcoded to UTF-8.
+
+The layout of an archive is
+
+    ArchiveHeader
+    ArchiveEntry[entryCount]        Sorted by path (byte-wise comparison)
+    char paths[pathsSize]           Zero terminated paths, '/' separated and relative to the archived directory
+    payload                         File contents, each starting on a kArchiveDataAlignment boundary and followed by a zero
+
+Directories are not stored - a path is a directory if any entry path starts with it followed by '/'.
+
+An archive can be 'mounted' at a path. Paths beneath the mount path are looked up in the archive and all other
+paths are passed to a fallback file system (if there is one). This allows an archive to be used as a search path
+alongside files on disk.
+*/
+class ArchiveFileSystem : public ISlangFileSystemExt, public RefObject
+{
+public:
+    static const uint32_t kArchiveFourCC = uint32_t('S') | (uint32_t('L') << 8) | (uint32_t('A') << 16) | (uint32_t('R') << 24);
+    static const uint32_t kArchiveVersion = 2;
+    static const uint32_t kArchiveDataAlignment = 16;
+
+    struct ArchiveHeader
+    {
+        uint32_t fourCC;                    ///< kArchiveFourCC
+        uint32_t version;                   ///< kArchiveVersion
+        uint32_t entryCount;                ///< Number of ArchiveEntry that follow the header
+        uint32_t pathsSize;                 ///< Size of the paths section in bytes
+    };
+
+    struct ArchiveEntry
+    {
+        uint32_t pathOffset;                ///< Offset of the path from the start of the paths section
+        uint32_t pathSize;                  ///< Length of the path in bytes (not including terminating zero)
+        uint64_t dataOffset;                ///< Offset of the contents from the start of the archive
+        uint64_t dataSize;                  ///< Size of the contents in bytes (not including terminating zero)
+    };
+
+    // ISlangUnknown
+    SLANG_REF_OBJECT_IUNKNOWN_ALL
+
+    // ISlangFileSystem
+    virtual SLANG_NO_THROW SlangResult SLANG_MCALL loadFile(
+        char const*     path,
+        ISlangBlob**    outBlob) SLANG_OVERRIDE;
+
+    // ISlangFileSystemExt
+    virtual SLANG_NO_THROW SlangResult SLANG_MCALL getCanoncialPath(
+        const char* path,
+        ISlangBlob** canonicalPathOut) SLANG_OVERRIDE;
+
+    virtual SLANG_NO_THROW SlangResult SLANG_MCALL calcRelativePath(
+        SlangPathType fromPathType,
+        const char* fromPath,
+        const char* path,
+        ISlangBlob** pathOut) SLANG_OVERRIDE;
+
+    virtual SLANG_NO_THROW SlangResult SLANG_MCALL getPathType(
+        const char* path,
+        SlangPathType* pathTypeOut) SLANG_OVERRIDE;
+
+        /// Get the number of files in the archive
+    UInt getFileCount() const { return UInt(m_header->entryCount); }
+
+        /// Load the archive at archivePath.
+        /// If mountPath is empty, all paths are looked up in the archive. Otherwise only paths beneath mountPath are, and other
+        /// paths are passed to fallbackFileSystem (which can be nullptr).
+    static SlangResult create(const String& archivePath, const String& mountPath, ISlangFileSystemExt* fallbackFileSystem, RefPtr<ArchiveFileSystem>& out);
+
+        /// Write an archive to archivePath, containing all of the files in (and beneath) directoryPath.
+        /// Files are copied into the archive one block at a time, so they are never all held in memory.
+    static SlangResult writeArchive(const String& directoryPath, const String& archivePath);
+
+protected:
+    ISlangUnknown* getInterface(const Guid& guid);
+
+        /// If path is in the archive, sets pathOut to the path relative to the root of the archive and returns true
+    bool _getArchivePath(const char* path, String& pathOut) const;
+        /// Find the entry for path (relative to archive root). Returns nullptr if not found
+    const ArchiveEntry* _findEntry(const UnownedStringSlice& path) const;
+        /// Returns true if path (relative to archive root) is a directory
+    bool _isDirectory(const UnownedStringSlice& path) const;
+        /// Get the path of an entry
+    UnownedStringSlice _getPath(const ArchiveEntry& entry) const { const char* path = m_paths + entry.pathOffset; return UnownedStringSlice(path, path + entry.pathSize); }
+
+    ArchiveFileSystem() {}
+
+    ComPtr<ISlangBlob> m_archiveBlob;                   ///< Holds the archive contents
+    const ArchiveHeader* m_header = nullptr;
+    const ArchiveEntry* m_entries = nullptr;
+    const char* m_paths = nullptr;
+
+    String m_mountPath;                                 ///< Simplified mount path, or empty if everything is in the archive
+    ComPtr<ISlangFileSystemExt> m_fallbackFileSystem;   ///< Used for paths that are not beneath the mount path. Can be nullptr.
+};
+
+}
+
+#endif // SLANG_ARCHIVE_FILE_SYSTEM_H_INCLUDED
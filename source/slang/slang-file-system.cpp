@@ -3,6 +3,7 @@
 #include "../../slang-com-ptr.h"
 #include "../core/slang-io.h"
 #include "../core/slang-string-util.h"
+#include "../core/text-io.h"
 
 #include "compiler.h"
 
@@ -72,6 +73,35 @@ SlangResult SLANG_MCALL DefaultFileSystem::getPathType(
     return Path::GetPathType(path, pathTypeOut);   
 }
 
+// True if the text in `data` needs to be transcoded to UTF-8, using the same
+// rules as `StreamReader` (a UTF-16 byte order mark, or null bytes in the first
+// block of the file)
+static bool _needsTranscodingToUTF8(const uint8_t* data, size_t size)
+{
+    if (size >= 2 && ((data[0] == 0xFF && data[1] == 0xFE) || (data[0] == 0xFE && data[1] == 0xFF)))
+    {
+        return true;
+    }
+
+    const size_t checkSize = (size < 4096) ? size : 4096;
+    const uint8_t* firstNull = (const uint8_t*)memchr(data, 0, checkSize);
+    if (firstNull)
+    {
+        for (const uint8_t* cur = firstNull + 1; cur + 1 < data + checkSize; ++cur)
+        {
+            if (*cur != 0)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Files smaller than this are copied rather than mapped. A copy can't change underneath the
+// compiler, and for a small file the mapping is barely any faster.
+static const uint64_t kMinMappedFileSize = 64 * 1024;
+
 SlangResult DefaultFileSystem::loadFile(char const* path, ISlangBlob** outBlob)
 {
     // Default implementation that uses the `core` libraries facilities for talking to the OS filesystem.
@@ -80,11 +110,48 @@ SlangResult DefaultFileSystem::loadFile(char const* path, ISlangBlob** outBlob)
     // a user could create a build of Slang that doesn't include any OS
     // filesystem calls.
 
-    if (!File::Exists(path))
+    uint64_t modifiedTime, fileSize;
+    if (SLANG_FAILED(File::GetModificationInfo(path, modifiedTime, fileSize)))
     {
         return SLANG_E_NOT_FOUND;
     }
 
+    // Source that is already UTF-8 (or ASCII) is used as is. Note that unlike
+    // `File::ReadAllText` this doesn't normalize line endings (the lexer handles
+    // all the styles) or strip a UTF-8 byte order mark (`SourceManager::createSourceFile`
+    // does that).
+    //
+    // Small files are copied. Larger ones are used straight from a mapping of the
+    // file, which the caller has to check is still valid before using it again
+    // (see `CacheFileSystem::_loadFile`).
+    if (fileSize >= kMinMappedFileSize)
+    {
+        ComPtr<ISlangBlob> mappedBlob;
+        if (SLANG_SUCCEEDED(MappedFileBlob::create(path, mappedBlob)) &&
+            !_needsTranscodingToUTF8((const uint8_t*)mappedBlob->getBufferPointer(), mappedBlob->getBufferSize()))
+        {
+            *outBlob = mappedBlob.detach();
+            return SLANG_OK;
+        }
+    }
+    else if (fileSize > 0)
+    {
+        try
+        {
+            List<unsigned char> bytes = File::ReadAllBytes(path);
+            if (bytes.Count() > 0 && !_needsTranscodingToUTF8(bytes.Buffer(), bytes.Count()))
+            {
+                const char* text = (const char*)bytes.Buffer();
+                *outBlob = StringUtil::createStringBlob(String(text, text + bytes.Count())).detach();
+                return SLANG_OK;
+            }
+        }
+        catch (...)
+        {
+            return SLANG_E_CANNOT_OPEN;
+        }
+    }
+
     try
     {
         String sourceString = File::ReadAllText(path);
@@ -97,6 +164,22 @@ SlangResult DefaultFileSystem::loadFile(char const* path, ISlangBlob** outBlob)
     return SLANG_E_CANNOT_OPEN;
 }
 
+/* static */void DefaultFileSystem::transcodeToUTF8IfNeeded(ISlangBlob* blob, ISlangBlob** outBlob)
+{
+    const uint8_t* data = (const uint8_t*)blob->getBufferPointer();
+    const size_t size = blob->getBufferSize();
+    if (!_needsTranscodingToUTF8(data, size))
+    {
+        blob->addRef();
+        *outBlob = blob;
+        return;
+    }
+
+    // Decode the same way as `File::ReadAllText`
+    StreamReader reader(new MemoryStream(data, size));
+    *outBlob = StringUtil::createStringBlob(reader.ReadToEnd()).detach();
+}
+
 // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! CacheFileSystem !!!!!!!!!!!!!!!!!!!!!!!!!!!
 
 /* static */ const Result CacheFileSystem::s_compressedResultToResult[] = 
@@ -127,9 +210,10 @@ ISlangUnknown* CacheFileSystem::getInterface(const Guid& guid)
     return _getInterface(this, guid);
 }
 
-CacheFileSystem::CacheFileSystem(ISlangFileSystem* fileSystem, bool useSimplifyForCanonicalPath) :
+CacheFileSystem::CacheFileSystem(ISlangFileSystem* fileSystem, bool useSimplifyForCanonicalPath, bool revalidate) :
     m_fileSystem(fileSystem),
-    m_useSimplifyForCanonicalPath(useSimplifyForCanonicalPath)
+    m_useSimplifyForCanonicalPath(useSimplifyForCanonicalPath),
+    m_revalidate(revalidate)
 {
     // Try to get the more sophisticated interface
     fileSystem->queryInterface(IID_ISlangFileSystemExt, (void**)m_fileSystemExt.writeRef());
@@ -143,13 +227,125 @@ CacheFileSystem::~CacheFileSystem()
     }
 }
 
+void CacheFileSystem::markStale()
+{
+    if (!m_revalidate)
+    {
+        return;
+    }
+    // Entries are revalidated lazily, when their epoch doesn't match
+    m_epoch++;
+
+    // Paths that couldn't be found may exist now, so allow them to be retried
+    for (const auto& failedPath : m_failedPaths)
+    {
+        m_pathMap.Remove(failedPath);
+    }
+    m_failedPaths.Clear();
+}
+
+void CacheFileSystem::invalidate(const String& path)
+{
+    PathInfo** infoPtr = m_pathMap.TryGetValue(path);
+    if (!infoPtr)
+    {
+        infoPtr = m_canonicalMap.TryGetValue(path);
+        if (!infoPtr)
+        {
+            return;
+        }
+    }
+
+    PathInfo* info = *infoPtr;
+    if (info)
+    {
+        info->reset();
+        // Make sure the modification info is recorded again on next use
+        info->m_validatedEpoch = 0;
+    }
+    else
+    {
+        // It's a path that failed, so just remove it so it can be retried
+        m_pathMap.Remove(path);
+    }
+    m_stats.invalidations++;
+}
+
+void CacheFileSystem::invalidateAll()
+{
+    for (const auto& pair : m_canonicalMap)
+    {
+        delete pair.Value;
+    }
+    m_canonicalMap.Clear();
+    m_pathMap.Clear();
+    m_failedPaths.Clear();
+}
+
+void CacheFileSystem::_validate(PathInfo* info)
+{
+    if (!m_revalidate || info->m_validatedEpoch == m_epoch)
+    {
+        return;
+    }
+
+    uint64_t modifiedTime = 0;
+    uint64_t fileSize = 0;
+    if (SLANG_FAILED(File::GetModificationInfo(info->getCanonicalPath(), modifiedTime, fileSize)))
+    {
+        // Use 0 to mean not found 
+        modifiedTime = 0;
+        fileSize = 0;
+    }
+
+    // If it has been validated before, see if it has changed since
+    if (info->m_validatedEpoch != 0)
+    {
+        m_stats.revalidations++;
+        if (info->m_modifiedTime != modifiedTime || info->m_fileSize != fileSize)
+        {
+            info->reset();
+            m_stats.invalidations++;
+        }
+    }
+
+    info->m_modifiedTime = modifiedTime;
+    info->m_fileSize = fileSize;
+    info->m_validatedEpoch = m_epoch;
+}
+
+void CacheFileSystem::_loadFile(PathInfo* info, const String& path)
+{
+    if (info->m_loadFileResult != CompressedResult::Uninitialized)
+    {
+        // A mapped file is only valid as long as the file doesn't change, whether or not the cache revalidates
+        MappedFileBlob* mappedBlob = MappedFileBlob::getMappedFileBlob(info->m_fileBlob);
+        if (!mappedBlob || mappedBlob->isFileUnchanged())
+        {
+            m_stats.loadFileHits++;
+            return;
+        }
+        info->reset();
+        m_stats.invalidations++;
+    }
+
+    m_stats.loadFileMisses++;
+    info->m_loadFileResult = toCompressedResult(m_fileSystem->loadFile(path.Buffer(), info->m_fileBlob.writeRef()));
+    if (info->m_fileBlob)
+    {
+        m_stats.bytesRead += info->m_fileBlob->getBufferSize();
+    }
+}
+
 CacheFileSystem::PathInfo* CacheFileSystem::_getPathInfo(const String& relPath)
 {
     PathInfo** infoPtr = m_pathMap.TryGetValue(relPath);
     if (infoPtr)
     {
+        m_stats.canonicalPathHits++;
         return *infoPtr;
     }
+    m_stats.canonicalPathMisses++;
 
     String canonicalPath;
     if (m_fileSystemExt)
@@ -161,6 +357,11 @@ CacheFileSystem::PathInfo* CacheFileSystem::_getPathInfo(const String& relPath)
         {
             // Write in result as being null ptr so not tried again
             m_pathMap.Add(relPath, nullptr);
+            if (m_revalidate)
+            {
+                // Unless the cache is marked as stale
+                m_failedPaths.Add(relPath);
+            }
             return nullptr;
         }
         // Get the path as a string
@@ -199,10 +400,8 @@ SlangResult CacheFileSystem::loadFile(char const* pathIn, ISlangBlob** blobOut)
         return SLANG_FAIL;
     }
     
-    if (info->m_loadFileResult == CompressedResult::Uninitialized)
-    {
-        info->m_loadFileResult = toCompressedResult(m_fileSystem->loadFile(path.Buffer(), info->m_fileBlob.writeRef()));
-    }
+    _validate(info);
+    _loadFile(info, path);
 
     *blobOut = info->m_fileBlob;
     if (*blobOut)
@@ -247,8 +446,11 @@ SlangResult CacheFileSystem::getPathType(const char* pathIn, SlangPathType* path
         return SLANG_E_NOT_FOUND;
     }
 
+    _validate(info);
+
     if (info->m_getPathTypeResult == CompressedResult::Uninitialized)
     {
+        m_stats.pathTypeMisses++;
         if (m_fileSystemExt)
         {
             info->m_getPathTypeResult = toCompressedResult(m_fileSystemExt->getPathType(pathIn, &info->m_pathType));
@@ -256,10 +458,7 @@ SlangResult CacheFileSystem::getPathType(const char* pathIn, SlangPathType* path
         else
         {
             // Okay try to load the file
-            if (info->m_loadFileResult == CompressedResult::Uninitialized)
-            {
-                info->m_loadFileResult = toCompressedResult(m_fileSystem->loadFile(path.Buffer(), info->m_fileBlob.writeRef()));
-            }
+            _loadFile(info, path);
 
             // Make the getPathResult the same as the load result
             info->m_getPathTypeResult = info->m_loadFileResult;
@@ -268,6 +467,11 @@ SlangResult CacheFileSystem::getPathType(const char* pathIn, SlangPathType* path
         }
     }
 
+    else
+    {
+        m_stats.pathTypeHits++;
+    }
+
     *pathTypeOut = info->m_pathType;
     return toResult(info->m_getPathTypeResult);
 }
@@ -43,6 +43,11 @@ public:
         /// Get a default instance
     static ISlangFileSystemExt* getSingleton() { return &s_singleton; }
 
+        /// Returns the text in data as a blob that can be lexed directly. Text that is already UTF-8 (or ASCII) is
+        /// returned as is in blob, and text that isn't (such as UTF-16 with a byte order mark) is transcoded to UTF-8,
+        /// the same as the contents of files loaded from disk.
+    static void transcodeToUTF8IfNeeded(ISlangBlob* blob, ISlangBlob** outBlob);
+
 private:
         /// Make so not constructible
     DefaultFileSystem() {}
@@ -63,6 +68,10 @@ NOTE! That this behavior is the same as previously in that....
 doing it this way means it works as before and requires no new functions.
 
 You can use a more sophisticated canonical style if you pass true to  useSimplifyForCanonicalPath. This will simplify relative path to create a canonical path.
+
+A CacheFileSystem can also be shared between compile requests (see Session::getFileSystemCache). In that case create it with 
+revalidate set. Calling markStale (at the start of each request) means each cached entry will be checked against the modification 
+time and size of the file on disk the next time it is used, and reloaded if they have changed. Paths that failed to resolve are retried.
 */
 class CacheFileSystem: public ISlangFileSystemExt, public RefObject
 {
@@ -79,6 +88,20 @@ class CacheFileSystem: public ISlangFileSystemExt, public RefObject
         CountOf,
     };
 
+        /// Counters of how the cache has been used
+    struct Stats
+    {
+        uint64_t bytesRead = 0;                 ///< Total bytes of files loaded from the underlying file system
+        uint32_t loadFileHits = 0;              ///< loadFile calls answered from the cache
+        uint32_t loadFileMisses = 0;            ///< loadFile calls that loaded from the underlying file system
+        uint32_t pathTypeHits = 0;
+        uint32_t pathTypeMisses = 0;
+        uint32_t canonicalPathHits = 0;         ///< Paths whose canonical path was already known
+        uint32_t canonicalPathMisses = 0;
+        uint32_t revalidations = 0;             ///< Number of entries checked against the file system after markStale
+        uint32_t invalidations = 0;             ///< Number of entries found to have changed, or explicitly invalidated
+    };
+
     // ISlangUnknown 
     SLANG_REF_OBJECT_IUNKNOWN_ALL
 
@@ -102,8 +125,19 @@ class CacheFileSystem: public ISlangFileSystemExt, public RefObject
         const char* path,
         SlangPathType* pathTypeOut) SLANG_OVERRIDE;
 
+        /// Mark all entries as needing to be revalidated before their next use. Only has an effect if revalidate was set on construction.
+    void markStale();
+        /// Discard what is cached about the file at path (which can be any path that refers to it)
+    void invalidate(const String& path);
+        /// Discard everything cached
+    void invalidateAll();
+
+        /// Get the usage counters
+    const Stats& getStats() const { return m_stats; }
+
         /// Ctor
-    CacheFileSystem(ISlangFileSystem* fileSystem, bool useSimplifyForCanonicalPath = false);
+        /// If revalidate is set, the underlying file system must be backed by the OS file system, as file modification times are used for revalidation.
+    CacheFileSystem(ISlangFileSystem* fileSystem, bool useSimplifyForCanonicalPath = false, bool revalidate = false);
         /// Dtor
     virtual ~CacheFileSystem();
 
@@ -123,6 +157,13 @@ protected:
 
             m_loadFileResult = CompressedResult::Uninitialized;
             m_getPathTypeResult = CompressedResult::Uninitialized;
+        }
+            /// Reset any cached results
+        void reset()
+        {
+            m_loadFileResult = CompressedResult::Uninitialized;
+            m_getPathTypeResult = CompressedResult::Uninitialized;
+            m_fileBlob.setNull();
         }
         ~PathInfo()
         {
@@ -136,10 +177,18 @@ protected:
         CompressedResult m_getPathTypeResult;    
         SlangPathType m_pathType;
         ComPtr<ISlangBlob> m_fileBlob;
+
+        uint32_t m_validatedEpoch = 0;                  ///< The epoch the entry was last known to be valid in
+        uint64_t m_modifiedTime = 0;                    ///< Modification time when last validated (0 if the file wasn't found)
+        uint64_t m_fileSize = 0;                        ///< File size when last validated
     };
 
         /// For a given relPath gets a PathInfo
     PathInfo* _getPathInfo(const String& relPath);
+        /// Makes sure the cached results in info are still valid, if revalidating
+    void _validate(PathInfo* info);
+        /// Load the file for info, if it hasn't been loaded already
+    void _loadFile(PathInfo* info, const String& path);
 
     /* TODO: This may be improved by mapping to a ISlangBlob. This makes output fast and easy, and if constructed 
     as a StringBlob, we can just static_cast to get as a string to use internally, instead of constantly converting. 
@@ -150,6 +199,11 @@ protected:
     Dictionary<String, PathInfo*> m_canonicalMap;   ///< Maps a canonical path to a files contents. This OWNs the PathInfo.
 
     bool m_useSimplifyForCanonicalPath;             ///< If set will use Path::Simplify to create 'canonical' paths
+    bool m_revalidate;                              ///< If set entries are checked against the file system after markStale
+    uint32_t m_epoch = 1;                           ///< Incremented by markStale
+    List<String> m_failedPaths;                     ///< Paths in m_pathMap that failed to produce a canonical path
+
+    Stats m_stats;
 
     ComPtr<ISlangFileSystem> m_fileSystem;          ///< Must always be set
     ComPtr<ISlangFileSystemExt> m_fileSystemExt;    ///< Optionally set -> if not will fall back on the m_fileSystem
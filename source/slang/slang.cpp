@@ -11,7 +11,9 @@
 #include "../slang/reflection.h"
 #include "syntax-visitors.h"
 #include "../slang/type-layout.h"
+#include "lookup.h"
 
+#include "slang-archive-file-system.h"
 #include "slang-file-system.h"
 
 #include "ir-serialize.h"
@@ -210,6 +212,7 @@ Profile getEffectiveProfile(EntryPointRequest* entryPoint, TargetRequest* target
     case CodeGenTarget::DXBytecodeAssembly:
     case CodeGenTarget::DXIL:
     case CodeGenTarget::DXILAssembly:
+    case CodeGenTarget::CPPSource:
         if(targetProfile.getFamily() != ProfileFamily::DX)
         {
             targetProfile.setVersion(ProfileVersion::DX_4_0);
@@ -307,7 +310,28 @@ CompileRequest::CompileRequest(Session* session)
 
     // Set up the default file system
     SLANG_ASSERT(fileSystem == nullptr);
-    fileSystemExt = new CacheFileSystem(DefaultFileSystem::getSingleton());
+    setDefaultFileSystem();
+}
+
+CompileRequest::~CompileRequest()
+{
+    destroyTypeLayoutCache();
+}
+
+void CompileRequest::setDefaultFileSystem()
+{
+    fileSystem.setNull();
+
+    if (CacheFileSystem* fileSystemCache = mSession->fileSystemCache)
+    {
+        // Files may have changed since the last request, so check entries before they are used again
+        fileSystemCache->markStale();
+        fileSystemExt = fileSystemCache;
+    }
+    else
+    {
+        fileSystemExt = new CacheFileSystem(DefaultFileSystem::getSingleton());
+    }
 }
 
 // Allocate static const storage for the various interface IDs that the Slang API needs to expose
@@ -422,6 +446,26 @@ RefPtr<Expr> CompileRequest::parseTypeString(TranslationUnitRequest * translatio
     return parseTypeFromSourceFile(translationUnit, tokens, &sink, scope);
 }
 
+// Returns true if the string is a single identifier, which would
+// parse as a plain name reference
+static bool _isSimpleTypeName(String const& typeStr)
+{
+    auto chars = typeStr.Buffer();
+    auto length = typeStr.Length();
+    if (length == 0)
+        return false;
+    for (UInt ii = 0; ii < length; ++ii)
+    {
+        char c = chars[ii];
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_')
+            continue;
+        if (ii > 0 && c >= '0' && c <= '9')
+            continue;
+        return false;
+    }
+    return true;
+}
+
 RefPtr<Type> checkProperType(TranslationUnitRequest * tu, TypeExp typeExp);
 Type* CompileRequest::getTypeFromString(String typeStr)
 {
@@ -434,11 +478,32 @@ Type* CompileRequest::getTypeFromString(String typeStr)
         scopesToTry.Add(tu->SyntaxNode->scope);
     for (auto & module : loadedModulesList)
         scopesToTry.Add(module->moduleDecl->scope);
+
+    // A simple name would just parse to a reference to that name,
+    // so we can construct the expression directly, and skip
+    // creating a source file to preprocess and parse.
+    Name* simpleName = _isSimpleTypeName(typeStr) ? getNamePool()->getName(typeStr) : nullptr;
+
     // parse type name
     for (auto & s : scopesToTry)
     {
-        RefPtr<Expr> typeExpr = parseTypeString(translationUnit,
-            typeStr, s);
+        RefPtr<Expr> typeExpr;
+        if (simpleName)
+        {
+            // If the name isn't visible from this scope, checking would
+            // just produce an error, so move on to the next one.
+            if (!lookUp(mSession, nullptr, simpleName, s).isValid())
+                continue;
+
+            auto varExpr = new VarExpr();
+            varExpr->scope = s.Ptr();
+            varExpr->name = simpleName;
+            typeExpr = varExpr;
+        }
+        else
+        {
+            typeExpr = parseTypeString(translationUnit, typeStr, s);
+        }
         type = checkProperType(translationUnit, TypeExp(typeExpr));
         if (type)
             break;
@@ -525,20 +590,55 @@ void CompileRequest::generateIR()
     {
         if (useSerialIRBottleneck)
         {              
-            IRSerialData serialData;
+            // A failure is reported as an error, which stops the request before the IR is used
+
+            // Holds the binary container the IR is written to
+            MemoryStream memoryStream;
             {
                 /// Generate IR for translation unit
                 RefPtr<IRModule> irModule(generateIRForTranslationUnit(translationUnit));
 
-                // Write IR out to serialData - copying over SourceLoc information directly
+                // Write IR out to serialData - with SourceLoc information held in a compact table
+                IRSerialData serialData;
                 IRSerialWriter writer;
-                writer.write(irModule, sourceManager, IRSerialWriter::OptionFlag::RawSourceLocation, &serialData);
+                const IRSerialBinary::CompressionType compressionType = IRSerialBinary::CompressionType(serialIRCompressionType);
+                if (SLANG_FAILED(writer.write(irModule, sourceManager, IRSerialWriter::OptionFlag::SourceLocationTable, &serialData)) ||
+                    SLANG_FAILED(IRSerialWriter::writeStream(serialData, compressionType, &memoryStream)))
+                {
+                    mSink.diagnose(SourceLoc(), Diagnostics::serialIRRoundTripFailed, "unable to write module");
+                    continue;
+                }
+
+                // Check the container is the same when its chunks are written on a single thread and on as many
+                // threads as possible (whatever the size of the module and the hardware)
+                if (shouldVerifySerialIRThreading)
+                {
+                    MemoryStream serialStream, parallelStream;
+                    if (SLANG_FAILED(IRSerialWriter::writeStream(serialData, compressionType, &serialStream, 1)) ||
+                        SLANG_FAILED(IRSerialWriter::writeStream(serialData, compressionType, &parallelStream, IRSerialWriter::kMaxWriteThreadCount)) ||
+                        serialStream.getContentsSize() != memoryStream.getContentsSize() ||
+                        parallelStream.getContentsSize() != memoryStream.getContentsSize() ||
+                        ::memcmp(serialStream.getContents(), memoryStream.getContents(), memoryStream.getContentsSize()) != 0 ||
+                        ::memcmp(parallelStream.getContents(), memoryStream.getContents(), memoryStream.getContentsSize()) != 0)
+                    {
+                        mSink.diagnose(SourceLoc(), Diagnostics::serialIRRoundTripFailed, "container differs when written on multiple threads");
+                    }
+                }
             }
             RefPtr<IRModule> irReadModule;
             {
-                // Read IR back from serialData
-                IRSerialReader reader;
-                reader.read(serialData, mSession, irReadModule);
+                // Read IR back from the container. The uncompressed arrays are used in place, and function bodies
+                // are only created when linking first needs them (with any failure reported to the sink).
+                List<uint8_t> contents;
+                memoryStream.swapContents(contents);
+
+                RefPtr<IRSerialContainer> container(new IRSerialContainer);
+                if (SLANG_FAILED(container->init(contents)) ||
+                    SLANG_FAILED(IRSerialReader::readLazy(container, mSession, &mSink, irReadModule)))
+                {
+                    mSink.diagnose(SourceLoc(), Diagnostics::serialIRRoundTripFailed, "unable to read module");
+                    continue;
+                }
             }
 
             // Use the serialized irModule
@@ -1072,6 +1172,7 @@ Session::~Session()
     constExprRate = nullptr;
 
     destroyTypeCheckingCache();
+    destroyTypeLayoutCache();
 
     builtinTypes = decltype(builtinTypes)();
     // destroy modules next
@@ -1147,6 +1248,63 @@ SLANG_API ISlangSharedLibraryLoader* spSessionGetSharedLibraryLoader(
     return (s->sharedLibraryLoader == Slang::DefaultSharedLibraryLoader::getSingleton()) ? nullptr : s->sharedLibraryLoader.get();
 }
 
+SLANG_API void spSessionSetFileSystemCacheEnabled(
+    SlangSession*   session,
+    int             enable)
+{
+    auto s = SESSION(session);
+    if (!enable)
+    {
+        s->fileSystemCache = nullptr;
+    }
+    else if (!s->fileSystemCache)
+    {
+        s->fileSystemCache = new Slang::CacheFileSystem(Slang::DefaultFileSystem::getSingleton(), false, true);
+    }
+}
+
+SLANG_API void spSessionInvalidateFileSystemCache(
+    SlangSession*   session,
+    char const*     path)
+{
+    auto s = SESSION(session);
+    if (!s->fileSystemCache)
+    {
+        return;
+    }
+    if (path)
+    {
+        s->fileSystemCache->invalidate(path);
+    }
+    else
+    {
+        s->fileSystemCache->invalidateAll();
+    }
+}
+
+SLANG_API SlangResult spSessionGetFileSystemCacheStats(
+    SlangSession*               session,
+    SlangFileSystemCacheStats*  outStats)
+{
+    auto s = SESSION(session);
+    if (!s->fileSystemCache)
+    {
+        return SLANG_E_UNINITIALIZED;
+    }
+
+    const auto& stats = s->fileSystemCache->getStats();
+    outStats->bytesRead = stats.bytesRead;
+    outStats->loadFileHits = stats.loadFileHits;
+    outStats->loadFileMisses = stats.loadFileMisses;
+    outStats->pathTypeHits = stats.pathTypeHits;
+    outStats->pathTypeMisses = stats.pathTypeMisses;
+    outStats->canonicalPathHits = stats.canonicalPathHits;
+    outStats->canonicalPathMisses = stats.canonicalPathMisses;
+    outStats->revalidations = stats.revalidations;
+    outStats->invalidations = stats.invalidations;
+    return SLANG_OK;
+}
+
 SLANG_API SlangCompileRequest* spCreateCompileRequest(
     SlangSession* session)
 {
@@ -1175,16 +1333,16 @@ SLANG_API void spSetFileSystem(
     if(!request) return;
     auto req = REQ(request);
 
-    // Set the fileSystem
-    req->fileSystem = fileSystem;
-
     // Set up fileSystemExt appropriately
     if (fileSystem == nullptr)
     {
-        req->fileSystemExt = new Slang::CacheFileSystem(Slang::DefaultFileSystem::getSingleton());
+        req->setDefaultFileSystem();
     }
     else
     {
+        // Set the fileSystem
+        req->fileSystem = fileSystem;
+
         // See if we have the interface 
         fileSystem->queryInterface(IID_ISlangFileSystemExt, (void**)req->fileSystemExt.writeRef()); 
 
@@ -1198,6 +1356,24 @@ SLANG_API void spSetFileSystem(
 }
 
 
+SLANG_API SlangResult spCreateArchiveFromDirectory(
+    char const*     directoryPath,
+    char const*     archivePath)
+{
+    return Slang::ArchiveFileSystem::writeArchive(directoryPath, archivePath);
+}
+
+SLANG_API SlangResult spLoadArchiveFileSystem(
+    char const*             archivePath,
+    ISlangFileSystemExt**   outFileSystem)
+{
+    Slang::RefPtr<Slang::ArchiveFileSystem> fileSystem;
+    SLANG_RETURN_ON_FAIL(Slang::ArchiveFileSystem::create(archivePath, Slang::String(), nullptr, fileSystem));
+    fileSystem->addRef();
+    *outFileSystem = fileSystem;
+    return SLANG_OK;
+}
+
 SLANG_API void spSetCompileFlags(
     SlangCompileRequest*    request,
     SlangCompileFlags       flags)
@@ -1718,4 +1894,32 @@ SLANG_API SlangReflection* spGetReflection(
     return (SlangReflection*) targetReq->layout.Ptr();
 }
 
+SLANG_API SlangResult spGetFlatReflectionBlob(
+    SlangCompileRequest*    request,
+    int                     targetIndex,
+    ISlangBlob**            outBlob)
+{
+    if(!request) return SLANG_ERROR_INVALID_PARAMETER;
+    if(!outBlob) return SLANG_ERROR_INVALID_PARAMETER;
+
+    auto req = REQ(request);
+
+    int targetCount = (int) req->targets.Count();
+    if((targetIndex < 0) || (targetIndex >= targetCount))
+    {
+        return SLANG_ERROR_INVALID_PARAMETER;
+    }
+    auto programLayout = req->targets[targetIndex]->layout.Ptr();
+    if(!programLayout)
+    {
+        return SLANG_FAIL;
+    }
+
+    Slang::List<uint8_t> data;
+    SLANG_RETURN_ON_FAIL(Slang::writeFlatReflection(programLayout, data));
+
+    *outBlob = Slang::createRawBlob(data.Buffer(), data.Count()).detach();
+    return SLANG_OK;
+}
+
 // ... rest of reflection API implementation is in `Reflection.cpp`
@@ -3,8 +3,20 @@
 
 #include "compiler.h"
 
+#include "../core/slang-cpu-defines.h"
 #include "../core/slang-string-util.h"
 
+#if SLANG_PROCESSOR_FAMILY_X86 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#   define SLANG_SOURCE_LOC_SIMD_SSE2 1
+#   include <emmintrin.h>
+#else
+#   define SLANG_SOURCE_LOC_SIMD_SSE2 0
+#endif
+
+#if SLANG_VC
+#   include <intrin.h>
+#endif
+
 namespace Slang {
 
 /* !!!!!!!!!!!!!!!!!!!!!!!!! SourceView !!!!!!!!!!!!!!!!!!!!!!!!!!!! */
@@ -181,6 +193,47 @@ PathInfo SourceView::getPathInfo(SourceLoc loc, SourceLocType type)
 
 /* !!!!!!!!!!!!!!!!!!!!!!! SourceFile !!!!!!!!!!!!!!!!!!!!!!!!!!!! */
 
+// Returns the index of the lowest set bit. mask must be non zero.
+static SLANG_FORCE_INLINE int _calcLowestSetBit(uint32_t mask)
+{
+    SLANG_ASSERT(mask);
+#if SLANG_VC
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return int(index);
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int index = 0;
+    while ((mask & 1) == 0)
+    {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+// Handles the line break at cursor, returning the cursor after the line break
+static SLANG_FORCE_INLINE const char* _handleLineBreak(const char* cursor, const char* end)
+{
+    const int c = *cursor++;
+    SLANG_ASSERT(c == '\r' || c == '\n');
+
+    // When we see a line-break character we need
+    // to record the line break, but we also need
+    // to deal with the annoying issue of encodings,
+    // where a multi-byte sequence might encode
+    // the line break.
+    if (cursor != end)
+    {
+        const int d = *cursor;
+        if ((c ^ d) == ('\r' ^ '\n'))
+            cursor++;
+    }
+    return cursor;
+}
+
 const List<uint32_t>& SourceFile::getLineBreakOffsets()
 {
     // We now have a raw input file that we can search for line breaks.
@@ -196,28 +249,37 @@ const List<uint32_t>& SourceFile::getLineBreakOffsets()
         // Treat the beginning of the file as a line break
         m_lineBreakOffsets.Add(0);
 
+#if SLANG_SOURCE_LOC_SIMD_SSE2
+        // Most bytes are not line breaks, so test 16 bytes at a time, and only
+        // look at individual bytes when a block contains a '\r' or '\n'.
+        const __m128i crs = _mm_set1_epi8('\r');
+        const __m128i lfs = _mm_set1_epi8('\n');
+        while (end - cursor >= 16)
+        {
+            const __m128i chars = _mm_loadu_si128((const __m128i*)cursor);
+            const uint32_t mask = uint32_t(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chars, crs), _mm_cmpeq_epi8(chars, lfs))));
+            if (mask == 0)
+            {
+                cursor += 16;
+                continue;
+            }
+
+            cursor = _handleLineBreak(cursor + _calcLowestSetBit(mask), end);
+            m_lineBreakOffsets.Add(uint32_t(cursor - begin));
+        }
+#endif
+
         while (cursor != end)
         {
-            int c = *cursor++;
-            switch (c)
+            const char c = *cursor;
+            if (c == '\r' || c == '\n')
             {
-                case '\r': case '\n':
-                {
-                    // When we see a line-break character we need
-                    // to record the line break, but we also need
-                    // to deal with the annoying issue of encodings,
-                    // where a multi-byte sequence might encode
-                    // the line break.
-
-                    int d = *cursor;
-                    if ((c^d) == ('\r' ^ '\n'))
-                        cursor++;
-
-                    m_lineBreakOffsets.Add(uint32_t(cursor - begin));
-                    break;
-                }
-                default:
-                    break;
+                cursor = _handleLineBreak(cursor, end);
+                m_lineBreakOffsets.Add(uint32_t(cursor - begin));
+            }
+            else
+            {
+                cursor++;
             }
         }
 
@@ -236,12 +298,33 @@ int SourceFile::calcLineIndexFromOffset(int offset)
 
     // Make sure we have the line break offsets
     const auto& lineBreakOffsets = getLineBreakOffsets();
+    const int lineCount = int(lineBreakOffsets.Count());
+
+    // Lookups are mostly in increasing order, so first check if the offset is on the
+    // same line as the last lookup, or the line after it.
+    {
+        int lineIndex = m_lastLineIndex;
+        SLANG_ASSERT(lineIndex < lineCount);
+        if (lineBreakOffsets[lineIndex] <= uint32_t(offset))
+        {
+            if (lineIndex + 1 >= lineCount || uint32_t(offset) < lineBreakOffsets[lineIndex + 1])
+            {
+                return lineIndex;
+            }
+            lineIndex++;
+            if (lineIndex + 1 >= lineCount || uint32_t(offset) < lineBreakOffsets[lineIndex + 1])
+            {
+                m_lastLineIndex = lineIndex;
+                return lineIndex;
+            }
+        }
+    }
 
     // At this point we can assume the `lineBreakOffsets` array has been filled in.
     // We will use a binary search to find the line index that contains our
     // chosen offset.
     int lo = 0;
-    int hi = int(lineBreakOffsets.Count());
+    int hi = lineCount;
 
     while (lo + 1 < hi)
     {
@@ -257,6 +340,7 @@ int SourceFile::calcLineIndexFromOffset(int offset)
         }
     }
 
+    m_lastLineIndex = lo;
     return lo;
 }
 
@@ -315,6 +399,13 @@ SourceFile* SourceManager::createSourceFile(const PathInfo& pathInfo, ISlangBlob
     UInt contentSize = contentBlob->getBufferSize();
     char const* contentEnd = contentBegin + contentSize;
 
+    // Skip a UTF-8 byte order mark, which a blob that holds the raw file
+    // contents (such as a `MappedFileBlob`) will still have
+    if (contentSize >= 3 && (unsigned char)contentBegin[0] == 0xEF && (unsigned char)contentBegin[1] == 0xBB && (unsigned char)contentBegin[2] == 0xBF)
+    {
+        contentBegin += 3;
+    }
+
     SourceFile* sourceFile = new SourceFile();
     sourceFile->pathInfo = pathInfo;
     sourceFile->contentBlob = contentBlob;
@@ -395,6 +486,13 @@ SourceView* SourceManager::findSourceView(SourceLoc loc) const
 
 SourceView* SourceManager::findSourceViewRecursively(SourceLoc loc) const
 {
+    // Check the last hit first
+    SourceView* lastView = m_lastSourceView;
+    if (lastView && lastView->getRange().contains(loc))
+    {
+        return lastView;
+    }
+
     // Start with this manager
     const SourceManager* manager = this;
     do 
@@ -403,6 +501,7 @@ SourceView* SourceManager::findSourceViewRecursively(SourceLoc loc) const
         // If we found a hit we are done
         if (sourceView)
         {
+            m_lastSourceView = sourceView;
             return sourceView;
         }
         // Try the parent
@@ -453,6 +552,21 @@ HumaneSourceLoc SourceManager::getHumaneLoc(SourceLoc loc, SourceLocType type)
     }
 }
 
+void SourceManager::getHumaneLocs(const SourceLoc* locs, UInt count, HumaneSourceLoc* outLocs, SourceLocType type)
+{
+    SourceView* sourceView = nullptr;
+    for (UInt i = 0; i < count; ++i)
+    {
+        const SourceLoc loc = locs[i];
+        // Only search for the view if the location isn't in the view of the previous location
+        if (!sourceView || !sourceView->getRange().contains(loc))
+        {
+            sourceView = findSourceViewRecursively(loc);
+        }
+        outLocs[i] = sourceView ? sourceView->getHumaneLoc(loc, type) : HumaneSourceLoc();
+    }
+}
+
 PathInfo SourceManager::getPathInfo(SourceLoc loc, SourceLocType type)
 {
     SourceView* sourceView = findSourceViewRecursively(loc);
@@ -150,6 +150,8 @@ public:
     const List<uint32_t>& getLineBreakOffsets();
 
         /// Calculate the line based on the offset 
+        /// Lookups are typically made in increasing order (for example when emitting #line directives), so the
+        /// line of the previous lookup is checked before falling back to a binary search.
     int calcLineIndexFromOffset(int offset);
 
         /// Calculate the offset for a line
@@ -164,6 +166,9 @@ public:
     // we will cache the starting offset of each line break in
     // the input file:
     List<uint32_t> m_lineBreakOffsets;
+
+    // The line index found by the last call to calcLineIndexFromOffset
+    int m_lastLineIndex = 0;
 };
 
 enum class SourceLocType
@@ -233,6 +238,10 @@ class SourceView: public RefObject
         /// Type determines if the location wanted is the original, or the 'normal' (which modifys behavior based on #line directives)
     HumaneSourceLoc getHumaneLoc(SourceLoc loc, SourceLocType type = SourceLocType::Nominal);
 
+        /// Get the humane source locations for an array of locations. Results are written to outLocs, which must hold count entries.
+        /// Most efficient when the locations are sorted, as consecutive locations in the same view share the view lookup.
+    void getHumaneLocs(const SourceLoc* locs, UInt count, HumaneSourceLoc* outLocs, SourceLocType type = SourceLocType::Nominal);
+
         /// Get the path associated with a location
     PathInfo getPathInfo(SourceLoc loc, SourceLocType type = SourceLocType::Nominal);
 
@@ -269,6 +278,10 @@ struct SourceManager
         /// Get the humane source location
     HumaneSourceLoc getHumaneLoc(SourceLoc loc, SourceLocType type = SourceLocType::Nominal);
 
+        /// Get the humane source locations for an array of locations. Results are written to outLocs, which must hold count entries.
+        /// Most efficient when the locations are sorted, as consecutive locations in the same view share the view lookup.
+    void getHumaneLocs(const SourceLoc* locs, UInt count, HumaneSourceLoc* outLocs, SourceLocType type = SourceLocType::Nominal);
+
         /// Get the path associated with a location 
     PathInfo getPathInfo(SourceLoc loc, SourceLocType type = SourceLocType::Nominal);
 
@@ -320,6 +333,10 @@ struct SourceManager
     List<RefPtr<SourceView> > m_sourceViews;                
     StringSlicePool m_slicePool;
 
+    // The view found by the last findSourceViewRecursively. Lookups tend to be clustered, so this is checked first.
+    // Views are never removed, and a parent manager outlives this one, so the pointer stays valid.
+    mutable SourceView* m_lastSourceView = nullptr;
+
     // Maps canonical paths to source files
     Dictionary<String, RefPtr<SourceFile> > m_sourceFiles;  
 };
@@ -660,6 +660,7 @@ LayoutRulesFamilyImpl* getDefaultLayoutRulesFamilyForTarget(TargetRequest* targe
     case CodeGenTarget::DXBytecodeAssembly:
     case CodeGenTarget::DXIL:
     case CodeGenTarget::DXILAssembly:
+    case CodeGenTarget::CPPSource:
         return &kHLSLLayoutRulesFamilyImpl;
 
     case CodeGenTarget::GLSL:
@@ -809,6 +810,7 @@ static bool isD3DTarget(TargetRequest* targetReq)
     case CodeGenTarget::DXBytecodeAssembly:
     case CodeGenTarget::DXIL:
     case CodeGenTarget::DXILAssembly:
+    case CodeGenTarget::CPPSource:
         return true;
 
     default:
@@ -1382,6 +1384,51 @@ int findGenericParam(List<RefPtr<GenericParamLayout>> & genericParameters, Globa
     return (int)genericParameters.FindFirst([=](RefPtr<GenericParamLayout> & x) {return x->decl.Ptr() == decl; });
 }
 
+Name* getReflectionName(VarDeclBase* varDecl)
+{
+    if (auto reflectionNameMod = varDecl->FindModifier<ParameterGroupReflectionName>())
+        return reflectionNameMod->nameAndLoc.name;
+
+    return varDecl->getName();
+}
+
+Int StructTypeLayout::findFieldIndexByName(String const& name)
+{
+    // Index any fields added since the last lookup. When names
+    // are repeated, the first field with the name is kept, as
+    // it would be found by a search in order.
+    Int fieldCount = Int(fields.Count());
+    for (Int ii = mapNameToFieldIndexCount; ii < fieldCount; ++ii)
+    {
+        auto varDecl = fields[ii]->varDecl.getDecl();
+        if (!varDecl)
+            continue;
+        if (auto fieldName = getReflectionName(varDecl))
+            mapNameToFieldIndex.AddIfNotExists(getText(fieldName), ii);
+    }
+    mapNameToFieldIndexCount = fieldCount;
+
+    Int index = -1;
+    mapNameToFieldIndex.TryGetValue(name, index);
+    return index;
+}
+
+EntryPointLayout* ProgramLayout::findEntryPointByName(String const& name)
+{
+    Int entryPointCount = Int(entryPoints.Count());
+    for (Int ii = mapNameToEntryPointIndexCount; ii < entryPointCount; ++ii)
+    {
+        if (auto entryPointName = entryPoints[ii]->entryPoint->getName())
+            mapNameToEntryPointIndex.AddIfNotExists(getText(entryPointName), ii);
+    }
+    mapNameToEntryPointIndexCount = entryPointCount;
+
+    Int index = -1;
+    if (!mapNameToEntryPointIndex.TryGetValue(name, index))
+        return nullptr;
+    return entryPoints[index];
+}
+
 // When constructing a new var layout from an existing one,
 // copy fields to the new var from the old.
 void copyVarLayoutFields(
@@ -2035,12 +2082,169 @@ RefPtr<TypeLayout> createTypeLayout(
     return typeLayout;
 }
 
+// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! TypeLayoutCache !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+// Identifies everything that a layout created by `CreateTypeLayout` depends on.
+// Layout rules objects are unique to their family, so targets that use the same
+// rules (e.g. HLSL and DXIL) produce the same keys.
+struct TypeLayoutCacheKey
+{
+    RefPtr<Type>        type;
+    LayoutRulesImpl*    rules;
+    MatrixLayoutMode    matrixLayoutMode;
+    MatrixLayoutMode    targetMatrixLayoutMode;
+    bool                allocateRegisterSpaceForParameterBlock;
+
+    bool operator==(const TypeLayoutCacheKey& rhs) const
+    {
+        return rules == rhs.rules &&
+            matrixLayoutMode == rhs.matrixLayoutMode &&
+            targetMatrixLayoutMode == rhs.targetMatrixLayoutMode &&
+            allocateRegisterSpaceForParameterBlock == rhs.allocateRegisterSpaceForParameterBlock &&
+            type->Equals(rhs.type);
+    }
+    int GetHashCode() const
+    {
+        int hash = combineHash(type->GetHashCode(), Slang::GetHashCode(rules));
+        hash = combineHash(hash, int(matrixLayoutMode) | (int(targetMatrixLayoutMode) << 8) | (int(allocateRegisterSpaceForParameterBlock) << 16));
+        return hash;
+    }
+};
+
+struct TypeLayoutCache
+{
+    Dictionary<TypeLayoutCacheKey, RefPtr<TypeLayout>> layouts;
+};
+
+TypeLayoutCache* Session::getTypeLayoutCache()
+{
+    if (!typeLayoutCache)
+        typeLayoutCache = new TypeLayoutCache();
+    return typeLayoutCache;
+}
+
+void Session::destroyTypeLayoutCache()
+{
+    delete typeLayoutCache;
+    typeLayoutCache = nullptr;
+}
+
+TypeLayoutCache* CompileRequest::getTypeLayoutCache()
+{
+    if (!typeLayoutCache)
+        typeLayoutCache = new TypeLayoutCache();
+    return typeLayoutCache;
+}
+
+void CompileRequest::destroyTypeLayoutCache()
+{
+    delete typeLayoutCache;
+    typeLayoutCache = nullptr;
+}
+
+static bool isBuiltinModule(Session* session, ModuleDecl* moduleDecl)
+{
+    for (auto& loadedModule : session->loadedModuleCode)
+    {
+        if (loadedModule.Ptr() == moduleDecl)
+            return true;
+    }
+    return false;
+}
+
+static bool isBuiltinDecl(Session* session, Decl* decl)
+{
+    while (decl && !decl->As<ModuleDecl>())
+        decl = decl->ParentDecl;
+    return decl && isBuiltinModule(session, decl->As<ModuleDecl>());
+}
+
+// Is the layout of `type` only dependent on declarations in the builtin
+// modules, which live as long as the session does. Layouts of other types
+// reference declarations owned by a compile request, so can't outlive it.
+static bool isBuiltinType(Session* session, Type* type)
+{
+    if (auto arrayType = type->As<ArrayExpressionType>())
+    {
+        if (arrayType->ArrayLength && !arrayType->ArrayLength.As<ConstantIntVal>())
+            return false;
+        return isBuiltinType(session, arrayType->baseType);
+    }
+    else if (auto declRefType = type->As<DeclRefType>())
+    {
+        if (!isBuiltinDecl(session, declRefType->declRef.getDecl()))
+            return false;
+
+        for (auto subst = declRefType->declRef.substitutions.substitutions; subst; subst = subst->outer)
+        {
+            auto genericSubst = subst.As<GenericSubstitution>();
+            if (!genericSubst || !isBuiltinDecl(session, genericSubst->genericDecl))
+                return false;
+
+            for (auto arg : genericSubst->args)
+            {
+                if (auto argType = arg.As<Type>())
+                {
+                    if (!isBuiltinType(session, argType))
+                        return false;
+                }
+                else if (!arg.As<ConstantIntVal>())
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+// Find the cache that a layout of `type` can be held in, or nullptr if it can't be cached
+static TypeLayoutCache* findTypeLayoutCache(TypeLayoutContext const& context, Type* type)
+{
+    auto targetReq = context.targetReq;
+    if (!targetReq || !context.rules)
+        return nullptr;
+
+    // The layout holds the type it was created for, so only canonical types are
+    // cached. Otherwise a layout for an alias could be returned for the aliased type.
+    if (type->GetCanonicalType() != type)
+        return nullptr;
+
+    auto compileRequest = targetReq->compileRequest;
+    auto session = compileRequest->mSession;
+    return isBuiltinType(session, type) ? session->getTypeLayoutCache() : compileRequest->getTypeLayoutCache();
+}
+
 RefPtr<TypeLayout> CreateTypeLayout(
     TypeLayoutContext const&    context,
     Type*                       type)
 {
+    // Layouts only depend on the type, the rules and a few target options, so are
+    // shared between targets (and requests) with the same inputs. Layouts are
+    // never modified once created, so the same object can be returned each time.
+    TypeLayoutCache* cache = findTypeLayoutCache(context, type);
+    TypeLayoutCacheKey key;
+    if (cache)
+    {
+        key.type = type;
+        key.rules = context.rules;
+        key.matrixLayoutMode = context.matrixLayoutMode;
+        key.targetMatrixLayoutMode = context.targetReq->getDefaultMatrixLayoutMode();
+        key.allocateRegisterSpaceForParameterBlock = shouldAllocateRegisterSpaceForParameterBlock(context);
+
+        RefPtr<TypeLayout> cachedTypeLayout;
+        if (cache->layouts.TryGetValue(key, cachedTypeLayout))
+            return cachedTypeLayout;
+    }
+
     RefPtr<TypeLayout> typeLayout;
     GetLayoutImpl(context, type, &typeLayout);
+
+    if (cache && typeLayout)
+    {
+        cache->layouts.Add(key, typeLayout);
+    }
     return typeLayout;
 }
 
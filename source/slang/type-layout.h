@@ -387,6 +387,18 @@ public:
     // in the array above, rather than to the actual pointer,
     // so that we 
     Dictionary<Decl*, RefPtr<VarLayout>> mapVarToLayout;
+
+    // Map from the reflected name of a field to its index in `fields`.
+    //
+    // This is built on the first lookup, and only covers the first
+    // `mapNameToFieldIndexCount` fields, so that any fields added
+    // after a lookup get indexed by the next one.
+    Dictionary<String, Int> mapNameToFieldIndex;
+    Int mapNameToFieldIndexCount = 0;
+
+    // Find the index in `fields` of the first field with the given
+    // name, or -1 if there is no such field.
+    Int findFieldIndexByName(String const& name);
 };
 
 class GenericParamTypeLayout : public TypeLayout
@@ -455,6 +467,14 @@ public:
     // will (eventually) belong there...
     List<RefPtr<EntryPointLayout>> entryPoints;
 
+    // Map from entry point name to its index in `entryPoints`,
+    // built on the first lookup (as for `StructTypeLayout` fields)
+    Dictionary<String, Int> mapNameToEntryPointIndex;
+    Int mapNameToEntryPointIndexCount = 0;
+
+    // Find the first entry point with the given name, or null if there is none
+    EntryPointLayout* findEntryPointByName(String const& name);
+
     List<RefPtr<GenericParamLayout>> globalGenericParams;
     Dictionary<String, GenericParamLayout*> globalGenericParamsMap;
 
@@ -700,6 +720,10 @@ createStructuredBufferTypeLayout(
     RefPtr<Type>                elementType);
 
 int findGenericParam(List<RefPtr<GenericParamLayout>> & genericParameters, GlobalGenericParamDecl * decl);
+
+// Get the name a variable is reflected with, which for
+// parameter groups may differ from the declared name.
+Name* getReflectionName(VarDeclBase* varDecl);
 //
 
 }
@@ -7,6 +7,43 @@
 #include "ir.h"
 
 #include "../../slang.h"
+#include "../core/slang-cpu-defines.h"
+#include "../core/slang-memory-arena.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#if SLANG_PROCESSOR_FAMILY_X86
+#   ifdef _MSC_VER
+#       include <intrin.h>
+#   else
+#       include <x86intrin.h>
+#   endif
+#endif
+
+// Lane-wise arithmetic for threads that run multiple lanes
+// uses SIMD instructions where the target supports them, and
+// falls back to scalar loops otherwise.
+#if SLANG_PROCESSOR_FAMILY_X86 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#   define SLANG_VM_SIMD_SSE2 1
+#   include <emmintrin.h>
+#else
+#   define SLANG_VM_SIMD_SSE2 0
+#endif
+
+#if SLANG_VM_SIMD_SSE2 && defined(__AVX__)
+#   define SLANG_VM_SIMD_AVX 1
+#   include <immintrin.h>
+#else
+#   define SLANG_VM_SIMD_AVX 0
+#endif
+
+#if SLANG_VM_SIMD_AVX && defined(__AVX2__)
+#   define SLANG_VM_SIMD_AVX2 1
+#else
+#   define SLANG_VM_SIMD_AVX2 0
+#endif
 
 namespace Slang
 {
@@ -55,7 +92,8 @@ struct VMReg
     // Type that the register is meant to hold
     VMType  type;
 
-    // offset of the variable inside the frame
+    // offset of the variable inside the register
+    // storage of a frame, for a single lane (see `VMFrame`)
     size_t  offset;
 };
 
@@ -66,6 +104,25 @@ struct VMConst
 
     // Operand address to use
     void*   ptr;
+
+    // If the constant is a `groupshared` variable, its
+    // index in the group-shared variables of the module,
+    // and -1 otherwise
+    Int     groupSharedIndex;
+};
+
+// Operations that the VM implements directly, for functions
+// that are declared without a body (e.g., in the standard library)
+enum VMIntrinsic
+{
+    kVMIntrinsic_None,
+
+    // A memory barrier without a group sync. All lanes of a
+    // thread group run on the same host thread, so this is a no-op.
+    kVMIntrinsic_MemoryBarrier,
+
+    // A barrier that waits for every thread in the group
+    kVMIntrinsic_GroupSync,
 };
 
 struct VMModule;
@@ -81,9 +138,97 @@ struct VMFunc
     VMReg*      regs;
     VMConst*    consts;
 
-    size_t      frameSize;
+    // Size of the register storage needed for one lane
+    size_t      laneRegsSize;
+
+    // The operation to perform if the function has no body
+    VMIntrinsic intrinsic;
+};
+
+// A call instruction, identified by its offset in the code
+// of the calling function
+struct VMCallSite
+{
+    VMFunc* caller;
+    UInt    offset;
+
+    int GetHashCode() const
+    {
+        return combineHash(Slang::GetHashCode(caller), Slang::GetHashCode(offset));
+    }
+
+    bool operator==(VMCallSite const& other) const
+    {
+        return caller == other.caller && offset == other.offset;
+    }
+};
+
+// A set of lanes in a multi-lane thread, with one bit per lane.
+typedef uint64_t VMLaneMask;
+
+// The maximum number of lanes that a single thread can run in lockstep.
+static const UInt kVMMaxLaneCount = sizeof(VMLaneMask) * 8;
+
+VMLaneMask getAllLanesMask(UInt laneCount)
+{
+    if (laneCount >= kVMMaxLaneCount)
+        return ~VMLaneMask(0);
+    return (VMLaneMask(1) << laneCount) - 1;
+}
+
+UInt getFirstLane(VMLaneMask mask)
+{
+    assert(mask);
+#if defined(__GNUC__) || defined(__clang__)
+    return UInt(__builtin_ctzll(mask));
+#else
+    UInt lane = 0;
+    while (!(mask & 1))
+    {
+        mask >>= 1;
+        lane++;
+    }
+    return lane;
+#endif
+}
+
+// Allows iterating over the lanes in a mask with a range-based `for`
+struct VMLanes
+{
+    struct Iterator
+    {
+        VMLaneMask mask;
+
+        UInt operator*() const { return getFirstLane(mask); }
+        void operator++() { mask &= mask - 1; }
+        bool operator!=(Iterator const& other) const { return mask != other.mask; }
+    };
+
+    VMLaneMask mask;
+
+    Iterator begin() const { Iterator it = { mask }; return it; }
+    Iterator end() const { Iterator it = { 0 }; return it; }
 };
 
+VMLanes getLanes(VMLaneMask mask)
+{
+    VMLanes lanes = { mask };
+    return lanes;
+}
+
+// A call frame on the stack of a thread.
+//
+// A thread may run several invocations ("lanes") of the same
+// code in lockstep. Each register in the frame then holds one
+// value per lane, stored as structure-of-arrays: register `r`
+// for lane `l` lives at `regs + r.offset*laneCount + l*r.size`,
+// so that lane-wise operations touch contiguous memory.
+//
+// Lanes that branch in different directions are tracked with
+// masks: `activeMask` is the lanes currently executing at `ip`,
+// and any other lane in `liveMask` is waiting to run the block
+// recorded for it in `laneBlocks`.
+//
 struct VMFrame
 {
     // The function from which this frame was spawned
@@ -96,7 +241,38 @@ struct VMFrame
     // The instruction pointer within this frame
     BCOp*   ip;
 
-    // Registers are stored after this point.
+    // The number of lanes this frame holds state for
+    UInt        laneCount;
+
+    // The lanes executing the code at `ip`
+    VMLaneMask  activeMask;
+
+    // The lanes that entered this call and haven't returned yet
+    VMLaneMask  liveMask;
+
+    // For each lane, the index of the block it will run next
+    // (only meaningful for lanes that are live but not active)
+    uint32_t*   laneBlocks;
+
+    // Storage for the registers of all lanes
+    char*       regs;
+
+    // Where a returned value should be written in the caller's
+    // frame (lane `l` at `resultPtr + l*resultStride`), or null
+    // if the caller doesn't use the result.
+    char*       resultPtr;
+    UInt        resultStride;
+
+    // Pointers to the storage for the `groupshared` variables
+    // of the module, for the thread group the frame runs in,
+    // or null to use the storage owned by the module.
+    void**      groupSharedPtrs;
+
+    // When profiling: the instruction that called this frame
+    // (with a null function for the outermost call), and the
+    // cycle count of the thread when the call began.
+    VMCallSite  callSite;
+    UInt64      profileStartCycles;
 };
 
 struct VM;
@@ -107,6 +283,16 @@ struct VMModule
     VM*         vm;
     void**      symbols;
     VMType*     types;
+
+    // For each symbol, its index among the `groupshared`
+    // variables of the module, or -1
+    Int*        symbolGroupSharedIndices;
+
+    // Offset of each `groupshared` variable in the
+    // memory for a thread group
+    size_t*     groupSharedOffsets;
+    UInt        groupSharedCount;
+    size_t      groupSharedSize;
 };
 
 UInt decodeUInt(BCOp** ioPtr)
@@ -151,16 +337,34 @@ Int decodeSInt(BCOp** ioPtr)
     }
 }
 
-void* getRegPtrImpl(VMFrame* frame, UInt id)
+// An operand decoded for use by all lanes of a frame.
+//
+// The value for lane `l` is at `ptr + l*stride`. Registers
+// hold one value per lane, while constants and global symbols
+// are shared by every lane and so use a stride of zero.
+struct VMOperand
+{
+    char*   ptr;
+    UInt    stride;
+
+    void* getLanePtr(UInt lane) const { return ptr + lane*stride; }
+
+    template<typename T>
+    T& get(UInt lane) const { return *(T*)(ptr + lane*stride); }
+};
+
+VMOperand getRegOperandImpl(VMFrame* frame, UInt id)
 {
     VMFunc* vmFunc = frame->func;
     VMReg* vmReg = &vmFunc->regs[id];
-    size_t offset = vmReg->offset;
 
-    return (void*)((char*)frame + offset);
+    VMOperand operand;
+    operand.ptr = frame->regs + vmReg->offset * frame->laneCount;
+    operand.stride = vmReg->type.getSize();
+    return operand;
 }
 
-void* getOperandPtrImpl(VMFrame* frame, Int id)
+VMOperand getOperandImpl(VMFrame* frame, Int id)
 {
     if( id >= 0 )
     {
@@ -168,7 +372,7 @@ void* getOperandPtrImpl(VMFrame* frame, Int id)
         // of the current call frame, and should
         // be used to index into a table of such values.
 
-        return getRegPtrImpl(frame, id);
+        return getRegOperandImpl(frame, id);
     }
     else
     {
@@ -179,7 +383,18 @@ void* getOperandPtrImpl(VMFrame* frame, Int id)
 
         VMFunc* vmFunc = frame->func;
         VMConst* vmConst = &vmFunc->consts[~id];
-        return vmConst->ptr;
+
+        VMOperand operand;
+        operand.ptr = (char*) vmConst->ptr;
+        operand.stride = 0;
+
+        // A `groupshared` variable lives in memory that
+        // belongs to the current thread group.
+        if( vmConst->groupSharedIndex >= 0 && frame->groupSharedPtrs )
+        {
+            operand.ptr = (char*) &frame->groupSharedPtrs[vmConst->groupSharedIndex];
+        }
+        return operand;
     }
 }
 
@@ -194,40 +409,26 @@ VMType getOperandTypeImpl(VMFrame* frame, Int id)
         return frame->func->consts[~id].type;
     }
 }
-struct VMPtrAndType
+struct VMOperandAndType
 {
-    void*   ptr;
-    VMType  type;
+    VMOperand   operand;
+    VMType      type;
 };
 
-VMPtrAndType decodeOperandPtrAndType(VMFrame* frame, BCOp** ioIP)
+VMOperandAndType decodeOperandAndType(VMFrame* frame, BCOp** ioIP)
 {
     Int id = decodeSInt(ioIP);
 
-    VMPtrAndType ptrAndType;
-    ptrAndType.ptr = getOperandPtrImpl(frame, id);
-    ptrAndType.type = getOperandTypeImpl(frame, id);
-    return ptrAndType;
+    VMOperandAndType operandAndType;
+    operandAndType.operand = getOperandImpl(frame, id);
+    operandAndType.type = getOperandTypeImpl(frame, id);
+    return operandAndType;
 }
 
-void* decodeOperandPtrImpl(VMFrame* frame, BCOp** ioIP)
+VMOperand decodeOperand(VMFrame* frame, BCOp** ioIP)
 {
     Int id = decodeSInt(ioIP);
-    return getOperandPtrImpl(frame, id);
-}
-
-
-template<typename T>
-T* decodeOperandPtr(VMFrame* frame, BCOp** ioIP)
-{
-    return (T*)decodeOperandPtrImpl(frame, ioIP);
-}
-
-
-template<typename T>
-T& decodeOperand(VMFrame* frame, BCOp** ioIP)
-{
-    return *decodeOperandPtr<T>(frame, ioIP);
+    return getOperandImpl(frame, id);
 }
 
 VMType decodeType(VMFrame* frame, BCOp** ioIP)
@@ -294,6 +495,35 @@ VMType getGlobalType(
     return getType(vmModule, vmModule->bcModule->symbols[globalID]->typeID);
 }
 
+struct VMIntrinsicInfo
+{
+    char const* name;
+    VMIntrinsic intrinsic;
+};
+
+static const VMIntrinsicInfo kVMIntrinsics[] =
+{
+    { "AllMemoryBarrier",                   kVMIntrinsic_MemoryBarrier },
+    { "DeviceMemoryBarrier",                kVMIntrinsic_MemoryBarrier },
+    { "GroupMemoryBarrier",                 kVMIntrinsic_MemoryBarrier },
+    { "AllMemoryBarrierWithGroupSync",      kVMIntrinsic_GroupSync },
+    { "DeviceMemoryBarrierWithGroupSync",   kVMIntrinsic_GroupSync },
+    { "GroupMemoryBarrierWithGroupSync",    kVMIntrinsic_GroupSync },
+};
+
+VMIntrinsic findVMIntrinsic(char const* name)
+{
+    if( !name )
+        return kVMIntrinsic_None;
+
+    for( auto info : kVMIntrinsics )
+    {
+        if( strcmp(info.name, name) == 0 )
+            return info.intrinsic;
+    }
+    return kVMIntrinsic_None;
+}
+
 VMFunc* loadVMFunc(
     BCFunc*     bcFunc,
     VMModule*   vmModule)
@@ -312,8 +542,16 @@ VMFunc* loadVMFunc(
     vmFunc->bcFunc = bcFunc;
     vmFunc->regs = vmRegs;
     vmFunc->consts = vmConsts;
+    vmFunc->intrinsic = kVMIntrinsic_None;
+
+    if( bcFunc->blockCount == 0 )
+    {
+        // A function without a body might be one that
+        // the VM knows how to implement itself.
+        vmFunc->intrinsic = findVMIntrinsic(bcFunc->name);
+    }
 
-    UInt offset = sizeof(VMFrame);
+    UInt offset = 0;
     for( UInt rr = 0; rr < regCount; ++rr )
     {
         BCReg* bcReg = &bcFunc->regs[rr];
@@ -334,7 +572,7 @@ VMFunc* loadVMFunc(
         vmRegs[rr].type = vmType;
         vmRegs[rr].offset = regOffset;
     }
-    vmFunc->frameSize = offset;
+    vmFunc->laneRegsSize = offset;
 
     for( UInt cc = 0; cc < constCount; ++cc )
     {
@@ -346,6 +584,7 @@ VMFunc* loadVMFunc(
                 auto globalID = bcConst.id;
                 vmFunc->consts[cc].ptr = &vmModule->symbols[globalID];
                 vmFunc->consts[cc].type = getGlobalType(vmModule, globalID);
+                vmFunc->consts[cc].groupSharedIndex = vmModule->symbolGroupSharedIndices[globalID];
             }
             break;
 
@@ -359,6 +598,7 @@ VMFunc* loadVMFunc(
                 fprintf(stderr, "BC [%p] : %d\n", &constInfo->ptr, (int)constInfo->ptr.rawVal);
             #endif
                 vmFunc->consts[cc].type = getType(vmModule, constInfo->typeID);
+                vmFunc->consts[cc].groupSharedIndex = -1;
             }
             break;
         }
@@ -369,14 +609,161 @@ VMFunc* loadVMFunc(
     return vmFunc;
 }
 
-VMFrame* createFrame(VMFunc* vmFunc)
+// Alignment used for the register storage of a frame, which
+// is enough for any register type as well as SIMD loads.
+static const size_t kVMFrameRegsAlignment = 16;
+
+// Call frames are created and destroyed in LIFO order, so each
+// thread allocates them from its own stack, rather than from
+// the heap. The stack is made of chunks that are never moved,
+// so that pointers into a frame stay valid.
+
+struct VMStackChunk
+{
+    // The chunk below this one, and the top of the stack
+    // in it from before this chunk was started
+    VMStackChunk*   prev;
+    char*           prevTop;
+
+    // The storage of the chunk
+    char*           begin;
+    char*           end;
+};
+
+struct VMStack
+{
+    // The chunk that holds the top of the stack, if any
+    VMStackChunk*   chunk;
+    char*           top;
+
+    // The last chunk to be emptied, which we hold on to so that
+    // a thread calling back and forth across the end of a chunk
+    // doesn't allocate every time
+    VMStackChunk*   spareChunk;
+};
+
+static const size_t kVMStackChunkSize = 64 * 1024;
+
+void initStack(VMStack* stack)
+{
+    stack->chunk = nullptr;
+    stack->top = nullptr;
+    stack->spareChunk = nullptr;
+}
+
+void destroyStack(VMStack* stack)
+{
+    VMStackChunk* chunk = stack->chunk;
+    while( chunk )
+    {
+        VMStackChunk* prev = chunk->prev;
+        free(chunk);
+        chunk = prev;
+    }
+    free(stack->spareChunk);
+    initStack(stack);
+}
+
+VMStackChunk* createStackChunk(size_t size)
+{
+    VMStackChunk* chunk = (VMStackChunk*) malloc(sizeof(VMStackChunk) + kVMFrameRegsAlignment + size);
+
+    size_t begin = (size_t)(chunk + 1);
+    begin = (begin + (kVMFrameRegsAlignment-1)) & ~(kVMFrameRegsAlignment-1);
+
+    chunk->prev = nullptr;
+    chunk->prevTop = nullptr;
+    chunk->begin = (char*) begin;
+    chunk->end = chunk->begin + size;
+    return chunk;
+}
+
+// Allocate `size` bytes on top of the stack, aligned
+// to `kVMFrameRegsAlignment`
+void* pushStack(VMStack* stack, size_t size)
+{
+    size = (size + (kVMFrameRegsAlignment-1)) & ~(kVMFrameRegsAlignment-1);
+
+    if( !stack->chunk || size > size_t(stack->chunk->end - stack->top) )
+    {
+        // We need to start a new chunk, and we try
+        // to re-use the spare one first.
+        VMStackChunk* chunk = stack->spareChunk;
+        stack->spareChunk = nullptr;
+        if( chunk && size > size_t(chunk->end - chunk->begin) )
+        {
+            free(chunk);
+            chunk = nullptr;
+        }
+        if( !chunk )
+        {
+            chunk = createStackChunk(Math::Max(size, kVMStackChunkSize));
+        }
+
+        chunk->prev = stack->chunk;
+        chunk->prevTop = stack->top;
+        stack->chunk = chunk;
+        stack->top = chunk->begin;
+    }
+
+    void* ptr = stack->top;
+    stack->top += size;
+    return ptr;
+}
+
+// Free the allocation at `ptr`, which must be the
+// last one on the stack that is still live.
+void popStack(VMStack* stack, void* ptr)
 {
-    VMFrame* vmFrame = (VMFrame*) malloc(vmFunc->frameSize);
+    VMStackChunk* chunk = stack->chunk;
+    assert((char*) ptr >= chunk->begin && (char*) ptr < stack->top);
+
+    if( (char*) ptr == chunk->begin && chunk->prev )
+    {
+        stack->chunk = chunk->prev;
+        stack->top = chunk->prevTop;
+
+        free(stack->spareChunk);
+        stack->spareChunk = chunk;
+    }
+    else
+    {
+        stack->top = (char*) ptr;
+    }
+}
+
+VMFrame* createFrame(VMStack* stack, VMFunc* vmFunc, UInt laneCount)
+{
+    // The frame header is followed by the per-lane block table,
+    // and then by the register storage for all the lanes.
+    size_t laneBlocksOffset = sizeof(VMFrame);
+    size_t regsOffset = laneBlocksOffset + laneCount * sizeof(uint32_t);
+    regsOffset = (regsOffset + (kVMFrameRegsAlignment-1)) & ~(kVMFrameRegsAlignment-1);
+    size_t frameSize = regsOffset + vmFunc->laneRegsSize * laneCount;
+
+    VMFrame* vmFrame = (VMFrame*) pushStack(stack, frameSize);
     vmFrame->func = vmFunc;
+    vmFrame->parent = nullptr;
     vmFrame->ip = vmFunc->bcFunc->blocks[0].code;
+    vmFrame->laneCount = laneCount;
+    vmFrame->activeMask = getAllLanesMask(laneCount);
+    vmFrame->liveMask = vmFrame->activeMask;
+    vmFrame->laneBlocks = (uint32_t*)((char*)vmFrame + laneBlocksOffset);
+    vmFrame->regs = (char*)vmFrame + regsOffset;
+    vmFrame->resultPtr = nullptr;
+    vmFrame->resultStride = 0;
+    vmFrame->groupSharedPtrs = nullptr;
+    vmFrame->callSite.caller = nullptr;
+    vmFrame->callSite.offset = 0;
+    vmFrame->profileStartCycles = 0;
     return vmFrame;
 }
 
+void destroyFrame(VMStack* stack, VMFrame* vmFrame)
+{
+    popStack(stack, vmFrame);
+}
+
 void dumpVMFrame(VMFrame* vmFrame)
 {
     fflush(stderr);
@@ -385,14 +772,20 @@ void dumpVMFrame(VMFrame* vmFrame)
     // state of all of its logical registers.
     // For now this is made easier by having
     // no overlapping register assignments...
+    //
+    // For a multi-lane frame we only dump the first
+    // active lane.
     VMFunc* vmFunc = vmFrame->func;
     BCFunc* bcFunc = vmFunc->bcFunc;
     UInt regCount = bcFunc->regCount;
+    UInt lane = getFirstLane(vmFrame->activeMask);
+
+    fprintf(stderr, "lane %u of %u\n", (unsigned int) lane, (unsigned int) vmFrame->laneCount);
 
     for (UInt rr = 0; rr < regCount; ++rr)
     {
         VMType regType = getOperandTypeImpl(vmFrame, rr);
-        void* regData = getRegPtrImpl(vmFrame, rr);
+        void* regData = getRegOperandImpl(vmFrame, rr).getLanePtr(lane);
 
         char const* name = bcFunc->regs[rr].name;
 
@@ -465,23 +858,203 @@ void dumpVMFrame(VMFrame* vmFrame)
     fflush(stderr);
 }
 
+// Profiling.
+//
+// When profiling is enabled, each VM thread counts the
+// instructions it runs and the cycles spent on them, broken
+// down by opcode and by function, along with the calls made
+// from each call site. Threads accumulate counters privately,
+// and merge them into the profile of the VM when they stop.
+
+// Read a timestamp for profiling. This is a CPU cycle count
+// where the target has one, and nanoseconds otherwise.
+UInt64 getVMProfileCycles()
+{
+#if SLANG_PROCESSOR_FAMILY_X86
+    return __rdtsc();
+#else
+    return (UInt64) std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+struct VMOpProfile
+{
+    UInt64  count;
+    UInt64  cycles;
+};
+
+struct VMFuncProfile
+{
+    VMFunc* func;
+
+    // The number of calls to the function
+    UInt64  callCount;
+
+    // The instructions executed in the body of the function,
+    // and the cycles spent on them (not counting callees)
+    UInt64  instCount;
+    UInt64  cycles;
+};
+
+struct VMCallSiteProfile
+{
+    VMCallSite  site;
+    VMFunc*     callee;
+
+    // The number of calls that returned, and the cycles
+    // spent in them (including callees)
+    UInt64      count;
+    UInt64      cycles;
+};
+
+struct VMProfile
+{
+    VMOpProfile                     ops[kIROpCount];
+
+    // Counters for functions and call sites are stored in
+    // lists, so that they can be referred to by index while
+    // new entries are being added.
+    List<VMFuncProfile>             funcs;
+    Dictionary<VMFunc*, UInt>       funcIndices;
+
+    List<VMCallSiteProfile>         callSites;
+    Dictionary<VMCallSite, UInt>    callSiteIndices;
+
+    VMProfile()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        memset(ops, 0, sizeof(ops));
+        funcs.Clear();
+        funcIndices.Clear();
+        callSites.Clear();
+        callSiteIndices.Clear();
+    }
+
+    UInt getFuncIndex(VMFunc* func)
+    {
+        UInt index = 0;
+        if( funcIndices.TryGetValue(func, index) )
+            return index;
+
+        VMFuncProfile funcProfile = {};
+        funcProfile.func = func;
+
+        index = funcs.Count();
+        funcs.Add(funcProfile);
+        funcIndices.Add(func, index);
+        return index;
+    }
+
+    UInt getCallSiteIndex(VMCallSite const& site, VMFunc* callee)
+    {
+        UInt index = 0;
+        if( callSiteIndices.TryGetValue(site, index) )
+            return index;
+
+        VMCallSiteProfile callSiteProfile = {};
+        callSiteProfile.site = site;
+        callSiteProfile.callee = callee;
+
+        index = callSites.Count();
+        callSites.Add(callSiteProfile);
+        callSiteIndices.Add(site, index);
+        return index;
+    }
+
+    // Add the counters from `other` into this profile
+    void add(VMProfile const& other)
+    {
+        for( UInt ii = 0; ii < kIROpCount; ++ii )
+        {
+            ops[ii].count += other.ops[ii].count;
+            ops[ii].cycles += other.ops[ii].cycles;
+        }
+
+        for( auto const& otherFunc : other.funcs )
+        {
+            VMFuncProfile& func = funcs[getFuncIndex(otherFunc.func)];
+            func.callCount += otherFunc.callCount;
+            func.instCount += otherFunc.instCount;
+            func.cycles += otherFunc.cycles;
+        }
+
+        for( auto const& otherCallSite : other.callSites )
+        {
+            VMCallSiteProfile& callSite = callSites[getCallSiteIndex(otherCallSite.site, otherCallSite.callee)];
+            callSite.count += otherCallSite.count;
+            callSite.cycles += otherCallSite.cycles;
+        }
+    }
+};
+
 struct VM
 {
+    // Storage for the global symbols of loaded modules
+    MemoryArena arena;
+
+    // Whether threads created from now on are profiled
+    bool        profilingEnabled;
+
+    // Counters merged from all the profiled threads
+    std::mutex  profileMutex;
+    VMProfile   profile;
+
+    // Storage for the last report from `getProfileReport`
+    String      profileReport;
 };
 
 VM* createVM()
 {
     VM* vm = new VM();
+    vm->arena.init(16 * 1024);
+    vm->profilingEnabled = false;
     return vm;
 }
 
 struct VMThread
 {
+    // The VM that the thread runs in
+    VM*         vm;
+
     // The currently executing call frame
     VMFrame*    frame;
+
+    // Storage for the call frames of the thread
+    VMStack     stack;
+
+    // The number of invocations that this thread
+    // runs in lockstep
+    UInt        laneCount;
+
+    // Storage for `groupshared` variables to be used by
+    // calls on this thread, or null (see `VMFrame`)
+    void**      groupSharedPtrs;
+
+    // Counters not yet merged into the profile of the VM,
+    // or null if the thread isn't profiled
+    VMProfile*  profile;
+
+    // The total cycles spent running instructions on the
+    // thread, when profiled
+    UInt64      profileCycles;
+};
+
+// The reason that `resumeThread` returned
+enum VMThreadStatus
+{
+    // The outermost call on the thread has returned
+    kVMThreadStatus_Done,
+
+    // All lanes of the thread are waiting at a group barrier
+    kVMThreadStatus_AtBarrier,
 };
 
-void resumeThread(
+VMThreadStatus resumeThread(
     VMThread*   vmThread);
 
 void computeTypeSizeAlign(
@@ -512,7 +1085,22 @@ void computeTypeSizeAlign(
         size = sizeof(void*);
         break;
 
+    case kIROp_RateQualifiedType:
+        {
+            // A rate-qualified type is stored just like its value type.
+            VMType valueType = ((VMType*) (impl + 1))[1];
+            size = valueType.getSize();
+            alignment = valueType.getAlignment();
+        }
+        break;
+
     default:
+        if(impl->op >= kIROp_FirstRate && impl->op <= kIROp_LastRate)
+        {
+            // Rates only appear as operands of other types
+            size = 0;
+            break;
+        }
         SLANG_UNIMPLEMENTED_X("type sizing");
         UNREACHABLE(impl->size = 0);
         break;
@@ -604,9 +1192,12 @@ VMType loadVMType(
     }
 }
 
-void* allocateImpl(VM* /*vm*/, UInt size, UInt /*align*/)
+void* allocateImpl(VM* vm, UInt size, UInt align)
 {
-    void* ptr = malloc(size);
+    // The arena doesn't support empty allocations
+    size = Math::Max(size, UInt(1));
+
+    void* ptr = vm->arena.allocateAligned(size, Math::Max(align, UInt(1)));
     memset(ptr, 0, size);
     return ptr;
 }
@@ -635,6 +1226,14 @@ void* loadVMSymbol(
     case kIROp_GlobalVar:
         {
             auto type = getType(vmModule, bcSymbol->typeID);
+            if( type.impl->op == kIROp_RateQualifiedType )
+            {
+                // A `groupshared` variable still gets storage owned
+                // by the module, which is used when its code isn't
+                // run as part of a thread group.
+                type = ((VMType*) (type.getImpl() + 1))[1];
+            }
+
             assert(type.impl->op == kIROp_PtrType);
 
             VMPtrTypeImpl* ptrTypeImpl = (VMPtrTypeImpl*) type.impl;
@@ -689,18 +1288,24 @@ VMModule* loadVMModuleInstance(
 
     UInt vmModuleSize = sizeof(VMModule)
         + symbolCount * sizeof(void*)
-        + typeCount * sizeof(VMType);
+        + typeCount * sizeof(VMType)
+        + symbolCount * sizeof(Int)
+        + symbolCount * sizeof(size_t);
 
     VMModule* vmModule = (VMModule*)malloc(vmModuleSize);
     memset(vmModule, 0, vmModuleSize);
 
     void** vmSymbols = (void**)(vmModule + 1);
     VMType* vmTypes = (VMType*)(vmSymbols + symbolCount);
+    Int* vmSymbolGroupSharedIndices = (Int*)(vmTypes + typeCount);
+    size_t* vmGroupSharedOffsets = (size_t*)(vmSymbolGroupSharedIndices + symbolCount);
 
     vmModule->bcModule = bcModule;
     vmModule->vm = vm;
     vmModule->symbols = vmSymbols;
     vmModule->types = vmTypes;
+    vmModule->symbolGroupSharedIndices = vmSymbolGroupSharedIndices;
+    vmModule->groupSharedOffsets = vmGroupSharedOffsets;
 
     // Initialize types before symbols, since the symbols
     // will all have types...
@@ -710,6 +1315,36 @@ VMModule* loadVMModuleInstance(
         vmTypes[tt] = loadVMType(vmModule, bcType);
     }
 
+    // Lay out the memory that each thread group needs for
+    // `groupshared` variables, before any function that
+    // refers to them gets loaded.
+    for(UInt ss = 0; ss < symbolCount; ++ss)
+    {
+        vmSymbolGroupSharedIndices[ss] = -1;
+
+        BCSymbol* bcSymbol = bcModule->symbols[ss];
+        if(bcSymbol->op != kIROp_GlobalVar)
+            continue;
+
+        auto type = getType(vmModule, bcSymbol->typeID);
+        if(type.impl->op != kIROp_RateQualifiedType)
+            continue;
+
+        VMType* typeArgs = (VMType*) (type.getImpl() + 1);
+        if(typeArgs[0].impl->op != kIROp_GroupSharedRate)
+            continue;
+
+        VMType valueType = ((VMPtrTypeImpl*) typeArgs[1].impl)->base;
+        UInt alignment = valueType.getAlignment();
+
+        size_t offset = (vmModule->groupSharedSize + (alignment-1)) & ~(alignment-1);
+        vmModule->groupSharedSize = offset + valueType.getSize();
+
+        UInt index = vmModule->groupSharedCount++;
+        vmSymbolGroupSharedIndices[ss] = Int(index);
+        vmGroupSharedOffsets[index] = offset;
+    }
+
     // Now we need to initialize all the VM-level symbols
     // from their BC-level equivalents.
     for(UInt ss = 0; ss < symbolCount; ++ss)
@@ -747,50 +1382,673 @@ void* findGlobalSymbolPtr(
 }
 
 VMThread* createThread(
-    VM* /*vm*/)
+    VM*     vm,
+    UInt    laneCount)
 {
+    if (laneCount == 0 || laneCount > kVMMaxLaneCount)
+        return nullptr;
+
     VMThread* thread = new VMThread();
+    thread->vm = vm;
     thread->frame = nullptr;
+    initStack(&thread->stack);
+    thread->laneCount = laneCount;
+    thread->groupSharedPtrs = nullptr;
+    thread->profile = vm->profilingEnabled ? new VMProfile() : nullptr;
+    thread->profileCycles = 0;
     return thread;
 }
 
+void destroyThread(
+    VMThread*   vmThread)
+{
+    destroyStack(&vmThread->stack);
+    delete vmThread->profile;
+    delete vmThread;
+}
+
+// Merge the counters of a profiled thread into its VM
+void flushThreadProfile(
+    VMThread*   vmThread)
+{
+    VMProfile* profile = vmThread->profile;
+    if( !profile )
+        return;
+
+    VM* vm = vmThread->vm;
+    {
+        std::lock_guard<std::mutex> lock(vm->profileMutex);
+        vm->profile.add(*profile);
+    }
+    profile->reset();
+}
+
 void beginCall(
     VMThread*   vmThread,
     VMFunc*     vmFunc)
 {
-    VMFrame* vmFrame = createFrame(vmFunc);
+    VMFrame* vmFrame = createFrame(&vmThread->stack, vmFunc, vmThread->laneCount);
+    vmFrame->groupSharedPtrs = vmThread->groupSharedPtrs;
+
+    if( VMProfile* profile = vmThread->profile )
+    {
+        profile->funcs[profile->getFuncIndex(vmFunc)].callCount++;
+        vmFrame->profileStartCycles = vmThread->profileCycles;
+    }
 
     vmFrame->parent = vmThread->frame;
     vmThread->frame = vmFrame;
 }
 
-void setArg(
+void setLaneArg(
     VMThread*   vmThread,
+    UInt        laneIndex,
     UInt        argIndex,
     void const* data,
     size_t      size)
 {
     // TODO: need all kinds of validation here...
 
-    void* dest = getRegPtrImpl(vmThread->frame, argIndex);
+    void* dest = getRegOperandImpl(vmThread->frame, argIndex).getLanePtr(laneIndex);
     memcpy(dest, data, size);
 }
 
-void resumeThread(
-    VMThread*   vmThread)
+void setArg(
+    VMThread*   vmThread,
+    UInt        argIndex,
+    void const* data,
+    size_t      size)
 {
-    auto frame = vmThread->frame;
-    auto ip = frame->ip;
-
-    for(;;)
+    // An argument set without a lane index is
+    // shared by all lanes of the thread.
+    UInt laneCount = vmThread->laneCount;
+    for( UInt ll = 0; ll < laneCount; ++ll )
     {
-#if 0
+        setLaneArg(vmThread, ll, argIndex, data, size);
+    }
+}
+
+// Record that the lanes in `mask` will run `blockIndex` next.
+void setLaneBlocks(
+    VMFrame*    frame,
+    VMLaneMask  mask,
+    Int         blockIndex)
+{
+    for( auto lane : getLanes(mask) )
+    {
+        frame->laneBlocks[lane] = (uint32_t) blockIndex;
+    }
+}
+
+// Pick the next group of lanes to run in `frame`, once
+// the active lanes have reached the end of a block.
+//
+// Lanes that took different branches may be waiting on
+// different blocks. We always run the lanes waiting on the
+// lowest-numbered block next. Blocks are laid out in
+// structured order (the merge point of an `if` comes after
+// both of its sides, and the break label of a loop comes
+// after its body), so this lets lanes that diverged meet up
+// again at the merge point, and run it together.
+//
+// Returns false if there are no live lanes left.
+bool scheduleNextBlock(
+    VMFrame*    frame)
+{
+    VMLaneMask liveMask = frame->liveMask;
+    if( !liveMask )
+        return false;
+
+    uint32_t nextBlock = ~uint32_t(0);
+    VMLaneMask nextMask = 0;
+    for( auto lane : getLanes(liveMask) )
+    {
+        uint32_t laneBlock = frame->laneBlocks[lane];
+        if( laneBlock < nextBlock )
+        {
+            nextBlock = laneBlock;
+            nextMask = 0;
+        }
+        if( laneBlock == nextBlock )
+        {
+            nextMask |= VMLaneMask(1) << lane;
+        }
+    }
+
+    frame->activeMask = nextMask;
+    frame->ip = frame->func->bcFunc->blocks[nextBlock].code;
+    return true;
+}
+
+// Continue execution after the active lanes of `frame` have
+// branched or returned. Returns the frame to continue in, which
+// is the parent frame if all lanes have returned, or null if
+// the outermost call of the thread is done.
+VMFrame* continueAfterBlock(
+    VMThread*   vmThread,
+    VMFrame*    frame)
+{
+    if( scheduleNextBlock(frame) )
+        return frame;
+
+    // All the lanes that entered this call have returned.
+    VMFrame* parentFrame = frame->parent;
+    vmThread->frame = parentFrame;
+    destroyFrame(&vmThread->stack, frame);
+
+    // HACK: we need to know when we are done.
+    // TODO: We should probably have the bottom
+    // of the stack for a thread always point
+    // to a special bytecode sequence that
+    // forces a `yield` op that can handle
+    // the exit from the interpreter, rather
+    // than always take a branch here.
+    //
+    // Otherwise, the parent frame was suspended in the
+    // middle of a block at a call, and it resumes with
+    // the same set of active lanes.
+    return parentFrame;
+}
+
+// Branch all active lanes of `frame` to the same block.
+VMFrame* branchActiveLanes(
+    VMThread*   vmThread,
+    VMFrame*    frame,
+    Int         blockIndex)
+{
+    if( frame->activeMask == frame->liveMask )
+    {
+        // No other lanes are waiting, so we can just jump.
+        frame->ip = frame->func->bcFunc->blocks[blockIndex].code;
+        return frame;
+    }
+
+    setLaneBlocks(frame, frame->activeMask, blockIndex);
+    return continueAfterBlock(vmThread, frame);
+}
+
+// Lane-wise operations.
+//
+// Each operation has a scalar `apply`, and may also provide
+// `applySimd` overloads for the SIMD vector types that can
+// implement it.
+
+struct VMAddOp
+{
+    template<typename T> static T apply(T left, T right) { return left + right; }
+#if SLANG_VM_SIMD_AVX
+    static __m256 applySimd(__m256 left, __m256 right) { return _mm256_add_ps(left, right); }
+#endif
+#if SLANG_VM_SIMD_AVX2
+    static __m256i applySimd(__m256i left, __m256i right) { return _mm256_add_epi32(left, right); }
+#endif
+#if SLANG_VM_SIMD_SSE2
+    static __m128 applySimd(__m128 left, __m128 right) { return _mm_add_ps(left, right); }
+    static __m128i applySimd(__m128i left, __m128i right) { return _mm_add_epi32(left, right); }
+#endif
+};
+
+struct VMSubOp
+{
+    template<typename T> static T apply(T left, T right) { return left - right; }
+#if SLANG_VM_SIMD_AVX
+    static __m256 applySimd(__m256 left, __m256 right) { return _mm256_sub_ps(left, right); }
+#endif
+#if SLANG_VM_SIMD_AVX2
+    static __m256i applySimd(__m256i left, __m256i right) { return _mm256_sub_epi32(left, right); }
+#endif
+#if SLANG_VM_SIMD_SSE2
+    static __m128 applySimd(__m128 left, __m128 right) { return _mm_sub_ps(left, right); }
+    static __m128i applySimd(__m128i left, __m128i right) { return _mm_sub_epi32(left, right); }
+#endif
+};
+
+struct VMMulOp
+{
+    template<typename T> static T apply(T left, T right) { return left * right; }
+#if SLANG_VM_SIMD_AVX
+    static __m256 applySimd(__m256 left, __m256 right) { return _mm256_mul_ps(left, right); }
+#endif
+#if SLANG_VM_SIMD_SSE2
+    static __m128 applySimd(__m128 left, __m128 right) { return _mm_mul_ps(left, right); }
+#endif
+};
+
+struct VMDivOp
+{
+    template<typename T> static T apply(T left, T right) { return left / right; }
+#if SLANG_VM_SIMD_AVX
+    static __m256 applySimd(__m256 left, __m256 right) { return _mm256_div_ps(left, right); }
+#endif
+#if SLANG_VM_SIMD_SSE2
+    static __m128 applySimd(__m128 left, __m128 right) { return _mm_div_ps(left, right); }
+#endif
+};
+
+struct VMModOp
+{
+    template<typename T> static T apply(T left, T right) { return left % right; }
+};
+
+struct VMEqlOp
+{
+    template<typename T> static bool apply(T left, T right) { return left == right; }
+};
+
+struct VMNeqOp
+{
+    template<typename T> static bool apply(T left, T right) { return left != right; }
+};
+
+struct VMLessOp
+{
+    template<typename T> static bool apply(T left, T right) { return left < right; }
+};
+
+struct VMGreaterOp
+{
+    template<typename T> static bool apply(T left, T right) { return left > right; }
+};
+
+struct VMLeqOp
+{
+    template<typename T> static bool apply(T left, T right) { return left <= right; }
+};
+
+struct VMGeqOp
+{
+    template<typename T> static bool apply(T left, T right) { return left >= right; }
+};
+
+// SIMD vector types used to process several lanes at once.
+//
+// An operand with a zero stride is shared by all lanes, and
+// gets broadcast to every element of the vector.
+template<typename T>
+struct VMSimdVec;
+
+#if SLANG_VM_SIMD_AVX
+template<>
+struct VMSimdVec<float>
+{
+    typedef __m256 Type;
+    static const UInt kWidth = 8;
+
+    static Type load(VMOperand const& operand, UInt lane)
+    {
+        return operand.stride ? _mm256_loadu_ps(&operand.get<float>(lane)) : _mm256_set1_ps(operand.get<float>(0));
+    }
+    static void store(VMOperand const& operand, UInt lane, Type value)
+    {
+        _mm256_storeu_ps(&operand.get<float>(lane), value);
+    }
+};
+#elif SLANG_VM_SIMD_SSE2
+template<>
+struct VMSimdVec<float>
+{
+    typedef __m128 Type;
+    static const UInt kWidth = 4;
+
+    static Type load(VMOperand const& operand, UInt lane)
+    {
+        return operand.stride ? _mm_loadu_ps(&operand.get<float>(lane)) : _mm_set1_ps(operand.get<float>(0));
+    }
+    static void store(VMOperand const& operand, UInt lane, Type value)
+    {
+        _mm_storeu_ps(&operand.get<float>(lane), value);
+    }
+};
+#endif
+
+#if SLANG_VM_SIMD_AVX2
+template<typename T>
+struct VMSimdIntVec
+{
+    typedef __m256i Type;
+    static const UInt kWidth = 8;
+
+    static Type load(VMOperand const& operand, UInt lane)
+    {
+        return operand.stride ? _mm256_loadu_si256((Type const*) operand.getLanePtr(lane)) : _mm256_set1_epi32(int(operand.get<T>(0)));
+    }
+    static void store(VMOperand const& operand, UInt lane, Type value)
+    {
+        _mm256_storeu_si256((Type*) operand.getLanePtr(lane), value);
+    }
+};
+#elif SLANG_VM_SIMD_SSE2
+template<typename T>
+struct VMSimdIntVec
+{
+    typedef __m128i Type;
+    static const UInt kWidth = 4;
+
+    static Type load(VMOperand const& operand, UInt lane)
+    {
+        return operand.stride ? _mm_loadu_si128((Type const*) operand.getLanePtr(lane)) : _mm_set1_epi32(int(operand.get<T>(0)));
+    }
+    static void store(VMOperand const& operand, UInt lane, Type value)
+    {
+        _mm_storeu_si128((Type*) operand.getLanePtr(lane), value);
+    }
+};
+#endif
+
+#if SLANG_VM_SIMD_SSE2
+template<> struct VMSimdVec<int32_t> : VMSimdIntVec<int32_t> {};
+template<> struct VMSimdVec<uint32_t> : VMSimdIntVec<uint32_t> {};
+#endif
+
+// Run a binary op on all lanes using SIMD vectors, with a
+// scalar loop for any lanes left over.
+template<typename T, typename Op>
+bool executeSimdBinaryOp(
+    UInt                laneCount,
+    VMOperand const&    dest,
+    VMOperand const&    left,
+    VMOperand const&    right)
+{
+    typedef VMSimdVec<T> Vec;
+
+    UInt lane = 0;
+    for( ; lane + Vec::kWidth <= laneCount; lane += Vec::kWidth )
+    {
+        Vec::store(dest, lane, Op::applySimd(Vec::load(left, lane), Vec::load(right, lane)));
+    }
+    for( ; lane < laneCount; ++lane )
+    {
+        dest.get<T>(lane) = Op::apply(left.get<T>(lane), right.get<T>(lane));
+    }
+    return true;
+}
+
+// Operations without a SIMD implementation for a given
+// type fall back to scalar code.
+template<typename T, typename R, typename Op>
+struct VMSimdBinaryOp
+{
+    static bool execute(UInt, VMOperand const&, VMOperand const&, VMOperand const&) { return false; }
+};
+
+#define SLANG_VM_SIMD_BINARY_OP(T, OP)                                                      \
+    template<> struct VMSimdBinaryOp<T, T, OP>                                              \
+    {                                                                                       \
+        static bool execute(UInt laneCount, VMOperand const& dest,                          \
+            VMOperand const& left, VMOperand const& right)                                  \
+        {                                                                                   \
+            return executeSimdBinaryOp<T, OP>(laneCount, dest, left, right);                \
+        }                                                                                   \
+    };
+
+#if SLANG_VM_SIMD_SSE2
+SLANG_VM_SIMD_BINARY_OP(float, VMAddOp)
+SLANG_VM_SIMD_BINARY_OP(float, VMSubOp)
+SLANG_VM_SIMD_BINARY_OP(float, VMMulOp)
+SLANG_VM_SIMD_BINARY_OP(float, VMDivOp)
+SLANG_VM_SIMD_BINARY_OP(int32_t, VMAddOp)
+SLANG_VM_SIMD_BINARY_OP(int32_t, VMSubOp)
+SLANG_VM_SIMD_BINARY_OP(uint32_t, VMAddOp)
+SLANG_VM_SIMD_BINARY_OP(uint32_t, VMSubOp)
+#endif
+
+#undef SLANG_VM_SIMD_BINARY_OP
+
+template<typename T, typename R, typename Op>
+void executeBinaryOp(
+    VMFrame*            frame,
+    VMOperand const&    dest,
+    VMOperand const&    left,
+    VMOperand const&    right)
+{
+    UInt laneCount = frame->laneCount;
+    VMLaneMask mask = frame->activeMask;
+    if( mask == getAllLanesMask(laneCount) )
+    {
+        // All lanes are active, so we can run straight
+        // through the registers.
+        if( VMSimdBinaryOp<T, R, Op>::execute(laneCount, dest, left, right) )
+            return;
+
+        for( UInt lane = 0; lane < laneCount; ++lane )
+        {
+            dest.get<R>(lane) = Op::apply(left.get<T>(lane), right.get<T>(lane));
+        }
+    }
+    else
+    {
+        for( auto lane : getLanes(mask) )
+        {
+            dest.get<R>(lane) = Op::apply(left.get<T>(lane), right.get<T>(lane));
+        }
+    }
+}
+
+// Decode and execute an arithmetic op that applies to integer types
+template<typename Op>
+void executeIntegerOp(
+    VMFrame*    frame,
+    BCOp**      ioIP)
+{
+    VMType type = decodeType(frame, ioIP);
+    /*UInt argCount = */decodeUInt(ioIP);
+    VMOperand left = decodeOperand(frame, ioIP);
+    VMOperand right = decodeOperand(frame, ioIP);
+    VMOperand dest = decodeOperand(frame, ioIP);
+
+    switch (type.getImpl()->op)
+    {
+    case kIROp_IntType:
+        executeBinaryOp<int32_t, int32_t, Op>(frame, dest, left, right);
+        break;
+
+    case kIROp_UIntType:
+        executeBinaryOp<uint32_t, uint32_t, Op>(frame, dest, left, right);
+        break;
+
+    default:
+        SLANG_UNEXPECTED("arithmetic op case");
+        break;
+    }
+}
+
+// Decode and execute an arithmetic op that applies to integer
+// and floating-point types
+template<typename Op>
+void executeArithmeticOp(
+    VMFrame*    frame,
+    BCOp**      ioIP)
+{
+    BCOp* ip = *ioIP;
+    VMType type = decodeType(frame, &ip);
+    if( type.getImpl()->op != kIROp_FloatType )
+    {
+        executeIntegerOp<Op>(frame, ioIP);
+        return;
+    }
+
+    /*UInt argCount = */decodeUInt(&ip);
+    VMOperand left = decodeOperand(frame, &ip);
+    VMOperand right = decodeOperand(frame, &ip);
+    VMOperand dest = decodeOperand(frame, &ip);
+    *ioIP = ip;
+
+    executeBinaryOp<float, float, Op>(frame, dest, left, right);
+}
+
+// Decode and execute a comparison, which produces a `Bool` result
+template<typename Op>
+void executeComparisonOp(
+    VMFrame*    frame,
+    BCOp**      ioIP)
+{
+    /*VMType resultType = */decodeType(frame, ioIP);
+    /*UInt argCount = */decodeUInt(ioIP);
+    auto leftOperandAndType = decodeOperandAndType(frame, ioIP);
+    VMOperand left = leftOperandAndType.operand;
+    VMOperand right = decodeOperand(frame, ioIP);
+    VMOperand dest = decodeOperand(frame, ioIP);
+
+    switch (leftOperandAndType.type.getImpl()->op)
+    {
+    case kIROp_IntType:
+        executeBinaryOp<int32_t, bool, Op>(frame, dest, left, right);
+        break;
+
+    case kIROp_UIntType:
+        executeBinaryOp<uint32_t, bool, Op>(frame, dest, left, right);
+        break;
+
+    case kIROp_FloatType:
+        executeBinaryOp<float, bool, Op>(frame, dest, left, right);
+        break;
+
+    case kIROp_BoolType:
+        executeBinaryOp<bool, bool, Op>(frame, dest, left, right);
+        break;
+
+    default:
+        SLANG_UNEXPECTED("comparison op case");
+        break;
+    }
+}
+
+// Collects the counters for a profiled thread while it is
+// running in `resumeThread`. The cycles for each instruction
+// are measured from its start to the start of the next one.
+struct VMProfiler
+{
+    VMThread*   thread;
+    VMProfile*  profile;
+
+    // The instruction being executed, if any
+    bool        hasInst;
+    IROp        instOp;
+    UInt        instFuncIndex;
+    UInt64      instStartCycles;
+
+    // Cached index of the last function we looked up
+    VMFunc*     lastFunc;
+    UInt        lastFuncIndex;
+
+    VMProfiler(VMThread* thread)
+        : thread(thread)
+        , profile(thread->profile)
+        , hasInst(false)
+        , lastFunc(nullptr)
+        , lastFuncIndex(0)
+    {}
+
+    ~VMProfiler()
+    {
+        if( hasInst )
+            endInst(getVMProfileCycles());
+    }
+
+    void endInst(UInt64 now)
+    {
+        if( !hasInst )
+            return;
+
+        UInt64 cycles = now - instStartCycles;
+        profile->ops[instOp].cycles += cycles;
+        profile->funcs[instFuncIndex].cycles += cycles;
+        thread->profileCycles += cycles;
+        hasInst = false;
+    }
+
+    void beginInst(VMFunc* func, IROp op)
+    {
+        UInt64 now = getVMProfileCycles();
+        endInst(now);
+
+        if( func != lastFunc )
+        {
+            lastFunc = func;
+            lastFuncIndex = profile->getFuncIndex(func);
+        }
+
+        profile->ops[op].count++;
+        profile->funcs[lastFuncIndex].instCount++;
+
+        hasInst = true;
+        instOp = op;
+        instFuncIndex = lastFuncIndex;
+        instStartCycles = now;
+    }
+
+    void beginCall(VMFrame* callerFrame, BCOp* callIP, VMFrame* calleeFrame)
+    {
+        VMFunc* caller = callerFrame->func;
+        calleeFrame->callSite.caller = caller;
+        calleeFrame->callSite.offset = callIP - caller->bcFunc->blocks[0].code.getPtr();
+        calleeFrame->profileStartCycles = thread->profileCycles;
+
+        profile->funcs[profile->getFuncIndex(calleeFrame->func)].callCount++;
+    }
+
+    // Called when the last lane returns from `frame`
+    void endCall(VMFrame* frame)
+    {
+        if( !frame->callSite.caller )
+            return;
+
+        VMCallSiteProfile& callSite = profile->callSites[
+            profile->getCallSiteIndex(frame->callSite, frame->func)];
+        callSite.count++;
+        callSite.cycles += thread->profileCycles - frame->profileStartCycles;
+    }
+};
+
+// Stands in for `VMProfiler` when profiling is turned off, so
+// that the unprofiled loop doesn't set one up or tear it down.
+struct VMNullProfiler
+{
+    VMNullProfiler(VMThread*) {}
+
+    void beginInst(VMFunc*, IROp) {}
+    void beginCall(VMFrame*, BCOp*, VMFrame*) {}
+    void endCall(VMFrame*) {}
+};
+
+template<bool kProfile>
+struct VMProfilerForMode
+{
+    typedef VMProfiler Type;
+};
+
+template<>
+struct VMProfilerForMode<false>
+{
+    typedef VMNullProfiler Type;
+};
+
+// The interpreter loop. Profiling is a template parameter, so
+// that it costs nothing when it is turned off.
+template<bool kProfile>
+VMThreadStatus resumeThreadImpl(
+    VMThread*   vmThread)
+{
+    auto frame = vmThread->frame;
+    auto ip = frame->ip;
+
+    typename VMProfilerForMode<kProfile>::Type profiler(vmThread);
+
+    for(;;)
+    {
+#if 0
         // debugging:
         frame->ip = ip;
         dumpVMFrame(frame);
 #endif
 
+        BCOp* instIP = ip;
         auto op = (IROp) decodeUInt(&ip);
+        if( kProfile )
+        {
+            profiler.beginInst(frame->func, op);
+        }
+
         switch( op )
         {
         case kIROp_Var:
@@ -799,21 +2057,24 @@ void resumeThread(
 
                 VMType type = decodeType(frame, &ip);
                 UInt argCount = decodeUInt(&ip);
-                void* argPtrs[16] = { 0 };
                 for( UInt aa = 0; aa < argCount; ++aa )
                 {
-                    void* argPtr = decodeOperandPtr<void>(frame, &ip);
-                    argPtrs[aa] = argPtr;
+                    decodeOperand(frame, &ip);
                 }
 
-                void** destPtr = decodeOperandPtr<void*>(frame, &ip);
-
                 // For now this is a bit silly and simple: the
                 // storage for the variable we are "allocating"
-                // should be right after outer destination, so we can
-                // set it pretty easily.
+                // is always the register right after the destination,
+                // so we can set it pretty easily.
+
+                Int destID = decodeSInt(&ip);
+                VMOperand dest = getOperandImpl(frame, destID);
+                VMOperand storage = getOperandImpl(frame, destID + 1);
 
-                *destPtr = destPtr + 1;
+                for( auto lane : getLanes(frame->activeMask) )
+                {
+                    dest.get<void*>(lane) = storage.getLanePtr(lane);
+                }
             }
             break;
 
@@ -821,17 +2082,21 @@ void resumeThread(
             {
                 // An ordinary memory store
                 VMType type = decodeType(frame, &ip);
-                void* dest = decodeOperand<void*>(frame, &ip);
-                void* src = decodeOperandPtr<void>(frame, &ip);
+                VMOperand dest = decodeOperand(frame, &ip);
+                VMOperand src = decodeOperand(frame, &ip);
 
+                auto size = type.getSize();
+                for( auto lane : getLanes(frame->activeMask) )
+                {
 #if 0
-                fprintf(stderr, "STORE *[%p] = [%p] // size: %d\n",
-                    dest,
-                    src,
-                    (int) type.getSize());
+                    fprintf(stderr, "STORE *[%p] = [%p] // size: %d\n",
+                        dest.get<void*>(lane),
+                        src.getLanePtr(lane),
+                        (int) size);
 #endif
 
-                memcpy(dest, src, type.getSize());
+                    memcpy(dest.get<void*>(lane), src.getLanePtr(lane), size);
+                }
             }
             break;
 
@@ -839,10 +2104,14 @@ void resumeThread(
             {
                 // An ordinary memory store
                 VMType type = decodeType(frame, &ip);
-                void* src = decodeOperand<void*>(frame, &ip);
-                void* dest = decodeOperandPtr<void>(frame, &ip);
+                VMOperand src = decodeOperand(frame, &ip);
+                VMOperand dest = decodeOperand(frame, &ip);
 
-                memcpy(dest, src, type.getSize());
+                auto size = type.getSize();
+                for( auto lane : getLanes(frame->activeMask) )
+                {
+                    memcpy(dest.getLanePtr(lane), src.get<void*>(lane), size);
+                }
             }
             break;
 
@@ -850,21 +2119,23 @@ void resumeThread(
             {
                 VMType type = decodeType(frame, &ip);
                 UInt argCount = decodeUInt(&ip);
-                void* argPtrs[16] = { 0 };
+                VMOperand args[16] = {};
                 for( UInt aa = 0; aa < argCount; ++aa )
                 {
-                    void* argPtr = decodeOperandPtr<void>(frame, &ip);
-                    argPtrs[aa] = argPtr;
+                    args[aa] = decodeOperand(frame, &ip);
                 }
 
-                void* dest = decodeOperandPtr<void>(frame, &ip);
-
-                char* bufferData = *(char**)argPtrs[0];
-                uint32_t index = *(uint32_t*)argPtrs[1];
+                VMOperand dest = decodeOperand(frame, &ip);
 
                 auto size = type.getSize();
-                char* elementData = bufferData + index*size;
-                memcpy(dest, elementData, size);
+                for( auto lane : getLanes(frame->activeMask) )
+                {
+                    char* bufferData = args[0].get<char*>(lane);
+                    uint32_t index = args[1].get<uint32_t>(lane);
+
+                    char* elementData = bufferData + index*size;
+                    memcpy(dest.getLanePtr(lane), elementData, size);
+                }
             }
             break;
 
@@ -873,16 +2144,20 @@ void resumeThread(
                 VMType resultType = decodeType(frame, &ip);
                 /*UInt argCount = */decodeUInt(&ip);
 
-                char* bufferData = decodeOperand<char*>(frame, &ip);
-                uint32_t index = decodeOperand<uint32_t>(frame, &ip);
+                VMOperand buffer = decodeOperand(frame, &ip);
+                VMOperand index = decodeOperand(frame, &ip);
 
-                auto srcPtrAndType = decodeOperandPtrAndType(frame, &ip);
-                void* srcPtr = srcPtrAndType.ptr;
-                VMType type = srcPtrAndType.type;
+                auto srcOperandAndType = decodeOperandAndType(frame, &ip);
+                VMOperand src = srcOperandAndType.operand;
+                VMType type = srcOperandAndType.type;
 
                 auto size = type.getSize();
-                char* elementData = bufferData + index*size;
-                memcpy(elementData, srcPtr, size);
+                for( auto lane : getLanes(frame->activeMask) )
+                {
+                    char* bufferData = buffer.get<char*>(lane);
+                    char* elementData = bufferData + index.get<uint32_t>(lane)*size;
+                    memcpy(elementData, src.getLanePtr(lane), size);
+                }
             }
             break;
 
@@ -892,22 +2167,23 @@ void resumeThread(
                 VMType type = ((VMPtrTypeImpl*)ptrType.getImpl())->base;
 
                 UInt argCount = decodeUInt(&ip);
-                void* argPtrs[16] = { 0 };
+                VMOperand args[16] = {};
                 for( UInt aa = 0; aa < argCount; ++aa )
                 {
-                    void* argPtr = decodeOperandPtr<void>(frame, &ip);
-                    argPtrs[aa] = argPtr;
+                    args[aa] = decodeOperand(frame, &ip);
                 }
 
-                void* dest = decodeOperandPtr<void>(frame, &ip);
-
-                char* bufferData = *(char**)argPtrs[0];
-                uint32_t index = *(uint32_t*)argPtrs[1];
+                VMOperand dest = decodeOperand(frame, &ip);
 
                 auto size = type.getSize();
-                char* elementData = bufferData + index*size;
+                for( auto lane : getLanes(frame->activeMask) )
+                {
+                    char* bufferData = args[0].get<char*>(lane);
+                    uint32_t index = args[1].get<uint32_t>(lane);
 
-                *(void**)dest = elementData;
+                    char* elementData = bufferData + index*size;
+                    dest.get<void*>(lane) = elementData;
+                }
             }
             break;
 
@@ -917,30 +2193,86 @@ void resumeThread(
                 VMType type = decodeType(frame, &ip);
                 UInt operandCount = decodeUInt(&ip);
 
-                // First operand is the callee function
-                VMFunc* func = decodeOperand<VMFunc*>(frame, &ip);
+                // First operand is the callee function.
+                //
+                // We expect all the active lanes to call the same
+                // function, so we take it from the first of them.
+                VMOperand funcOperand = decodeOperand(frame, &ip);
+                VMFunc* func = funcOperand.get<VMFunc*>(getFirstLane(frame->activeMask));
+
+                if( func->intrinsic != kVMIntrinsic_None )
+                {
+                    // The intrinsics we support take no arguments
+                    // and return nothing, so we just skip the operands.
+                    for( UInt aa = 1; aa < operandCount; ++aa )
+                    {
+                        decodeOperand(frame, &ip);
+                    }
+                    if( type.getImpl()->op != kIROp_VoidType )
+                    {
+                        decodeOperand(frame, &ip);
+                    }
+
+                    // A group sync suspends the thread, so that the
+                    // other threads of the group can catch up.
+                    //
+                    // We only do this when every lane of the thread
+                    // has reached the barrier. A barrier in divergent
+                    // control flow is undefined behavior, and we
+                    // treat it as a no-op.
+                    if( func->intrinsic == kVMIntrinsic_GroupSync
+                        && frame->activeMask == getAllLanesMask(frame->laneCount) )
+                    {
+                        frame->ip = ip;
+                        return kVMThreadStatus_AtBarrier;
+                    }
+                    break;
+                }
+
+                if( func->bcFunc->blockCount == 0 )
+                {
+                    SLANG_UNEXPECTED("call to function without a body");
+                }
 
-                // Okay, we need to create a frame to prepare the call
-                VMFrame* newFrame = createFrame(func);
+                // Okay, we need to create a frame to prepare the call.
+                // Only the lanes that are active in the caller take
+                // part in the call.
+                VMFrame* newFrame = createFrame(&vmThread->stack, func, frame->laneCount);
                 newFrame->parent = frame;
+                newFrame->groupSharedPtrs = frame->groupSharedPtrs;
+                newFrame->activeMask = frame->activeMask;
+                newFrame->liveMask = frame->activeMask;
+                if( kProfile )
+                {
+                    profiler.beginCall(frame, instIP, newFrame);
+                }
 
                 // Remaining arguments should populate the
                 // first N registers of the callee
                 UInt argCount = operandCount - 1;
                 for( UInt aa = 0; aa < argCount; ++aa )
                 {
-                    void* argPtr = decodeOperandPtr<void>(frame, &ip);
-                    void* regPtr = getRegPtrImpl(newFrame, aa);
+                    VMOperand arg = decodeOperand(frame, &ip);
+                    VMOperand reg = getRegOperandImpl(newFrame, aa);
 
                     VMType regType = func->regs[aa].type;
-                    memcpy(regPtr, argPtr, regType.getSize());
+                    auto size = regType.getSize();
+                    for( auto lane : getLanes(newFrame->activeMask) )
+                    {
+                        memcpy(reg.getLanePtr(lane), arg.getLanePtr(lane), size);
+                    }
                 }
 
-                // Note that we do *not* try to read off
-                // the destination operand, and instead
-                // leave that to be done during the
-                // return sequence.
+                // If the call produces a value, then we read off
+                // the destination operand now, so that lanes can
+                // write their results as they return.
                 //
+                if( type.getImpl()->op != kIROp_VoidType )
+                {
+                    VMOperand dest = decodeOperand(frame, &ip);
+                    newFrame->resultPtr = dest.ptr;
+                    newFrame->resultStride = dest.stride;
+                }
 
                 // Save the IP we were using in teh current function.
                 //
@@ -950,29 +2282,24 @@ void resumeThread(
                 //
                 frame = newFrame;
                 ip = newFrame->ip;
+                vmThread->frame = frame;
             }
             break;
 
         case kIROp_ReturnVoid:
             {
-                // Easy case: just jump to the parent frame,
-                // without having to worry about operands.
-                VMFrame* newFrame = frame->parent;
-                vmThread->frame = newFrame;
-
-                // HACK: we need to know when we are done.
-                // TODO: We should probably have the bottom
-                // of the stack for a thread always point
-                // to a special bytecode sequence that
-                // forces a `yield` op that can handle
-                // the exit from the interpreter, rather
-                // than always take a branch here.
-                if (!newFrame)
-                    return;
+                // Easy case: the active lanes are done, without
+                // having to worry about operands.
+                frame->liveMask &= ~frame->activeMask;
+                if( kProfile && !frame->liveMask )
+                {
+                    profiler.endCall(frame);
+                }
 
-                frame = newFrame;
+                frame = continueAfterBlock(vmThread, frame);
+                if (!frame)
+                    return kVMThreadStatus_Done;
                 ip = frame->ip;
-
             }
             break;
 
@@ -980,24 +2307,29 @@ void resumeThread(
             {
                 VMType instType = decodeType(frame, &ip);
                 /*UInt argCount =*/ decodeUInt(&ip);
-                void* argPtr = decodeOperandPtr<void>(frame, &ip);
+                auto valOperandAndType = decodeOperandAndType(frame, &ip);
+                VMOperand val = valOperandAndType.operand;
 
-                VMFrame* newFrame = frame->parent;
-                vmThread->frame = newFrame;
+                if( char* resultPtr = frame->resultPtr )
+                {
+                    auto size = valOperandAndType.type.getSize();
+                    auto resultStride = frame->resultStride;
+                    for( auto lane : getLanes(frame->activeMask) )
+                    {
+                        memcpy(resultPtr + lane*resultStride, val.getLanePtr(lane), size);
+                    }
+                }
 
-                // Note: see the comments above about
-                // this branch.
-                if (!newFrame)
-                    return;
+                frame->liveMask &= ~frame->activeMask;
+                if( kProfile && !frame->liveMask )
+                {
+                    profiler.endCall(frame);
+                }
 
-                frame = newFrame;
+                frame = continueAfterBlock(vmThread, frame);
+                if (!frame)
+                    return kVMThreadStatus_Done;
                 ip = frame->ip;
-
-                auto destPtrAndType = decodeOperandPtrAndType(frame, &ip);
-                void* destPtr = destPtrAndType.ptr;
-                VMType type = destPtrAndType.type;
-
-                memcpy(destPtr, argPtr, type.getSize());
             }
             break;
 
@@ -1030,7 +2362,7 @@ void resumeThread(
 
                 for (UInt ee = 0; ee < extraArgCount; ++ee)
                 {
-                    decodeOperandPtr<void>(frame, &ip);
+                    decodeOperand(frame, &ip);
                 }
 
                 auto baseRegIndex = destinationBlock.params - func->bcFunc->regs;
@@ -1038,16 +2370,21 @@ void resumeThread(
                 {
                     auto regIndex = baseRegIndex + pp;
 
-                    void* argPtr = decodeOperandPtr<void>(frame, &ip);
-                    void* regPtr = getRegPtrImpl(frame, regIndex);
+                    VMOperand arg = decodeOperand(frame, &ip);
+                    VMOperand reg = getRegOperandImpl(frame, regIndex);
 
                     VMType regType = func->regs[regIndex].type;
-                    memcpy(regPtr, argPtr, regType.getSize());
+                    auto size = regType.getSize();
+                    for( auto lane : getLanes(frame->activeMask) )
+                    {
+                        memcpy(reg.getLanePtr(lane), arg.getLanePtr(lane), size);
+                    }
                 }
 
                 // Now simply jump to the destination block.
                 //
-                ip = destinationBlock.code;
+                frame = branchActiveLanes(vmThread, frame, destinationBlockIndex);
+                ip = frame->ip;
             }
             break;
 
@@ -1059,94 +2396,89 @@ void resumeThread(
 
                 VMType type = decodeType(frame, &ip);
                 UInt argCount = decodeUInt(&ip);
-                bool* condition = decodeOperandPtr<bool>(frame, &ip);
+                VMOperand condition = decodeOperand(frame, &ip);
                 Int trueBlockID = decodeSInt(&ip);
                 Int falseBlockID = decodeSInt(&ip);
                 for( UInt aa = 4; aa < argCount; ++aa )
                 {
-                    decodeOperandPtr<void>(frame, &ip);
+                    decodeOperand(frame, &ip);
                 }
 
-                Int destinationBlock = *condition ? trueBlockID : falseBlockID;
-
                 // TODO: we need to deal with the case of
                 // passing arguments to the block, which
                 // means copying between the registers...
                 //
-                ip = frame->func->bcFunc->blocks[destinationBlock].code;
-            }
-            break;
 
-        case kIROp_Greater:
-            {
-                // For now our encoding is very regular, so we can decode without
-                // knowing too much about an instruction...
-
-                VMType resultType = decodeType(frame, &ip);
-                /*UInt argCount = */decodeUInt(&ip);
-                //void* argPtrs[16] = { 0 };
-                auto leftOpnd = decodeOperandPtrAndType(frame, &ip);
-                auto type = leftOpnd.type;
-                auto leftPtr = leftOpnd.ptr;
-                void* rightPtr = decodeOperandPtr<void>(frame, &ip);
-
-                bool* destPtr = decodeOperandPtr<bool>(frame, &ip);
-
-                switch (type.impl->op)
+                VMLaneMask activeMask = frame->activeMask;
+                VMLaneMask trueMask = 0;
+                for( auto lane : getLanes(activeMask) )
                 {
-                case kIROp_IntType:
-                    *destPtr = *(int32_t*)leftPtr > *(int32_t*)rightPtr;
-                    break;
+                    if( condition.get<bool>(lane) )
+                        trueMask |= VMLaneMask(1) << lane;
+                }
 
-                default:
-                    SLANG_UNEXPECTED("comparison op case");
-                    break;
+                if( trueMask == activeMask )
+                {
+                    frame = branchActiveLanes(vmThread, frame, trueBlockID);
+                }
+                else if( trueMask == 0 )
+                {
+                    frame = branchActiveLanes(vmThread, frame, falseBlockID);
+                }
+                else
+                {
+                    // The lanes disagree on the condition, so each
+                    // side of the branch will run with its own lanes.
+                    setLaneBlocks(frame, trueMask, trueBlockID);
+                    setLaneBlocks(frame, activeMask & ~trueMask, falseBlockID);
+                    frame = continueAfterBlock(vmThread, frame);
                 }
+                ip = frame->ip;
             }
             break;
 
+        case kIROp_Add:
+            executeArithmeticOp<VMAddOp>(frame, &ip);
+            break;
+
+        case kIROp_Sub:
+            executeArithmeticOp<VMSubOp>(frame, &ip);
+            break;
+
         case kIROp_Mul:
-            {
-                VMType type = decodeType(frame, &ip);
-                /*UInt argCount = */decodeUInt(&ip);
-                void* leftPtr = decodeOperandPtr<void>(frame, &ip);
-                void* rightPtr = decodeOperandPtr<void>(frame, &ip);
+            executeArithmeticOp<VMMulOp>(frame, &ip);
+            break;
 
-                void* destPtr = decodeOperandPtr<void>(frame, &ip);
+        case kIROp_Div:
+            executeArithmeticOp<VMDivOp>(frame, &ip);
+            break;
 
-                switch (type.impl->op)
-                {
-                case kIROp_IntType:
-                    *(int32_t*)destPtr = *(int32_t*)leftPtr * *(int32_t*)rightPtr;
-                    break;
+        case kIROp_Mod:
+            executeIntegerOp<VMModOp>(frame, &ip);
+            break;
 
-                default:
-                    SLANG_UNEXPECTED("comparison op case");
-                    break;
-                }
-            }
+        case kIROp_Eql:
+            executeComparisonOp<VMEqlOp>(frame, &ip);
             break;
 
-        case kIROp_Sub:
-            {
-                VMType type = decodeType(frame, &ip);
-                /*UInt argCount = */decodeUInt(&ip);
-                void* leftPtr = decodeOperandPtr<void>(frame, &ip);
-                void* rightPtr = decodeOperandPtr<void>(frame, &ip);
+        case kIROp_Neq:
+            executeComparisonOp<VMNeqOp>(frame, &ip);
+            break;
 
-                void* destPtr = decodeOperandPtr<void>(frame, &ip);
+        case kIROp_Less:
+            executeComparisonOp<VMLessOp>(frame, &ip);
+            break;
 
-                switch (type.impl->op)
-                {
-                case kIROp_IntType:
-                    *(int32_t*)destPtr = *(int32_t*)leftPtr - *(int32_t*)rightPtr;
-                    break;
+        case kIROp_Greater:
+            executeComparisonOp<VMGreaterOp>(frame, &ip);
+            break;
 
-                default:
-                    SLANG_UNEXPECTED("comparison op case");
-                    break;
-                }
-            }
+        case kIROp_Leq:
+            executeComparisonOp<VMLeqOp>(frame, &ip);
+            break;
+
+        case kIROp_Geq:
+            executeComparisonOp<VMGeqOp>(frame, &ip);
             break;
 
         default:
@@ -1156,15 +2488,13 @@ void resumeThread(
 
                 VMType type = decodeType(frame, &ip);
                 UInt argCount = decodeUInt(&ip);
-                void* argPtrs[16] = { 0 };
                 for( UInt aa = 0; aa < argCount; ++aa )
                 {
-                    void* argPtr = decodeOperandPtr<void>(frame, &ip);
-                    argPtrs[aa] = argPtr;
+                    decodeOperand(frame, &ip);
                 }
 
                 SLANG_UNEXPECTED("unknown bytecode op");
-                return;
+                return kVMThreadStatus_Done;
             }
             break;
         }
@@ -1172,6 +2502,446 @@ void resumeThread(
 
 }
 
+VMThreadStatus resumeThread(
+    VMThread*   vmThread)
+{
+    if( vmThread->profile )
+        return resumeThreadImpl<true>(vmThread);
+    else
+        return resumeThreadImpl<false>(vmThread);
+}
+
+// Dispatching a compute kernel over a grid of thread groups.
+//
+// The groups of a dispatch are shared out between a pool of
+// worker threads. Each worker starts with a contiguous range
+// of group indices, and takes groups from the front of its
+// range. A worker that runs out of work steals the back half
+// of the range of some other worker.
+//
+// All the threads of a group run on a single worker, using
+// VM threads of up to `kVMMaxLaneCount` lanes each. A group
+// barrier suspends a VM thread, and the worker resumes each
+// of the VM threads of the group in turn until all of them
+// have reached the barrier (or finished).
+
+// The range of group indices that a worker has left to run
+struct VMDispatchQueue
+{
+    std::mutex  mutex;
+    UInt        groupBegin;
+    UInt        groupEnd;
+};
+
+struct VMDispatchContext
+{
+    VMFunc*             func;
+    SlangVMDispatchDesc desc;
+
+    UInt                groupCount;
+    UInt                threadsPerGroup;
+    UInt                laneCount;
+
+    UInt                workerCount;
+    VMDispatchQueue*    queues;
+};
+
+// Take the next group for worker `workerIndex` to run, stealing
+// from other workers when its own range is empty. Returns false
+// when there is no work left anywhere.
+bool takeDispatchGroup(
+    VMDispatchContext*  context,
+    UInt                workerIndex,
+    UInt*               outGroupIndex)
+{
+    VMDispatchQueue* queue = &context->queues[workerIndex];
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if( queue->groupBegin < queue->groupEnd )
+        {
+            *outGroupIndex = queue->groupBegin++;
+            return true;
+        }
+    }
+
+    UInt workerCount = context->workerCount;
+    for( UInt ww = 1; ww < workerCount; ++ww )
+    {
+        VMDispatchQueue* victim = &context->queues[(workerIndex + ww) % workerCount];
+
+        UInt stolenBegin = 0;
+        UInt stolenEnd = 0;
+        {
+            std::lock_guard<std::mutex> lock(victim->mutex);
+            UInt remaining = victim->groupEnd - victim->groupBegin;
+            if( remaining == 0 )
+                continue;
+
+            stolenEnd = victim->groupEnd;
+            stolenBegin = stolenEnd - (remaining + 1) / 2;
+            victim->groupEnd = stolenBegin;
+        }
+
+        // We run the first stolen group right away, and
+        // make the rest available from our own range.
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->groupBegin = stolenBegin + 1;
+        queue->groupEnd = stolenEnd;
+
+        *outGroupIndex = stolenBegin;
+        return true;
+    }
+
+    return false;
+}
+
+// Per-worker state that is reused across the groups it runs
+struct VMDispatchWorker
+{
+    VMDispatchContext*  context;
+    UInt                workerIndex;
+
+    // One VM thread for each chunk of lanes in a group
+    List<VMThread*>     threads;
+
+    // Storage for the `groupshared` variables of a group
+    List<char>          groupSharedData;
+    List<void*>         groupSharedPtrs;
+};
+
+void runDispatchGroup(
+    VMDispatchWorker*   worker,
+    UInt                groupIndex)
+{
+    VMDispatchContext* context = worker->context;
+    VMFunc* func = context->func;
+    SlangVMDispatchDesc const& desc = context->desc;
+
+    // Each group starts with zeroed `groupshared` memory.
+    if( worker->groupSharedData.Count() )
+    {
+        memset(worker->groupSharedData.Buffer(), 0, worker->groupSharedData.Count());
+    }
+
+    UInt groupX = groupIndex % desc.groupCount[0];
+    UInt groupY = (groupIndex / desc.groupCount[0]) % desc.groupCount[1];
+    UInt groupZ = groupIndex / (desc.groupCount[0] * desc.groupCount[1]);
+
+    UInt dispatchWidth = desc.groupCount[0] * desc.groupSize[0];
+    UInt dispatchHeight = desc.groupCount[1] * desc.groupSize[1];
+
+    UInt paramCount = func->bcFunc->blocks[0].paramCount;
+
+    UInt threadCount = worker->threads.Count();
+    for( UInt tt = 0; tt < threadCount; ++tt )
+    {
+        VMThread* vmThread = worker->threads[tt];
+        beginCall(vmThread, func);
+
+        UInt laneCount = vmThread->laneCount;
+        for( UInt ll = 0; ll < laneCount; ++ll )
+        {
+            UInt threadInGroup = tt * context->laneCount + ll;
+
+            UInt threadX = threadInGroup % desc.groupSize[0];
+            UInt threadY = (threadInGroup / desc.groupSize[0]) % desc.groupSize[1];
+            UInt threadZ = threadInGroup / (desc.groupSize[0] * desc.groupSize[1]);
+
+            UInt dispatchX = groupX * desc.groupSize[0] + threadX;
+            UInt dispatchY = groupY * desc.groupSize[1] + threadY;
+            UInt dispatchZ = groupZ * desc.groupSize[2] + threadZ;
+
+            uint32_t args[] =
+            {
+                uint32_t(dispatchX + dispatchY * dispatchWidth + dispatchZ * dispatchWidth * dispatchHeight),
+                uint32_t(threadInGroup),
+                uint32_t(groupIndex),
+            };
+            for( UInt pp = 0; pp < paramCount; ++pp )
+            {
+                setLaneArg(vmThread, ll, pp, &args[pp], sizeof(args[pp]));
+            }
+        }
+    }
+
+    // Run the VM threads of the group round-robin, one
+    // barrier at a time, until all of them are done.
+    for(;;)
+    {
+        bool anyAtBarrier = false;
+        for( auto vmThread : worker->threads )
+        {
+            if( !vmThread->frame )
+                continue;
+
+            if( resumeThread(vmThread) == kVMThreadStatus_AtBarrier )
+                anyAtBarrier = true;
+        }
+        if( !anyAtBarrier )
+            break;
+    }
+}
+
+void runDispatchWorker(
+    VMDispatchContext*  context,
+    UInt                workerIndex)
+{
+    VMDispatchWorker worker;
+    worker.context = context;
+    worker.workerIndex = workerIndex;
+
+    VMModule* module = context->func->module;
+    worker.groupSharedData.SetSize(module->groupSharedSize);
+    worker.groupSharedPtrs.SetSize(module->groupSharedCount);
+    for( UInt ii = 0; ii < module->groupSharedCount; ++ii )
+    {
+        worker.groupSharedPtrs[ii] = worker.groupSharedData.Buffer() + module->groupSharedOffsets[ii];
+    }
+
+    for( UInt firstLane = 0; firstLane < context->threadsPerGroup; firstLane += context->laneCount )
+    {
+        UInt laneCount = Math::Min(context->laneCount, context->threadsPerGroup - firstLane);
+        VMThread* vmThread = createThread(module->vm, laneCount);
+        vmThread->groupSharedPtrs = worker.groupSharedPtrs.Buffer();
+        worker.threads.Add(vmThread);
+    }
+
+    UInt groupIndex = 0;
+    while( takeDispatchGroup(context, workerIndex, &groupIndex) )
+    {
+        runDispatchGroup(&worker, groupIndex);
+    }
+
+    for( auto vmThread : worker.threads )
+    {
+        flushThreadProfile(vmThread);
+        destroyThread(vmThread);
+    }
+}
+
+SlangResult dispatch(
+    VMFunc*                     func,
+    SlangVMDispatchDesc const&  desc)
+{
+    if( func->bcFunc->blockCount == 0 )
+        return SLANG_E_INVALID_ARG;
+
+    // Threads are identified by up to three arguments (see `SlangVM_dispatch`)
+    if( func->bcFunc->blocks[0].paramCount > 3 )
+        return SLANG_E_INVALID_ARG;
+
+    VMDispatchContext context;
+    context.func = func;
+    context.desc = desc;
+    context.groupCount = desc.groupCount[0] * desc.groupCount[1] * desc.groupCount[2];
+    context.threadsPerGroup = desc.groupSize[0] * desc.groupSize[1] * desc.groupSize[2];
+    if( context.groupCount == 0 || context.threadsPerGroup == 0 )
+        return SLANG_OK;
+
+    UInt laneCount = desc.laneCount ? desc.laneCount : context.threadsPerGroup;
+    context.laneCount = Math::Min(laneCount, kVMMaxLaneCount);
+
+    UInt workerCount = desc.workerCount;
+    if( !workerCount )
+    {
+        workerCount = std::thread::hardware_concurrency();
+        if( !workerCount )
+            workerCount = 1;
+    }
+    context.workerCount = Math::Min(workerCount, context.groupCount);
+
+    // Share the groups out evenly to start with
+    context.queues = new VMDispatchQueue[context.workerCount];
+    for( UInt ww = 0; ww < context.workerCount; ++ww )
+    {
+        context.queues[ww].groupBegin = (context.groupCount * ww) / context.workerCount;
+        context.queues[ww].groupEnd = (context.groupCount * (ww + 1)) / context.workerCount;
+    }
+
+    // The calling thread acts as the first worker.
+    List<std::thread> workerThreads;
+    for( UInt ww = 1; ww < context.workerCount; ++ww )
+    {
+        workerThreads.Add(std::thread(runDispatchWorker, &context, ww));
+    }
+    runDispatchWorker(&context, 0);
+    for( auto& workerThread : workerThreads )
+    {
+        workerThread.join();
+    }
+
+    delete[] context.queues;
+    return SLANG_OK;
+}
+
+// Profile reports
+
+void setProfilingEnabled(
+    VM*     vm,
+    bool    enabled)
+{
+    vm->profilingEnabled = enabled;
+}
+
+void resetProfile(
+    VM*     vm)
+{
+    std::lock_guard<std::mutex> lock(vm->profileMutex);
+    vm->profile.reset();
+}
+
+char const* getVMFuncName(VMFunc* func)
+{
+    char const* name = func->bcFunc->name;
+    return name ? name : "<unnamed>";
+}
+
+String getCallSiteName(VMCallSite const& site)
+{
+    char buffer[32];
+    sprintf_s(buffer, sizeof(buffer), "+0x%x", (unsigned int) site.offset);
+
+    StringBuilder sb;
+    sb << getVMFuncName(site.caller) << buffer;
+    return sb.ProduceString();
+}
+
+void appendJSONString(StringBuilder& sb, char const* text)
+{
+    sb << '"';
+    for( char const* cursor = text; *cursor; ++cursor )
+    {
+        char c = *cursor;
+        if( c == '"' || c == '\\' )
+            sb << '\\';
+        sb << c;
+    }
+    sb << '"';
+}
+
+void appendProfileTable(StringBuilder& sb, VMProfile const& profile)
+{
+    char line[256];
+
+    List<UInt> opIndices;
+    for( UInt ii = 0; ii < kIROpCount; ++ii )
+    {
+        if( profile.ops[ii].count )
+            opIndices.Add(ii);
+    }
+    opIndices.Sort([&](UInt a, UInt b) { return profile.ops[a].cycles > profile.ops[b].cycles; });
+
+    sprintf_s(line, sizeof(line), "%-32s %16s %16s %12s\n", "op", "count", "cycles", "cycles/op");
+    sb << line;
+    for( auto ii : opIndices )
+    {
+        VMOpProfile const& op = profile.ops[ii];
+        sprintf_s(line, sizeof(line), "%-32s %16llu %16llu %12.1f\n",
+            getIROpInfo((IROp) ii).name,
+            (unsigned long long) op.count,
+            (unsigned long long) op.cycles,
+            double(op.cycles) / double(op.count));
+        sb << line;
+    }
+
+    List<VMFuncProfile> funcs = profile.funcs;
+    funcs.Sort([](VMFuncProfile const& a, VMFuncProfile const& b) { return a.cycles > b.cycles; });
+
+    sprintf_s(line, sizeof(line), "\n%-32s %16s %16s %16s\n", "function", "calls", "instructions", "cycles");
+    sb << line;
+    for( auto const& func : funcs )
+    {
+        sprintf_s(line, sizeof(line), "%-32s %16llu %16llu %16llu\n",
+            getVMFuncName(func.func),
+            (unsigned long long) func.callCount,
+            (unsigned long long) func.instCount,
+            (unsigned long long) func.cycles);
+        sb << line;
+    }
+
+    List<VMCallSiteProfile> callSites = profile.callSites;
+    callSites.Sort([](VMCallSiteProfile const& a, VMCallSiteProfile const& b) { return a.cycles > b.cycles; });
+
+    sprintf_s(line, sizeof(line), "\n%-32s %-32s %16s %16s\n", "call site", "callee", "calls", "cycles");
+    sb << line;
+    for( auto const& callSite : callSites )
+    {
+        sprintf_s(line, sizeof(line), "%-32s %-32s %16llu %16llu\n",
+            getCallSiteName(callSite.site).Buffer(),
+            getVMFuncName(callSite.callee),
+            (unsigned long long) callSite.count,
+            (unsigned long long) callSite.cycles);
+        sb << line;
+    }
+}
+
+void appendProfileJSON(StringBuilder& sb, VMProfile const& profile)
+{
+    sb << "{\n  \"ops\": [";
+    bool first = true;
+    for( UInt ii = 0; ii < kIROpCount; ++ii )
+    {
+        VMOpProfile const& op = profile.ops[ii];
+        if( !op.count )
+            continue;
+
+        sb << (first ? "\n" : ",\n") << "    { \"op\": ";
+        appendJSONString(sb, getIROpInfo((IROp) ii).name);
+        sb << ", \"count\": " << op.count << ", \"cycles\": " << op.cycles << " }";
+        first = false;
+    }
+
+    sb << "\n  ],\n  \"functions\": [";
+    first = true;
+    for( auto const& func : profile.funcs )
+    {
+        sb << (first ? "\n" : ",\n") << "    { \"name\": ";
+        appendJSONString(sb, getVMFuncName(func.func));
+        sb << ", \"calls\": " << func.callCount;
+        sb << ", \"instructions\": " << func.instCount;
+        sb << ", \"cycles\": " << func.cycles << " }";
+        first = false;
+    }
+
+    sb << "\n  ],\n  \"callSites\": [";
+    first = true;
+    for( auto const& callSite : profile.callSites )
+    {
+        sb << (first ? "\n" : ",\n") << "    { \"caller\": ";
+        appendJSONString(sb, getVMFuncName(callSite.site.caller));
+        sb << ", \"offset\": " << UInt64(callSite.site.offset) << ", \"callee\": ";
+        appendJSONString(sb, getVMFuncName(callSite.callee));
+        sb << ", \"calls\": " << callSite.count;
+        sb << ", \"cycles\": " << callSite.cycles << " }";
+        first = false;
+    }
+
+    sb << "\n  ]\n}\n";
+}
+
+char const* getProfileReport(
+    VM*                     vm,
+    SlangVMProfileFormat    format)
+{
+    std::lock_guard<std::mutex> lock(vm->profileMutex);
+
+    StringBuilder sb;
+    switch( format )
+    {
+    default:
+    case SLANG_VM_PROFILE_FORMAT_TABLE:
+        appendProfileTable(sb, vm->profile);
+        break;
+
+    case SLANG_VM_PROFILE_FORMAT_JSON:
+        appendProfileJSON(sb, vm->profile);
+        break;
+    }
+
+    vm->profileReport = sb.ProduceString();
+    return vm->profileReport.Buffer();
+}
+
 
 
 
@@ -1209,11 +2979,61 @@ SLANG_API void* SlangVMModule_findGlobalSymbolPtr(
         name);
 }
 
+SLANG_API SlangResult SlangVM_dispatch(
+    SlangVMModule*              module,
+    SlangVMFunc*                func,
+    SlangVMDispatchDesc const*  desc)
+{
+    if (!module || !func || !desc)
+        return SLANG_E_INVALID_ARG;
+    if (((Slang::VMFunc*) func)->module != (Slang::VMModule*) module)
+        return SLANG_E_INVALID_ARG;
+
+    return Slang::dispatch(
+        (Slang::VMFunc*) func,
+        *desc);
+}
+
+SLANG_API void SlangVM_setProfilingEnabled(
+    SlangVM*    vm,
+    int         enable)
+{
+    Slang::setProfilingEnabled(
+        (Slang::VM*) vm,
+        enable != 0);
+}
+
+SLANG_API void SlangVM_resetProfile(
+    SlangVM*    vm)
+{
+    Slang::resetProfile(
+        (Slang::VM*) vm);
+}
+
+SLANG_API char const* SlangVM_getProfileReport(
+    SlangVM*                vm,
+    SlangVMProfileFormat    format)
+{
+    return Slang::getProfileReport(
+        (Slang::VM*) vm,
+        format);
+}
+
 SLANG_API SlangVMThread* SlangVMThread_create(
     SlangVM*    vm)
 {
     return (SlangVMThread*)Slang::createThread(
-        (Slang::VM*) vm);
+        (Slang::VM*) vm,
+        1);
+}
+
+SLANG_API SlangVMThread* SlangVMThread_createWithLanes(
+    SlangVM*    vm,
+    SlangUInt   laneCount)
+{
+    return (SlangVMThread*)Slang::createThread(
+        (Slang::VM*) vm,
+        laneCount);
 }
 
 SLANG_API void SlangVMThread_beginCall(
@@ -1238,9 +3058,26 @@ SLANG_API void SlangVMThread_setArg(
         size);
 }
 
+SLANG_API void SlangVMThread_setLaneArg(
+    SlangVMThread*  thread,
+    SlangUInt       laneIndex,
+    SlangUInt       argIndex,
+    void const*     data,
+    size_t          size)
+{
+    Slang::setLaneArg(
+        (Slang::VMThread*)  thread,
+        laneIndex,
+        argIndex,
+        data,
+        size);
+}
+
 SLANG_API void SlangVMThread_resume(
     SlangVMThread*  thread)
 {
     Slang::resumeThread(
         (Slang::VMThread*)  thread);
+    Slang::flushThreadProfile(
+        (Slang::VMThread*)  thread);
 }
@@ -31,6 +31,23 @@ static void diagnosticCallback(
 
 static SlangResult innerMain(int argc, char** argv)
 {
+    // Building an archive doesn't involve a compile request:
+    //     slangc -build-archive <directory> <archive>
+    if (argc > 1 && strcmp(argv[1], "-build-archive") == 0)
+    {
+        if (argc != 4)
+        {
+            fprintf(stderr, "usage: slangc -build-archive <directory> <archive>\n");
+            return SLANG_E_INVALID_ARG;
+        }
+        const SlangResult res = spCreateArchiveFromDirectory(argv[2], argv[3]);
+        if (SLANG_FAILED(res))
+        {
+            fprintf(stderr, "error: unable to build archive '%s' from '%s'\n", argv[3], argv[2]);
+        }
+        return res;
+    }
+
     // Parse any command-line options
 
     SlangSession* session = spCreateSession(nullptr);
@@ -94,7 +94,7 @@ RefPtr<ShaderProgram> ShaderCompiler::compileProgram(
 
     RefPtr<ShaderProgram> shaderProgram;
     Slang::List<const char*> rawTypeNames;
-    for (auto typeName : request.entryPointTypeArguments)
+    for (auto& typeName : request.entryPointTypeArguments)
         rawTypeNames.Add(typeName.Buffer());
     if (request.computeShader.name)
     {
@@ -3,29 +3,360 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "../../source/core/secure-crt.h"
+#include "../../source/core/slang-shared-library.h"
 #include <slang.h>
+#include <slang-com-ptr.h>
+#include <slang-cpp-prelude.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Run `func` over `threadCount` threads with `SlangVM_dispatch`,
+// returning the time taken in milliseconds.
+static double dispatchThreads(
+    SlangVMModule*  vmModule,
+    SlangVMFunc*    vmFunc,
+    uint32_t        threadCount,
+    uint32_t        groupSize,
+    uint32_t        laneCount,
+    uint32_t        workerCount)
+{
+    SlangVMDispatchDesc desc = {};
+    desc.groupCount[0] = (threadCount + groupSize - 1) / groupSize;
+    desc.groupCount[1] = 1;
+    desc.groupCount[2] = 1;
+    desc.groupSize[0] = groupSize;
+    desc.groupSize[1] = 1;
+    desc.groupSize[2] = 1;
+    desc.laneCount = laneCount;
+    desc.workerCount = workerCount;
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    SlangVM_dispatch(vmModule, vmFunc, &desc);
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    return std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
 
-static SlangResult innerMain(int argc, char*const* argv)
+// Owns a session and a compile request for it, so both are
+// destroyed however we return.
+struct CompileSession
+{
+    CompileSession()
+    {
+        session = spCreateSession(nullptr);
+        request = spCreateCompileRequest(session);
+    }
+    ~CompileSession()
+    {
+        spDestroyCompileRequest(request);
+        spDestroySession(session);
+    }
+
+    SlangSession*           session;
+    SlangCompileRequest*    request;
+};
+
+static bool fileExists(std::string const& path)
+{
+    FILE* file;
+    fopen_s(&file, path.c_str(), "rb");
+    if (!file)
+        return false;
+    fclose(file);
+    return true;
+}
+
+// Find the directory holding `slang-cpp-prelude.h`, which generated C++
+// is compiled against. That is `preludeDirOption` if it was given,
+// otherwise the `SLANG_ROOT` environment variable if set, otherwise the
+// first directory containing the prelude found searching upwards from
+// the executable (normally the root of the source tree, three levels up
+// from e.g. `bin/linux-x64/release/`).
+static SlangResult findPreludeDir(
+    char const*     exePath,
+    char const*     preludeDirOption,
+    std::string&    outPreludeDir)
 {
-    // TODO: parse arguments
+    if (preludeDirOption)
+    {
+        outPreludeDir = preludeDirOption;
+        return SLANG_OK;
+    }
+
+    if (char const* rootDir = getenv("SLANG_ROOT"))
+    {
+        outPreludeDir = rootDir;
+        return SLANG_OK;
+    }
+
+    std::string dir = exePath;
+    size_t slashIndex = dir.find_last_of("/\\");
+    dir = (slashIndex == std::string::npos) ? std::string(".") : dir.substr(0, slashIndex);
+    for (int ii = 0; ii < 8; ++ii)
+    {
+        if (fileExists(dir + "/slang-cpp-prelude.h"))
+        {
+            outPreludeDir = dir;
+            return SLANG_OK;
+        }
+        dir += "/..";
+    }
+
+    fprintf(stderr, "unable to find 'slang-cpp-prelude.h', use -prelude-dir or set SLANG_ROOT\n");
+    return SLANG_FAIL;
+}
+
+// Compile the kernel in `inputText` to C++, build that into a shared
+// library with the system C++ compiler, and run it on the CPU.
+static SlangResult runKernelAsCPP(
+    char const*     exePath,
+    char const*     preludeDirOption,
+    char const*     inputPath,
+    char const*     inputText,
+    uint32_t        threadCount)
+{
+    std::string preludeDir;
+    SLANG_RETURN_ON_FAIL(findPreludeDir(exePath, preludeDirOption, preludeDir));
+
+    CompileSession compileSession;
+    SlangSession* session = compileSession.session;
+    SlangCompileRequest* request = compileSession.request;
+
+    spSetCodeGenTarget(request, SLANG_CPP_SOURCE);
+
+    int translationUnitIndex = spAddTranslationUnit(
+        request,
+        SLANG_SOURCE_LANGUAGE_SLANG,
+        nullptr);
+
+    spAddTranslationUnitSourceString(
+        request,
+        translationUnitIndex,
+        inputPath,
+        inputText);
+
+    int entryPointIndex = spAddEntryPoint(
+        request,
+        translationUnitIndex,
+        "main",
+        spFindProfile(session, "cs_5_0"));
 
+    if (SLANG_FAILED(spCompile(request)))
+    {
+        char const* output = spGetDiagnosticOutput(request);
+        fputs(output, stderr);
+        return SLANG_FAIL;
+    }
+
+    // Write out the generated code next to the library we are going to build
+#ifdef _WIN32
+    char const* tempDir = getenv("TEMP");
+#else
+    char const* tempDir = getenv("TMPDIR");
+#endif
+    std::string basePath = std::string(tempDir ? tempDir : "/tmp") + "/slang-eval-test-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::string sourcePath = basePath + ".cpp";
+
+    FILE* sourceFile;
+    fopen_s(&sourceFile, sourcePath.c_str(), "wb");
+    if (!sourceFile)
+    {
+        fprintf(stderr, "unable to write '%s'\n", sourcePath.c_str());
+        return SLANG_FAIL;
+    }
+    fputs(spGetEntryPointSource(request, entryPointIndex), sourceFile);
+    fclose(sourceFile);
+
+    // Build it, naming the library the way `ISlangSharedLibraryLoader` expects
+#ifdef _WIN32
+    std::string libraryPath = basePath + ".dll";
+    std::string command = "cl /nologo /LD /O2 /EHsc /I\"" + preludeDir + "\" \"" + sourcePath + "\" /Fe\"" + libraryPath + "\" > NUL";
+#else
+    size_t fileNameIndex = basePath.find_last_of('/') + 1;
+    std::string libraryPath = basePath.substr(0, fileNameIndex) + "lib" + basePath.substr(fileNameIndex) + ".so";
+    char const* compiler = getenv("CXX");
+    std::string command = std::string(compiler ? compiler : "c++") + " -std=c++11 -O2 -shared -fPIC -w -I'" + preludeDir + "' -o '" + libraryPath + "' '" + sourcePath + "'";
+#endif
+    int compileStatus = system(command.c_str());
+    remove(sourcePath.c_str());
+    if (compileStatus != 0)
+    {
+        fprintf(stderr, "failed to compile generated C++: %s\n", command.c_str());
+        return SLANG_FAIL;
+    }
+
+    ISlangSharedLibraryLoader* loader = spSessionGetSharedLibraryLoader(session);
+    if (!loader)
+    {
+        loader = Slang::DefaultSharedLibraryLoader::getSingleton();
+    }
+
+    Slang::ComPtr<ISlangSharedLibrary> library;
+    if (SLANG_FAILED(loader->loadSharedLibrary(basePath.c_str(), library.writeRef())))
+    {
+        fprintf(stderr, "failed to load '%s'\n", libraryPath.c_str());
+        remove(libraryPath.c_str());
+        return SLANG_FAIL;
+    }
+
+    typedef void* (*FindGlobalParamFunc)(char const* name);
+    typedef void (*GetThreadGroupSizeFunc)(uint32_t* outSize);
+    typedef void (*DispatchFunc)(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
+
+    auto findGlobalParam = (FindGlobalParamFunc)library->findFuncByName("slang_findGlobalParam");
+    auto getThreadGroupSize = (GetThreadGroupSizeFunc)library->findFuncByName("slang_getThreadGroupSize");
+    auto dispatch = (DispatchFunc)library->findFuncByName("slang_dispatch");
+    if (!findGlobalParam || !getThreadGroupSize || !dispatch)
+    {
+        fprintf(stderr, "generated library is missing entry points\n");
+        library.setNull();
+        remove(libraryPath.c_str());
+        return SLANG_FAIL;
+    }
+
+    uint32_t groupSize[3];
+    getThreadGroupSize(groupSize);
+
+    uint32_t groupCount = (threadCount + groupSize[0] - 1) / groupSize[0];
+    uint32_t bufferCount = groupCount * groupSize[0];
+
+    std::vector<int32_t> inputData(bufferCount);
+    std::vector<int32_t> outputData(bufferCount);
+    for (uint32_t ii = 0; ii < bufferCount; ++ii)
+    {
+        inputData[ii] = int32_t(ii % 8);
+    }
+
+    if (auto inputArg = (SlangCPP::StructuredBuffer<int32_t>*)findGlobalParam("input"))
+    {
+        inputArg->data = inputData.data();
+        inputArg->count = bufferCount;
+    }
+    if (auto outputArg = (SlangCPP::RWStructuredBuffer<int32_t>*)findGlobalParam("output"))
+    {
+        outputArg->data = outputData.data();
+        outputArg->count = bufferCount;
+    }
+
+    dispatch(groupCount, 1, 1);
+
+    for (uint32_t ii = 0; ii < threadCount; ++ii)
+    {
+        fprintf(stdout, "outputData[%u] = %d\n", ii, outputData[ii]);
+    }
+
+    library.setNull();
+    remove(libraryPath.c_str());
+
+    return SLANG_OK;
+}
+
+static SlangResult innerMain(int argc, char*const* argv)
+{
     assert(argc >= 2);
     char const* inputPath = argv[1];
 
+    // The number of invocations to run in lockstep on each VM thread
+    uint32_t laneCount = 1;
+
+    // The number of invocations of the kernel to run
+    uint32_t threadCount = 8;
+
+    // Options for running the kernel with `SlangVM_dispatch`
+    bool useDispatch = false;
+    uint32_t groupSize = 1;
+    uint32_t workerCount = 0;
+
+    // Time dispatches with 1 to N workers, instead of printing output
+    bool benchmark = false;
+
+    // Print a VM profile report to stderr after running the kernel
+    bool profile = false;
+    SlangVMProfileFormat profileFormat = SLANG_VM_PROFILE_FORMAT_TABLE;
+
+    // Compile the kernel to C++ and run it natively, instead of in the VM
+    bool useCPP = false;
+    char const* preludeDir = nullptr;
+
+    for (int aa = 2; aa < argc; ++aa)
+    {
+        if (strcmp(argv[aa], "-lanes") == 0 && aa + 1 < argc)
+        {
+            laneCount = (uint32_t)atoi(argv[++aa]);
+        }
+        else if (strcmp(argv[aa], "-threads") == 0 && aa + 1 < argc)
+        {
+            threadCount = (uint32_t)atoi(argv[++aa]);
+        }
+        else if (strcmp(argv[aa], "-dispatch") == 0)
+        {
+            useDispatch = true;
+        }
+        else if (strcmp(argv[aa], "-group-size") == 0 && aa + 1 < argc)
+        {
+            groupSize = (uint32_t)atoi(argv[++aa]);
+        }
+        else if (strcmp(argv[aa], "-workers") == 0 && aa + 1 < argc)
+        {
+            workerCount = (uint32_t)atoi(argv[++aa]);
+        }
+        else if (strcmp(argv[aa], "-benchmark") == 0)
+        {
+            useDispatch = true;
+            benchmark = true;
+        }
+        else if (strcmp(argv[aa], "-profile") == 0)
+        {
+            profile = true;
+        }
+        else if (strcmp(argv[aa], "-profile-json") == 0)
+        {
+            profile = true;
+            profileFormat = SLANG_VM_PROFILE_FORMAT_JSON;
+        }
+        else if (strcmp(argv[aa], "-cpp") == 0)
+        {
+            useCPP = true;
+        }
+        else if (strcmp(argv[aa], "-prelude-dir") == 0 && aa + 1 < argc)
+        {
+            preludeDir = argv[++aa];
+        }
+        else
+        {
+            fprintf(stderr, "unknown option '%s'\n", argv[aa]);
+            return SLANG_FAIL;
+        }
+    }
+
     // Slurp in the input file, so that we can compile and run it
     FILE* inputFile;
     fopen_s(&inputFile, inputPath, "rb");
-    assert(inputFile);
+    if (!inputFile)
+    {
+        fprintf(stderr, "unable to read '%s'\n", inputPath);
+        return SLANG_FAIL;
+    }
 
     fseek(inputFile, 0, SEEK_END);
     size_t inputSize = ftell(inputFile);
     fseek(inputFile, 0, SEEK_SET);
 
-    char* inputText = (char*)malloc(inputSize + 1);
-    fread(inputText, inputSize, 1, inputFile);
-    inputText[inputSize] = 0;
+    std::vector<char> inputBuffer(inputSize + 1);
+    fread(inputBuffer.data(), inputSize, 1, inputFile);
+    inputBuffer[inputSize] = 0;
     fclose(inputFile);
+    char const* inputText = inputBuffer.data();
+
+    if (useCPP)
+    {
+        return runKernelAsCPP(argv[0], preludeDir, inputPath, inputText, threadCount);
+    }
 
     // TODO: scan through the text to find comments,
     // that instruct us how to generate input and
@@ -33,8 +364,9 @@ static SlangResult innerMain(int argc, char*const* argv)
 
     //
 
-    SlangSession* session = spCreateSession(nullptr);
-    SlangCompileRequest* request = spCreateCompileRequest(session);
+    CompileSession compileSession;
+    SlangSession* session = compileSession.session;
+    SlangCompileRequest* request = compileSession.request;
 
     spSetOutputContainerFormat(
         request,
@@ -73,6 +405,7 @@ static SlangResult innerMain(int argc, char*const* argv)
     // Now we need to create an execution context to go and run the bytecode we got
 
     SlangVM* vm = SlangVM_create();
+    SlangVM_setProfilingEnabled(vm, profile);
 
     SlangVMModule* vmModule = SlangVMModule_load(
         vm,
@@ -91,41 +424,93 @@ static SlangResult innerMain(int argc, char*const* argv)
         vmModule,
         "output");
 
-    SlangVMThread* vmThread = SlangVMThread_create(
-        vm);
+    // The kernel output is made a whole number of groups long, in
+    // case the last group runs past the requested number of threads.
+    uint32_t outputCount = ((threadCount + groupSize - 1) / groupSize) * groupSize;
 
-    int32_t inputData[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
-    int32_t outputData[8] = { 0 };
+    std::vector<int32_t> inputData(outputCount);
+    std::vector<int32_t> outputData(outputCount);
+    for (uint32_t ii = 0; ii < outputCount; ++ii)
+    {
+        inputData[ii] = int32_t(ii % 8);
+    }
 
-    inputArg = inputData;
-    outputArg = outputData;
+    inputArg = inputData.data();
+    outputArg = outputData.data();
 
-    // TODO: set arguments based on specification from the user...
-    for (uint32_t threadID = 0; threadID < 8; ++threadID)
+    if (benchmark)
     {
-#if 0
-        fprintf(stderr, "\n\nthreadID = %u\n\n", threadID);
-        fflush(stderr);
-#endif
+        uint32_t maxWorkerCount = workerCount ? workerCount : std::thread::hardware_concurrency();
+        if (maxWorkerCount == 0)
+            maxWorkerCount = 1;
 
-        SlangVMThread_beginCall(vmThread, vmFunc);
+        double baseTime = 0;
+        for (uint32_t ww = 1; ww <= maxWorkerCount; ++ww)
+        {
+            double time = dispatchThreads(vmModule, vmFunc, threadCount, groupSize, laneCount, ww);
+            if (ww == 1)
+                baseTime = time;
 
-        SlangVMThread_setArg(
-            vmThread,
-            0,
-            &threadID,
-            sizeof(threadID));
+            fprintf(stdout, "workers = %u: %.3f ms (speedup %.2fx)\n", ww, time, baseTime / time);
+        }
 
-        SlangVMThread_resume(vmThread);
+        return SLANG_OK;
     }
 
-    for (uint32_t ii = 0; ii < 8; ++ii)
+    if (useDispatch)
+    {
+        dispatchThreads(vmModule, vmFunc, threadCount, groupSize, laneCount, workerCount);
+    }
+    else
+    {
+        SlangVMThread* vmThread = SlangVMThread_createWithLanes(
+            vm,
+            laneCount);
+        if (!vmThread)
+        {
+            fprintf(stderr, "invalid lane count %u\n", laneCount);
+            return SLANG_FAIL;
+        }
+
+        // TODO: set arguments based on specification from the user...
+        for (uint32_t baseThreadID = 0; baseThreadID < threadCount; baseThreadID += laneCount)
+        {
+#if 0
+            fprintf(stderr, "\n\nthreadID = %u\n\n", baseThreadID);
+            fflush(stderr);
+#endif
+
+            SlangVMThread_beginCall(vmThread, vmFunc);
+
+            // Lanes past the end of the dispatch re-run the
+            // last thread, which writes the same result.
+            for (uint32_t laneIndex = 0; laneIndex < laneCount; ++laneIndex)
+            {
+                uint32_t threadID = baseThreadID + laneIndex;
+                if (threadID >= threadCount)
+                    threadID = threadCount - 1;
+
+                SlangVMThread_setLaneArg(
+                    vmThread,
+                    laneIndex,
+                    0,
+                    &threadID,
+                    sizeof(threadID));
+            }
+
+            SlangVMThread_resume(vmThread);
+        }
+    }
+
+    for (uint32_t ii = 0; ii < threadCount; ++ii)
     {
         fprintf(stdout, "outputData[%u] = %d\n", ii, outputData[ii]);
     }
 
-    spDestroyCompileRequest(request);
-    spDestroySession(session);
+    if (profile)
+    {
+        fprintf(stderr, "%s", SlangVM_getProfileReport(vm, profileFormat));
+    }
 
     return SLANG_OK;
 }
@@ -5,8 +5,13 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <string>
+#include <vector>
+
 #include <slang.h>
 #include <slang-com-helper.h>
+#include <slang-com-ptr.h>
+#include <slang-flat-reflection.h>
 
 struct PrettyWriter
 {
@@ -80,9 +85,27 @@ static void write(PrettyWriter& writer, SlangUInt val)
     fprintf(stdout, "%llu", (unsigned long long)val);
 }
 
-static void emitReflectionVarInfoJSON(PrettyWriter& writer, slang::VariableReflection* var);
-static void emitReflectionTypeLayoutJSON(PrettyWriter& writer, slang::TypeLayoutReflection* type);
-static void emitReflectionTypeJSON(PrettyWriter& writer, slang::TypeReflection* type);
+// The JSON is emitted either through the reflection API, or by walking the flat reflection
+// blob (see `slang-flat-reflection.h`), whose types mirror the API. So the emit functions
+// are templated on the (pointer) type of the reflection object they are passed, and
+// both ways must produce exactly the same output.
+
+template<typename VariableReflectionPtr>
+static void emitReflectionVarInfoJSON(PrettyWriter& writer, VariableReflectionPtr var);
+template<typename TypeLayoutReflectionPtr>
+static void emitReflectionTypeLayoutJSON(PrettyWriter& writer, TypeLayoutReflectionPtr type);
+template<typename TypeReflectionPtr>
+static void emitReflectionTypeJSON(PrettyWriter& writer, TypeReflectionPtr type);
+
+static bool isShared(slang::VariableReflection* var)
+{
+    return var->findModifier(slang::Modifier::Shared) != nullptr;
+}
+
+static bool isShared(slang::flat::VariableReflection const* var)
+{
+    return var && var->hasModifier(slang::Modifier::Shared);
+}
 
 static void emitReflectionVarBindingInfoJSON(
     PrettyWriter&           writer,
@@ -146,9 +169,10 @@ static void emitReflectionVarBindingInfoJSON(
     }
 }
 
+template<typename VariableLayoutReflectionPtr>
 static void emitReflectionVarBindingInfoJSON(
     PrettyWriter&                       writer,
-    slang::VariableLayoutReflection*    var)
+    VariableLayoutReflectionPtr    var)
 {
     auto stage = var->getStage();
     if (stage != SLANG_STAGE_NONE)
@@ -241,19 +265,21 @@ static void emitReflectionNameInfoJSON(
     write(writer, "\"");
 }
 
+template<typename VariableReflectionPtr>
 static void emitReflectionModifierInfoJSON(
     PrettyWriter&               writer,
-    slang::VariableReflection*  var)
+    VariableReflectionPtr       var)
 {
-    if( var->findModifier(slang::Modifier::Shared) )
+    if( isShared(var) )
     {
         write(writer, ",\n\"shared\": true");
     }
 }
 
+template<typename VariableLayoutReflectionPtr>
 static void emitReflectionVarLayoutJSON(
     PrettyWriter&                       writer,
-    slang::VariableLayoutReflection*    var)
+    VariableLayoutReflectionPtr    var)
 {
     write(writer, "{\n");
     indent(writer);
@@ -298,9 +324,10 @@ static void emitReflectionScalarTypeInfoJSON(
     write(writer, "\"");
 }
 
+template<typename TypeReflectionPtr>
 static void emitReflectionTypeInfoJSON(
     PrettyWriter&           writer,
-    slang::TypeReflection*  type)
+    TypeReflectionPtr  type)
 {
     auto kind = type->getKind();
     switch(kind)
@@ -486,9 +513,10 @@ static void emitReflectionTypeInfoJSON(
     }
 }
 
+template<typename TypeLayoutReflectionPtr>
 static void emitReflectionTypeLayoutInfoJSON(
     PrettyWriter&                   writer,
-    slang::TypeLayoutReflection*    typeLayout)
+    TypeLayoutReflectionPtr    typeLayout)
 {
     switch( typeLayout->getKind() )
     {
@@ -594,9 +622,10 @@ static void emitReflectionTypeLayoutInfoJSON(
     // TODO: emit size info for types
 }
 
+template<typename TypeLayoutReflectionPtr>
 static void emitReflectionTypeLayoutJSON(
     PrettyWriter&                   writer,
-    slang::TypeLayoutReflection*    typeLayout)
+    TypeLayoutReflectionPtr    typeLayout)
 {
     write(writer, "{\n");
     indent(writer);
@@ -605,9 +634,10 @@ static void emitReflectionTypeLayoutJSON(
     write(writer, "\n}");
 }
 
+template<typename TypeReflectionPtr>
 static void emitReflectionTypeJSON(
     PrettyWriter&           writer,
-    slang::TypeReflection*  type)
+    TypeReflectionPtr  type)
 {
     write(writer, "{\n");
     indent(writer);
@@ -616,9 +646,10 @@ static void emitReflectionTypeJSON(
     write(writer, "\n}");
 }
 
+template<typename VariableReflectionPtr>
 static void emitReflectionVarInfoJSON(
     PrettyWriter&               writer,
-    slang::VariableReflection*  var)
+    VariableReflectionPtr  var)
 {
     emitReflectionNameInfoJSON(writer, var->getName());
 
@@ -629,9 +660,10 @@ static void emitReflectionVarInfoJSON(
     emitReflectionTypeJSON(writer, var->getType());
 }
 
+template<typename VariableLayoutReflectionPtr>
 static void emitReflectionParamJSON(
     PrettyWriter&                       writer,
-    slang::VariableLayoutReflection*    param)
+    VariableLayoutReflectionPtr    param)
 {
     write(writer, "{\n");
     indent(writer);
@@ -700,9 +732,10 @@ Range<T> range(T end)
     return Range<T>(T(0), end);
 }
 
+template<typename TypeParameterReflectionPtr>
 static void emitReflectionTypeParamJSON(
     PrettyWriter&                   writer,
-    slang::TypeParameterReflection* typeParam)
+    TypeParameterReflectionPtr typeParam)
 {
     write(writer, "{\n");
     indent(writer);
@@ -727,9 +760,10 @@ static void emitReflectionTypeParamJSON(
     write(writer, "\n}");
 }
 
+template<typename EntryPointReflectionPtr>
 static void emitReflectionEntryPointJSON(
     PrettyWriter&                   writer,
-    slang::EntryPointReflection*    entryPoint)
+    EntryPointReflectionPtr    entryPoint)
 {
     write(writer, "{\n");
     indent(writer);
@@ -788,9 +822,259 @@ static void emitReflectionEntryPointJSON(
     write(writer, "\n}");
 }
 
+// A name that isn't used by any of the tests
+static char const* const kMissingName = "notDeclaredAnywhere";
+
+// Writes the start of an item in the "lookups" list
+static void beginLookupJSON(
+    PrettyWriter&   writer,
+    bool&           isFirst)
+{
+    if (!isFirst) write(writer, ",\n");
+    isFirst = false;
+}
+
+static void emitLookupJSON(
+    PrettyWriter&       writer,
+    bool&               isFirst,
+    std::string const&  scope,
+    char const*         name,
+    SlangInt            index)
+{
+    beginLookupJSON(writer, isFirst);
+    write(writer, "{\"scope\": \"");
+    write(writer, scope.c_str());
+    write(writer, "\", \"name\": \"");
+    write(writer, name);
+    write(writer, "\", \"index\": ");
+    if (index < 0)
+    {
+        write(writer, "null");
+    }
+    else
+    {
+        write(writer, SlangUInt(index));
+    }
+    write(writer, "}");
+}
+
+// Find the parameter of `scope` (the program or an entry point) called `name`, returning
+// its index, or -1 if there isn't one
+template<typename ScopePtr>
+static SlangInt findParameterIndexByName(
+    ScopePtr        scope,
+    char const*     name)
+{
+    auto parameter = scope->findParameterByName(name);
+    if (!parameter)
+        return -1;
+
+    for (auto pp : range(scope->getParameterCount()))
+    {
+        if (scope->getParameterByIndex(pp) == parameter)
+            return SlangInt(pp);
+    }
+    // Found something that isn't one of the parameters
+    assert(!"unexpected parameter");
+    return SlangInt(scope->getParameterCount());
+}
+
+// Looks up every parameter of `scope` by name (and a name that isn't a parameter)
+template<typename ScopePtr>
+static void emitParameterLookupsJSON(
+    PrettyWriter&       writer,
+    bool&               isFirst,
+    char const*         scopeName,
+    ScopePtr            scope)
+{
+    for (auto pp : range(scope->getParameterCount()))
+    {
+        if (auto name = scope->getParameterByIndex(pp)->getName())
+        {
+            emitLookupJSON(writer, isFirst, scopeName, name, findParameterIndexByName(scope, name));
+        }
+    }
+    emitLookupJSON(writer, isFirst, scopeName, kMissingName, findParameterIndexByName(scope, kMissingName));
+}
+
+// Looks up every field of every struct in `typeLayout` by name (and a name that isn't a
+// field), and adds the names of the structs to `outTypeNames`
+template<typename TypeLayoutReflectionPtr>
+static void emitFieldLookupsJSON(
+    PrettyWriter&               writer,
+    bool&                       isFirst,
+    std::string const&          path,
+    TypeLayoutReflectionPtr     typeLayout,
+    std::vector<std::string>&   outTypeNames)
+{
+    if (!typeLayout)
+        return;
+
+    switch (typeLayout->getKind())
+    {
+    case slang::TypeReflection::Kind::Struct:
+        {
+            if (auto typeName = typeLayout->getName())
+            {
+                bool isNew = true;
+                for (auto const& name : outTypeNames)
+                    isNew = isNew && name != typeName;
+                if (isNew)
+                    outTypeNames.push_back(typeName);
+            }
+
+            auto fieldCount = typeLayout->getFieldCount();
+            for (uint32_t ff = 0; ff < fieldCount; ++ff)
+            {
+                auto field = typeLayout->getFieldByIndex(ff);
+                if (auto name = field->getName())
+                {
+                    emitLookupJSON(writer, isFirst, path, name, typeLayout->findFieldIndexByName(name));
+                    emitFieldLookupsJSON(writer, isFirst, path + "." + name, field->getTypeLayout(), outTypeNames);
+                }
+            }
+            emitLookupJSON(writer, isFirst, path, kMissingName, typeLayout->findFieldIndexByName(kMissingName));
+        }
+        break;
+
+    case slang::TypeReflection::Kind::Array:
+        emitFieldLookupsJSON(writer, isFirst, path + "[]", typeLayout->getElementTypeLayout(), outTypeNames);
+        break;
+
+    case slang::TypeReflection::Kind::ConstantBuffer:
+    case slang::TypeReflection::Kind::ParameterBlock:
+    case slang::TypeReflection::Kind::TextureBuffer:
+    case slang::TypeReflection::Kind::ShaderStorageBuffer:
+        emitFieldLookupsJSON(writer, isFirst, path, typeLayout->getElementTypeLayout(), outTypeNames);
+        break;
+
+    default:
+        break;
+    }
+}
+
+template<typename ScopePtr>
+static void emitParameterFieldLookupsJSON(
+    PrettyWriter&               writer,
+    bool&                       isFirst,
+    std::string const&          pathPrefix,
+    ScopePtr                    scope,
+    std::vector<std::string>&   outTypeNames)
+{
+    for (auto pp : range(scope->getParameterCount()))
+    {
+        auto parameter = scope->getParameterByIndex(pp);
+        if (auto name = parameter->getName())
+        {
+            emitFieldLookupsJSON(writer, isFirst, pathPrefix + name, parameter->getTypeLayout(), outTypeNames);
+        }
+    }
+}
+
+static char const* findTypeNameByName(
+    slang::ShaderReflection*            programReflection,
+    std::vector<std::string> const&     /* typeNames */,
+    char const*                         name)
+{
+    auto type = programReflection->findTypeByName(name);
+    return type ? type->getName() : nullptr;
+}
+
+// The flat format can't look up types by name (as that needs the compiler), so just
+// find the types it holds that are reached from the parameters
+static char const* findTypeNameByName(
+    slang::flat::ShaderReflection const*    /* programReflection */,
+    std::vector<std::string> const&         typeNames,
+    char const*                             name)
+{
+    for (auto const& typeName : typeNames)
+    {
+        if (typeName == name)
+            return typeName.c_str();
+    }
+    return nullptr;
+}
+
+template<typename ShaderReflectionPtr>
+static void emitTypeLookupJSON(
+    PrettyWriter&                       writer,
+    bool&                               isFirst,
+    ShaderReflectionPtr                 programReflection,
+    std::vector<std::string> const&     typeNames,
+    char const*                         name)
+{
+    beginLookupJSON(writer, isFirst);
+    write(writer, "{\"type\": \"");
+    write(writer, name);
+    write(writer, "\", \"found\": ");
+    if (auto foundName = findTypeNameByName(programReflection, typeNames, name))
+    {
+        write(writer, "\"");
+        write(writer, foundName);
+        write(writer, "\"");
+    }
+    else
+    {
+        write(writer, "null");
+    }
+    write(writer, "}");
+}
+
+// Emits the results of looking up everything by name, which should be the same as
+// what is found by index
+template<typename ShaderReflectionPtr>
+static void emitLookupsJSON(
+    PrettyWriter&               writer,
+    ShaderReflectionPtr         programReflection)
+{
+    write(writer, "\"lookups\": [\n");
+    indent(writer);
+
+    bool isFirst = true;
+    std::vector<std::string> typeNames;
+
+    emitParameterLookupsJSON(writer, isFirst, "(global)", programReflection);
+    emitParameterFieldLookupsJSON(writer, isFirst, "", programReflection, typeNames);
+
+    auto entryPointCount = programReflection->getEntryPointCount();
+    for (auto ee : range(entryPointCount))
+    {
+        auto entryPoint = programReflection->getEntryPointByIndex(ee);
+        auto entryPointName = entryPoint->getName();
+
+        beginLookupJSON(writer, isFirst);
+        write(writer, "{\"entryPoint\": \"");
+        write(writer, entryPointName);
+        write(writer, "\", \"index\": ");
+        auto foundEntryPoint = programReflection->findEntryPointByName(entryPointName);
+        SlangInt index = -1;
+        for (auto ii : range(entryPointCount))
+        {
+            if (programReflection->getEntryPointByIndex(ii) == foundEntryPoint)
+                index = SlangInt(ii);
+        }
+        write(writer, SlangUInt(index));
+        write(writer, "}");
+
+        emitParameterLookupsJSON(writer, isFirst, entryPointName, entryPoint);
+        emitParameterFieldLookupsJSON(writer, isFirst, std::string(entryPointName) + ":", entryPoint, typeNames);
+    }
+
+    for (auto const& typeName : typeNames)
+    {
+        emitTypeLookupJSON(writer, isFirst, programReflection, typeNames, typeName.c_str());
+    }
+    emitTypeLookupJSON(writer, isFirst, programReflection, typeNames, kMissingName);
+
+    dedent(writer);
+    write(writer, "\n]");
+}
+
+template<typename ShaderReflectionPtr>
 static void emitReflectionJSON(
     PrettyWriter&               writer,
-    slang::ShaderReflection*    programReflection)
+    ShaderReflectionPtr         programReflection,
+    bool                        emitLookups)
 {
     write(writer, "{\n");
     indent(writer);
@@ -843,17 +1127,43 @@ static void emitReflectionJSON(
         dedent(writer);
         write(writer, "\n]");
     }
+
+    if (emitLookups)
+    {
+        write(writer, ",\n");
+        emitLookupsJSON(writer, programReflection);
+    }
+
     dedent(writer);
     write(writer, "\n}\n");
 }
 
 void emitReflectionJSON(
-    SlangReflection*    reflection)
+    SlangReflection*    reflection,
+    bool                emitLookups)
 {
     auto programReflection = (slang::ShaderReflection*) reflection;
 
     PrettyWriter writer;
-    emitReflectionJSON(writer, programReflection);
+    emitReflectionJSON(writer, programReflection, emitLookups);
+}
+
+static SlangResult emitFlatReflectionJSON(
+    SlangCompileRequest*    request,
+    bool                    emitLookups)
+{
+    Slang::ComPtr<ISlangBlob> blob;
+    SLANG_RETURN_ON_FAIL(spGetFlatReflectionBlob(request, 0, blob.writeRef()));
+
+    auto programReflection = slang::flat::ShaderReflection::get(blob->getBufferPointer(), blob->getBufferSize());
+    if (!programReflection)
+    {
+        return SLANG_FAIL;
+    }
+
+    PrettyWriter writer;
+    emitReflectionJSON(writer, programReflection, emitLookups);
+    return SLANG_OK;
 }
 
 static SlangResult maybeDumpDiagnostic(SlangResult res, SlangCompileRequest* request)
@@ -876,14 +1186,44 @@ static SlangResult innerMain(int argc, char*const*argv)
     char const* appName = "slang-reflection-test";
     if (argc > 0) appName = argv[0];
 
-    SLANG_RETURN_ON_FAIL(maybeDumpDiagnostic(spProcessCommandLineArguments(request, &argv[1], argc - 1), request));
+    // With `-flat` the output is produced from the flat reflection blob
+    // instead of the reflection API. With `-lookups` it ends with the
+    // results of looking up everything by name. The other options are
+    // passed on to the compile request.
+    bool useFlatReflection = false;
+    bool emitLookups = false;
+    std::vector<char const*> compileArgs;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-flat") == 0)
+        {
+            useFlatReflection = true;
+        }
+        else if (strcmp(argv[i], "-lookups") == 0)
+        {
+            emitLookups = true;
+        }
+        else
+        {
+            compileArgs.push_back(argv[i]);
+        }
+    }
+
+    SLANG_RETURN_ON_FAIL(maybeDumpDiagnostic(spProcessCommandLineArguments(request, compileArgs.data(), int(compileArgs.size())), request));
     SLANG_RETURN_ON_FAIL(maybeDumpDiagnostic(spCompile(request), request));
 
     // Okay, let's go through and emit reflection info on whatever
     // we have.
 
-    SlangReflection* reflection = spGetReflection(request);
-    emitReflectionJSON(reflection);
+    if (useFlatReflection)
+    {
+        SLANG_RETURN_ON_FAIL(emitFlatReflectionJSON(request, emitLookups));
+    }
+    else
+    {
+        SlangReflection* reflection = spGetReflection(request);
+        emitReflectionJSON(reflection, emitLookups);
+    }
 
     spDestroyCompileRequest(request);
     spDestroySession(session);
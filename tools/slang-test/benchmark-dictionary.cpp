@@ -0,0 +1,185 @@
+// benchmark-dictionary.cpp
+
+#include "../../source/core/dictionary.h"
+#include "../../source/core/slang-string.h"
+
+#include "test-context.h"
+#include "benchmark.h"
+
+#include "../../source/core/slang-random-generator.h"
+
+using namespace Slang;
+
+static const int kRunCount = 5;
+
+// Pointer keys are the most common in the compiler (e.g. maps from IR instructions or declarations)
+static void _benchmarkPointerKeys(int count)
+{
+    // Spread out like heap allocations, but without allocating
+    List<void*> keys;
+    List<void*> missingKeys;
+    for (int i = 0; i < count; ++i)
+    {
+        keys.Add((void*)(size_t(0x10000) + size_t(i) * 48));
+        missingKeys.Add((void*)(size_t(0x10000) + size_t(i) * 48 + 16));
+    }
+    // Enough work per measurement to time
+    const int repeatCount = (count < 100000) ? 100000 / count : 1;
+
+    char heading[64];
+    sprintf(heading, "Pointer keys, n = %d (x%d)", count, repeatCount);
+    benchmarkHeading(heading);
+
+    Dictionary<void*, int> dict;
+    benchmarkReport("insert", benchmarkMinTime(kRunCount, [&]() {
+        for (int r = 0; r < repeatCount; ++r)
+        {
+            dict = Dictionary<void*, int>();
+            for (int i = 0; i < count; ++i)
+            {
+                dict.Add(keys[i], i);
+            }
+        }
+    }));
+    SLANG_CHECK(dict.Count() == count);
+    benchmarkReport("hit", benchmarkMinTime(kRunCount, [&]() {
+        int sum = 0;
+        for (int r = 0; r < repeatCount; ++r)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                sum += *dict.TryGetValue(keys[i]);
+            }
+        }
+        benchmarkKeep(sum);
+    }));
+    benchmarkReport("miss", benchmarkMinTime(kRunCount, [&]() {
+        int found = 0;
+        for (int r = 0; r < repeatCount; ++r)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                found += dict.ContainsKey(missingKeys[i]) ? 1 : 0;
+            }
+        }
+        SLANG_CHECK(found == 0);
+    }));
+    benchmarkReport("iterate", benchmarkMinTime(kRunCount, [&]() {
+        int sum = 0;
+        for (int r = 0; r < repeatCount; ++r)
+        {
+            for (auto& pair : dict)
+            {
+                sum += pair.Value;
+            }
+        }
+        benchmarkKeep(sum);
+    }));
+}
+
+// Misses get slower as the table fills, as more groups are full and the probe has to go on to the next.
+// The counts fill 131072 slots to different loads, up to the most it holds before it grows (and one more).
+static void _benchmarkMissesByLoad()
+{
+    benchmarkHeading("Pointer key misses by load, 1M lookups");
+
+    const int capacity = 131072;
+    const int maxCount = int(capacity * MaxLoadFactor);
+    const int counts[] = { capacity / 2, capacity * 5 / 8, capacity * 3 / 4, maxCount, maxCount + 1 };
+    for (auto count : counts)
+    {
+        Dictionary<void*, int> dict;
+        for (int i = 0; i < count; ++i)
+        {
+            dict.Add((void*)(size_t(0x10000) + size_t(i) * 48), i);
+        }
+
+        const int lookupCount = 1000000;
+        const double time = benchmarkMinTime(kRunCount, [&]() {
+            int found = 0;
+            for (int i = 0; i < lookupCount; ++i)
+            {
+                found += dict.ContainsKey((void*)(size_t(0x10000) + size_t(i % count) * 48 + 16)) ? 1 : 0;
+            }
+            SLANG_CHECK(found == 0);
+        });
+
+        const int slotCount = (count <= maxCount) ? capacity : capacity * 2;
+        char name[64];
+        sprintf(name, "n = %d (%d%% full)", count, int(100.0 * count / slotCount));
+        benchmarkReport(name, time);
+    }
+}
+
+static void _benchmarkStringKeys(int count)
+{
+    List<String> keys;
+    for (int i = 0; i < count; ++i)
+    {
+        keys.Add(String("identifier_") + String(i * 7919));
+    }
+
+    char heading[64];
+    sprintf(heading, "String keys, n = %d", count);
+    benchmarkHeading(heading);
+
+    Dictionary<String, int> dict;
+    benchmarkReport("insert", benchmarkMinTime(kRunCount, [&]() {
+        dict = Dictionary<String, int>();
+        for (int i = 0; i < count; ++i)
+        {
+            dict.Add(keys[i], i);
+        }
+    }));
+    SLANG_CHECK(dict.Count() == count);
+    benchmarkReport("hit", benchmarkMinTime(kRunCount, [&]() {
+        int sum = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            sum += *dict.TryGetValue(keys[i]);
+        }
+        benchmarkKeep(sum);
+    }));
+}
+
+static void dictionaryBenchmark()
+{
+    _benchmarkPointerKeys(1000);
+    _benchmarkPointerKeys(100000);
+    _benchmarkPointerKeys(1000000);
+
+    _benchmarkMissesByLoad();
+
+    _benchmarkStringKeys(100000);
+
+    // Lots of short lived small maps, as made per function or per scope
+    benchmarkHeading("Small maps");
+    benchmarkReport("100k maps of 8 entries", benchmarkMinTime(kRunCount, [&]() {
+        int sum = 0;
+        for (int i = 0; i < 100000; ++i)
+        {
+            Dictionary<int, int> dict;
+            for (int j = 0; j < 8; ++j)
+            {
+                dict.Add(i + j * 31, j);
+            }
+            sum += dict.Count();
+        }
+        benchmarkKeep(sum);
+    }));
+
+    // Adding and removing, so removed slots are reused
+    benchmarkHeading("HashSet churn");
+    benchmarkReport("1M add/remove, 1000 live", benchmarkMinTime(kRunCount, [&]() {
+        DefaultRandomGenerator randGen(0x5eed);
+        HashSet<int> set;
+        for (int i = 0; i < 1000000; ++i)
+        {
+            set.Add(randGen.nextInt32UpTo(2000));
+            set.Remove(randGen.nextInt32UpTo(2000));
+        }
+        benchmarkKeep(set.Count());
+    }));
+}
+
+SLANG_BENCHMARK("Dictionary", dictionaryBenchmark);
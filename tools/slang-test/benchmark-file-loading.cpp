@@ -0,0 +1,106 @@
+// benchmark-file-loading.cpp
+
+#include "../../source/core/slang-io.h"
+#include "../../source/core/slang-string-util.h"
+
+#include "test-context.h"
+#include "benchmark.h"
+
+#include <stdio.h>
+
+using namespace Slang;
+
+static const int kRunCount = 3;
+
+// Writes fileCount files of fileSize bytes of source text, adding their paths to outPaths
+static void _writeFiles(const char* prefix, int fileCount, size_t fileSize, List<String>& outPaths)
+{
+    StringBuilder builder;
+    int lineIndex = 0;
+    while (builder.Length() < fileSize)
+    {
+        builder << "static const float value" << lineIndex++ << " = 1.0; // filler\n";
+    }
+    const String text = builder.ToString().SubString(0, fileSize);
+
+    for (int i = 0; i < fileCount; ++i)
+    {
+        StringBuilder path;
+        path << "benchmark-file-loading-" << prefix << "-" << i << ".slang";
+        File::WriteAllText(path, text);
+        outPaths.Add(path);
+    }
+}
+
+// Sums a byte from every page, so that a mapping is actually read
+static size_t _touchPages(ISlangBlob* blob)
+{
+    const unsigned char* data = (const unsigned char*)blob->getBufferPointer();
+    const size_t size = blob->getBufferSize();
+    size_t sum = 0;
+    for (size_t i = 0; i < size; i += 4096)
+    {
+        sum += data[i];
+    }
+    return sum;
+}
+
+// Times each way of loading the files at paths, which are files loaded from the OS file cache
+static void _timeLoading(const List<String>& paths)
+{
+    size_t sum = 0;
+
+    benchmarkReport("File::ReadAllText, then a string blob", benchmarkMinTime(kRunCount, [&]() {
+        for (const auto& path : paths)
+        {
+            sum += _touchPages(StringUtil::createStringBlob(File::ReadAllText(path)));
+        }
+    }));
+
+    benchmarkReport("File::ReadAllBytes, then a string blob (small files)", benchmarkMinTime(kRunCount, [&]() {
+        for (const auto& path : paths)
+        {
+            List<unsigned char> bytes = File::ReadAllBytes(path);
+            const char* text = (const char*)bytes.Buffer();
+            sum += _touchPages(StringUtil::createStringBlob(String(text, text + bytes.Count())));
+        }
+    }));
+
+    benchmarkReport("MappedFileBlob (large files)", benchmarkMinTime(kRunCount, [&]() {
+        for (const auto& path : paths)
+        {
+            ComPtr<ISlangBlob> blob;
+            SLANG_CHECK(SLANG_SUCCEEDED(MappedFileBlob::create(path, blob)));
+            sum += _touchPages(blob);
+        }
+    }));
+
+    benchmarkKeep(sum);
+}
+
+static void fileLoadingBenchmark()
+{
+    // Source files are loaded by `DefaultFileSystem::loadFile`, which copies small files and maps larger
+    // ones. These are the two sizes either side of where it switches.
+    List<String> smallPaths;
+    _writeFiles("small", 2000, 4 * 1024 - 10, smallPaths);
+    List<String> largePaths;
+    _writeFiles("large", 100, 256 * 1024 - 10, largePaths);
+
+    benchmarkHeading("2000 files of 4KB");
+    _timeLoading(smallPaths);
+
+    benchmarkHeading("100 files of 256KB");
+    _timeLoading(largePaths);
+
+    for (const auto& path : smallPaths)
+    {
+        ::remove(path.Buffer());
+    }
+    for (const auto& path : largePaths)
+    {
+        ::remove(path.Buffer());
+    }
+}
+
+SLANG_BENCHMARK("FileLoading", fileLoadingBenchmark);
@@ -0,0 +1,61 @@
+// benchmark-member-lookup.cpp
+
+#include "../../slang.h"
+
+#include "../../source/core/slang-string.h"
+
+#include "test-context.h"
+#include "benchmark.h"
+
+#include <stdio.h>
+
+using namespace Slang;
+
+static const int kRunCount = 3;
+
+// Global declarations that each look up names in the module scope, as the parser does when it
+// checks whether an identifier names a type. So the module's member dictionary is needed
+// between each member being added.
+static String _makeGlobalsSource(int globalCount)
+{
+    StringBuilder builder;
+    builder << "struct S0 { float value; };\n";
+    for (int i = 1; i < globalCount; ++i)
+    {
+        builder << "struct S" << i << " { S" << (i - 1) << " inner; };\n";
+    }
+    return builder.ProduceString();
+}
+
+// Parses and checks source (without generating code), returning the fastest time in ms
+static double _timeFrontEnd(SlangSession* session, const String& source)
+{
+    return benchmarkMinTime(kRunCount, [&]() {
+        SlangCompileRequest* request = spCreateCompileRequest(session);
+        spSetCodeGenTarget(request, SLANG_HLSL);
+        spSetCompileFlags(request, SLANG_COMPILE_FLAG_NO_CODEGEN);
+        const int translationUnitIndex = spAddTranslationUnit(request, SLANG_SOURCE_LANGUAGE_SLANG, nullptr);
+        spAddTranslationUnitSourceString(request, translationUnitIndex, "member-lookup-benchmark.slang", source.Buffer());
+        SLANG_CHECK(spCompile(request) == 0);
+        spDestroyCompileRequest(request);
+    });
+}
+
+static void memberLookupBenchmark()
+{
+    SlangSession* session = spCreateSession(nullptr);
+
+    // Each doubling of the number of globals should about double the time
+    benchmarkHeading("structs that each use the one before (front end)");
+    const int globalCounts[] = { 5000, 10000, 20000 };
+    for (auto globalCount : globalCounts)
+    {
+        char name[64];
+        sprintf(name, "%d structs", globalCount);
+        benchmarkReport(name, _timeFrontEnd(session, _makeGlobalsSource(globalCount)));
+    }
+
+    spDestroySession(session);
+}
+
+SLANG_BENCHMARK("MemberLookup", memberLookupBenchmark);
@@ -0,0 +1,135 @@
+// benchmark-parameter-binding.cpp
+
+#include "../../slang.h"
+
+#include "../../source/core/slang-string.h"
+
+#include "test-context.h"
+#include "benchmark.h"
+
+#include "../../source/core/slang-random-generator.h"
+
+using namespace Slang;
+
+static const int kRunCount = 3;
+
+enum class RegisterOrder
+{
+    Ascending,
+    Descending,
+    Random,
+};
+
+// Textures, texture arrays, UAVs and samplers. Every other parameter is bound explicitly (with gaps between the
+// registers) and the rest are allocated around them.
+static String _makeMixedSource(int paramCount)
+{
+    StringBuilder builder;
+    for (int i = 0; i < paramCount; ++i)
+    {
+        const bool isExplicit = (i & 1) == 0;
+        switch ((i >> 1) & 3)
+        {
+            case 0:
+                builder << "Texture2D t" << i;
+                if (isExplicit) builder << " : register(t" << (i * 2) << ")";
+                break;
+            case 1:
+                builder << "Texture2D ta" << i << "[4]";
+                if (isExplicit) builder << " : register(t" << (i * 2) << ")";
+                break;
+            case 2:
+                builder << "RWTexture2D<float4> u" << i;
+                if (isExplicit) builder << " : register(u" << (i * 2) << ")";
+                break;
+            default:
+                builder << "SamplerState s" << i;
+                if (isExplicit) builder << " : register(s" << (i * 2) << ")";
+                break;
+        }
+        builder << ";\n";
+    }
+    return builder.ProduceString();
+}
+
+// Explicitly bound textures, with gaps between the registers, declared in the given order. Followed by as many
+// implicitly bound texture arrays, which have to be allocated in the gaps.
+static String _makeExplicitSource(int paramCount, RegisterOrder order)
+{
+    List<int> registers;
+    for (int i = 0; i < paramCount; ++i)
+    {
+        registers.Add(i * 3);
+    }
+    if (order == RegisterOrder::Descending)
+    {
+        registers.Reverse();
+    }
+    else if (order == RegisterOrder::Random)
+    {
+        DefaultRandomGenerator randGen(0xb1d);
+        for (int i = paramCount - 1; i > 0; --i)
+        {
+            const int j = randGen.nextInt32UpTo(i + 1);
+            const int tmp = registers[i];
+            registers[i] = registers[j];
+            registers[j] = tmp;
+        }
+    }
+
+    StringBuilder builder;
+    for (int i = 0; i < paramCount; ++i)
+    {
+        builder << "Texture2D t" << i << " : register(t" << registers[i] << ");\n";
+    }
+    for (int i = 0; i < paramCount; ++i)
+    {
+        builder << "Texture2D ta" << i << "[2];\n";
+    }
+    return builder.ProduceString();
+}
+
+// Checks and binds the parameters in source for HLSL, returning the fastest time in ms
+static double _timeBinding(SlangSession* session, const String& source, unsigned int expectedParamCount)
+{
+    return benchmarkMinTime(kRunCount, [&]() {
+        SlangCompileRequest* request = spCreateCompileRequest(session);
+        spSetCodeGenTarget(request, SLANG_HLSL);
+        spSetCompileFlags(request, SLANG_COMPILE_FLAG_NO_CODEGEN);
+        const int translationUnitIndex = spAddTranslationUnit(request, SLANG_SOURCE_LANGUAGE_SLANG, nullptr);
+        spAddTranslationUnitSourceString(request, translationUnitIndex, "parameter-binding-benchmark.slang", source.Buffer());
+        SLANG_CHECK(spCompile(request) == 0);
+        SLANG_CHECK(spReflection_GetParameterCount(spGetReflection(request)) == expectedParamCount);
+        spDestroyCompileRequest(request);
+    });
+}
+
+static void parameterBindingBenchmark()
+{
+    SlangSession* session = spCreateSession(nullptr);
+
+    // The front end is the same for each order, so the differences between them are the cost of keeping the
+    // used ranges sorted. Each doubling of the parameter count should about double the time.
+    const int paramCounts[] = { 10000, 20000, 40000 };
+    for (auto paramCount : paramCounts)
+    {
+        char heading[64];
+        sprintf(heading, "%d parameters (front end and parameter binding)", paramCount);
+        benchmarkHeading(heading);
+
+        benchmarkReport("mixed textures, arrays, UAVs and samplers",
+            _timeBinding(session, _makeMixedSource(paramCount), unsigned(paramCount)));
+
+        const int halfCount = paramCount / 2;
+        benchmarkReport("half explicit in ascending order, half implicit arrays",
+            _timeBinding(session, _makeExplicitSource(halfCount, RegisterOrder::Ascending), unsigned(paramCount)));
+        benchmarkReport("half explicit in descending order, half implicit arrays",
+            _timeBinding(session, _makeExplicitSource(halfCount, RegisterOrder::Descending), unsigned(paramCount)));
+        benchmarkReport("half explicit in random order, half implicit arrays",
+            _timeBinding(session, _makeExplicitSource(halfCount, RegisterOrder::Random), unsigned(paramCount)));
+    }
+
+    spDestroySession(session);
+}
+
+SLANG_BENCHMARK("ParameterBinding", parameterBindingBenchmark);
@@ -0,0 +1,94 @@
+// benchmark-serial-ir.cpp
+
+#include "../../slang.h"
+
+#include "../../source/core/slang-string.h"
+
+#include "test-context.h"
+#include "benchmark.h"
+
+using namespace Slang;
+
+static const int kRunCount = 5;
+
+// A module with lots of small functions, each calling the one before
+static String _makeSource(int functionCount)
+{
+    StringBuilder builder;
+    builder << "struct Value { float a; int b; float3 c; };\n";
+    builder << "RWStructuredBuffer<float> output;\n";
+    builder << "float f0(Value v, int n) { return v.a; }\n";
+    for (int i = 1; i < functionCount; ++i)
+    {
+        builder << "float f" << i << "(Value v, int n)\n";
+        builder << "{\n";
+        builder << "    float sum = v.a * " << (i % 7) << ".0 + float(v.b);\n";
+        builder << "    for (int j = 0; j < n; ++j)\n";
+        builder << "    {\n";
+        builder << "        sum += dot(v.c, float3(j, " << i << ", 1));\n";
+        builder << "        if (sum > 100.0) { sum *= 0.5; }\n";
+        builder << "    }\n";
+        builder << "    return sum + f" << (i - 1) << "(v, n - 1);\n";
+        builder << "}\n";
+    }
+    builder << "[numthreads(1, 1, 1)]\n";
+    builder << "void main(uint3 tid : SV_DispatchThreadID)\n";
+    builder << "{\n";
+    builder << "    Value v; v.a = 1.0; v.b = int(tid.x); v.c = float3(1, 2, 3);\n";
+    builder << "    output[tid.x] = f" << (functionCount - 1) << "(v, 4);\n";
+    builder << "}\n";
+    return builder.ProduceString();
+}
+
+// Compiles source with args (and no target), returning the fastest time in ms
+static double _timeCompile(SlangSession* session, const String& source, const char* const* args, int argCount)
+{
+    return benchmarkMinTime(kRunCount, [&]() {
+        SlangCompileRequest* request = spCreateCompileRequest(session);
+        SLANG_CHECK(SLANG_SUCCEEDED(spProcessCommandLineArguments(request, args, argCount)));
+        const int translationUnitIndex = spAddTranslationUnit(request, SLANG_SOURCE_LANGUAGE_SLANG, nullptr);
+        spAddTranslationUnitSourceString(request, translationUnitIndex, "serial-ir-benchmark.slang", source.Buffer());
+        spAddEntryPoint(request, translationUnitIndex, "main", spFindProfile(session, "cs_5_0"));
+        SLANG_CHECK(spCompile(request) == 0);
+        spDestroyCompileRequest(request);
+    });
+}
+
+static void serialIRBenchmark()
+{
+    SlangSession* session = spCreateSession(nullptr);
+
+    const String source = _makeSource(500);
+
+    // The difference between compiling with and without the serialized IR bottleneck is the cost
+    // of writing the module, and reading it back (function bodies are only read when they are used).
+    const char* compressionNames[] = { "none", "lite", "stream-vbyte", "lz4" };
+
+    benchmarkHeading("500 functions, front end and IR generation (-skip-codegen)");
+    {
+        const char* args[] = { "-skip-codegen" };
+        benchmarkReport("without -serial-ir", _timeCompile(session, source, args, SLANG_COUNT_OF(args)));
+    }
+    for (auto compressionName : compressionNames)
+    {
+        const char* args[] = { "-skip-codegen", "-serial-ir-compression", compressionName };
+        const String name = String("-serial-ir-compression ") + compressionName;
+        benchmarkReport(name.Buffer(), _timeCompile(session, source, args, SLANG_COUNT_OF(args)));
+    }
+
+    benchmarkHeading("500 functions, to HLSL (all bodies are read back)");
+    {
+        const char* args[] = { "-target", "hlsl" };
+        benchmarkReport("without -serial-ir", _timeCompile(session, source, args, SLANG_COUNT_OF(args)));
+    }
+    for (auto compressionName : compressionNames)
+    {
+        const char* args[] = { "-target", "hlsl", "-serial-ir-compression", compressionName };
+        const String name = String("-serial-ir-compression ") + compressionName;
+        benchmarkReport(name.Buffer(), _timeCompile(session, source, args, SLANG_COUNT_OF(args)));
+    }
+
+    spDestroySession(session);
+}
+
+SLANG_BENCHMARK("SerialIR", serialIRBenchmark);
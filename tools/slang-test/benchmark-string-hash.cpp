@@ -0,0 +1,166 @@
+// benchmark-string-hash.cpp
+
+#include "../../source/core/dictionary.h"
+#include "../../source/core/slang-io.h"
+#include "../../source/core/slang-string.h"
+
+#include "test-context.h"
+#include "benchmark.h"
+
+#include "../../source/core/slang-random-generator.h"
+
+using namespace Slang;
+
+static const int kRunCount = 5;
+// Each measurement hashes/looks up every name this many times
+static const int kRepeatCount = 100;
+
+// Add the distinct identifiers in the file at path to outNames
+static void _addIdentifiers(const String& path, HashSet<String>& ioSeen, List<String>& outNames)
+{
+    if (!File::Exists(path))
+    {
+        return;
+    }
+    const String text = File::ReadAllText(path);
+
+    const char* cur = text.Buffer();
+    const char* end = cur + text.Length();
+    while (cur < end)
+    {
+        const char c = *cur;
+        if (c == '_' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+        {
+            const char* start = cur;
+            while (cur < end && (*cur == '_' || (*cur >= 'a' && *cur <= 'z') || (*cur >= 'A' && *cur <= 'Z') || (*cur >= '0' && *cur <= '9')))
+            {
+                cur++;
+            }
+            String name(start, cur);
+            if (!ioSeen.Contains(name))
+            {
+                ioSeen.Add(name);
+                outNames.Add(name);
+            }
+        }
+        else
+        {
+            cur++;
+        }
+    }
+}
+
+// Make up names that look like mangled names, a prefix followed by length prefixed parts
+static void _makeMangledNames(const List<String>& identifiers, int count, int partCount, List<String>& outNames)
+{
+    DefaultRandomGenerator randGen(0x3a46);
+    for (int i = 0; i < count; ++i)
+    {
+        StringBuilder builder;
+        builder << "_S";
+        const int numParts = 1 + randGen.nextInt32UpTo(partCount);
+        for (int j = 0; j < numParts; ++j)
+        {
+            const String& part = identifiers[randGen.nextInt32UpTo(int(identifiers.Count()))];
+            builder << int(part.Length()) << part;
+        }
+        builder << "p" << i << "V";
+        outNames.Add(builder.ProduceString());
+    }
+}
+
+static void _benchmarkNames(const char* heading, const List<String>& names)
+{
+    size_t totalSize = 0;
+    for (const auto& name : names)
+    {
+        totalSize += name.Length();
+    }
+
+    char line[128];
+    sprintf(line, "%s: %d names, average length %.1f (x%d)", heading, int(names.Count()), double(totalSize) / double(names.Count()), kRepeatCount);
+    benchmarkHeading(line);
+
+    benchmarkReport("GetHashCode(const char*, size_t)", benchmarkMinTime(kRunCount, [&]() {
+        int hash = 0;
+        for (int r = 0; r < kRepeatCount; ++r)
+        {
+            for (const auto& name : names)
+            {
+                hash ^= GetHashCode(name.Buffer(), size_t(name.Length()));
+            }
+        }
+        benchmarkKeep(hash);
+    }));
+
+    benchmarkReport("String::GetHashCode (cached after the first)", benchmarkMinTime(kRunCount, [&]() {
+        int hash = 0;
+        for (int r = 0; r < kRepeatCount; ++r)
+        {
+            for (const auto& name : names)
+            {
+                hash ^= name.GetHashCode();
+            }
+        }
+        benchmarkKeep(hash);
+    }));
+
+    Dictionary<String, int> dict;
+    for (UInt i = 0; i < names.Count(); ++i)
+    {
+        dict.Add(names[i], int(i));
+    }
+
+    benchmarkReport("Dictionary<String> hit", benchmarkMinTime(kRunCount, [&]() {
+        int sum = 0;
+        for (int r = 0; r < kRepeatCount; ++r)
+        {
+            for (const auto& name : names)
+            {
+                sum += *dict.TryGetValue(name);
+            }
+        }
+        benchmarkKeep(sum);
+    }));
+
+    // As when looking up a name built from a token or by concatenation, so there is no cached hash
+    benchmarkReport("Dictionary<String> hit, new String key", benchmarkMinTime(kRunCount, [&]() {
+        int found = 0;
+        for (int r = 0; r < kRepeatCount; ++r)
+        {
+            for (const auto& name : names)
+            {
+                const String key(name.Buffer(), name.Buffer() + name.Length());
+                found += dict.ContainsKey(key) ? 1 : 0;
+            }
+        }
+        SLANG_CHECK(found == int(names.Count()) * kRepeatCount);
+    }));
+}
+
+static void stringHashBenchmark()
+{
+    // Identifiers from the standard library source (slang-test runs from the root of the tree)
+    HashSet<String> seen;
+    List<String> identifiers;
+    _addIdentifiers("source/slang/core.meta.slang", seen, identifiers);
+    _addIdentifiers("source/slang/hlsl.meta.slang", seen, identifiers);
+    SLANG_CHECK(identifiers.Count() > 0);
+    if (identifiers.Count() == 0)
+    {
+        return;
+    }
+
+    List<String> mangledNames;
+    _makeMangledNames(identifiers, 2000, 4, mangledNames);
+
+    // Long names, as built for specialized generics
+    List<String> longMangledNames;
+    _makeMangledNames(identifiers, 2000, 16, longMangledNames);
+
+    _benchmarkNames("Identifiers", identifiers);
+    _benchmarkNames("Mangled names", mangledNames);
+    _benchmarkNames("Long mangled names", longMangledNames);
+}
+
+SLANG_BENCHMARK("StringHash", stringHashBenchmark);
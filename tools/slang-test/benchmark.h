@@ -0,0 +1,49 @@
+// benchmark.h
+#ifndef SLANG_BENCHMARK_H
+#define SLANG_BENCHMARK_H
+
+#include <chrono>
+#include <stdio.h>
+
+// Helpers for benchmarks registered with SLANG_BENCHMARK
+
+    /// Runs func runCount times, and returns the time of the fastest run in milliseconds
+template <typename FUNC>
+double benchmarkMinTime(int runCount, const FUNC& func)
+{
+    double minTime = 0.0;
+    for (int i = 0; i < runCount; ++i)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        func();
+        const auto endTime = std::chrono::high_resolution_clock::now();
+
+        const double time = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        minTime = (i == 0 || time < minTime) ? time : minTime;
+    }
+    return minTime;
+}
+
+    /// Write the time of a named measurement to stdout
+inline void benchmarkReport(const char* name, double timeInMs)
+{
+    printf("    %-56s %10.3f ms\n", name, timeInMs);
+    fflush(stdout);
+}
+
+    /// Write a heading for the measurements that follow to stdout
+inline void benchmarkHeading(const char* heading)
+{
+    printf("%s\n", heading);
+    fflush(stdout);
+}
+
+    /// Stops the compiler from optimizing away a computed value
+template <typename T>
+void benchmarkKeep(const T& value)
+{
+    static volatile T s_sink;
+    s_sink = value;
+}
+
+#endif
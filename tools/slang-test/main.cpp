@@ -770,7 +770,7 @@ TestResult runSimpleTest(TestContext* context, TestInput& input)
     return result;
 }
 
-TestResult runReflectionTest(TestContext* context, TestInput& input)
+static TestResult _runReflectionTest(TestContext* context, TestInput& input, bool useFlatReflection)
 {
     auto filePath = input.filePath;
     auto outputStem = input.outputStem;
@@ -778,6 +778,10 @@ TestResult runReflectionTest(TestContext* context, TestInput& input)
     OSProcessSpawner spawner;
 
     spawner.pushExecutablePath(String(g_options.binDir) + "slang-reflection-test" + osGetExecutableSuffix());
+    if (useFlatReflection)
+    {
+        spawner.pushArgument("-flat");
+    }
     spawner.pushArgument(filePath);
 
     for( auto arg : input.testOptions->args )
@@ -822,7 +826,7 @@ TestResult runReflectionTest(TestContext* context, TestInput& input)
     // diagnose the problem.
     if (result == TestResult::Fail)
     {
-        String actualOutputPath = outputStem + ".actual";
+        String actualOutputPath = outputStem + (useFlatReflection ? ".flat.actual" : ".actual");
         Slang::File::WriteAllText(actualOutputPath, actualOutput);
 
         context->dumpOutputDifference(expectedOutput, actualOutput);
@@ -831,6 +835,18 @@ TestResult runReflectionTest(TestContext* context, TestInput& input)
     return result;
 }
 
+TestResult runReflectionTest(TestContext* context, TestInput& input)
+{
+    // The flat reflection blob must report exactly what the reflection API does,
+    // so the output from walking it is compared against the same expected output
+    const TestResult result = _runReflectionTest(context, input, false);
+    if (result != TestResult::Pass)
+    {
+        return result;
+    }
+    return _runReflectionTest(context, input, true);
+}
+
 String getExpectedOutput(String const& outputStem)
 {
     String expectedOutputPath = outputStem + ".expected";
@@ -1934,6 +1950,9 @@ int main(
 
     auto compatibilityIssueCatagory = addTestCategory("compatibility-issue", fullTestCategory);
 
+    // Benchmarks take a while, and only report timings, so they aren't part of `full`
+    auto benchmarkCategory = addTestCategory("benchmark", nullptr);
+
     // An un-categorized test will always belong to the `full` category
     g_defaultTestCategory = fullTestCategory;
 
@@ -1983,10 +2002,10 @@ int main(
         while (cur)
         {
             StringBuilder filePath;
-            filePath << "unit-tests/" << cur->m_name << ".internal";
+            filePath << (cur->m_isBenchmark ? "benchmarks/" : "unit-tests/") << cur->m_name << ".internal";
 
             TestOptions testOptions;
-            testOptions.categories.Add(unitTestCatagory);
+            testOptions.categories.Add(cur->m_isBenchmark ? benchmarkCategory : unitTestCatagory);
             testOptions.command = filePath;
 
             if (shouldRunTest(&context, testOptions.command))
@@ -515,7 +515,7 @@ Slang::String OSProcessSpawner::getCommandLine()
 OSError OSProcessSpawner::spawnAndWaitForCompletion()
 {
     List<char const*> argPtrs;
-    for(auto arg : arguments_)
+    for(auto& arg : arguments_)
     {
         argPtrs.Add(arg.Buffer());
     }
@@ -8,10 +8,11 @@ struct TestRegister
 {
     typedef void (*TestFunc)();
 
-    TestRegister(const char* name, TestFunc func):
+    TestRegister(const char* name, TestFunc func, bool isBenchmark = false):
         m_next(s_first),
         m_name(name),
-        m_func(func)
+        m_func(func),
+        m_isBenchmark(isBenchmark)
     {
         s_first = this;
     }
@@ -19,11 +20,14 @@ struct TestRegister
     TestFunc m_func;
     const char* m_name;
     TestRegister* m_next;
+    bool m_isBenchmark;                         ///< If set, only run when the 'benchmark' category is selected
 
     static TestRegister* s_first;
 };
 
 #define SLANG_UNIT_TEST(name, func) static TestRegister s_unitTest##__LINE__(name, func)
+    /// Benchmarks are not part of the 'full' category, so they only run with `-category benchmark`. They write timings to stdout.
+#define SLANG_BENCHMARK(name, func) static TestRegister s_benchmark##__LINE__(name, func, true)
 
 enum class TestOutputMode
 {
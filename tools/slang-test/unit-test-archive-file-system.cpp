@@ -0,0 +1,119 @@
+// unit-test-archive-file-system.cpp
+
+#include "../../source/core/slang-io.h"
+#include "../../source/core/stream.h"
+
+#include "../../slang-com-ptr.h"
+
+#include "test-context.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#   include <direct.h>
+#   define rmdir _rmdir
+#else
+#   include <unistd.h>
+#endif
+
+using namespace Slang;
+
+static void _writeFile(const String& path, const void* data, size_t size)
+{
+    FileStream stream(path, FileMode::Create);
+    stream.Write(data, Int64(size));
+}
+
+// Loads path from fileSystem, and checks the contents are the expected ones followed by a zero
+static void _checkLoad(ISlangFileSystemExt* fileSystem, const char* path, const void* expected, size_t expectedSize)
+{
+    ComPtr<ISlangBlob> blob;
+    SLANG_CHECK(SLANG_SUCCEEDED(fileSystem->loadFile(path, blob.writeRef())));
+    if (blob)
+    {
+        const char* data = (const char*)blob->getBufferPointer();
+        SLANG_CHECK(blob->getBufferSize() == expectedSize);
+        SLANG_CHECK(blob->getBufferSize() != expectedSize || ::memcmp(data, expected, expectedSize) == 0);
+        SLANG_CHECK(data[blob->getBufferSize()] == 0);
+    }
+}
+
+static void archiveFileSystemUnitTest()
+{
+    const String directoryPath = "unit-test-archive-file-system";
+    const String subDirectoryPath = Path::Combine(directoryPath, "sub");
+    const String archivePath = "unit-test-archive-file-system.tmp";
+
+    Path::CreateDir(directoryPath);
+    Path::CreateDir(subDirectoryPath);
+
+    const char text[] = "float a;";
+
+    // A page sized file, so a mapping of just the file would have no room for a terminating zero
+    List<char> pageText;
+    pageText.SetSize(4096);
+    for (UInt i = 0; i < pageText.Count(); ++i)
+    {
+        pageText[i] = char('a' + (i % 26));
+    }
+
+    // "int x;" as UTF-16 (little endian) with a byte order mark
+    const char utf16Text[] = "\xff\xfei\0n\0t\0 \0x\0;\0";
+
+    List<String> filePaths;
+    filePaths.Add(Path::Combine(directoryPath, "a.slang"));
+    filePaths.Add(Path::Combine(subDirectoryPath, "page.h"));
+    filePaths.Add(Path::Combine(subDirectoryPath, "empty.h"));
+    filePaths.Add(Path::Combine(directoryPath, "utf16.slang"));
+
+    _writeFile(filePaths[0], text, ::strlen(text));
+    _writeFile(filePaths[1], pageText.Buffer(), pageText.Count());
+    _writeFile(filePaths[2], "", 0);
+    _writeFile(filePaths[3], utf16Text, sizeof(utf16Text) - 1);
+
+    SLANG_CHECK(SLANG_SUCCEEDED(spCreateArchiveFromDirectory(directoryPath.Buffer(), archivePath.Buffer())));
+
+    ComPtr<ISlangFileSystemExt> fileSystem;
+    SLANG_CHECK(SLANG_SUCCEEDED(spLoadArchiveFileSystem(archivePath.Buffer(), fileSystem.writeRef())));
+
+    if (fileSystem)
+    {
+        _checkLoad(fileSystem, "a.slang", text, ::strlen(text));
+        _checkLoad(fileSystem, "sub/page.h", pageText.Buffer(), pageText.Count());
+        _checkLoad(fileSystem, "sub/../sub/empty.h", "", 0);
+        // Transcoded to UTF-8, the same as a file loaded from disk
+        {
+            const String utf8Text = File::ReadAllText(filePaths[3]);
+            SLANG_CHECK(utf8Text.StartsWith("int x"));
+            _checkLoad(fileSystem, "utf16.slang", utf8Text.Buffer(), utf8Text.Length());
+        }
+
+        ComPtr<ISlangBlob> blob;
+        SLANG_CHECK(fileSystem->loadFile("missing.slang", blob.writeRef()) == SLANG_E_NOT_FOUND);
+        SLANG_CHECK(fileSystem->loadFile("sub", blob.writeRef()) == SLANG_E_NOT_FOUND);
+
+        SlangPathType pathType;
+        SLANG_CHECK(SLANG_SUCCEEDED(fileSystem->getPathType("sub", &pathType)) && pathType == SLANG_PATH_TYPE_DIRECTORY);
+        SLANG_CHECK(SLANG_SUCCEEDED(fileSystem->getPathType("sub/page.h", &pathType)) && pathType == SLANG_PATH_TYPE_FILE);
+        SLANG_CHECK(fileSystem->getPathType("su", &pathType) == SLANG_E_NOT_FOUND);
+    }
+    fileSystem.setNull();
+
+    // A truncated archive isn't loaded
+    {
+        List<unsigned char> bytes = File::ReadAllBytes(archivePath);
+        _writeFile(archivePath, bytes.Buffer(), bytes.Count() - 1);
+        SLANG_CHECK(SLANG_FAILED(spLoadArchiveFileSystem(archivePath.Buffer(), fileSystem.writeRef())));
+    }
+
+    ::remove(archivePath.Buffer());
+    for (const auto& filePath : filePaths)
+    {
+        ::remove(filePath.Buffer());
+    }
+    ::rmdir(subDirectoryPath.Buffer());
+    ::rmdir(directoryPath.Buffer());
+}
+
+SLANG_UNIT_TEST("ArchiveFileSystem", archiveFileSystemUnitTest);
@@ -116,6 +116,50 @@ static void byteEncodeUnitTest()
         SLANG_CHECK(memcmp(decodeBuffer.begin(), initialBuffer.begin(), sizeof(uint32_t) * blockSize) == 0);
     }
 
+    {
+        // StreamVByte, control byte followed by the value bytes
+        const uint32_t values[] = { 0x12, 0x1234, 0x123456, 0x12345678, 0 };
+        const uint8_t expected[] = { 0xe4, 0x00, 0x12, 0x34, 0x12, 0x56, 0x34, 0x12, 0x78, 0x56, 0x34, 0x12, 0x00 };
+
+        List<uint8_t> encoded;
+        ByteEncodeUtil::encodeStreamVByteUInt32(values, SLANG_COUNT_OF(values), encoded);
+        SLANG_CHECK(encoded.Count() == SLANG_COUNT_OF(expected) && memcmp(encoded.begin(), expected, sizeof(expected)) == 0);
+
+        uint32_t decoded[SLANG_COUNT_OF(values)];
+        SLANG_CHECK(ByteEncodeUtil::decodeStreamVByteUInt32(encoded.begin(), encoded.Count(), SLANG_COUNT_OF(values), decoded) == sizeof(expected));
+        SLANG_CHECK(memcmp(decoded, values, sizeof(values)) == 0);
+    }
+
+    {
+        // StreamVByte round trip of different sizes, such that the SIMD and the tail decoding are used
+        List<uint32_t> initialBuffer;
+        List<uint32_t> decodeBuffer;
+        List<uint8_t> encodedBuffer;
+
+        for (int numValues = 0; numValues < 300; numValues += (numValues < 40) ? 1 : 37)
+        {
+            initialBuffer.SetSize(numValues);
+            for (int i = 0; i < numValues; i++)
+            {
+                const uint32_t shift = uint32_t(randGen.nextInt32() & 3) * 8;
+                initialBuffer[i] = uint32_t(randGen.nextInt32()) >> shift;
+            }
+
+            ByteEncodeUtil::encodeStreamVByteUInt32(initialBuffer.begin(), numValues, encodedBuffer);
+            SLANG_CHECK(size_t(encodedBuffer.Count()) == ByteEncodeUtil::calcEncodeStreamVByteSizeUInt32(initialBuffer.begin(), numValues));
+
+            // Decode into a buffer with a guard value at the end
+            decodeBuffer.SetSize(numValues + 1);
+            decodeBuffer[numValues] = 0xcdcdcdcd;
+
+            const size_t numDecodeBytes = ByteEncodeUtil::decodeStreamVByteUInt32(encodedBuffer.begin(), encodedBuffer.Count(), numValues, decodeBuffer.begin());
+
+            SLANG_CHECK(numDecodeBytes == size_t(encodedBuffer.Count()));
+            SLANG_CHECK(memcmp(decodeBuffer.begin(), initialBuffer.begin(), sizeof(uint32_t) * numValues) == 0);
+            SLANG_CHECK(decodeBuffer[numValues] == 0xcdcdcdcd);
+        }
+    }
+
     {
         checkUInt32(uint32_t(0));
         checkUInt32(uint32_t(0x7fffff));
@@ -0,0 +1,117 @@
+// unit-test-chunked-string-builder.cpp
+
+#include "../../source/core/slang-chunked-string-builder.h"
+
+#include "test-context.h"
+
+#include "../../source/core/slang-random-generator.h"
+
+using namespace Slang;
+
+static bool _hasContents(ChunkedStringBuilder& builder, const String& expected)
+{
+    // The chunks must hold the contents in order
+    StringBuilder joined;
+    for (UInt ii = 0; ii < builder.getChunkCount(); ++ii)
+    {
+        joined << builder.getChunk(ii);
+    }
+    const String str = builder.produceString();
+    return builder.getLength() == expected.Length() && joined == expected && str == expected && str.Buffer()[str.Length()] == 0;
+}
+
+static void chunkedStringBuilderUnitTest()
+{
+    DefaultRandomGenerator randGen(0x1234fedc);
+
+    // Empty
+    {
+        ChunkedStringBuilder builder;
+        builder.append("");
+        SLANG_CHECK(builder.getChunkCount() == 0);
+        SLANG_CHECK(_hasContents(builder, String()));
+    }
+
+    // Random length appends, crossing many chunks
+    {
+        ChunkedStringBuilder builder;
+        StringBuilder expected;
+
+        List<char> text;
+        text.SetSize(ChunkedStringBuilder::kChunkSize * 2);
+        for (UInt ii = 0; ii < text.Count(); ++ii)
+        {
+            text[ii] = char('a' + (ii % 26));
+        }
+
+        for (int ii = 0; ii < 2000; ++ii)
+        {
+            // Mostly short, sometimes longer than a chunk
+            const int32_t length = randGen.nextInt32UpTo(20) ? randGen.nextInt32UpTo(100) : randGen.nextInt32UpTo(int32_t(text.Count()));
+            const int32_t start = randGen.nextInt32UpTo(int32_t(text.Count()) - length + 1);
+            builder.append(text.Buffer() + start, text.Buffer() + start + length);
+            expected.Append(text.Buffer() + start, UInt(length));
+        }
+        SLANG_CHECK(builder.getChunkCount() > 1);
+        SLANG_CHECK(_hasContents(builder, expected));
+
+        // Can keep appending after producing a string
+        builder << "end";
+        expected << "end";
+        SLANG_CHECK(_hasContents(builder, expected));
+    }
+
+    // A long string is referenced, and isn't changed by later appends
+    {
+        StringBuilder longBuilder;
+        for (int ii = 0; ii < ChunkedStringBuilder::kMinReferenceLength; ++ii)
+        {
+            longBuilder << "x";
+        }
+        const String longString = longBuilder.ProduceString();
+
+        ChunkedStringBuilder builder;
+        builder << longString;
+        SLANG_CHECK(builder.getChunk(0).begin() == longString.begin());
+        SLANG_CHECK(builder.produceString().begin() == longString.begin());
+
+        builder << "tail";
+        SLANG_CHECK(_hasContents(builder, longString + "tail"));
+        SLANG_CHECK(longString.Length() == UInt(ChunkedStringBuilder::kMinReferenceLength));
+    }
+
+    // A single chunk is produced without copying, and isn't written into afterwards
+    {
+        ChunkedStringBuilder builder;
+        builder << "abc";
+        const String str = builder.produceString();
+        builder << "def";
+        SLANG_CHECK(str == "abc");
+        SLANG_CHECK(_hasContents(builder, "abcdef"));
+    }
+
+    // Splicing
+    {
+        ChunkedStringBuilder body;
+        body << "body";
+        ChunkedStringBuilder prefix;
+        prefix << "prefix ";
+        ChunkedStringBuilder suffix;
+        suffix << " suffix";
+
+        body.prependChunks(prefix);
+        body.appendChunks(suffix);
+        SLANG_CHECK(prefix.getLength() == 0 && prefix.getChunkCount() == 0);
+        SLANG_CHECK(suffix.getLength() == 0 && suffix.getChunkCount() == 0);
+
+        body << "!";
+        SLANG_CHECK(_hasContents(body, "prefix body suffix!"));
+
+        ChunkedStringBuilder empty;
+        empty.prependChunks(body);
+        empty << "?";
+        SLANG_CHECK(_hasContents(empty, "prefix body suffix!?"));
+    }
+}
+
+SLANG_UNIT_TEST("ChunkedStringBuilder", chunkedStringBuilderUnitTest);
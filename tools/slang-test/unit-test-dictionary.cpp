@@ -0,0 +1,218 @@
+// unit-test-dictionary.cpp
+
+#include "../../source/core/dictionary.h"
+#include "../../source/core/slang-string.h"
+
+#include <stdlib.h>
+#include <unordered_map>
+
+#include "test-context.h"
+
+#include "../../source/core/slang-random-generator.h"
+
+using namespace Slang;
+
+namespace { // anonymous
+
+// A key whose hash only has a few distinct values, so groups fill up and removals leave deleted slots
+struct CollidingKey
+{
+    bool operator==(const CollidingKey& rhs) const { return value == rhs.value; }
+    int GetHashCode() const { return value & 7; }
+
+    int value;
+};
+
+// Returns memory that is only 8 byte aligned (never 16), and counts allocations
+struct MisalignedAllocator
+{
+    void* Alloc(size_t size)
+    {
+        s_allocCount++;
+        uint8_t* data = (uint8_t*)malloc(size + 24);
+        const size_t offset = ((size_t(data) & 15) == 0) ? 8 : 16;
+        data[offset - 1] = uint8_t(offset);
+        return data + offset;
+    }
+    void Free(void* ptr)
+    {
+        uint8_t* data = (uint8_t*)ptr;
+        free(data - data[-1]);
+    }
+
+    static int s_allocCount;
+};
+
+int MisalignedAllocator::s_allocCount = 0;
+
+struct IntKeyTraits
+{
+    typedef int Key;
+    static Key make(int value) { return value; }
+    static int getValue(Key key) { return key; }
+};
+
+struct StringKeyTraits
+{
+    typedef String Key;
+    static Key make(int value) { return String("key") + String(value); }
+    static int getValue(const Key& key) { return StringToInt(key.SubString(3, key.Length() - 3)); }
+};
+
+struct CollidingKeyTraits
+{
+    typedef CollidingKey Key;
+    static Key make(int value) { CollidingKey key; key.value = value; return key; }
+    static int getValue(const Key& key) { return key.value; }
+};
+
+} // anonymous
+
+template <typename TRAITS, typename DICT>
+static void _checkSame(const DICT& dict, const std::unordered_map<int, int>& map)
+{
+    SLANG_CHECK(dict.Count() == int(map.size()));
+
+    // Iteration visits every entry exactly once
+    std::unordered_map<int, int> seen;
+    for (auto& pair : dict)
+    {
+        const int value = TRAITS::getValue(pair.Key);
+        auto it = map.find(value);
+        SLANG_CHECK(it != map.end() && it->second == pair.Value);
+        seen[value]++;
+    }
+    SLANG_CHECK(seen.size() == map.size());
+    for (auto& pair : seen)
+    {
+        SLANG_CHECK(pair.second == 1);
+    }
+
+    for (auto& pair : map)
+    {
+        const typename TRAITS::Key key = TRAITS::make(pair.first);
+        int* value = dict.TryGetValue(key);
+        SLANG_CHECK(value && *value == pair.second);
+    }
+}
+
+template <typename TRAITS, typename DICT>
+static void _randomTest(DefaultRandomGenerator& randGen, int keyRange, int opCount)
+{
+    typedef typename TRAITS::Key Key;
+
+    DICT dict;
+    std::unordered_map<int, int> map;
+
+    for (int i = 0; i < opCount; ++i)
+    {
+        const int value = randGen.nextInt32UpTo(keyRange);
+        const Key key = TRAITS::make(value);
+        const bool present = map.find(value) != map.end();
+
+        switch (randGen.nextInt32UpTo(10))
+        {
+            case 0: case 1: case 2: case 3:
+            {
+                SLANG_CHECK(dict.AddIfNotExists(key, i) == !present);
+                if (!present)
+                {
+                    map[value] = i;
+                }
+                break;
+            }
+            case 4: case 5: case 6:
+            {
+                dict.Remove(key);
+                map.erase(value);
+                SLANG_CHECK(!dict.ContainsKey(key));
+                break;
+            }
+            case 7: case 8:
+            {
+                SLANG_CHECK(dict.ContainsKey(key) == present);
+                int found = -1;
+                SLANG_CHECK(dict.TryGetValue(key, found) == present);
+                SLANG_CHECK(!present || found == map[value]);
+                break;
+            }
+            default:
+            {
+                if (randGen.nextInt32UpTo(200) == 0)
+                {
+                    dict.Clear();
+                    map.clear();
+                }
+                else if (randGen.nextInt32UpTo(50) == 0)
+                {
+                    dict.Reserve(int(map.size()) + randGen.nextInt32UpTo(1000));
+                }
+                else if (randGen.nextInt32UpTo(20) == 0)
+                {
+                    _checkSame<TRAITS>(dict, map);
+                }
+                break;
+            }
+        }
+    }
+    _checkSame<TRAITS>(dict, map);
+
+    // Removing everything while iterating (which is allowed) leaves it empty
+    List<Key> keys;
+    for (auto& pair : dict)
+    {
+        keys.Add(pair.Key);
+    }
+    for (auto& pair : dict)
+    {
+        dict.Remove(pair.Key);
+    }
+    SLANG_CHECK(dict.Count() == 0);
+    for (auto& key : keys)
+    {
+        SLANG_CHECK(!dict.ContainsKey(key));
+    }
+}
+
+static void dictionaryUnitTest()
+{
+    DefaultRandomGenerator randGen(0x5d1c7);
+
+    // Small key ranges give lots of hits and removals, large ones make it grow
+    const int keyRanges[] = { 10, 100, 5000 };
+    for (auto keyRange : keyRanges)
+    {
+        _randomTest<IntKeyTraits, Dictionary<int, int>>(randGen, keyRange, 20000);
+        _randomTest<StringKeyTraits, Dictionary<String, int>>(randGen, keyRange, 20000);
+        _randomTest<CollidingKeyTraits, Dictionary<CollidingKey, int>>(randGen, keyRange, 20000);
+        _randomTest<IntKeyTraits, Dictionary<int, int, MisalignedAllocator>>(randGen, keyRange, 20000);
+        _randomTest<StringKeyTraits, Dictionary<String, int, MisalignedAllocator>>(randGen, keyRange, 20000);
+    }
+
+    // Keys that are added and removed over and over reuse deleted slots (or rehash in place),
+    // so it shouldn't keep allocating
+    {
+        Dictionary<CollidingKey, int, MisalignedAllocator> dict;
+        for (int i = 0; i < 64; ++i)
+        {
+            dict.Add(CollidingKeyTraits::make(i), i);
+        }
+
+        const int startAllocCount = MisalignedAllocator::s_allocCount;
+        for (int i = 64; i < 100000; ++i)
+        {
+            dict.Remove(CollidingKeyTraits::make(i - 64));
+            dict.Add(CollidingKeyTraits::make(i), i);
+        }
+        SLANG_CHECK(dict.Count() == 64);
+        for (int i = 100000 - 64; i < 100000; ++i)
+        {
+            int* value = dict.TryGetValue(CollidingKeyTraits::make(i));
+            SLANG_CHECK(value && *value == i);
+        }
+        // Rehashing to clear deleted slots allocates, but only every so often
+        SLANG_CHECK(MisalignedAllocator::s_allocCount - startAllocCount < 100000 / 16);
+    }
+}
+
+SLANG_UNIT_TEST("Dictionary", dictionaryUnitTest);
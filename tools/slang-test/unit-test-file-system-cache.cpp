@@ -0,0 +1,96 @@
+// unit-test-file-system-cache.cpp
+
+#include "../../slang.h"
+
+#include "../../source/core/slang-io.h"
+
+#include "test-context.h"
+
+#include <stdio.h>
+
+using namespace Slang;
+
+// Compiles path (without generating code) with a new request, returning the result
+static SlangResult _compile(SlangSession* session, const String& path)
+{
+    SlangCompileRequest* request = spCreateCompileRequest(session);
+    spSetCompileFlags(request, SLANG_COMPILE_FLAG_NO_CODEGEN);
+    const int translationUnitIndex = spAddTranslationUnit(request, SLANG_SOURCE_LANGUAGE_SLANG, nullptr);
+    spAddTranslationUnitSourceFile(request, translationUnitIndex, path.Buffer());
+    const SlangResult res = spCompile(request) ? SLANG_FAIL : SLANG_OK;
+    spDestroyCompileRequest(request);
+    return res;
+}
+
+static SlangFileSystemCacheStats _getStats(SlangSession* session)
+{
+    SlangFileSystemCacheStats stats = {};
+    SLANG_CHECK(SLANG_SUCCEEDED(spSessionGetFileSystemCacheStats(session, &stats)));
+    return stats;
+}
+
+static void fileSystemCacheUnitTest()
+{
+    const String sourcePath = "unit-test-file-system-cache.slang";
+    const String includePath = "unit-test-file-system-cache.h";
+
+    File::WriteAllText(sourcePath, "#include \"unit-test-file-system-cache.h\"\nfloat getValue() { return VALUE; }\n");
+    File::WriteAllText(includePath, "#define VALUE 1.0\n");
+
+    SlangSession* session = spCreateSession(nullptr);
+
+    // The cache isn't there until it's enabled
+    {
+        SlangFileSystemCacheStats stats;
+        SLANG_CHECK(spSessionGetFileSystemCacheStats(session, &stats) == SLANG_E_UNINITIALIZED);
+    }
+
+    spSessionSetFileSystemCacheEnabled(session, 1);
+
+    // The first request reads both files from disk
+    SLANG_CHECK(SLANG_SUCCEEDED(_compile(session, sourcePath)));
+    const SlangFileSystemCacheStats firstStats = _getStats(session);
+    SLANG_CHECK(firstStats.loadFileMisses >= 2);
+    SLANG_CHECK(firstStats.bytesRead > 0);
+    SLANG_CHECK(firstStats.revalidations == 0 && firstStats.invalidations == 0);
+
+    // The second request finds them in the cache, after checking they haven't changed
+    SLANG_CHECK(SLANG_SUCCEEDED(_compile(session, sourcePath)));
+    const SlangFileSystemCacheStats secondStats = _getStats(session);
+    SLANG_CHECK(secondStats.loadFileMisses == firstStats.loadFileMisses);
+    SLANG_CHECK(secondStats.loadFileHits >= firstStats.loadFileHits + 2);
+    SLANG_CHECK(secondStats.bytesRead == firstStats.bytesRead);
+    SLANG_CHECK(secondStats.revalidations >= 2);
+    SLANG_CHECK(secondStats.invalidations == 0);
+
+    // Changing the include (its size as well, in case the modification time doesn't change) is seen
+    // by the next request, which now fails as VALUE isn't defined
+    File::WriteAllText(includePath, "#define OTHER_VALUE 1.0\n");
+    SLANG_CHECK(SLANG_FAILED(_compile(session, sourcePath)));
+    const SlangFileSystemCacheStats thirdStats = _getStats(session);
+    SLANG_CHECK(thirdStats.invalidations == 1);
+    SLANG_CHECK(thirdStats.loadFileMisses == secondStats.loadFileMisses + 1);
+    SLANG_CHECK(thirdStats.bytesRead > secondStats.bytesRead);
+
+    // Explicitly invalidating everything reads both from disk again
+    File::WriteAllText(includePath, "#define VALUE 2.0\n");
+    spSessionInvalidateFileSystemCache(session, nullptr);
+    SLANG_CHECK(SLANG_SUCCEEDED(_compile(session, sourcePath)));
+    const SlangFileSystemCacheStats fourthStats = _getStats(session);
+    SLANG_CHECK(fourthStats.loadFileMisses >= thirdStats.loadFileMisses + 2);
+
+    // Disabling discards the cache
+    spSessionSetFileSystemCacheEnabled(session, 0);
+    {
+        SlangFileSystemCacheStats stats;
+        SLANG_CHECK(spSessionGetFileSystemCacheStats(session, &stats) == SLANG_E_UNINITIALIZED);
+    }
+    SLANG_CHECK(SLANG_SUCCEEDED(_compile(session, sourcePath)));
+
+    spDestroySession(session);
+
+    ::remove(sourcePath.Buffer());
+    ::remove(includePath.Buffer());
+}
+
+SLANG_UNIT_TEST("FileSystemCache", fileSystemCacheUnitTest);
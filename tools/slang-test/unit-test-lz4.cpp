@@ -0,0 +1,120 @@
+// unit-test-lz4.cpp
+
+#include "../../source/core/slang-lz4-util.h"
+
+#include "test-context.h"
+
+#include "../../source/core/slang-random-generator.h"
+#include "../../source/core/list.h"
+
+using namespace Slang;
+
+static bool _roundTrip(const List<uint8_t>& src)
+{
+    List<uint8_t> compressed;
+    LZ4Util::compress(src.begin(), size_t(src.Count()), compressed);
+    if (size_t(compressed.Count()) > LZ4Util::calcMaxCompressedSize(size_t(src.Count())))
+    {
+        return false;
+    }
+
+    // Decompress into a buffer with a guard byte, to check nothing is written past the end
+    List<uint8_t> decompressed;
+    decompressed.SetSize(src.Count() + 1);
+    decompressed[src.Count()] = 0xcd;
+
+    if (SLANG_FAILED(LZ4Util::decompress(compressed.begin(), size_t(compressed.Count()), decompressed.begin(), size_t(src.Count()))))
+    {
+        return false;
+    }
+    return decompressed[src.Count()] == 0xcd && memcmp(decompressed.begin(), src.begin(), src.Count()) == 0;
+}
+
+static void lz4UnitTest()
+{
+    DefaultRandomGenerator randGen(0x4c5a3421);
+
+    // Empty and tiny buffers are all literals
+    for (int size = 0; size < 20; ++size)
+    {
+        List<uint8_t> src;
+        for (int i = 0; i < size; ++i)
+        {
+            src.Add(uint8_t(i & 3));
+        }
+        SLANG_CHECK(_roundTrip(src));
+    }
+
+    // Random data doesn't compress, but must not grow beyond the maximum
+    {
+        List<uint8_t> src;
+        src.SetSize(100000);
+        for (auto& v : src)
+        {
+            v = uint8_t(randGen.nextInt32());
+        }
+        SLANG_CHECK(_roundTrip(src));
+    }
+
+    // Repetitive data, with long matches, and short overlapping matches
+    {
+        List<uint8_t> src;
+        for (int i = 0; i < 70000; ++i)
+        {
+            src.Add(uint8_t(i % 5));
+        }
+        for (int i = 0; i < 1000; ++i)
+        {
+            src.Add(0);
+        }
+        SLANG_CHECK(_roundTrip(src));
+
+        List<uint8_t> compressed;
+        LZ4Util::compress(src.begin(), size_t(src.Count()), compressed);
+        SLANG_CHECK(compressed.Count() < src.Count() / 50);
+    }
+
+    // Data like serialized arrays, with runs of small values and random words
+    {
+        List<uint8_t> src;
+        for (int i = 0; i < 30000; ++i)
+        {
+            const int32_t value = randGen.nextInt32UpTo(8) ? randGen.nextInt32UpTo(16) : randGen.nextInt32();
+            const uint8_t* bytes = (const uint8_t*)&value;
+            src.AddRange(bytes, sizeof(value));
+        }
+        SLANG_CHECK(_roundTrip(src));
+    }
+
+    // Corrupt or truncated input fails (or at least stays in bounds)
+    {
+        List<uint8_t> src;
+        for (int i = 0; i < 4000; ++i)
+        {
+            src.Add(uint8_t((i * 7) % 13));
+        }
+        List<uint8_t> compressed;
+        LZ4Util::compress(src.begin(), size_t(src.Count()), compressed);
+
+        List<uint8_t> dst;
+        dst.SetSize(src.Count());
+
+        // Wrong size
+        SLANG_CHECK(SLANG_FAILED(LZ4Util::decompress(compressed.begin(), size_t(compressed.Count()), dst.begin(), size_t(src.Count() - 1))));
+        SLANG_CHECK(SLANG_FAILED(LZ4Util::decompress(compressed.begin(), size_t(compressed.Count() - 1), dst.begin(), size_t(src.Count()))));
+
+        // Offset before the start of the output
+        const uint8_t badOffset[] = { 0x10, 'a', 0x02, 0x00, 0x00 };
+        SLANG_CHECK(SLANG_FAILED(LZ4Util::decompress(badOffset, sizeof(badOffset), dst.begin(), 5)));
+
+        // Randomly changed bytes never write out of bounds
+        for (int i = 0; i < 100; ++i)
+        {
+            List<uint8_t> corrupt(compressed);
+            corrupt[randGen.nextInt32UpTo(int32_t(corrupt.Count()))] = uint8_t(randGen.nextInt32());
+            LZ4Util::decompress(corrupt.begin(), size_t(corrupt.Count()), dst.begin(), size_t(dst.Count()));
+        }
+    }
+}
+
+SLANG_UNIT_TEST("LZ4", lz4UnitTest);
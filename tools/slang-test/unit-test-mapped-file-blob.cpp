@@ -0,0 +1,107 @@
+// unit-test-mapped-file-blob.cpp
+
+#include "../../source/core/slang-io.h"
+#include "../../source/core/stream.h"
+#include "../../source/core/slang-string-util.h"
+
+#include "test-context.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   define NOMINMAX
+#   include <Windows.h>
+#   undef WIN32_LEAN_AND_MEAN
+#   undef NOMINMAX
+#else
+#   include <unistd.h>
+#endif
+
+using namespace Slang;
+
+static size_t _getPageSize()
+{
+#ifdef _WIN32
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return size_t(systemInfo.dwPageSize);
+#else
+    return size_t(::sysconf(_SC_PAGESIZE));
+#endif
+}
+
+static void _writeFile(const String& path, const List<char>& contents)
+{
+    FileStream stream(path, FileMode::Create);
+    stream.Write(contents.Buffer(), Int64(contents.Count()));
+}
+
+static void mappedFileBlobUnitTest()
+{
+    const String path = "unit-test-mapped-file-blob.tmp";
+
+    // Sizes either side of (and on) one and several pages
+    const size_t pageSize = _getPageSize();
+    SLANG_CHECK(pageSize > 0);
+    const size_t sizes[] = { 1, 2, 100, pageSize - 1, pageSize, pageSize + 1, pageSize * 2, pageSize * 16 - 1, pageSize * 16, pageSize * 16 + 1 };
+
+    List<char> contents;
+    for (auto size : sizes)
+    {
+        contents.SetSize(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            // Ends with a backslash, which the lexer looks past
+            contents[i] = (i + 1 == size) ? '\\' : char('a' + (i % 26));
+        }
+
+        _writeFile(path, contents);
+
+        ComPtr<ISlangBlob> blob;
+        SlangResult res = MappedFileBlob::create(path, blob);
+        if (SLANG_SUCCEEDED(res))
+        {
+            // Contents are the same, and followed by a zero
+            const char* data = (const char*)blob->getBufferPointer();
+            SLANG_CHECK(blob->getBufferSize() == size);
+            SLANG_CHECK(::memcmp(data, contents.Buffer(), size) == 0);
+            SLANG_CHECK(data[size] == 0);
+
+            MappedFileBlob* mappedBlob = MappedFileBlob::getMappedFileBlob(blob);
+            SLANG_CHECK(mappedBlob && mappedBlob->isFileUnchanged());
+        }
+        else
+        {
+            // Can only fail if there is no room for the terminating zero
+            SLANG_CHECK(res == SLANG_E_CANNOT_OPEN && (size % pageSize) == 0);
+        }
+    }
+
+    // A blob that isn't a mapping isn't mistaken for one
+    SLANG_CHECK(MappedFileBlob::getMappedFileBlob(StringUtil::createStringBlob("mapped")) == nullptr);
+
+    // Rewriting the file is noticed. (The mapping isn't read after that, as reading past the
+    // end of a file that has been truncated is fatal on some platforms.)
+    {
+        ComPtr<ISlangBlob> blob;
+        SLANG_CHECK(SLANG_SUCCEEDED(MappedFileBlob::create(path, blob)));
+        MappedFileBlob* mappedBlob = MappedFileBlob::getMappedFileBlob(blob);
+        SLANG_CHECK(mappedBlob && mappedBlob->isFileUnchanged());
+
+        contents.SetSize(contents.Count() + 1);
+        contents[contents.Count() - 1] = 'x';
+        _writeFile(path, contents);
+        SLANG_CHECK(!mappedBlob->isFileUnchanged());
+    }
+
+    ::remove(path.Buffer());
+
+    {
+        ComPtr<ISlangBlob> blob;
+        SLANG_CHECK(MappedFileBlob::create(path, blob) == SLANG_E_NOT_FOUND);
+    }
+}
+
+SLANG_UNIT_TEST("MappedFileBlob", mappedFileBlobUnitTest);
@@ -10,6 +10,8 @@
 
 #include "../../source/core/slang-random-generator.h"
 #include "../../source/core/list.h"
+#include "../../source/core/dictionary.h"
+#include "../../source/core/slang-string.h"
 
 using namespace Slang;
 
@@ -33,6 +35,12 @@ enum class TestMode
     eCount,
 };
 
+struct Mark
+{
+    MemoryArena::Mark m_mark;
+    int m_blockCount;
+};
+
 } // anonymous
 
 static size_t getAlignment(TestMode mode)
@@ -150,6 +158,7 @@ static void memoryArenaUnitTest()
             arena.init(blockSize, alignment);
 
             List<Block> blocks;
+            List<Mark> marks;
 
             for (int i = 0; i < 10000; i++)
             {
@@ -163,11 +172,13 @@ static void memoryArenaUnitTest()
                         // Deallocate everything
                         arena.deallocateAll();
                         blocks.Clear();
+                        marks.Clear();
                     }   
                     else if (var == 2)
                     {
                         arena.reset();
                         blocks.Clear();
+                        marks.Clear();
                     }
                     else
                     {
@@ -177,6 +188,22 @@ static void memoryArenaUnitTest()
                         SLANG_CHECK(allocatedMemory >= usedMemory);
                     }
                 }
+                else if (var < 40)
+                {
+                    Mark mark;
+                    mark.m_mark = arena.mark();
+                    mark.m_blockCount = int(blocks.Count());
+                    marks.Add(mark);
+                }
+                else if (var < 70 && marks.Count() > 0)
+                {
+                    // Rewind to the most recent mark, which deallocates all the blocks allocated since
+                    const Mark mark = marks.Last();
+                    marks.RemoveLast();
+
+                    arena.rewind(mark.m_mark);
+                    blocks.SetSize(mark.m_blockCount);
+                }
                 else
                 {
                     size_t sizeInBytes = (randGen.nextInt32() & 255) + 1;
@@ -248,6 +275,70 @@ static void memoryArenaUnitTest()
             }
         }
     }
+
+    {
+        // Rewinding keeps regular blocks for reuse
+        MemoryArena arena(1024);
+        arena.allocate(100);
+        const MemoryArena::Mark mark = arena.mark();
+        for (int i = 0; i < 20; ++i)
+        {
+            arena.allocate(500);
+        }
+        arena.allocate(4096);
+
+        const size_t allocatedMemory = arena.calcTotalMemoryAllocated();
+        arena.rewind(mark);
+        SLANG_CHECK(arena.calcTotalMemoryUsed() <= 1024 + 100);
+        SLANG_CHECK(arena.calcTotalMemoryAllocated() < allocatedMemory);
+
+        for (int i = 0; i < 20; ++i)
+        {
+            arena.allocate(500);
+        }
+        SLANG_CHECK(arena.calcTotalMemoryAllocated() < allocatedMemory);
+
+        // Rewinding to before the first allocation
+        arena.deallocateAll();
+        const MemoryArena::Mark emptyMark = arena.mark();
+        arena.allocate(100);
+        arena.rewind(emptyMark);
+        SLANG_CHECK(arena.calcTotalMemoryUsed() == 0);
+    }
+
+    {
+        // Containers on the thread scratch arena
+        MemoryArena& scratch = MemoryArena::getThreadScratch();
+        const size_t usedMemory = scratch.calcTotalMemoryUsed();
+        {
+            MemoryArenaScope scope;
+
+            List<int, ScratchAllocator> list;
+            Dictionary<int, int, ScratchAllocator> dict;
+            HashSet<String, ScratchAllocator> set;
+            for (int i = 0; i < 1000; ++i)
+            {
+                list.Add(i);
+                dict.Add(i, i * 2);
+                set.Add(String(i));
+            }
+
+            {
+                MemoryArenaScope innerScope;
+                List<int, ScratchAllocator> innerList;
+                innerList.SetSize(1000);
+            }
+
+            bool isOk = (list.Count() == 1000) && (dict.Count() == 1000) && (set.Count() == 1000);
+            for (int i = 0; i < 1000 && isOk; ++i)
+            {
+                isOk = (list[i] == i) && dict.ContainsKey(i) && (dict[i].GetValue() == i * 2) && set.Contains(String(i));
+            }
+            SLANG_CHECK(isOk);
+            SLANG_CHECK(scratch.calcTotalMemoryUsed() > usedMemory);
+        }
+        SLANG_CHECK(scratch.calcTotalMemoryUsed() == usedMemory);
+    }
 }
 
 SLANG_UNIT_TEST("MemoryArena", memoryArenaUnitTest);
\ No newline at end of file
@@ -0,0 +1,114 @@
+// unit-test-name-pool.cpp
+
+#include "../../source/slang/name.h"
+
+#include "test-context.h"
+
+#include "../../source/core/slang-random-generator.h"
+
+using namespace Slang;
+
+namespace { // anonymous
+
+// Gives access to the keyword table, so the test can check which names share a slot with a keyword
+struct TestRootNamePool : public RootNamePool
+{
+    bool hasKeywordTable() const { return m_keywordTable.Count() != 0; }
+    UInt getKeywordSlot(int hash) const { return UInt((uint32_t(hash) * m_keywordMultiplier) >> m_keywordShift); }
+    Name* getKeywordInSlot(UInt slot) const { return m_keywordTable[slot].name; }
+};
+
+} // anonymous
+
+static void namePoolUnitTest()
+{
+    static const char* const kKeywords[] =
+    {
+        "break", "case", "class", "continue", "default", "discard", "do", "else",
+        "enum", "for", "if", "let", "operator", "packoffset", "register", "return",
+        "struct", "switch", "void", "while", "this", "true", "false", "typedef",
+        "cbuffer", "tbuffer", "static", "const", "in", "out", "inout", "uniform",
+    };
+
+    TestRootNamePool rootPool;
+    NamePool pool;
+    pool.setRootNamePool(&rootPool);
+
+    // The same text always gives the same name, whichever overload is used
+    List<Name*> keywordNames;
+    for (auto keyword : kKeywords)
+    {
+        Name* name = pool.getName(String(keyword));
+        SLANG_CHECK(name->text == keyword);
+        SLANG_CHECK(name->hash == String(keyword).GetHashCode());
+        SLANG_CHECK(pool.getName(UnownedTerminatedStringSlice(keyword)) == name);
+        keywordNames.Add(name);
+        rootPool.addKeyword(name);
+    }
+    // Adding a keyword twice is harmless
+    rootPool.addKeyword(keywordNames[0]);
+
+    // Every keyword is found, through the keyword table
+    for (UInt ii = 0; ii < keywordNames.Count(); ++ii)
+    {
+        const UnownedStringSlice text = UnownedTerminatedStringSlice(kKeywords[ii]);
+        SLANG_CHECK(rootPool.findName(text, text.GetHashCode()) == keywordNames[ii]);
+    }
+    SLANG_CHECK(rootPool.hasKeywordTable());
+    for (auto name : keywordNames)
+    {
+        SLANG_CHECK(rootPool.getKeywordInSlot(rootPool.getKeywordSlot(name->hash)) == name);
+    }
+
+    // Lots of other names (enough to grow the main table several times). Many share a
+    // slot in the keyword table with a keyword, and must not be found as that keyword.
+    DefaultRandomGenerator randGen(0x4e616d65);
+    List<String> texts;
+    List<Name*> names;
+    int collisionCount = 0;
+    for (int ii = 0; ii < 20000; ++ii)
+    {
+        StringBuilder builder;
+        const int length = 1 + randGen.nextInt32UpTo(10);
+        for (int jj = 0; jj < length; ++jj)
+        {
+            builder.Append(char('a' + randGen.nextInt32UpTo(26)));
+        }
+        builder.Append(Int32(ii));
+        const String text = builder.ProduceString();
+
+        const UnownedStringSlice slice = text.getUnownedSlice();
+        const int hash = slice.GetHashCode();
+        if (rootPool.getKeywordInSlot(rootPool.getKeywordSlot(hash)))
+        {
+            collisionCount++;
+        }
+
+        SLANG_CHECK(rootPool.findName(slice, hash) == nullptr);
+        Name* name = pool.getName(slice, hash);
+        SLANG_CHECK(name && name->text == text && keywordNames.IndexOf(name) == UInt(-1));
+
+        texts.Add(text);
+        names.Add(name);
+    }
+    SLANG_CHECK(collisionCount > 0);
+    SLANG_CHECK(rootPool.getNameCount() == keywordNames.Count() + names.Count());
+
+    // Everything is still found after the table has grown
+    for (UInt ii = 0; ii < names.Count(); ++ii)
+    {
+        SLANG_CHECK(pool.getName(texts[ii]) == names[ii]);
+    }
+    for (UInt ii = 0; ii < keywordNames.Count(); ++ii)
+    {
+        SLANG_CHECK(pool.getName(String(kKeywords[ii])) == keywordNames[ii]);
+    }
+
+    // Keywords added after lookups have been made are found too
+    Name* lateKeyword = names[0];
+    rootPool.addKeyword(lateKeyword);
+    SLANG_CHECK(rootPool.findName(texts[0].getUnownedSlice(), texts[0].GetHashCode()) == lateKeyword);
+    SLANG_CHECK(rootPool.getKeywordInSlot(rootPool.getKeywordSlot(lateKeyword->hash)) == lateKeyword);
+}
+
+SLANG_UNIT_TEST("NamePool", namePoolUnitTest);
@@ -0,0 +1,113 @@
+// unit-test-serial-source-loc-table.cpp
+
+#include "../../source/slang/serial-source-loc-table.h"
+
+#include "test-context.h"
+
+#include "../../source/core/slang-random-generator.h"
+
+using namespace Slang;
+
+// Encodes locs, decodes the table, and checks expanding the runs gives back the same locations
+static void _checkRoundTrip(const List<SourceLoc::RawValue>& locs)
+{
+    List<uint8_t> table;
+    SerialSourceLocTableUtil::encode(locs.Buffer(), int(locs.Count()), table);
+
+    List<SerialSourceLocRun> runs;
+    SLANG_CHECK(SLANG_SUCCEEDED(SerialSourceLocTableUtil::decode(table.Buffer(), table.Count(), runs)));
+
+    List<SourceLoc::RawValue> decodedLocs;
+    decodedLocs.SetSize(locs.Count());
+    for (UInt i = 0; i < decodedLocs.Count(); ++i)
+    {
+        decodedLocs[i] = 0;
+    }
+
+    uint32_t prevEnd = 1;
+    for (const auto& run : runs)
+    {
+        // Runs are in instruction order, don't overlap, and never hold 'no location'
+        SLANG_CHECK(run.startInstIndex >= prevEnd && run.numInst > 0 && run.m_sourceLoc != 0);
+        SLANG_CHECK(UInt(run.startInstIndex + run.numInst) <= locs.Count());
+        if (UInt(run.startInstIndex + run.numInst) > locs.Count())
+        {
+            return;
+        }
+        for (uint32_t i = 0; i < run.numInst; ++i)
+        {
+            decodedLocs[run.startInstIndex + i] = run.m_sourceLoc;
+        }
+        prevEnd = run.startInstIndex + run.numInst;
+    }
+
+    // Index 0 is the null instruction, which has no location
+    for (UInt i = 1; i < locs.Count(); ++i)
+    {
+        SLANG_CHECK(decodedLocs[i] == locs[i]);
+    }
+
+    // A truncated table is either a prefix of the runs, or fails - it never reads past the end
+    if (table.Count() > 0)
+    {
+        List<SerialSourceLocRun> truncatedRuns;
+        if (SLANG_SUCCEEDED(SerialSourceLocTableUtil::decode(table.Buffer(), table.Count() - 1, truncatedRuns)))
+        {
+            SLANG_CHECK(truncatedRuns.Count() <= runs.Count());
+        }
+    }
+}
+
+static void serialSourceLocTableUnitTest()
+{
+    // Nothing, or just the null instruction
+    {
+        List<SourceLoc::RawValue> locs;
+        _checkRoundTrip(locs);
+        locs.Add(0);
+        _checkRoundTrip(locs);
+    }
+
+    // Runs that go forwards and backwards, with gaps that have no location
+    {
+        const SourceLoc::RawValue values[] = { 0, 10, 10, 10, 12, 11, 0, 0, 11, 5, 5, 1000, 999, 0, 1 };
+        List<SourceLoc::RawValue> locs;
+        locs.AddRange(values, SLANG_COUNT_OF(values));
+        _checkRoundTrip(locs);
+    }
+
+    // Locations from several source files are in separate, far apart ranges. Jumping between them
+    // (as happens with inlined or included code) gives large differences in either direction.
+    {
+        const SourceLoc::RawValue fileStarts[] = { 1, 0x10000, 0x7fff0000, 0xfffff000 };
+
+        DefaultRandomGenerator randGen(0x10c7ab1e);
+        List<SourceLoc::RawValue> locs;
+        locs.Add(0);
+
+        SourceLoc::RawValue loc = fileStarts[0];
+        for (int i = 0; i < 20000; ++i)
+        {
+            switch (randGen.nextInt32UpTo(8))
+            {
+                case 0:     loc = fileStarts[randGen.nextInt32UpTo(SLANG_COUNT_OF(fileStarts))] + randGen.nextInt32UpTo(0x800); break;
+                case 1:     loc = 0; break;
+                case 2:     loc -= (loc > 16) ? randGen.nextInt32UpTo(16) : 0; break;
+                case 3:
+                case 4:     loc += randGen.nextInt32UpTo(64); break;
+                default:    break;
+            }
+            locs.Add(loc);
+        }
+        _checkRoundTrip(locs);
+    }
+
+    // A table that ends part way through a value fails to decode
+    {
+        const uint8_t table[] = { 1, 0xff };
+        List<SerialSourceLocRun> runs;
+        SLANG_CHECK(SLANG_FAILED(SerialSourceLocTableUtil::decode(table, sizeof(table), runs)));
+    }
+}
+
+SLANG_UNIT_TEST("SerialSourceLocTable", serialSourceLocTableUnitTest);
@@ -0,0 +1,192 @@
+// unit-test-source-loc.cpp
+
+#include "../../source/slang/source-loc.h"
+
+#include "test-context.h"
+
+#include "../../source/core/slang-random-generator.h"
+
+using namespace Slang;
+
+// Finds the line break offsets one byte at a time. A '\r\n' or '\n\r' pair is a single line break.
+static List<uint32_t> _calcLineBreakOffsets(const String& content)
+{
+    List<uint32_t> offsets;
+    offsets.Add(0);
+
+    const char* chars = content.Buffer();
+    const UInt size = content.Length();
+    for (UInt i = 0; i < size; ++i)
+    {
+        const char c = chars[i];
+        if (c == '\r' || c == '\n')
+        {
+            if (i + 1 < size && (c ^ chars[i + 1]) == ('\r' ^ '\n'))
+            {
+                i++;
+            }
+            offsets.Add(uint32_t(i + 1));
+        }
+    }
+    return offsets;
+}
+
+static bool _areEqual(const List<uint32_t>& a, const List<uint32_t>& b)
+{
+    if (a.Count() != b.Count())
+    {
+        return false;
+    }
+    for (UInt i = 0; i < a.Count(); ++i)
+    {
+        if (a[i] != b[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static String _makeContent(DefaultRandomGenerator& randGen, int size)
+{
+    // Mostly text, with lots of line breaks of each kind, so they fall at every position in a block
+    const char chars[] = "ab \t;{}\r\n\n\n\r";
+    StringBuilder builder;
+    for (int i = 0; i < size; ++i)
+    {
+        builder.Append(chars[randGen.nextInt32UpTo(SLANG_COUNT_OF(chars) - 1)]);
+    }
+    return builder.ProduceString();
+}
+
+// Checks the humane location of every offset of the view, looking them up in the order given
+static void _checkLocs(SourceManager& sourceManager, SourceView* view, const List<uint32_t>& lineBreakOffsets, const List<int>& offsets)
+{
+    const SourceLoc begin = view->getRange().begin;
+    for (auto offset : offsets)
+    {
+        int lineIndex = 0;
+        while (lineIndex + 1 < int(lineBreakOffsets.Count()) && lineBreakOffsets[lineIndex + 1] <= uint32_t(offset))
+        {
+            lineIndex++;
+        }
+
+        const HumaneSourceLoc humaneLoc = sourceManager.getHumaneLoc(begin + offset);
+        SLANG_CHECK(humaneLoc.line == lineIndex + 1);
+        SLANG_CHECK(humaneLoc.column == offset - int(lineBreakOffsets[lineIndex]) + 1);
+        SLANG_CHECK(humaneLoc.pathInfo.foundPath == view->getSourceFile()->pathInfo.foundPath);
+    }
+}
+
+static void sourceLocUnitTest()
+{
+    DefaultRandomGenerator randGen(0x50c10c);
+
+    SourceManager sourceManager;
+    sourceManager.initialize(nullptr);
+
+    // Sizes around the block size used to scan for line breaks
+    const int sizes[] = { 0, 1, 2, 15, 16, 17, 31, 32, 33, 100, 4099 };
+
+    List<SourceView*> views;
+    List<List<uint32_t>> viewLineBreakOffsets;
+    for (auto size : sizes)
+    {
+        const String content = _makeContent(randGen, size);
+        const List<uint32_t> lineBreakOffsets = _calcLineBreakOffsets(content);
+
+        SourceFile* sourceFile = sourceManager.createSourceFile(PathInfo::makePath(String("file") + String(size)), content);
+        SLANG_CHECK(_areEqual(sourceFile->getLineBreakOffsets(), lineBreakOffsets));
+
+        views.Add(sourceManager.createSourceView(sourceFile));
+        viewLineBreakOffsets.Add(lineBreakOffsets);
+    }
+
+    // Content ending with a line break, or half of a '\r\n'
+    {
+        SourceFile* sourceFile = sourceManager.createSourceFile(PathInfo::makePath("endsWithCR"), String("a\r\nb\r"));
+        const List<uint32_t>& lineBreakOffsets = sourceFile->getLineBreakOffsets();
+        SLANG_CHECK(lineBreakOffsets.Count() == 3 && lineBreakOffsets[1] == 3 && lineBreakOffsets[2] == 5);
+    }
+
+    // Forwards, backwards, and in random order through each view
+    for (UInt i = 0; i < views.Count(); ++i)
+    {
+        const int size = sizes[i];
+        List<int> offsets;
+        for (int offset = 0; offset <= size; ++offset)
+        {
+            offsets.Add(offset);
+        }
+        _checkLocs(sourceManager, views[i], viewLineBreakOffsets[i], offsets);
+
+        offsets.Reverse();
+        _checkLocs(sourceManager, views[i], viewLineBreakOffsets[i], offsets);
+
+        for (int j = 0; j <= size; ++j)
+        {
+            offsets[j] = randGen.nextInt32UpTo(size + 1);
+        }
+        _checkLocs(sourceManager, views[i], viewLineBreakOffsets[i], offsets);
+    }
+
+    // Alternating between views, so the cached view and line are rarely hits
+    for (int i = 0; i < 2000; ++i)
+    {
+        const int viewIndex = randGen.nextInt32UpTo(int(views.Count()));
+        List<int> offsets;
+        offsets.Add(randGen.nextInt32UpTo(sizes[viewIndex] + 1));
+        _checkLocs(sourceManager, views[viewIndex], viewLineBreakOffsets[viewIndex], offsets);
+    }
+
+    // Looking up a batch, with runs in the same view (and locations that aren't in any view),
+    // gives the same results as looking them up one at a time
+    {
+        List<SourceLoc> locs;
+        for (int i = 0; i < 2000; ++i)
+        {
+            const int viewIndex = randGen.nextInt32UpTo(int(views.Count()));
+            const int runCount = randGen.nextInt32UpTo(4) + 1;
+            for (int j = 0; j < runCount; ++j)
+            {
+                locs.Add(views[viewIndex]->getRange().begin + randGen.nextInt32UpTo(sizes[viewIndex] + 1));
+            }
+            if (randGen.nextInt32UpTo(16) == 0)
+            {
+                locs.Add(SourceLoc());
+            }
+        }
+
+        List<HumaneSourceLoc> humaneLocs;
+        humaneLocs.SetSize(locs.Count());
+        sourceManager.getHumaneLocs(locs.Buffer(), locs.Count(), humaneLocs.Buffer());
+        for (UInt i = 0; i < locs.Count(); ++i)
+        {
+            const HumaneSourceLoc humaneLoc = sourceManager.getHumaneLoc(locs[i]);
+            SLANG_CHECK(humaneLocs[i].line == humaneLoc.line && humaneLocs[i].column == humaneLoc.column &&
+                humaneLocs[i].pathInfo.foundPath == humaneLoc.pathInfo.foundPath);
+        }
+    }
+
+    // A #line directive changes the nominal location, but not the actual one
+    {
+        SourceFile* sourceFile = sourceManager.createSourceFile(PathInfo::makePath("directive"), String("a\nb\nc\nd\n"));
+        SourceView* view = sourceManager.createSourceView(sourceFile);
+        const SourceLoc begin = view->getRange().begin;
+
+        // The line after the directive (which is on the second line) is line 10
+        view->addLineDirective(begin + 2, "other", 10);
+
+        HumaneSourceLoc humaneLoc = sourceManager.getHumaneLoc(begin + 4);
+        SLANG_CHECK(humaneLoc.line == 10 && humaneLoc.pathInfo.foundPath == "other");
+        humaneLoc = sourceManager.getHumaneLoc(begin + 4, SourceLocType::Actual);
+        SLANG_CHECK(humaneLoc.line == 3 && humaneLoc.pathInfo.foundPath == "directive");
+        humaneLoc = sourceManager.getHumaneLoc(begin);
+        SLANG_CHECK(humaneLoc.line == 1 && humaneLoc.pathInfo.foundPath == "directive");
+    }
+
+    // A location that isn't in any view
+    SLANG_CHECK(sourceManager.getHumaneLoc(SourceLoc()).line == 0);
+}
+
+SLANG_UNIT_TEST("SourceLoc", sourceLocUnitTest);
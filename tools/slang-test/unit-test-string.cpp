@@ -0,0 +1,106 @@
+// unit-test-string.cpp
+
+#include "../../source/core/slang-string.h"
+
+#include "test-context.h"
+
+using namespace Slang;
+
+static bool _hasContents(const String& str, const char* contents)
+{
+    const UInt length = UInt(strlen(contents));
+    return str.Length() == length &&
+        strcmp(str.Buffer(), contents) == 0 &&
+        str.Buffer()[length] == 0 &&
+        str.getUnownedSlice() == UnownedStringSlice(contents, length) &&
+        str.GetHashCode() == UnownedStringSlice(contents, length).GetHashCode();
+}
+
+static void stringUnitTest()
+{
+    // Grow a string one char at a time, across reallocations of its buffer
+    {
+        char expected[64] = { 0 };
+        String str;
+        SLANG_CHECK(_hasContents(str, ""));
+        for (int i = 0; i < 40; ++i)
+        {
+            expected[i] = char('a' + (i % 26));
+            str.append(expected[i]);
+            SLANG_CHECK(_hasContents(str, expected));
+        }
+    }
+
+    // Copies and moves of empty, short and long strings
+    {
+        const char* const texts[] = { "", "x", "abcdefghijklmn", "abcdefghijklmno", "a much longer string than the rest" };
+        for (auto text : texts)
+        {
+            String str(text);
+            String copy(str);
+            SLANG_CHECK(_hasContents(copy, text));
+            SLANG_CHECK(copy == str);
+
+            String moved(_Move(copy));
+            SLANG_CHECK(_hasContents(moved, text));
+            SLANG_CHECK(_hasContents(copy, ""));
+
+            String assigned;
+            assigned = moved;
+            SLANG_CHECK(_hasContents(assigned, text));
+            assigned = assigned;
+            SLANG_CHECK(_hasContents(assigned, text));
+
+            // Changing a copy doesn't change the original
+            assigned.append("!");
+            SLANG_CHECK(_hasContents(moved, text));
+
+            assigned = String();
+            SLANG_CHECK(_hasContents(assigned, ""));
+        }
+    }
+
+    // Appending a string to itself
+    {
+        String str("abcdef");
+        str.append(str);
+        SLANG_CHECK(_hasContents(str, "abcdefabcdef"));
+        str.append(str);
+        SLANG_CHECK(_hasContents(str, "abcdefabcdefabcdefabcdef"));
+    }
+
+    // Appending numbers
+    {
+        String str(int32_t(-12345));
+        SLANG_CHECK(_hasContents(str, "-12345"));
+        str.append(uint64_t(678));
+        SLANG_CHECK(_hasContents(str, "-12345678"));
+    }
+
+    // The representation holds the contents, and is shared by copies
+    {
+        String str("short");
+        StringRepresentation* rep = str.getStringRepresentation();
+        SLANG_CHECK(rep && StringRepresentation::asSlice(rep) == UnownedStringSlice("short"));
+        SLANG_CHECK(String(str).getStringRepresentation() == rep);
+        SLANG_CHECK(_hasContents(str, "short"));
+
+        SLANG_CHECK(String().getStringRepresentation() == nullptr);
+    }
+
+    // Slices and hashing
+    {
+        String str("  hello  ");
+        SLANG_CHECK(String(str.Trim()) == "hello");
+        SLANG_CHECK(String(str.SubString(2, 3)) == "hel");
+        SLANG_CHECK(String("hello").GetHashCode() == String(str.Trim()).GetHashCode());
+
+        StringBuilder builder;
+        builder << "hel" << "lo";
+        SLANG_CHECK(builder.ProduceString().GetHashCode() == String("hello").GetHashCode());
+        builder << "!";
+        SLANG_CHECK(_hasContents(builder, "hello!"));
+    }
+}
+
+SLANG_UNIT_TEST("String", stringUnitTest);
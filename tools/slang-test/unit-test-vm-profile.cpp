@@ -0,0 +1,131 @@
+// unit-test-vm-profile.cpp
+
+#include "../../slang.h"
+
+#include "../../source/core/slang-string.h"
+
+#include "test-context.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Slang;
+
+static const char kKernelSource[] =
+    "StructuredBuffer<int> input;\n"
+    "RWStructuredBuffer<int> output;\n"
+    "int twice(int value) { return value * 2; }\n"
+    "[numthreads(4, 1, 1)]\n"
+    "void main(uint tid : SV_DispatchThreadID)\n"
+    "{\n"
+    "    output[tid] = twice(input[tid]) + 1;\n"
+    "}\n";
+
+// The JSON report of a VM that has counted nothing
+static const char kEmptyJSONReport[] = "{\n  \"ops\": [\n  ],\n  \"functions\": [\n  ],\n  \"callSites\": [\n  ]\n}\n";
+
+// Find the number following `prefix` in the report, or return -1 if prefix isn't found
+static int64_t _findCount(const char* report, const char* prefix)
+{
+    const char* found = strstr(report, prefix);
+    return found ? int64_t(strtoull(found + strlen(prefix), nullptr, 10)) : -1;
+}
+
+static void _dispatch(SlangVMModule* vmModule, SlangVMFunc* vmFunc, uint32_t threadCount)
+{
+    SlangVMDispatchDesc desc = {};
+    desc.groupCount[0] = threadCount / 4;
+    desc.groupCount[1] = 1;
+    desc.groupCount[2] = 1;
+    desc.groupSize[0] = 4;
+    desc.groupSize[1] = 1;
+    desc.groupSize[2] = 1;
+    desc.laneCount = 1;
+    desc.workerCount = 2;
+    SLANG_CHECK(SLANG_SUCCEEDED(SlangVM_dispatch(vmModule, vmFunc, &desc)));
+}
+
+static void vmProfileUnitTest()
+{
+    SlangSession* session = spCreateSession(nullptr);
+    SlangCompileRequest* request = spCreateCompileRequest(session);
+
+    spSetOutputContainerFormat(request, SLANG_CONTAINER_FORMAT_SLANG_MODULE);
+    const int translationUnitIndex = spAddTranslationUnit(request, SLANG_SOURCE_LANGUAGE_SLANG, nullptr);
+    spAddTranslationUnitSourceString(request, translationUnitIndex, "vm-profile.slang", kKernelSource);
+    spAddEntryPoint(request, translationUnitIndex, "main", spFindProfile(session, "cs_5_0"));
+
+    SLANG_CHECK(spCompile(request) == 0);
+
+    size_t bytecodeSize = 0;
+    const void* bytecode = spGetCompileRequestCode(request, &bytecodeSize);
+    SLANG_CHECK(bytecode && bytecodeSize > 0);
+    if (!bytecode)
+    {
+        spDestroyCompileRequest(request);
+        spDestroySession(session);
+        return;
+    }
+
+    SlangVM* vm = SlangVM_create();
+    SlangVMModule* vmModule = SlangVMModule_load(vm, bytecode, bytecodeSize);
+    SlangVMFunc* vmFunc = (SlangVMFunc*)SlangVMModule_findGlobalSymbolPtr(vmModule, "main");
+
+    const uint32_t threadCount = 8;
+    int32_t inputData[threadCount];
+    int32_t outputData[threadCount];
+    for (uint32_t i = 0; i < threadCount; ++i)
+    {
+        inputData[i] = int32_t(i);
+        outputData[i] = 0;
+    }
+    *(int32_t**)SlangVMModule_findGlobalSymbolPtr(vmModule, "input") = inputData;
+    *(int32_t**)SlangVMModule_findGlobalSymbolPtr(vmModule, "output") = outputData;
+
+    // Nothing has run yet
+    SLANG_CHECK(strcmp(SlangVM_getProfileReport(vm, SLANG_VM_PROFILE_FORMAT_JSON), kEmptyJSONReport) == 0);
+
+    SlangVM_setProfilingEnabled(vm, 1);
+    _dispatch(vmModule, vmFunc, threadCount);
+
+    for (uint32_t i = 0; i < threadCount; ++i)
+    {
+        SLANG_CHECK(outputData[i] == int32_t(i * 2 + 1));
+    }
+
+    {
+        const char* report = SlangVM_getProfileReport(vm, SLANG_VM_PROFILE_FORMAT_JSON);
+
+        // Every thread calls main, which calls twice from a single call site
+        SLANG_CHECK(_findCount(report, "{ \"name\": \"main\", \"calls\": ") == threadCount);
+        SLANG_CHECK(_findCount(report, "{ \"name\": \"twice\", \"calls\": ") == threadCount);
+        SLANG_CHECK(_findCount(report, "\"callee\": \"twice\", \"calls\": ") == threadCount);
+        SLANG_CHECK(_findCount(report, "{ \"op\": \"call\", \"count\": ") >= threadCount);
+        SLANG_CHECK(_findCount(report, "{ \"op\": \"mul\", \"count\": ") == threadCount);
+        SLANG_CHECK(_findCount(report, "\"name\": \"main\", \"calls\": 8, \"instructions\": ") > 0);
+    }
+
+    // The table lists the same functions
+    {
+        const char* report = SlangVM_getProfileReport(vm, SLANG_VM_PROFILE_FORMAT_TABLE);
+        SLANG_CHECK(strstr(report, "main") != nullptr && strstr(report, "twice") != nullptr);
+    }
+
+    // Counters accumulate over dispatches
+    _dispatch(vmModule, vmFunc, threadCount);
+    SLANG_CHECK(_findCount(SlangVM_getProfileReport(vm, SLANG_VM_PROFILE_FORMAT_JSON), "{ \"name\": \"main\", \"calls\": ") == threadCount * 2);
+
+    // Resetting clears everything
+    SlangVM_resetProfile(vm);
+    SLANG_CHECK(strcmp(SlangVM_getProfileReport(vm, SLANG_VM_PROFILE_FORMAT_JSON), kEmptyJSONReport) == 0);
+
+    // Nothing is counted once profiling is disabled
+    SlangVM_setProfilingEnabled(vm, 0);
+    _dispatch(vmModule, vmFunc, threadCount);
+    SLANG_CHECK(strcmp(SlangVM_getProfileReport(vm, SLANG_VM_PROFILE_FORMAT_JSON), kEmptyJSONReport) == 0);
+
+    spDestroyCompileRequest(request);
+    spDestroySession(session);
+}
+
+SLANG_UNIT_TEST("VMProfile", vmProfileUnitTest);